@@ -242,6 +242,7 @@ typedef struct SColumnInfoData {
   SColumnInfo info;     // column info
   bool        hasNull;  // if current column data has null value.
   bool        reassigned; // if current column data is reassigned.
+  bool        fromDict;   // var-size rows decoded from a dictionary, the rows of one value share its payload
 } SColumnInfoData;
 
 typedef struct SQueryTableDataCond {
@@ -366,6 +367,19 @@ typedef struct SSortExecInfo {
   int32_t readBytes;   // read io bytes
 } SSortExecInfo;
 
+typedef struct SGroupbyExecInfo {
+  int32_t spillLoops;   // times the in-memory group hash has been spilled
+  int64_t spillGroups;  // number of groups in the on-disk hash
+  int64_t spillBytes;   // bytes written to disk by the on-disk hash
+} SGroupbyExecInfo;
+
+typedef struct SHashJoinExecInfo {
+  int32_t buildSide;        // 0: left child, 1: right child
+  int32_t spillPartitions;  // number of build partitions spilled to disk
+  int64_t buildRows;
+  int64_t spillBytes;  // bytes written to disk by the spilled partitions
+} SHashJoinExecInfo;
+
 typedef struct STUidTagInfo {
   char*    name;
   uint64_t uid;
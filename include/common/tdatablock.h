@@ -208,6 +208,7 @@ double blockDataGetSerialRowSize(const SSDataBlock* pBlock);
 size_t blockDataGetSerialMetaSize(uint32_t numOfCols);
 
 int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo);
+int32_t blockDataReorder(SSDataBlock* pDataBlock, const int32_t* index);
 
 int32_t colInfoDataEnsureCapacity(SColumnInfoData* pColumn, uint32_t numOfRows, bool clearPayload);
 int32_t blockDataEnsureCapacity(SSDataBlock* pDataBlock, uint32_t numOfRows);
@@ -240,6 +241,13 @@ int32_t blockGetEncodeSize(const SSDataBlock* pBlock);
 int32_t blockEncode(const SSDataBlock* pBlock, char* data, int32_t numOfCols);
 const char* blockDecode(SSDataBlock* pBlock, const char* pData);
 
+// compress each column of a block encoded by blockEncode, blockDecode decodes the result as well
+int32_t blockGetCompressBound(const char* pData);
+int32_t blockCompress(const char* pData, char* pOut);
+// restore the bytes of blockEncode from a block that may be compressed
+int32_t blockGetDecompressSize(const char* pData);
+int32_t blockDecompress(const char* pData, char* pOut);
+
 // for debug
 char* dumpBlockData(SSDataBlock* pDataBlock, const char* flag, char** dumpBuf);
 
@@ -211,6 +211,7 @@ struct SColData {
   int32_t *aOffset;
   int32_t  nData;
   uint8_t *pData;
+  int32_t  nDict;  // > 0: the values come from a dictionary of nDict entries, code of row i at aOffset[nVal + i]
 };
 
 #pragma pack(push, 1)
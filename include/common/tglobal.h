@@ -60,6 +60,7 @@ extern int32_t tsNumOfRpcSessions;
 extern int32_t tsTimeToGetAvailableConn;
 extern int32_t tsKeepAliveIdle;
 extern int32_t tsNumOfCommitThreads;
+extern int32_t tsNumOfVnodeInsertThreads;
 extern int32_t tsNumOfTaskQueueThreads;
 extern int32_t tsNumOfMnodeQueryThreads;
 extern int32_t tsNumOfMnodeFetchThreads;
@@ -116,6 +117,14 @@ extern char    *tsSvrCrashReportUri;
 extern int32_t tsQueryBufferSize;  // maximum allowed usage buffer size in MB for each data node during query processing
 extern int64_t tsQueryBufferSizeBytes;    // maximum allowed usage buffer size in byte for each data node
 extern int32_t tsCacheLazyLoadThreshold;  // cost threshold for last/last_row loading cache as much as possible
+extern int32_t tsTsdbBlockCacheSize;      // MB, decompressed column data cache of each vnode, 0 means disabled
+extern bool    tsTagColumnStore;          // columnar copy of the child table tags of each super table, for tag filters
+extern int32_t tsTagColumnStoreSize;      // MB, of the tag column stores of each vnode
+extern int32_t tsBgWriteRateLimit;        // MB/s, writes of the merge, compact and retention tasks, 0 means no limit
+extern int32_t tsCommitFileSetThreads;    // file sets of a memtable committed at once on the commit pool
+extern int32_t tsCommitMemBudget;         // MB, memtable data the threads of one commit encode at the same time
+extern bool    tsAdaptiveCompress;        // pick the encoding of each tsdb block, unreadable by older versions
+extern bool    tsHllSparsePartial;        // sparse hll partial results of few set buckets, unreadable by older versions
 
 // query client
 extern int32_t tsQueryPolicy;
@@ -126,6 +135,7 @@ extern int32_t tsQueryRsmaTolerance;
 extern bool    tsQueryPlannerTrace;
 extern int32_t tsQueryNodeChunkSize;
 extern bool    tsQueryUseNodeAllocator;
+extern bool    tsQueryUseHashJoin;
 extern bool    tsKeepColumnName;
 extern bool    tsEnableQueryHb;
 extern bool    tsEnableScience;
@@ -172,6 +182,7 @@ extern char tsSmlChildTableName[];
 extern char tsSmlTagName[];
 extern bool tsSmlDot2Underline;
 extern char tsSmlTsDefaultName[];
+extern int32_t tsSmlParseThreads;
 // extern bool    tsSmlDataFormat;
 // extern int32_t tsSmlBatchSize;
 
@@ -199,6 +210,9 @@ extern bool    tsFilterScalarMode;
 extern int32_t tsKeepTimeOffset;
 extern int32_t tsMaxStreamBackendCache;
 extern int32_t tsPQSortMemThreshold;
+extern int32_t tsGroupHashMemThreshold;
+extern int32_t tsHashJoinMemThreshold;
+extern int32_t tsNumOfSortThreads;
 extern int32_t tsResolveFQDNRetryTime;
 
 // #define NEEDTO_COMPRESSS_MSG(size) (tsCompressMsgSize != -1 && (size) > tsCompressMsgSize)
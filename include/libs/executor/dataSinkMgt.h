@@ -115,6 +115,12 @@ int32_t dsGetDataBlock(DataSinkHandle handle, SOutputData* pOutput);
 
 int32_t dsGetCacheSize(DataSinkHandle handle, uint64_t* pSize);
 
+/**
+ * Let the datasinker compress the blocks it caches from now on, if it supports it and compressColData allows it.
+ * @param handle
+ */
+void dsSetCompressResult(DataSinkHandle handle);
+
 /**
  * After dsGetStatus returns DS_NEED_SCHEDULE, the caller need to put this into the work queue.
  * @param ahandle
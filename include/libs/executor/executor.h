@@ -225,6 +225,15 @@ void    resetTaskInfo(qTaskInfo_t tinfo);
 int32_t qStreamOperatorReleaseState(qTaskInfo_t tInfo);
 int32_t qStreamOperatorReloadState(qTaskInfo_t tInfo);
 
+/**
+ * Create the workers that generate the sorted runs and perform the intermediate merge passes of the external sorts
+ * @param numOfThreads 1 means the sorts are performed on the query threads
+ * @return
+ */
+int32_t qInitSortWorkers(int32_t numOfThreads);
+
+void qCleanupSortWorkers();
+
 #ifdef __cplusplus
 }
 #endif
@@ -415,6 +415,15 @@ typedef struct SSortMergeJoinPhysiNode {
   SNode*     pColEqualOnConditions;
 } SSortMergeJoinPhysiNode;
 
+typedef struct SHashJoinPhysiNode {
+  SPhysiNode node;
+  EJoinType  joinType;
+  SNode*     pMergeCondition;        // primary key equal condition, used as part of the hash key
+  SNode*     pColEqualOnConditions;  // the other equal conditions of the hash key
+  SNode*     pOnConditions;          // residual join conditions, evaluated on the joined rows
+  SNodeList* pTargets;
+} SHashJoinPhysiNode;
+
 typedef struct SAggPhysiNode {
   SPhysiNode node;
   SNodeList* pExprs;  // these are expression list of group_by_clause and parameter expression of aggregate function
@@ -297,7 +297,6 @@ typedef struct SSelectStmt {
   bool          isEmptyResult;
   bool          isSubquery;
   bool          hasAggFuncs;
-  bool          hasRepeatScanFuncs;
   bool          hasIndefiniteRowsFunc;
   bool          hasMultiRowsFunc;
   bool          hasSelectFunc;
@@ -210,6 +210,10 @@ typedef struct SSyncLogStore {
   int32_t (*syncLogGetEntry)(struct SSyncLogStore* pLogStore, SyncIndex index, SSyncRaftEntry** ppEntry);
   int32_t (*syncLogTruncate)(struct SSyncLogStore* pLogStore, SyncIndex fromIndex);
 
+  // the fsyncs of the appends between the outermost begin and end are done once by the end, which returns true then
+  void (*syncLogBeginGroupCommit)(struct SSyncLogStore* pLogStore);
+  bool (*syncLogEndGroupCommit)(struct SSyncLogStore* pLogStore);
+
 } SSyncLogStore;
 
 typedef struct SSyncInfo {
@@ -251,6 +255,8 @@ void      syncStop(int64_t rid);
 void      syncPreStop(int64_t rid);
 void      syncPostStop(int64_t rid);
 int32_t   syncPropose(int64_t rid, SRpcMsg* pMsg, bool isWeak, int64_t* seq);
+bool      syncBeginGroupCommit(int64_t rid);
+void      syncEndGroupCommit(int64_t rid);
 int32_t   syncIsCatchUp(int64_t rid);
 ESyncRole syncGetRole(int64_t rid);
 int32_t   syncProcessMsg(int64_t rid, SRpcMsg* pMsg);
@@ -120,6 +120,9 @@ typedef struct SWal {
   SHashObj *pRefHash;  // refId -> SWalRef
   // path
   char path[WAL_PATH_LEN];
+  // group commit
+  int32_t groupDepth;
+  bool    fsyncPending;
   // reusable write head
   SWalCkHead writeHead;
 } SWal;
@@ -179,6 +182,12 @@ int64_t walAppendLog(SWal *, int64_t index, tmsg_t msgType, SWalSyncInfo syncMet
 
 void walFsync(SWal *, bool force);
 
+// Group commit: the fsyncs walFsync would do between the outermost begin and end are done once, by the end, which
+// returns true when it closed the outermost group. Appends are still written to the file one by one, so readers see
+// them as before.
+void walBeginGroupCommit(SWal *);
+bool walEndGroupCommit(SWal *);
+
 // apis for lifecycle management
 int32_t walCommit(SWal *, int64_t ver);
 int32_t walRollback(SWal *, int64_t ver);
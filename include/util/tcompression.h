@@ -123,6 +123,46 @@ int32_t tsCompressBigint(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32
 int32_t tsDecompressBigint(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg, void *pBuf,
                            int32_t nBuf);
 
+/*************************************************************************
+ *                  SIMD KERNELS
+ *************************************************************************/
+// The transforms around the byte/bit packing of the codecs above. All functions taking `in` read in[-1] (and in[-2]
+// for the delta of delta), so the caller handles the first element(s) of a column itself.
+typedef struct {
+  const char *name;
+  // number of leading zero bytes of p[0, n)
+  int32_t (*zeroBytes)(const uint8_t *p, int32_t n);
+  // p[i] holds a delta of delta on entry and the value on return, *pValue and *pDelta carry the running sums
+  void (*prefixSum2I64)(int64_t *p, int32_t n, int64_t *pValue, int64_t *pDelta);
+  void (*prefixXorU64)(uint64_t *p, int32_t n, uint64_t *pPrev);
+  void (*prefixXorU32)(uint32_t *p, int32_t n, uint32_t *pPrev);
+  // decode n zigzag deltas of `bit` bits of a simple8b word, return the last value
+  int64_t (*unpackSimple8b)(uint64_t w, int32_t bit, int32_t n, int64_t prev, int64_t *out);
+  // out[i] = zigzag(in[i] - in[i-1]), return false if any subtraction overflows
+  bool (*zigzagDeltaI64)(const int64_t *in, int32_t n, uint64_t *out);
+  // out[i] = zigzag((in[i] - in[i-1]) - (in[i-1] - in[i-2])), return false if any subtraction overflows
+  bool (*zigzagDeltaOfDeltaI64)(const int64_t *in, int32_t n, uint64_t *out);
+  void (*xorPrevU64)(const uint64_t *in, int32_t n, uint64_t *out);
+  void (*xorPrevU32)(const uint32_t *in, int32_t n, uint32_t *out);
+} SCompSimdKernels;
+
+// NULL if SIMD-builtins is off, otherwise the AVX-512, AVX2 or scalar kernels, whichever the cpu supports
+const SCompSimdKernels *tsGetCompSimdKernels();
+
+/*************************************************************************
+ *                  ADAPTIVE COMPRESSION
+ *************************************************************************/
+// A block of an integer, timestamp, float or double type is encoded by the codec of the type above or, if smaller,
+// by frame-of-reference bit packing, a dictionary, run-length or decimal (ALP) encoding. Such a block starts with a
+// byte having COMP_ADAPT_FLAG set, the decoder hands any other block to the codec of the type.
+#define COMP_ADAPT_FLAG 0x80
+
+bool    tsIsAdaptiveType(int8_t type);
+int32_t tsCompressAdaptive(int8_t type, void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg,
+                           void *pBuf, int32_t nBuf);
+int32_t tsDecompressAdaptive(int8_t type, void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut,
+                             uint8_t cmprAlg, void *pBuf, int32_t nBuf);
+
 /*************************************************************************
  *                  STREAM COMPRESSION
  *************************************************************************/
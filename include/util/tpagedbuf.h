@@ -39,6 +39,7 @@ typedef struct SDiskbasedBufStatis {
   int32_t getPages;
   int32_t releasePages;
   int32_t flushPages;
+  int32_t flushWaits;  // times of waiting for the background writes when too many bytes are in flight
 } SDiskbasedBufStatis;
 
 /**
@@ -151,6 +152,22 @@ void setBufPageDirty(void* pPage, bool dirty);
  */
 void setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, bool comp);
 
+/**
+ * Write the evicted pages to disk on a background io thread, and allow pages to be prefetched.
+ * @param pBuf
+ * @param maxInflightBytes the max bytes of pages being written or prefetched, the eviction blocks when it is exceeded
+ * @return
+ */
+int32_t dBufSetAsyncIo(SDiskbasedBuf* pBuf, int64_t maxInflightBytes);
+
+/**
+ * Hint that the page will be accessed soon, it is read from disk in background if it is not in memory.
+ * Only works if async io is enabled by dBufSetAsyncIo.
+ * @param pBuf
+ * @param pageId
+ */
+void dBufPrefetchPage(SDiskbasedBuf* pBuf, int32_t pageId);
+
 /**
  * Set the pageId page buffer is not need
  * @param pBuf
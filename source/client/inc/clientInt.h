@@ -186,6 +186,8 @@ typedef struct SReqResultInfo {
   bool           convertUcs4;
   int32_t        payloadLen;
   char*          convertJson;
+  char*          decompBuf;  // the block of a compressed response, restored
+  int32_t        decompBufSize;
 } SReqResultInfo;
 
 typedef struct SRequestSendRecvBody {
@@ -71,6 +71,8 @@ extern "C" {
 
 #define OTD_JSON_FIELDS_NUM     4
 #define MAX_RETRY_TIMES 10
+// a batch of line or telnet protocol is split across smlParseThreads threads only if every one gets this many lines
+#define SML_PARSE_MIN_LINES_PER_THREAD 4096
 typedef TSDB_SML_PROTOCOL_TYPE SMLProtocolType;
 
 typedef enum {
@@ -172,6 +174,7 @@ typedef struct {
   SHashObj *tableUids;
   SHashObj *superTables;
   SHashObj *pVgHash;
+  SArray   *mergedTables;  // child tables of the parse threads merged into one of childTables, see smlParseLines
 
   STscObj     *taos;
   SCatalog    *pCatalog;
@@ -257,6 +260,7 @@ void freeSSmlKv(void* data);
 int32_t smlParseInfluxString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLineInfo *elements);
 int32_t smlParseTelnetString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLineInfo *elements);
 int32_t smlParseJSON(SSmlHandle *info, char *payload);
+int32_t smlParseLines(SSmlHandle *info, char *lines[], char *rawLine, char *rawLineEnd, int numLines);
 
 void    smlStrReplace(char* src, int32_t len);
 #ifdef __cplusplus
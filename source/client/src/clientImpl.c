@@ -2101,6 +2101,31 @@ void resetConnectDB(STscObj* pTscObj) {
   taosThreadMutexUnlock(&pTscObj->mutex);
 }
 
+static int32_t doDecompressResult(SReqResultInfo* pResultInfo) {
+  int32_t len = blockGetDecompressSize(pResultInfo->pData);
+  if (len <= 0) {
+    tscError("invalid length %d of compressed result", len);
+    return TSDB_CODE_TSC_INTERNAL_ERROR;
+  }
+
+  if (pResultInfo->decompBufSize < len) {
+    char* p = taosMemoryRealloc(pResultInfo->decompBuf, len);
+    if (p == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pResultInfo->decompBuf = p;
+    pResultInfo->decompBufSize = len;
+  }
+
+  if (blockDecompress(pResultInfo->pData, pResultInfo->decompBuf) != len) {
+    tscError("failed to decompress result, length:%d", len);
+    return TSDB_CODE_TSC_INTERNAL_ERROR;
+  }
+
+  pResultInfo->pData = pResultInfo->decompBuf;
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t setQueryResultFromRsp(SReqResultInfo* pResultInfo, const SRetrieveTableRsp* pRsp, bool convertUcs4,
                               bool freeAfterUse) {
   if (pResultInfo == NULL || pRsp == NULL) {
@@ -2118,7 +2143,13 @@ int32_t setQueryResultFromRsp(SReqResultInfo* pResultInfo, const SRetrieveTableR
   pResultInfo->payloadLen = htonl(pRsp->compLen);
   pResultInfo->precision = pRsp->precision;
 
-  // TODO handle the compressed case
+  if (pRsp->compressed && pResultInfo->numOfRows > 0) {
+    int32_t code = doDecompressResult(pResultInfo);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
   pResultInfo->totalRows += pResultInfo->numOfRows;
   return setResultDataPtr(pResultInfo, pResultInfo->fields, pResultInfo->numOfCols, pResultInfo->numOfRows,
                           convertUcs4);
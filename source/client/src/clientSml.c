@@ -256,6 +256,7 @@ void getTableUid(SSmlHandle *info, SSmlLineInfo *currElement, SSmlTableInfo *tin
 
 static void smlDestroySTableMeta(void *para) {
   SSmlSTableMeta *meta = *(SSmlSTableMeta**)para;
+  if (meta == NULL) return;
   taosHashCleanup(meta->tagHash);
   taosHashCleanup(meta->colHash);
   taosArrayDestroy(meta->tags);
@@ -326,14 +327,19 @@ cleanup:
   kvVal->type = TSDB_DATA_TYPE_FLOAT;                                                          \
   kvVal->f = (float)result;
 
-#define SET_BIGINT                                                                                       \
-  errno = 0;                                                                                             \
-  int64_t tmp = taosStr2Int64(pVal, &endptr, 10);                                                        \
-  if (errno == ERANGE) {                                                                                 \
-    smlBuildInvalidDataMsg(msg, "big int out of range[-9223372036854775808,9223372036854775807]", pVal); \
-    return false;                                                                                        \
-  }                                                                                                      \
-  kvVal->type = TSDB_DATA_TYPE_BIGINT;                                                                   \
+#define SET_BIGINT                                                                                         \
+  int64_t tmp = 0;                                                                                         \
+  if (isInt) {                                                                                             \
+    tmp = (int64_t)result;                                                                                 \
+  } else {                                                                                                 \
+    errno = 0;                                                                                             \
+    tmp = taosStr2Int64(pVal, &endptr, 10);                                                                \
+    if (errno == ERANGE) {                                                                                 \
+      smlBuildInvalidDataMsg(msg, "big int out of range[-9223372036854775808,9223372036854775807]", pVal); \
+      return false;                                                                                        \
+    }                                                                                                      \
+  }                                                                                                        \
+  kvVal->type = TSDB_DATA_TYPE_BIGINT;                                                                     \
   kvVal->i = tmp;
 
 #define SET_INT                                                                    \
@@ -353,8 +359,13 @@ cleanup:
   kvVal->i = result;
 
 #define SET_UBIGINT                                                                             \
+  uint64_t tmp = 0;                                                                             \
   errno = 0;                                                                                    \
-  uint64_t tmp = taosStr2UInt64(pVal, &endptr, 10);                                             \
+  if (isInt && result >= 0) {                                                                   \
+    tmp = (uint64_t)result;                                                                     \
+  } else {                                                                                      \
+    tmp = taosStr2UInt64(pVal, &endptr, 10);                                                    \
+  }                                                                                             \
   if (errno == ERANGE || result < 0) {                                                          \
     smlBuildInvalidDataMsg(msg, "unsigned big int out of range[0,18446744073709551615]", pVal); \
     return false;                                                                               \
@@ -394,11 +405,61 @@ cleanup:
   kvVal->type = TSDB_DATA_TYPE_UTINYINT;                                        \
   kvVal->u = result;
 
+static const double smlPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// The common case of taosStr2Double: a sign, at most 19 digits with or without a fraction and no exponent. If the
+// digits fit in the 53 bits of a double and there are at most 22 of them after the point, both the digits and the
+// power of ten are exact doubles and one division rounds the same as strtod. *pIsInt tells there is no point.
+static bool smlStr2DoubleFast(const char *pVal, int32_t len, double *pResult, bool *pIsInt, char **pEnd) {
+  const char *p = pVal;
+  const char *end = pVal + len;
+  bool        negative = false;
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = (*p == '-');
+    p++;
+  }
+
+  uint64_t mantissa = 0;
+  int32_t  digits = 0;
+  int32_t  fraction = 0;
+  for (; p < end && *p >= '0' && *p <= '9'; p++, digits++) {
+    mantissa = mantissa * 10 + (*p - '0');
+  }
+  *pIsInt = (p == end || *p != '.');
+  if (!*pIsInt) {
+    for (p++; p < end && *p >= '0' && *p <= '9'; p++, digits++, fraction++) {
+      mantissa = mantissa * 10 + (*p - '0');
+    }
+  }
+
+  // exponents and hex floats are left to strtod
+  if (digits == 0 || digits > 19 || mantissa > (1ull << 53) ||
+      (p < end && (*p == 'e' || *p == 'E' || *p == 'x' || *p == 'X'))) {
+    return false;
+  }
+
+  double result = (double)mantissa;
+  if (fraction > 0) {
+    if (fraction >= sizeof(smlPow10) / sizeof(smlPow10[0])) return false;
+    result /= smlPow10[fraction];
+  }
+
+  *pResult = negative ? -result : result;
+  *pEnd = (char *)p;
+  return true;
+}
+
 bool smlParseNumber(SSmlKv *kvVal, SSmlMsgBuf *msg) {
   const char *pVal = kvVal->value;
   int32_t     len = kvVal->length;
   char       *endptr = NULL;
-  double      result = taosStr2Double(pVal, &endptr);
+  double      result = 0;
+  bool        isInt = false;
+  if (!smlStr2DoubleFast(pVal, len, &result, &isInt, &endptr)) {
+    isInt = false;
+    result = taosStr2Double(pVal, &endptr);
+  }
   if (pVal == endptr) {
     RETURN_FALSE
   }
@@ -1174,6 +1235,7 @@ static int32_t smlUpdateMeta(SHashObj *metaHash, SArray *metaArray, SArray *cols
 
 void smlDestroyTableInfo(void *para) {
   SSmlTableInfo *tag = *(SSmlTableInfo**)para;
+  if (tag == NULL) return;
   for (size_t i = 0; i < taosArrayGetSize(tag->cols); i++) {
     SHashObj *kvHash = (SHashObj *)taosArrayGetP(tag->cols, i);
     taosHashCleanup(kvHash);
@@ -1228,6 +1290,7 @@ void smlDestroyInfo(SSmlHandle *info) {
   taosHashCleanup(info->childTables);
   taosHashCleanup(info->superTables);
   taosHashCleanup(info->tableUids);
+  taosArrayDestroyEx(info->mergedTables, smlDestroyTableInfo);
 
   for (int i = 0; i < taosArrayGetSize(info->tagJsonArray); i++) {
     cJSON *tags = (cJSON *)taosArrayGetP(info->tagJsonArray, i);
@@ -1629,13 +1692,204 @@ static int32_t smlParseLine(SSmlHandle *info, char *lines[], char *rawLine, char
   return code;
 }
 
-static int smlProcess(SSmlHandle *info, char *lines[], char *rawLine, char *rawLineEnd, int numLines) {
+typedef struct {
+  SSmlHandle *info;
+  char      **lines;
+  char       *rawLine;
+  char       *rawLineEnd;
+  int32_t     numLines;
+  int32_t     code;
+  bool        started;
+  TdThread    thread;
+  char        msg[ERROR_MSG_BUF_DEFAULT_SIZE];
+} SSmlParseTask;
+
+static void smlParseChunk(SSmlParseTask *pTask) {
+  pTask->code = smlParseLine(pTask->info, pTask->lines, pTask->rawLine, pTask->rawLineEnd, pTask->numLines);
+  if (pTask->code == TSDB_CODE_SUCCESS) {
+    pTask->code = smlParseLineBottom(pTask->info);
+  }
+}
+
+static void *smlParseThreadFp(void *param) {
+  setThreadName("sml-parse");
+  smlParseChunk((SSmlParseTask *)param);
+  return NULL;
+}
+
+// move the child and super tables of one chunk into info, leaving NULL behind in sub. Rows of a child table seen before
+// are appended to it and the super table metas are merged the way smlParseLineBottom merges the lines of one chunk.
+static int32_t smlMergeParseResult(SSmlHandle *info, SSmlHandle *sub) {
   int32_t code = TSDB_CODE_SUCCESS;
-  int32_t retryNum = 0;
+  SSmlTableInfo **oneTable = (SSmlTableInfo **)taosHashIterate(sub->childTables, NULL);
+  while (oneTable) {
+    SSmlTableInfo  *tinfo = *oneTable;
+    size_t          keyLen = 0;
+    void           *key = taosHashGetKey(oneTable, &keyLen);
+    SSmlTableInfo **pDst = (SSmlTableInfo **)taosHashGet(info->childTables, key, keyLen);
+    if (pDst) {
+      // the tags of the super table meta may still point to the escaped keys of this one, so it lives as long as info
+      taosArrayAddAll((*pDst)->cols, tinfo->cols);
+      taosArrayClear(tinfo->cols);
+      if (info->mergedTables == NULL) {
+        info->mergedTables = taosArrayInit(8, POINTER_BYTES);
+      }
+      if (info->mergedTables == NULL || taosArrayPush(info->mergedTables, &tinfo) == NULL) {
+        smlDestroyTableInfo(&tinfo);
+        code = TSDB_CODE_OUT_OF_MEMORY;
+      }
+    } else {
+      // the uid of a child table is only unique inside the handle that assigned it
+      SSmlLineInfo element = {.measure = (char *)tinfo->sTableName, .measureLen = tinfo->sTableNameLen};
+      getTableUid(info, &element, tinfo);
+      taosHashPut(info->childTables, key, keyLen, &tinfo, POINTER_BYTES);
+    }
+    *oneTable = NULL;
+    oneTable = (SSmlTableInfo **)taosHashIterate(sub->childTables, oneTable);
+  }
+
+  SSmlSTableMeta **oneSTable = (SSmlSTableMeta **)taosHashIterate(sub->superTables, NULL);
+  while (oneSTable) {
+    size_t           keyLen = 0;
+    void            *key = taosHashGetKey(oneSTable, &keyLen);
+    SSmlSTableMeta **pDst = (SSmlSTableMeta **)taosHashGet(info->superTables, key, keyLen);
+    if (pDst) {
+      if (code == TSDB_CODE_SUCCESS) {
+        code = smlUpdateMeta((*pDst)->colHash, (*pDst)->cols, (*oneSTable)->cols, false, &info->msgBuf);
+      }
+      if (code == TSDB_CODE_SUCCESS) {
+        code = smlUpdateMeta((*pDst)->tagHash, (*pDst)->tags, (*oneSTable)->tags, true, &info->msgBuf);
+      }
+    } else {
+      taosHashPut(info->superTables, key, keyLen, oneSTable, POINTER_BYTES);
+      *oneSTable = NULL;
+    }
+    oneSTable = (SSmlSTableMeta **)taosHashIterate(sub->superTables, oneSTable);
+  }
 
-  info->cost.parseTime = taosGetTimestampUs();
+  return code;
+}
+
+// Split the lines into numOfThreads chunks and parse each chunk into its own handle, the calling thread takes the
+// first one. The chunks are merged in order, so the rows of a child table keep the order of the lines and the error of
+// the first bad line is the one reported. Only used for the line and telnet protocols, which never rerun in the
+// non-dataFormat mode.
+static int32_t smlParseLineParallel(SSmlHandle *info, char *lines[], char *rawLine, char *rawLineEnd, int numLines,
+                                    int32_t numOfThreads) {
+  int32_t        code = TSDB_CODE_SUCCESS;
+  SSmlParseTask *pTasks = (SSmlParseTask *)taosMemoryCalloc(numOfThreads, sizeof(SSmlParseTask));
+  if (pTasks == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  info->dataFormat = false;
+  if (info->lines == NULL) {
+    info->lines = (SSmlLineInfo *)taosMemoryCalloc(numLines, sizeof(SSmlLineInfo));
+    if (info->lines == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+  }
+
+  int32_t start = 0;
+  for (int32_t i = 0; i < numOfThreads; i++) {
+    SSmlParseTask *pTask = pTasks + i;
+    int32_t        num = numLines / numOfThreads + (i < numLines % numOfThreads ? 1 : 0);
+
+    SSmlHandle *sub = smlBuildSmlInfo(NULL);
+    if (sub == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+    sub->id = info->id;
+    sub->protocol = info->protocol;
+    sub->precision = info->precision;
+    sub->isRawLine = info->isRawLine;
+    sub->ttl = info->ttl;
+    sub->dataFormat = false;
+    sub->msgBuf.buf = pTask->msg;
+    sub->msgBuf.len = ERROR_MSG_BUF_DEFAULT_SIZE;
+    sub->lines = info->lines + start;
+    sub->lineNum = num;
+
+    pTask->info = sub;
+    pTask->numLines = num;
+    if (lines) {
+      pTask->lines = lines + start;
+    } else {
+      // comment lines are not counted in numLines, they go to the chunk of the line after them
+      pTask->rawLine = rawLine;
+      int32_t cnt = 0;
+      while (cnt < num && rawLine < rawLineEnd) {
+        if (info->protocol != TSDB_SML_LINE_PROTOCOL || rawLine[0] != '#') {
+          cnt++;
+        }
+        char *next = memchr(rawLine, '\n', rawLineEnd - rawLine);
+        rawLine = next ? next + 1 : rawLineEnd;
+      }
+      pTask->rawLineEnd = (i == numOfThreads - 1) ? rawLineEnd : rawLine;
+    }
+    start += num;
+  }
+
+  for (int32_t i = 1; i < numOfThreads; i++) {
+    SSmlParseTask *pTask = pTasks + i;
+    if (taosThreadCreate(&pTask->thread, NULL, smlParseThreadFp, pTask) == 0) {
+      pTask->started = true;
+    } else {
+      uWarn("SML:0x%" PRIx64 " failed to create parse thread, parse chunk %d in the caller", info->id, i);
+      smlParseChunk(pTask);
+    }
+  }
+  smlParseChunk(pTasks);
+  for (int32_t i = 1; i < numOfThreads; i++) {
+    if (pTasks[i].started) {
+      taosThreadJoin(pTasks[i].thread, NULL);
+    }
+  }
+
+  for (int32_t i = 0; i < numOfThreads; i++) {
+    if (pTasks[i].code != TSDB_CODE_SUCCESS) {
+      code = pTasks[i].code;
+      tstrncpy(info->msgBuf.buf, pTasks[i].msg, info->msgBuf.len);
+      uError("SML:0x%" PRIx64 " parse chunk %d failed:%s", info->id, i, tstrerror(code));
+      goto _exit;
+    }
+  }
+
+  for (int32_t i = 0; i < numOfThreads; i++) {
+    code = smlMergeParseResult(info, pTasks[i].info);
+    if (code != TSDB_CODE_SUCCESS) {
+      uError("SML:0x%" PRIx64 " merge chunk %d failed:%s", info->id, i, tstrerror(code));
+      goto _exit;
+    }
+  }
+
+_exit:
+  for (int32_t i = 0; i < numOfThreads; i++) {
+    SSmlHandle *sub = pTasks[i].info;
+    if (sub == NULL) continue;
+    // the lines belong to info
+    sub->lines = NULL;
+    sub->lineNum = 0;
+    smlDestroyInfo(sub);
+  }
+  taosMemoryFree(pTasks);
+  return code;
+}
 
-  code = smlParseLine(info, lines, rawLine, rawLineEnd, numLines);
+int32_t smlParseLines(SSmlHandle *info, char *lines[], char *rawLine, char *rawLineEnd, int numLines) {
+  int32_t numOfThreads = 1;
+  if (info->protocol != TSDB_SML_JSON_PROTOCOL) {
+    numOfThreads = TMIN(tsSmlParseThreads, numLines / SML_PARSE_MIN_LINES_PER_THREAD);
+  }
+
+  if (numOfThreads > 1) {
+    uDebug("SML:0x%" PRIx64 " parse %d lines in %d threads", info->id, numLines, numOfThreads);
+    return smlParseLineParallel(info, lines, rawLine, rawLineEnd, numLines, numOfThreads);
+  }
+
+  int32_t code = smlParseLine(info, lines, rawLine, rawLineEnd, numLines);
   if (code != 0) {
     uError("SML:0x%" PRIx64 " smlParseLine error : %s", info->id, tstrerror(code));
     return code;
@@ -1645,6 +1899,19 @@ static int smlProcess(SSmlHandle *info, char *lines[], char *rawLine, char *rawL
     uError("SML:0x%" PRIx64 " smlParseLineBottom error : %s", info->id, tstrerror(code));
     return code;
   }
+  return code;
+}
+
+static int smlProcess(SSmlHandle *info, char *lines[], char *rawLine, char *rawLineEnd, int numLines) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  int32_t retryNum = 0;
+
+  info->cost.parseTime = taosGetTimestampUs();
+
+  code = smlParseLines(info, lines, rawLine, rawLineEnd, numLines);
+  if (code != 0) {
+    return code;
+  }
 
   info->cost.lineNum = info->lineNum;
   info->cost.numOfSTables = taosHashGetSize(info->superTables);
@@ -18,6 +18,13 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(_TD_X86_) && defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+// before os.h, which forbids the malloc/free that mm_malloc.h refers to
+#include <immintrin.h>
+#define SML_SIMD_X86
+#define SML_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
 #include "clientSml.h"
 
 // comma ,
@@ -54,6 +61,80 @@
 #define BINARY_ADD_LEN 2  // "binary"   2 means " "
 #define NCHAR_ADD_LEN  3  // L"nchar"   3 means L" "
 
+// The scan loops below only act on ' ', ',', '=', '"' and '\\', looking back one byte for an escape, so they may jump
+// straight to the next of these characters. The vector scans test two vectors, 32 or 64 bytes, at a time and leave the
+// tail of a line to a single vector and then to the table.
+static const uint8_t smlSpecialChar[256] = {[SPACE] = 1, [COMMA] = 1, [EQUAL] = 1, [QUOTE] = 1, [SLASH] = 1};
+
+static FORCE_INLINE const char *smlSkipPlainScalar(const char *p, const char *end) {
+  while (p < end && !smlSpecialChar[(uint8_t)*p]) p++;
+  return p;
+}
+
+#ifdef SML_SIMD_X86
+// a bit for each special character of the 16 bytes at p
+static FORCE_INLINE uint32_t smlSpecialMaskSse2(const char *p) {
+  __m128i v = _mm_loadu_si128((const __m128i *)p);
+  __m128i m = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(SPACE)), _mm_cmpeq_epi8(v, _mm_set1_epi8(COMMA))),
+      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(EQUAL)), _mm_cmpeq_epi8(v, _mm_set1_epi8(QUOTE))));
+  return (uint32_t)_mm_movemask_epi8(_mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(SLASH))));
+}
+
+static const char *smlSkipPlainSse2(const char *p, const char *end) {
+  for (; end - p >= 32; p += 32) {
+    uint32_t mask = smlSpecialMaskSse2(p) | (smlSpecialMaskSse2(p + 16) << 16);
+    if (mask != 0) return p + __builtin_ctz(mask);
+  }
+  if (end - p >= 16) {
+    uint32_t mask = smlSpecialMaskSse2(p);
+    if (mask != 0) return p + __builtin_ctz(mask);
+    p += 16;
+  }
+  return smlSkipPlainScalar(p, end);
+}
+
+// a bit for each special character of the 32 bytes at p
+SML_TARGET_AVX2 static FORCE_INLINE uint32_t smlSpecialMaskAvx2(const char *p) {
+  __m256i v = _mm256_loadu_si256((const __m256i *)p);
+  __m256i m = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(SPACE)), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(COMMA))),
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(EQUAL)), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(QUOTE))));
+  return (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(SLASH))));
+}
+
+SML_TARGET_AVX2 static const char *smlSkipPlainAvx2(const char *p, const char *end) {
+  for (; end - p >= 64; p += 64) {
+    uint64_t mask = smlSpecialMaskAvx2(p) | ((uint64_t)smlSpecialMaskAvx2(p + 32) << 32);
+    if (mask != 0) return p + __builtin_ctzll(mask);
+  }
+  if (end - p >= 32) {
+    uint32_t mask = smlSpecialMaskAvx2(p);
+    if (mask != 0) return p + __builtin_ctz(mask);
+    p += 32;
+  }
+  return smlSkipPlainSse2(p, end);
+}
+#endif
+
+// the first special character in [p, end), or end
+static FORCE_INLINE const char *smlSkipPlain(const char *p, const char *end) {
+#ifdef SML_SIMD_X86
+  return (tsSIMDBuiltins && tsAVX2Enable) ? smlSkipPlainAvx2(p, end) : smlSkipPlainSse2(p, end);
+#else
+  return smlSkipPlainScalar(p, end);
+#endif
+}
+
+// one scan by level, declared for smlTest only, in its smlTestInt.h
+const char *smlSkipPlainByLevel(const char *p, const char *end, int8_t level) {
+#ifdef SML_SIMD_X86
+  if (level == 2) return smlSkipPlainAvx2(p, end);
+  if (level == 1) return smlSkipPlainSse2(p, end);
+#endif
+  return smlSkipPlainScalar(p, end);
+}
+
 uint8_t smlPrecisionConvert[7] = {TSDB_TIME_PRECISION_NANO,    TSDB_TIME_PRECISION_HOURS, TSDB_TIME_PRECISION_MINUTES,
                                   TSDB_TIME_PRECISION_SECONDS, TSDB_TIME_PRECISION_MILLI, TSDB_TIME_PRECISION_MICRO,
                                   TSDB_TIME_PRECISION_NANO};
@@ -203,6 +284,10 @@ static int32_t smlParseTagKv(SSmlHandle *info, char **sql, char *sqlEnd, SSmlLin
     bool        keyEscaped = false;
     size_t      keyLenEscaped = 0;
     while (*sql < sqlEnd) {
+      *sql = (char *)smlSkipPlain(*sql, sqlEnd);
+      if (unlikely(*sql == sqlEnd)) {
+        break;
+      }
       if (unlikely(IS_SPACE(*sql) || IS_COMMA(*sql))) {
         smlBuildInvalidDataMsg(&info->msgBuf, "invalid data", *sql);
         return TSDB_CODE_SML_INVALID_DATA;
@@ -231,6 +316,10 @@ static int32_t smlParseTagKv(SSmlHandle *info, char **sql, char *sqlEnd, SSmlLin
     size_t      valueLenEscaped = 0;
     while (*sql < sqlEnd) {
       // parse value
+      *sql = (char *)smlSkipPlain(*sql, sqlEnd);
+      if (unlikely(*sql == sqlEnd)) {
+        break;
+      }
       if (unlikely(IS_SPACE(*sql) || IS_COMMA(*sql))) {
         break;
       } else if (unlikely(IS_EQUAL(*sql))) {
@@ -412,6 +501,10 @@ static int32_t smlParseColKv(SSmlHandle *info, char **sql, char *sqlEnd, SSmlLin
     bool        keyEscaped = false;
     size_t      keyLenEscaped = 0;
     while (*sql < sqlEnd) {
+      *sql = (char *)smlSkipPlain(*sql, sqlEnd);
+      if (unlikely(*sql == sqlEnd)) {
+        break;
+      }
       if (unlikely(IS_SPACE(*sql) || IS_COMMA(*sql))) {
         smlBuildInvalidDataMsg(&info->msgBuf, "invalid data", *sql);
         return TSDB_CODE_SML_INVALID_DATA;
@@ -442,6 +535,10 @@ static int32_t smlParseColKv(SSmlHandle *info, char **sql, char *sqlEnd, SSmlLin
     const char *escapeChar = NULL;
     while (*sql < sqlEnd) {
       // parse value
+      *sql = (char *)smlSkipPlain(*sql, sqlEnd);
+      if (unlikely(*sql == sqlEnd)) {
+        break;
+      }
       if (unlikely(*(*sql) == QUOTE && (*(*sql - 1) != SLASH || (*sql - 1) == escapeChar))) {
         quoteNum++;
         (*sql)++;
@@ -563,6 +660,10 @@ int32_t smlParseInfluxString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLine
   // parse measure
   size_t measureLenEscaped = 0;
   while (sql < sqlEnd) {
+    sql = (char *)smlSkipPlain(sql, sqlEnd);
+    if (unlikely(sql == sqlEnd)) {
+      break;
+    }
     if (unlikely((sql != elements->measure) && IS_SLASH_LETTER_IN_MEASUREMENT(sql))) {
       elements->measureEscaped = true;
       measureLenEscaped++;
@@ -587,6 +688,10 @@ int32_t smlParseInfluxString(SSmlHandle *info, char *sql, char *sqlEnd, SSmlLine
   // to get measureTagsLen before
   const char *tmp = sql;
   while (tmp < sqlEnd) {
+    tmp = smlSkipPlain(tmp, sqlEnd);
+    if (unlikely(tmp == sqlEnd)) {
+      break;
+    }
     if (unlikely(IS_SPACE(tmp))) {
       break;
     }
@@ -18,6 +18,8 @@
 #include <taoserror.h>
 #include <tglobal.h>
 #include <iostream>
+#include <string>
+#include <vector>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wwrite-strings"
@@ -26,6 +28,7 @@
 #pragma GCC diagnostic ignored "-Wsign-compare"
 
 #include "../inc/clientSml.h"
+#include "smlTestInt.h"
 #include "taos.h"
 
 int main(int argc, char **argv) {
@@ -581,4 +584,339 @@ TEST(testCase, smlParseNumber_performance_Test) {
     printf("smlParseNumberOld:%s cost:%" PRId64, str[i], taosGetTimestampUs() - t2);
     printf("\n\n");
   }
-}
\ No newline at end of file
+}
+
+TEST(testCase, smlParseNumber_fast_Test) {
+  char       buf[64] = {0};
+  SSmlMsgBuf msg = {0};
+  msg.buf = buf;
+  msg.len = 64;
+
+  std::vector<std::string> nums = {"0",     "-0",    "+7",     "1.",     ".5",     "-.5",    "0.1",
+                                   "3.14",  "1e5",   "1.5E-3", "1E+2",   "nan",    "inf",    "9007199254740992",
+                                   "9007199254740993",       "-9223372036854775808",           "18446744073709551615",
+                                   "123456789012345678",     "1234567890123456789",            "12345678901234567890",
+                                   "0.0000000000000000000001",                                 "00000000000000000000001"};
+  uint64_t seed = 1;
+  for (int i = 0; i < 10000; ++i) {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    char str[64] = {0};
+    int  intDigits = (seed >> 8) % 17, fracDigits = (seed >> 16) % 9;
+    snprintf(str, sizeof(str), "%s%.*s%s%.*s", (seed & 1) ? "-" : "", intDigits + 1, "98765432109876543210",
+             fracDigits ? "." : "", fracDigits, std::to_string(seed).c_str());
+    nums.push_back(str);
+  }
+
+  const char *suffixes[] = {"", "f64", "f32", "i64", "i", "u64", "u", "i32", "u16", "i8"};
+  for (const std::string &num : nums) {
+    for (const char *suffix : suffixes) {
+      std::string str = num + suffix;
+      SSmlKv      kv = {0};
+      kv.value = str.c_str();
+      kv.length = str.size();
+      bool res = smlParseNumber(&kv, &msg);
+
+      // what the parser computed with strtod/strtoll alone
+      char  *endptr = NULL;
+      double d = taosStr2Double(str.c_str(), &endptr);
+      if (endptr == str.c_str() || strcmp(endptr, suffix) != 0) {
+        ASSERT_FALSE(res) << str;
+        continue;
+      }
+      if (!res) continue;  // out of the range of the type
+
+      switch (kv.type) {
+        case TSDB_DATA_TYPE_DOUBLE:
+          ASSERT_EQ(memcmp(&kv.d, &d, sizeof(double)), 0) << str;
+          break;
+        case TSDB_DATA_TYPE_FLOAT:
+          ASSERT_EQ(kv.f, (float)d) << str;
+          break;
+        case TSDB_DATA_TYPE_BIGINT:
+          ASSERT_EQ(kv.i, taosStr2Int64(str.c_str(), NULL, 10)) << str;
+          break;
+        case TSDB_DATA_TYPE_UBIGINT:
+          ASSERT_EQ(kv.u, taosStr2UInt64(str.c_str(), NULL, 10)) << str;
+          break;
+        case TSDB_DATA_TYPE_INT:
+        case TSDB_DATA_TYPE_TINYINT:
+          ASSERT_EQ(kv.i, (int64_t)d) << str;
+          break;
+        default:
+          ASSERT_EQ(kv.u, (uint64_t)d) << str;
+          break;
+      }
+    }
+  }
+}
+
+// Telegraf-like lines of a few inputs, with an escaped tag value and a string field here and there
+static std::vector<std::string> smlGenInfluxLines(int32_t num) {
+  std::vector<std::string> lines;
+  char                     line[1024] = {0};
+  uint64_t                 seed = 2023;
+  int64_t                  ts = 1626006833639000000;
+  for (int32_t i = 0; i < num; ++i) {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    int32_t host = (seed >> 8) % 200;
+    double  v = (double)((seed >> 16) % 100000) / 100;
+    ts += 1000000;
+    switch (i % 4) {
+      case 0:
+        snprintf(line, sizeof(line),
+                 "cpu,cpu=cpu%d,host=server%03d,region=us-west-2 usage_user=%.2f,usage_system=%.2f,usage_idle=%.2f,"
+                 "usage_iowait=0.1,usage_steal=0 %" PRId64,
+                 i % 8, host, v, v / 7, 100 - v / 3, ts);
+        break;
+      case 1:
+        snprintf(line, sizeof(line),
+                 "mem,host=server%03d active=%" PRIu64 "i,available=%" PRIu64 "i,available_percent=%.2f,buffered=0i,"
+                 "free=%" PRIu64 "i,used_percent=%.3f %" PRId64,
+                 host, seed % 100000000, seed % 1000000000, v / 10, seed % 10000, v / 11, ts);
+        break;
+      case 2:
+        snprintf(line, sizeof(line),
+                 "disk,device=sda%d,fstype=ext4,host=server%03d,mode=rw,path=/var/lib\\ data free=%" PRIu64
+                 "i,inodes_free=%" PRIu64 "i,used_percent=%.2f %" PRId64,
+                 i % 3, host, seed % 1000000000000, seed % 1000000, v / 10, ts);
+        break;
+      default:
+        snprintf(line, sizeof(line),
+                 "system,host=server%03d load1=%.2f,load5=%.2f,n_cpus=8i,uptime_format=\"%d days, \\\"up\\\"\" %" PRId64,
+                 host, v / 1000, v / 900, host, ts);
+        break;
+    }
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+TEST(testCase, smlSkipPlain_simd_Test) {
+  char sse42 = 0, avx = 0, avx2 = 0, fma = 0, avx512 = 0;
+  taosGetCpuInstructions(&sse42, &avx, &avx2, &fma, &avx512);
+
+  // plain letters with the special characters, their neighbours and bytes over 0x7f at random densities
+  const char alphabet[] = " ,=\"\\!+-<>[]a0\x7f\x80\xa0\xdc\xff";
+  char       buf[160] = {0};
+  uint64_t   seed = 2024;
+  for (int32_t i = 0; i < 5000; ++i) {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    int32_t len = (seed >> 8) % sizeof(buf);
+    int32_t density = 1 + (seed >> 24) % 64;
+    for (int32_t j = 0; j < len; ++j) {
+      seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+      buf[j] = ((seed >> 8) % density == 0) ? alphabet[(seed >> 24) % (sizeof(alphabet) - 1)] : 'a' + (seed >> 32) % 26;
+    }
+
+    // from every offset, so that the vector loads start at any alignment and end in any tail
+    for (int32_t start = 0; start <= len; ++start) {
+      const char *expected = smlSkipPlainByLevel(buf + start, buf + len, 0);
+      for (int8_t level = 1; level <= (avx2 ? 2 : 1); ++level) {
+        ASSERT_EQ(smlSkipPlainByLevel(buf + start, buf + len, level), expected)
+            << "line " << i << ", start " << start << ", level " << (int32_t)level;
+      }
+    }
+  }
+}
+
+TEST(testCase, smlParseInfluxString_simd_Test) {
+  std::vector<std::string> lines = smlGenInfluxLines(2000);
+
+  char sse42 = 0, avx = 0, avx2 = 0, fma = 0, avx512 = 0;
+  taosGetCpuInstructions(&sse42, &avx, &avx2, &fma, &avx512);
+  char oldSimd = tsSIMDBuiltins, oldAvx2 = tsAVX2Enable;
+
+  // the shape of every parsed line, which must not depend on the scan
+  std::vector<std::vector<int64_t>> expected;
+  for (int32_t level = 0; level < (avx2 ? 2 : 1); ++level) {
+    tsSIMDBuiltins = level;
+    tsAVX2Enable = level ? avx2 : 0;
+
+    SSmlHandle *info = smlBuildSmlInfo(NULL);
+    info->protocol = TSDB_SML_LINE_PROTOCOL;
+    info->dataFormat = false;
+
+    std::vector<std::vector<int64_t>> shapes;
+    for (const std::string &line : lines) {
+      SSmlLineInfo elements = {0};
+      char        *sql = (char *)line.c_str();
+      int32_t      ret = smlParseInfluxString(info, sql, sql + line.size(), &elements);
+      shapes.push_back({ret, (int64_t)elements.measureLen, (int64_t)elements.measureTagsLen, (int64_t)elements.tagsLen,
+                        (int64_t)elements.colsLen, (int64_t)elements.timestampLen,
+                        (int64_t)taosArrayGetSize(elements.colArray)});
+      taosArrayDestroyEx(elements.colArray, freeSSmlKv);
+    }
+    smlDestroyInfo(info);
+
+    if (level == 0) {
+      expected = shapes;
+    } else {
+      ASSERT_EQ(shapes, expected);
+    }
+    for (const std::vector<int64_t> &shape : shapes) ASSERT_EQ(shape[0], 0);
+  }
+
+  tsSIMDBuiltins = oldSimd;
+  tsAVX2Enable = oldAvx2;
+}
+
+// the MB/s of each scan and of the parser on 200k lines, run with --gtest_also_run_disabled_tests
+TEST(testCase, DISABLED_smlParseInfluxString_performance_Test) {
+  std::vector<std::string> lines = smlGenInfluxLines(200000);
+  size_t                   bytes = 0;
+  for (const std::string &line : lines) bytes += line.size();
+
+  char sse42 = 0, avx = 0, avx2 = 0, fma = 0, avx512 = 0;
+  taosGetCpuInstructions(&sse42, &avx, &avx2, &fma, &avx512);
+  const char *names[] = {"table", "sse2", "avx2"};
+
+  // every special character of every line, one scan after another
+  for (int8_t level = 0; level <= (avx2 ? 2 : 1); ++level) {
+    int64_t found = 0;
+    int64_t start = taosGetTimestampUs();
+    for (const std::string &line : lines) {
+      const char *end = line.data() + line.size();
+      for (const char *p = smlSkipPlainByLevel(line.data(), end, level); p < end;
+           p = smlSkipPlainByLevel(p + 1, end, level)) {
+        found++;
+      }
+    }
+    int64_t cost = taosGetTimestampUs() - start;
+    printf("smlSkipPlain %s: %d lines, %" PRId64 " special characters, %.2f MB/s\n", names[level],
+           (int32_t)lines.size(), found, cost > 0 ? bytes / (double)cost : 0);
+  }
+
+  char oldSimd = tsSIMDBuiltins, oldAvx2 = tsAVX2Enable;
+  for (int32_t level = 0; level < (avx2 ? 2 : 1); ++level) {
+    tsSIMDBuiltins = level;
+    tsAVX2Enable = level ? avx2 : 0;
+
+    SSmlHandle *info = smlBuildSmlInfo(NULL);
+    info->protocol = TSDB_SML_LINE_PROTOCOL;
+    info->dataFormat = false;
+
+    int64_t start = taosGetTimestampUs();
+    for (const std::string &line : lines) {
+      SSmlLineInfo elements = {0};
+      char        *sql = (char *)line.c_str();
+      ASSERT_EQ(smlParseInfluxString(info, sql, sql + line.size(), &elements), 0);
+      taosArrayDestroyEx(elements.colArray, freeSSmlKv);
+    }
+    int64_t cost = taosGetTimestampUs() - start;
+    printf("smlParseInfluxString %s: %d lines, %.2f MB/s\n", level ? "avx2" : "sse2/scalar", (int32_t)lines.size(),
+           cost > 0 ? bytes / (double)cost : 0);
+    smlDestroyInfo(info);
+  }
+
+  tsSIMDBuiltins = oldSimd;
+  tsAVX2Enable = oldAvx2;
+}
+
+// parse one raw batch with tsSmlParseThreads threads, the handle is left as smlProcess would see it
+static SSmlHandle *smlParseRawLines(std::string &raw, int32_t numLines, int32_t threads, int64_t *cost) {
+  int32_t oldThreads = tsSmlParseThreads;
+  tsSmlParseThreads = threads;
+
+  SSmlHandle *info = smlBuildSmlInfo(NULL);
+  info->protocol = TSDB_SML_LINE_PROTOCOL;
+  info->isRawLine = true;
+  info->dataFormat = false;
+  info->lineNum = numLines;
+  info->lines = (SSmlLineInfo *)taosMemoryCalloc(numLines, sizeof(SSmlLineInfo));
+
+  int64_t start = taosGetTimestampUs();
+  int32_t ret = smlParseLines(info, NULL, (char *)raw.data(), (char *)raw.data() + raw.size(), numLines);
+  *cost = taosGetTimestampUs() - start;
+  EXPECT_EQ(ret, 0);
+
+  tsSmlParseThreads = oldThreads;
+  return info;
+}
+
+static void smlCheckSameKvs(SArray *expected, SArray *kvs) {
+  ASSERT_EQ(taosArrayGetSize(kvs), taosArrayGetSize(expected));
+  for (int32_t i = 0; i < taosArrayGetSize(expected); ++i) {
+    SSmlKv *a = (SSmlKv *)taosArrayGet(expected, i);
+    SSmlKv *b = (SSmlKv *)taosArrayGet(kvs, i);
+    ASSERT_EQ(std::string(a->key, a->keyLen), std::string(b->key, b->keyLen));
+    ASSERT_EQ(a->type, b->type);
+    ASSERT_EQ(a->length, b->length);
+  }
+}
+
+TEST(testCase, smlParseLines_parallel_Test) {
+  std::vector<std::string> lines = smlGenInfluxLines(40000);
+  std::string              raw;
+  for (int32_t i = 0; i < lines.size(); ++i) {
+    if (i % 1000 == 999) raw += "# comment\n";
+    // a new column in the last line, to be merged into the metas of the first chunk
+    if (i == lines.size() - 1) lines[i].insert(lines[i].rfind(' '), ",extra=\"not in the other lines\"");
+    raw += lines[i];
+    raw += "\n";
+  }
+  int32_t numLines = lines.size();
+
+  int64_t     cost = 0;
+  SSmlHandle *expected = smlParseRawLines(raw, numLines, 1, &cost);
+  printf("smlParseLines 1 thread: %d lines, %.2f MB/s\n", numLines, cost > 0 ? raw.size() / (double)cost : 0);
+
+  for (int32_t threads : {2, 4, 8}) {
+    SSmlHandle *info = smlParseRawLines(raw, numLines, threads, &cost);
+    printf("smlParseLines %d threads: %d lines, %.2f MB/s\n", threads, numLines,
+           cost > 0 ? raw.size() / (double)cost : 0);
+
+    // the same child tables with the same rows in the same order
+    ASSERT_EQ(taosHashGetSize(info->childTables), taosHashGetSize(expected->childTables));
+    SSmlTableInfo **oneTable = (SSmlTableInfo **)taosHashIterate(expected->childTables, NULL);
+    while (oneTable) {
+      size_t          keyLen = 0;
+      void           *key = taosHashGetKey(oneTable, &keyLen);
+      SSmlTableInfo **other = (SSmlTableInfo **)taosHashGet(info->childTables, key, keyLen);
+      ASSERT_NE(other, nullptr);
+      ASSERT_STREQ((*other)->childTableName, (*oneTable)->childTableName);
+      smlCheckSameKvs((*oneTable)->tags, (*other)->tags);
+      ASSERT_EQ(taosArrayGetSize((*other)->cols), taosArrayGetSize((*oneTable)->cols));
+      for (int32_t i = 0; i < taosArrayGetSize((*oneTable)->cols); ++i) {
+        SHashObj *a = (SHashObj *)taosArrayGetP((*oneTable)->cols, i);
+        SHashObj *b = (SHashObj *)taosArrayGetP((*other)->cols, i);
+        SSmlKv  **tsA = (SSmlKv **)taosHashGet(a, tsSmlTsDefaultName, strlen(tsSmlTsDefaultName));
+        SSmlKv  **tsB = (SSmlKv **)taosHashGet(b, tsSmlTsDefaultName, strlen(tsSmlTsDefaultName));
+        ASSERT_EQ((*tsB)->i, (*tsA)->i);
+        ASSERT_EQ(taosHashGetSize(b), taosHashGetSize(a));
+      }
+      oneTable = (SSmlTableInfo **)taosHashIterate(expected->childTables, oneTable);
+    }
+
+    // the same super table metas, the column order included
+    ASSERT_EQ(taosHashGetSize(info->superTables), taosHashGetSize(expected->superTables));
+    SSmlSTableMeta **oneSTable = (SSmlSTableMeta **)taosHashIterate(expected->superTables, NULL);
+    while (oneSTable) {
+      size_t           keyLen = 0;
+      void            *key = taosHashGetKey(oneSTable, &keyLen);
+      SSmlSTableMeta **other = (SSmlSTableMeta **)taosHashGet(info->superTables, key, keyLen);
+      ASSERT_NE(other, nullptr);
+      smlCheckSameKvs((*oneSTable)->cols, (*other)->cols);
+      smlCheckSameKvs((*oneSTable)->tags, (*other)->tags);
+      oneSTable = (SSmlSTableMeta **)taosHashIterate(expected->superTables, oneSTable);
+    }
+    ASSERT_EQ(taosHashGetSize(info->tableUids), taosHashGetSize(expected->tableUids));
+    smlDestroyInfo(info);
+  }
+  smlDestroyInfo(expected);
+
+  // a bad line fails the batch with its own message, whichever chunk it is in
+  raw.replace(raw.rfind("extra="), 6, "extra ");
+  int32_t oldThreads = tsSmlParseThreads;
+  tsSmlParseThreads = 4;
+  SSmlHandle *info = smlBuildSmlInfo(NULL);
+  char        msg[ERROR_MSG_BUF_DEFAULT_SIZE] = {0};
+  info->protocol = TSDB_SML_LINE_PROTOCOL;
+  info->isRawLine = true;
+  info->msgBuf.buf = msg;
+  info->msgBuf.len = sizeof(msg);
+  info->lineNum = numLines;
+  ASSERT_NE(smlParseLines(info, NULL, (char *)raw.data(), (char *)raw.data() + raw.size(), numLines), 0);
+  ASSERT_NE(strlen(msg), 0);
+  smlDestroyInfo(info);
+  tsSmlParseThreads = oldThreads;
+}
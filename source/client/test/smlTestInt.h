@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_SML_TEST_INT_H
+#define TDENGINE_SML_TEST_INT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "os.h"
+
+// the internals of clientSmlLine.c only smlTest calls
+
+// one scan by level, 0 the table, 1 SSE2 and 2 AVX2 if the cpu has it
+const char *smlSkipPlainByLevel(const char *p, const char *end, int8_t level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_SML_TEST_INT_H
@@ -16,6 +16,7 @@
 #define _DEFAULT_SOURCE
 #include "tdatablock.h"
 #include "tcompare.h"
+#include "tcompression.h"
 #include "tlog.h"
 #include "tname.h"
 
@@ -407,6 +408,7 @@ int32_t colDataAssign(SColumnInfoData* pColumnInfoData, const SColumnInfoData* p
   }
 
   pColumnInfoData->hasNull = pSource->hasNull;
+  pColumnInfoData->fromDict = pSource->fromDict;
   pColumnInfoData->info = pSource->info;
   return 0;
 }
@@ -1065,6 +1067,23 @@ int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo) {
   return TSDB_CODE_SUCCESS;
 }
 
+// move the row index[i] of the block to the row i
+int32_t blockDataReorder(SSDataBlock* pDataBlock, const int32_t* index) {
+  if (pDataBlock->info.rows <= 1) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SColumnInfoData* pCols = createHelpColInfoData(pDataBlock);
+  if (pCols == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return terrno;
+  }
+
+  blockDataAssign(pCols, pDataBlock, index);
+  copyBackToBlock(pDataBlock, pCols);
+  return TSDB_CODE_SUCCESS;
+}
+
 void blockDataCleanup(SSDataBlock* pDataBlock) {
   blockDataEmpty(pDataBlock);
   SDataBlockInfo* pInfo = &pDataBlock->info;
@@ -1157,6 +1176,7 @@ static int32_t doEnsureCapacity(SColumnInfoData* pColumn, const SDataBlockInfo*
 
 void colInfoDataCleanup(SColumnInfoData* pColumn, uint32_t numOfRows) {
   pColumn->hasNull = false;
+  pColumn->fromDict = false;
 
   if (IS_VAR_DATA_TYPE(pColumn->info.type)) {
     pColumn->varmeta.length = 0;
@@ -2191,12 +2211,241 @@ int32_t blockEncode(const SSDataBlock* pBlock, char* data, int32_t numOfCols) {
   return dataLen;
 }
 
+// clang-format off
+// A block compressed by blockCompress keeps the header of blockEncode, version aside, and replaces the column data:
+// +--------------+-----------------+---------------------------------------+-------------------------------------------+
+// | header       | original length | codec, meta length, data length       | col1 meta | col1 data | col2 meta | ...  |
+// | of version 1 | sizeof(int32_t) | (int8_t + 2 * int32_t) * numOfCols    | compressed                               |
+// +--------------+-----------------+---------------------------------------+-------------------------------------------+
+// The offsets of var data columns are compressed as integers and the null bitmaps with LZ4. The data of timestamp,
+// integer and floating point columns is compressed with the codec of its type, other types with LZ4.
+// clang-format on
+#define BLOCK_COMPRESS_VERSION 2
+#define BLOCK_COL_HEAD_SIZE    (sizeof(int8_t) + sizeof(int32_t) * 2)
+
+#define BLOCK_COL_CODEC_LZ4  0
+#define BLOCK_COL_CODEC_TYPE 1
+
+typedef int32_t (*FBlockColCodec)(void* pIn, int32_t nIn, int32_t nEle, void* pOut, int32_t nOut, uint8_t cmprAlg,
+                                  void* pBuf, int32_t nBuf);
+
+typedef struct SBlockColCodec {
+  FBlockColCodec comp;
+  FBlockColCodec decomp;
+} SBlockColCodec;
+
+static SBlockColCodec blockGetColCodec(int8_t codec, int8_t type) {
+  if (codec == BLOCK_COL_CODEC_TYPE) {
+    switch (type) {
+      case TSDB_DATA_TYPE_TIMESTAMP:
+        return (SBlockColCodec){tsCompressTimestamp, tsDecompressTimestamp};
+      case TSDB_DATA_TYPE_BIGINT:
+      case TSDB_DATA_TYPE_UBIGINT:
+        return (SBlockColCodec){tsCompressBigint, tsDecompressBigint};
+      case TSDB_DATA_TYPE_INT:
+      case TSDB_DATA_TYPE_UINT:
+        return (SBlockColCodec){tsCompressInt, tsDecompressInt};
+      case TSDB_DATA_TYPE_SMALLINT:
+      case TSDB_DATA_TYPE_USMALLINT:
+        return (SBlockColCodec){tsCompressSmallint, tsDecompressSmallint};
+      case TSDB_DATA_TYPE_TINYINT:
+      case TSDB_DATA_TYPE_UTINYINT:
+        return (SBlockColCodec){tsCompressTinyint, tsDecompressTinyint};
+      case TSDB_DATA_TYPE_FLOAT:
+        return (SBlockColCodec){tsCompressFloat, tsDecompressFloat};
+      case TSDB_DATA_TYPE_DOUBLE:
+        return (SBlockColCodec){tsCompressDouble, tsDecompressDouble};
+      default:
+        return (SBlockColCodec){NULL, NULL};
+    }
+  }
+
+  return (SBlockColCodec){tsCompressString, tsDecompressString};
+}
+
+static int8_t blockChooseColCodec(int8_t type) {
+#ifdef TD_TSZ
+  // the lossy float codecs must not touch query results
+  if ((type == TSDB_DATA_TYPE_FLOAT && lossyFloat) || (type == TSDB_DATA_TYPE_DOUBLE && lossyDouble)) {
+    return BLOCK_COL_CODEC_LZ4;
+  }
+#endif
+  return (blockGetColCodec(BLOCK_COL_CODEC_TYPE, type).comp != NULL) ? BLOCK_COL_CODEC_TYPE : BLOCK_COL_CODEC_LZ4;
+}
+
+static int32_t blockCompressSeg(FBlockColCodec fp, const char* pIn, int32_t nIn, int32_t bytes, char* pOut) {
+  if (nIn == 0) {
+    return 0;
+  }
+  return fp((void*)pIn, nIn, nIn / bytes, pOut, nIn + COMP_OVERFLOW_BYTES, ONE_STAGE_COMP, NULL, 0);
+}
+
+static int32_t blockDecompressSeg(FBlockColCodec fp, const char* pIn, int32_t nIn, int32_t bytes, char* pOut,
+                                  int32_t nOut) {
+  if (nOut == 0) {
+    return (nIn == 0) ? 0 : -1;
+  }
+  if (nIn <= 0 || fp((void*)pIn, nIn, nOut / bytes, pOut, nOut, ONE_STAGE_COMP, NULL, 0) != nOut) {
+    return -1;
+  }
+  return 0;
+}
+
+static FORCE_INLINE int32_t blockColMetaSize(int8_t type, int32_t numOfRows) {
+  return IS_VAR_DATA_TYPE(type) ? numOfRows * sizeof(int32_t) : BitmapLen(numOfRows);
+}
+
+// decompress the meta and the data of a column to pMeta and pData, *ppIn is advanced past the column
+static int32_t blockDecompressCol(int8_t type, int32_t numOfRows, int32_t len, const char* pHead, const char** ppIn,
+                                  char* pMeta, char* pData) {
+  int8_t  codec = *(int8_t*)pHead;
+  int32_t metaLen = *(int32_t*)(pHead + sizeof(int8_t));
+  int32_t dataLen = *(int32_t*)(pHead + sizeof(int8_t) + sizeof(int32_t));
+
+  SBlockColCodec metaCodec = blockGetColCodec(IS_VAR_DATA_TYPE(type) ? BLOCK_COL_CODEC_TYPE : BLOCK_COL_CODEC_LZ4,
+                                              IS_VAR_DATA_TYPE(type) ? TSDB_DATA_TYPE_INT : TSDB_DATA_TYPE_BINARY);
+  SBlockColCodec dataCodec = blockGetColCodec(codec, type);
+  int32_t        bytes = (codec == BLOCK_COL_CODEC_TYPE) ? tDataTypes[type].bytes : 1;
+  if (dataCodec.decomp == NULL) {
+    uError("invalid codec %d of column type %d in compressed block", codec, type);
+    return -1;
+  }
+
+  const char* pIn = *ppIn;
+  if (blockDecompressSeg(metaCodec.decomp, pIn, metaLen, IS_VAR_DATA_TYPE(type) ? sizeof(int32_t) : 1, pMeta,
+                         blockColMetaSize(type, numOfRows)) != 0) {
+    uError("failed to decompress the meta of column type %d, rows:%d", type, numOfRows);
+    return -1;
+  }
+  pIn += metaLen;
+
+  if (blockDecompressSeg(dataCodec.decomp, pIn, dataLen, bytes, pData, len) != 0) {
+    uError("failed to decompress the data of column type %d, rows:%d, length:%d", type, numOfRows, len);
+    return -1;
+  }
+  pIn += dataLen;
+
+  *ppIn = pIn;
+  return 0;
+}
+
+int32_t blockGetCompressBound(const char* pData) {
+  int32_t dataLen = *(int32_t*)(pData + sizeof(int32_t));
+  int32_t numOfCols = *(int32_t*)(pData + sizeof(int32_t) * 3);
+  return dataLen + sizeof(int32_t) + numOfCols * (BLOCK_COL_HEAD_SIZE + COMP_OVERFLOW_BYTES * 2);
+}
+
+int32_t blockCompress(const char* pData, char* pOut) {
+  ASSERT(*(int32_t*)pData == 1);
+
+  int32_t dataLen = *(int32_t*)(pData + sizeof(int32_t));
+  int32_t numOfRows = *(int32_t*)(pData + sizeof(int32_t) * 2);
+  int32_t numOfCols = *(int32_t*)(pData + sizeof(int32_t) * 3);
+  int32_t metaSize = blockDataGetSerialMetaSize(numOfCols);
+
+  const char*    pSchema = pData + sizeof(int32_t) * 5 + sizeof(uint64_t);
+  const int32_t* colLen = (const int32_t*)(pData + metaSize - numOfCols * sizeof(int32_t));
+
+  memcpy(pOut, pData, metaSize);
+  *(int32_t*)pOut = BLOCK_COMPRESS_VERSION;
+
+  char* p = pOut + metaSize;
+  *(int32_t*)p = dataLen;
+  p += sizeof(int32_t);
+
+  char* pHead = p;
+  p += numOfCols * BLOCK_COL_HEAD_SIZE;
+
+  const char* pIn = pData + metaSize;
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    int8_t  type = *(int8_t*)(pSchema + i * (sizeof(int8_t) + sizeof(int32_t)));
+    int32_t len = htonl(colLen[i]);
+    int32_t nMeta = blockColMetaSize(type, numOfRows);
+    int8_t  codec = blockChooseColCodec(type);
+
+    SBlockColCodec metaCodec = blockGetColCodec(IS_VAR_DATA_TYPE(type) ? BLOCK_COL_CODEC_TYPE : BLOCK_COL_CODEC_LZ4,
+                                                IS_VAR_DATA_TYPE(type) ? TSDB_DATA_TYPE_INT : TSDB_DATA_TYPE_BINARY);
+    int32_t metaLen = blockCompressSeg(metaCodec.comp, pIn, nMeta, IS_VAR_DATA_TYPE(type) ? sizeof(int32_t) : 1, p);
+    if (metaLen < 0) {
+      return -1;
+    }
+    pIn += nMeta;
+    p += metaLen;
+
+    int32_t bytes = (codec == BLOCK_COL_CODEC_TYPE) ? tDataTypes[type].bytes : 1;
+    int32_t compLen = blockCompressSeg(blockGetColCodec(codec, type).comp, pIn, len, bytes, p);
+    if (compLen < 0) {
+      return -1;
+    }
+    pIn += len;
+    p += compLen;
+
+    *(int8_t*)pHead = codec;
+    *(int32_t*)(pHead + sizeof(int8_t)) = metaLen;
+    *(int32_t*)(pHead + sizeof(int8_t) + sizeof(int32_t)) = compLen;
+    pHead += BLOCK_COL_HEAD_SIZE;
+  }
+
+  int32_t compLen = (int32_t)(p - pOut);
+  *(int32_t*)(pOut + sizeof(int32_t)) = compLen;
+  return compLen;
+}
+
+int32_t blockGetDecompressSize(const char* pData) {
+  if (*(int32_t*)pData != BLOCK_COMPRESS_VERSION) {
+    return *(int32_t*)(pData + sizeof(int32_t));
+  }
+
+  int32_t numOfCols = *(int32_t*)(pData + sizeof(int32_t) * 3);
+  return *(int32_t*)(pData + blockDataGetSerialMetaSize(numOfCols));
+}
+
+int32_t blockDecompress(const char* pData, char* pOut) {
+  if (*(int32_t*)pData != BLOCK_COMPRESS_VERSION) {
+    int32_t dataLen = *(int32_t*)(pData + sizeof(int32_t));
+    memcpy(pOut, pData, dataLen);
+    return dataLen;
+  }
+
+  int32_t numOfRows = *(int32_t*)(pData + sizeof(int32_t) * 2);
+  int32_t numOfCols = *(int32_t*)(pData + sizeof(int32_t) * 3);
+  int32_t metaSize = blockDataGetSerialMetaSize(numOfCols);
+  int32_t dataLen = *(int32_t*)(pData + metaSize);
+
+  const char*    pSchema = pData + sizeof(int32_t) * 5 + sizeof(uint64_t);
+  const int32_t* colLen = (const int32_t*)(pData + metaSize - numOfCols * sizeof(int32_t));
+  const char*    pHead = pData + metaSize + sizeof(int32_t);
+  const char*    pIn = pHead + numOfCols * BLOCK_COL_HEAD_SIZE;
+
+  memcpy(pOut, pData, metaSize);
+  *(int32_t*)pOut = 1;
+  *(int32_t*)(pOut + sizeof(int32_t)) = dataLen;
+
+  char* p = pOut + metaSize;
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    int8_t  type = *(int8_t*)(pSchema + i * (sizeof(int8_t) + sizeof(int32_t)));
+    int32_t len = htonl(colLen[i]);
+    int32_t nMeta = blockColMetaSize(type, numOfRows);
+    if (p + nMeta + len > pOut + dataLen) {
+      uError("invalid column length %d of compressed block, rows:%d", len, numOfRows);
+      return -1;
+    }
+
+    if (blockDecompressCol(type, numOfRows, len, pHead + i * BLOCK_COL_HEAD_SIZE, &pIn, p, p + nMeta) != 0) {
+      return -1;
+    }
+    p += nMeta + len;
+  }
+
+  return (p - pOut == dataLen) ? dataLen : -1;
+}
+
 const char* blockDecode(SSDataBlock* pBlock, const char* pData) {
   const char* pStart = pData;
 
   int32_t version = *(int32_t*)pStart;
   pStart += sizeof(int32_t);
-  ASSERT(version == 1);
+  ASSERT(version == 1 || version == BLOCK_COMPRESS_VERSION);
 
   // total length sizeof(int32_t)
   int32_t dataLen = *(int32_t*)pStart;
@@ -2241,14 +2490,23 @@ const char* blockDecode(SSDataBlock* pBlock, const char* pData) {
   int32_t* colLen = (int32_t*)pStart;
   pStart += sizeof(int32_t) * numOfCols;
 
+  // the column data of a compressed block follows the original length and the column heads
+  const char* pColHead = NULL;
+  if (version == BLOCK_COMPRESS_VERSION) {
+    pColHead = pStart + sizeof(int32_t);
+    pStart = pColHead + numOfCols * BLOCK_COL_HEAD_SIZE;
+  }
+
   for (int32_t i = 0; i < numOfCols; ++i) {
     colLen[i] = htonl(colLen[i]);
     ASSERT(colLen[i] >= 0);
 
     SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, i);
     if (IS_VAR_DATA_TYPE(pColInfoData->info.type)) {
-      memcpy(pColInfoData->varmeta.offset, pStart, sizeof(int32_t) * numOfRows);
-      pStart += sizeof(int32_t) * numOfRows;
+      if (pColHead == NULL) {
+        memcpy(pColInfoData->varmeta.offset, pStart, sizeof(int32_t) * numOfRows);
+        pStart += sizeof(int32_t) * numOfRows;
+      }
 
       if (colLen[i] > 0 && pColInfoData->varmeta.allocLen < colLen[i]) {
         char* tmp = taosMemoryRealloc(pColInfoData->pData, colLen[i]);
@@ -2261,20 +2519,29 @@ const char* blockDecode(SSDataBlock* pBlock, const char* pData) {
       }
 
       pColInfoData->varmeta.length = colLen[i];
-    } else {
+    } else if (pColHead == NULL) {
       memcpy(pColInfoData->nullbitmap, pStart, BitmapLen(numOfRows));
       pStart += BitmapLen(numOfRows);
     }
 
-    if (colLen[i] > 0) {
-      memcpy(pColInfoData->pData, pStart, colLen[i]);
+    if (pColHead != NULL) {
+      char* pMeta = IS_VAR_DATA_TYPE(pColInfoData->info.type) ? (char*)pColInfoData->varmeta.offset
+                                                               : pColInfoData->nullbitmap;
+      if (blockDecompressCol(pColInfoData->info.type, numOfRows, colLen[i], pColHead + i * BLOCK_COL_HEAD_SIZE,
+                             &pStart, pMeta, pColInfoData->pData) != 0) {
+        return NULL;
+      }
+    } else {
+      if (colLen[i] > 0) {
+        memcpy(pColInfoData->pData, pStart, colLen[i]);
+      }
+      pStart += colLen[i];
     }
 
     // TODO
     // setting this flag to true temporarily so aggregate function on stable will
     // examine NULL value for non-primary key column
     pColInfoData->hasNull = true;
-    pStart += colLen[i];
   }
 
   pBlock->info.dataLoad = 1;
@@ -1577,6 +1577,7 @@ void tColDataClear(SColData *pColData) {
   pColData->nVal = 0;
   pColData->flag = 0;
   pColData->nData = 0;
+  pColData->nDict = 0;
 }
 
 void tColDataDeepClear(SColData *pColData) {
@@ -1952,6 +1953,7 @@ static int32_t (*tColDataAppendValueImpl[8][3])(SColData *pColData, uint8_t *pDa
 };
 int32_t tColDataAppendValue(SColData *pColData, SColVal *pColVal) {
   ASSERT(pColData->cid == pColVal->cid && pColData->type == pColVal->type);
+  pColData->nDict = 0;
   return tColDataAppendValueImpl[pColData->flag][pColVal->flag](
       pColData, IS_VAR_DATA_TYPE(pColData->type) ? pColVal->value.pData : (uint8_t *)&pColVal->value.val,
       pColVal->value.nData);
@@ -2265,6 +2267,7 @@ int32_t tColDataUpdateValue(SColData *pColData, SColVal *pColVal, bool forward)
   ASSERT(pColData->nVal > 0);
 
   if (tColDataUpdateValueImpl[pColData->flag][pColVal->flag] == NULL) return 0;
+  pColData->nDict = 0;
 
   return tColDataUpdateValueImpl[pColData->flag][pColVal->flag](
       pColData, IS_VAR_DATA_TYPE(pColData->type) ? pColVal->value.pData : (uint8_t *)&pColVal->value.val,
@@ -2387,6 +2390,7 @@ int32_t tColDataCopy(SColData *pColDataFrom, SColData *pColData, xMallocFn xMall
   int32_t code = 0;
 
   *pColData = *pColDataFrom;
+  pColData->nDict = 0;  // the dictionary codes are not copied
 
   // bitmap
   switch (pColData->flag) {
@@ -3134,6 +3138,7 @@ int32_t tGetColData(uint8_t *pBuf, SColData *pColData) {
   n += tGetI8(pBuf + n, &pColData->type);
   n += tGetI32v(pBuf + n, &pColData->nVal);
   n += tGetI8(pBuf + n, &pColData->flag);
+  pColData->nDict = 0;
 
   // bitmap
   switch (pColData->flag) {
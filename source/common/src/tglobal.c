@@ -52,6 +52,7 @@ int32_t tsTimeToGetAvailableConn = 500000;
 int32_t tsKeepAliveIdle = 60;
 
 int32_t tsNumOfCommitThreads = 2;
+int32_t tsNumOfVnodeInsertThreads = 1;  // 1 means the submitted tables are inserted by the vnode write thread only
 int32_t tsNumOfTaskQueueThreads = 4;
 int32_t tsNumOfMnodeQueryThreads = 4;
 int32_t tsNumOfMnodeFetchThreads = 1;
@@ -66,6 +67,9 @@ int32_t tsNumOfSnodeStreamThreads = 4;
 int32_t tsNumOfSnodeWriteThreads = 1;
 int32_t tsMaxStreamBackendCache = 128;  // M
 int32_t tsPQSortMemThreshold = 16;      // M
+int32_t tsGroupHashMemThreshold = 0;    // M, 0 means the group by hash never spills
+int32_t tsHashJoinMemThreshold = 64;    // M
+int32_t tsNumOfSortThreads = 1;        // 1 means the external sort runs on the query thread only
 
 // sync raft
 int32_t tsElectInterval = 25 * 1000;
@@ -112,6 +116,7 @@ char tsSmlTsDefaultName[TSDB_COL_NAME_LEN] = "_ts";
 char tsSmlTagName[TSDB_COL_NAME_LEN] = "_tag_null";
 char tsSmlChildTableName[TSDB_TABLE_NAME_LEN] = "";  // user defined child table name can be specified in tag value.
                                                      // If set to empty system will generate table name using MD5 hash.
+int32_t tsSmlParseThreads = 1;  // threads parsing one large batch of line or telnet protocol, 1 means the caller only
 // true means that the name and order of cols in each line are the same(only for influx protocol)
 // bool    tsSmlDataFormat = false;
 // int32_t tsSmlBatchSize = 10000;
@@ -130,6 +135,7 @@ int32_t tsQueryRsmaTolerance = 1000;  // the tolerance time (ms) to judge from w
 bool    tsQueryPlannerTrace = false;
 int32_t tsQueryNodeChunkSize = 32 * 1024;
 bool    tsQueryUseNodeAllocator = true;
+bool    tsQueryUseHashJoin = false;
 bool    tsKeepColumnName = false;
 int32_t tsRedirectPeriod = 10;
 int32_t tsRedirectFactor = 2;
@@ -183,6 +189,14 @@ char    tsTagFilterCache = 0;
 int32_t tsQueryBufferSize = -1;
 int64_t tsQueryBufferSizeBytes = -1;
 int32_t tsCacheLazyLoadThreshold = 500;
+bool    tsTagColumnStore = false;
+int32_t tsTagColumnStoreSize = 64;
+int32_t tsBgWriteRateLimit = 0;
+int32_t tsCommitFileSetThreads = 2;
+int32_t tsCommitMemBudget = 256;
+bool    tsAdaptiveCompress = false;
+bool    tsHllSparsePartial = false;
+int32_t tsTsdbBlockCacheSize = 0;
 
 int32_t  tsDiskCfgNum = 0;
 SDiskCfg tsDiskCfg[TFS_MAX_DISKS] = {0};
@@ -368,11 +382,13 @@ static int32_t taosAddClientCfg(SConfig *pCfg) {
   if (cfgAddBool(pCfg, "queryPlannerTrace", tsQueryPlannerTrace, CFG_SCOPE_CLIENT) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryNodeChunkSize", tsQueryNodeChunkSize, 1024, 128 * 1024, CFG_SCOPE_CLIENT) != 0) return -1;
   if (cfgAddBool(pCfg, "queryUseNodeAllocator", tsQueryUseNodeAllocator, CFG_SCOPE_CLIENT) != 0) return -1;
+  if (cfgAddBool(pCfg, "queryUseHashJoin", tsQueryUseHashJoin, CFG_SCOPE_CLIENT) != 0) return -1;
   if (cfgAddBool(pCfg, "keepColumnName", tsKeepColumnName, CFG_SCOPE_CLIENT) != 0) return -1;
   if (cfgAddString(pCfg, "smlChildTableName", "", CFG_SCOPE_CLIENT) != 0) return -1;
   if (cfgAddString(pCfg, "smlTagName", tsSmlTagName, CFG_SCOPE_CLIENT) != 0) return -1;
   if (cfgAddString(pCfg, "smlTsDefaultName", tsSmlTsDefaultName, CFG_SCOPE_CLIENT) != 0) return -1;
   if (cfgAddBool(pCfg, "smlDot2Underline", tsSmlDot2Underline, CFG_SCOPE_CLIENT) != 0) return -1;
+  if (cfgAddInt32(pCfg, "smlParseThreads", tsSmlParseThreads, 1, 256, CFG_SCOPE_CLIENT) != 0) return -1;
   //  if (cfgAddBool(pCfg, "smlDataFormat", tsSmlDataFormat, CFG_SCOPE_CLIENT) != 0) return -1;
   //  if (cfgAddInt32(pCfg, "smlBatchSize", tsSmlBatchSize, 1, INT32_MAX, CFG_SCOPE_CLIENT) != 0) return -1;
   if (cfgAddInt32(pCfg, "maxInsertBatchRows", tsMaxInsertBatchRows, 1, INT32_MAX, CFG_SCOPE_CLIENT) != 0) return -1;
@@ -423,6 +439,7 @@ static int32_t taosAddSystemCfg(SConfig *pCfg) {
   if (cfgAddBool(pCfg, "SSE42", tsSSE42Enable, CFG_SCOPE_BOTH) != 0) return -1;
   if (cfgAddBool(pCfg, "AVX", tsAVXEnable, CFG_SCOPE_BOTH) != 0) return -1;
   if (cfgAddBool(pCfg, "AVX2", tsAVX2Enable, CFG_SCOPE_BOTH) != 0) return -1;
+  if (cfgAddBool(pCfg, "AVX512", tsAVX512Enable, CFG_SCOPE_BOTH) != 0) return -1;
   if (cfgAddBool(pCfg, "FMA", tsFMAEnable, CFG_SCOPE_BOTH) != 0) return -1;
   if (cfgAddBool(pCfg, "SIMD-builtins", tsSIMDBuiltins, CFG_SCOPE_BOTH) != 0) return -1;
   if (cfgAddBool(pCfg, "tagFilterCache", tsTagFilterCache, CFG_SCOPE_BOTH) != 0) return -1;
@@ -482,6 +499,8 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   tsNumOfCommitThreads = tsNumOfCores / 2;
   tsNumOfCommitThreads = TRANGE(tsNumOfCommitThreads, 2, 4);
   if (cfgAddInt32(pCfg, "numOfCommitThreads", tsNumOfCommitThreads, 1, 1024, CFG_SCOPE_SERVER) != 0) return -1;
+  if (cfgAddInt32(pCfg, "numOfVnodeInsertThreads", tsNumOfVnodeInsertThreads, 1, 1024, CFG_SCOPE_SERVER) != 0)
+    return -1;
 
   tsNumOfMnodeReadThreads = tsNumOfCores / 8;
   tsNumOfMnodeReadThreads = TRANGE(tsNumOfMnodeReadThreads, 1, 4);
@@ -576,11 +595,22 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
 
   if (cfgAddInt32(pCfg, "cacheLazyLoadThreshold", tsCacheLazyLoadThreshold, 0, 100000, CFG_SCOPE_SERVER) != 0)
     return -1;
+  if (cfgAddInt32(pCfg, "tsdbBlockCacheSize", tsTsdbBlockCacheSize, 0, 65536, CFG_SCOPE_SERVER) != 0) return -1;
+  if (cfgAddBool(pCfg, "tagColumnStore", tsTagColumnStore, CFG_SCOPE_SERVER) != 0) return -1;
+  if (cfgAddInt32(pCfg, "tagColumnStoreSize", tsTagColumnStoreSize, 1, 65536, CFG_SCOPE_SERVER) != 0) return -1;
+  if (cfgAddInt32(pCfg, "bgWriteRateLimit", tsBgWriteRateLimit, 0, 1048576, CFG_SCOPE_SERVER) != 0) return -1;
+  if (cfgAddInt32(pCfg, "commitFileSetThreads", tsCommitFileSetThreads, 1, 64, CFG_SCOPE_SERVER) != 0) return -1;
+  if (cfgAddInt32(pCfg, "commitMemBudget", tsCommitMemBudget, 1, 65536, CFG_SCOPE_SERVER) != 0) return -1;
+  if (cfgAddBool(pCfg, "adaptiveCompress", tsAdaptiveCompress, CFG_SCOPE_SERVER) != 0) return -1;
+  if (cfgAddBool(pCfg, "hllSparsePartial", tsHllSparsePartial, CFG_SCOPE_SERVER) != 0) return -1;
 
   if (cfgAddBool(pCfg, "filterScalarMode", tsFilterScalarMode, CFG_SCOPE_SERVER) != 0) return -1;
   if (cfgAddInt32(pCfg, "keepTimeOffset", tsKeepTimeOffset, 0, 23, CFG_SCOPE_SERVER) != 0) return -1;
   if (cfgAddInt32(pCfg, "maxStreamBackendCache", tsMaxStreamBackendCache, 16, 1024, CFG_SCOPE_SERVER) != 0) return -1;
   if (cfgAddInt32(pCfg, "pqSortMemThreshold", tsPQSortMemThreshold, 1, 10240, CFG_SCOPE_SERVER) != 0) return -1;
+  if (cfgAddInt32(pCfg, "groupHashMemThreshold", tsGroupHashMemThreshold, 0, 10240, CFG_SCOPE_SERVER) != 0) return -1;
+  if (cfgAddInt32(pCfg, "hashJoinMemThreshold", tsHashJoinMemThreshold, 1, 10240, CFG_SCOPE_SERVER) != 0) return -1;
+  if (cfgAddInt32(pCfg, "numOfSortThreads", tsNumOfSortThreads, 1, 64, CFG_SCOPE_SERVER) != 0) return -1;
   if (cfgAddInt32(pCfg, "resolveFQDNRetryTime", tsResolveFQDNRetryTime, 1, 10240, 0) != 0) return -1;
 
   GRANT_CFG_ADD;
@@ -837,6 +867,7 @@ static int32_t taosSetClientCfg(SConfig *pCfg) {
   tstrncpy(tsSmlTagName, cfgGetItem(pCfg, "smlTagName")->str, TSDB_COL_NAME_LEN);
   tstrncpy(tsSmlTsDefaultName, cfgGetItem(pCfg, "smlTsDefaultName")->str, TSDB_COL_NAME_LEN);
   tsSmlDot2Underline = cfgGetItem(pCfg, "smlDot2Underline")->bval;
+  tsSmlParseThreads = cfgGetItem(pCfg, "smlParseThreads")->i32;
   //  tsSmlDataFormat = cfgGetItem(pCfg, "smlDataFormat")->bval;
 
   //  tsSmlBatchSize = cfgGetItem(pCfg, "smlBatchSize")->i32;
@@ -853,6 +884,7 @@ static int32_t taosSetClientCfg(SConfig *pCfg) {
   tsQueryPlannerTrace = cfgGetItem(pCfg, "queryPlannerTrace")->bval;
   tsQueryNodeChunkSize = cfgGetItem(pCfg, "queryNodeChunkSize")->i32;
   tsQueryUseNodeAllocator = cfgGetItem(pCfg, "queryUseNodeAllocator")->bval;
+  tsQueryUseHashJoin = cfgGetItem(pCfg, "queryUseHashJoin")->bval;
   tsKeepColumnName = cfgGetItem(pCfg, "keepColumnName")->bval;
   tsUseAdapter = cfgGetItem(pCfg, "useAdapter")->bval;
   tsEnableCrashReport = cfgGetItem(pCfg, "crashReporting")->bval;
@@ -913,6 +945,7 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsKeepAliveIdle = cfgGetItem(pCfg, "keepAliveIdle")->i32;
 
   tsNumOfCommitThreads = cfgGetItem(pCfg, "numOfCommitThreads")->i32;
+  tsNumOfVnodeInsertThreads = cfgGetItem(pCfg, "numOfVnodeInsertThreads")->i32;
   tsNumOfMnodeReadThreads = cfgGetItem(pCfg, "numOfMnodeReadThreads")->i32;
   tsNumOfVnodeQueryThreads = cfgGetItem(pCfg, "numOfVnodeQueryThreads")->i32;
   tsRatioOfVnodeStreamThreads = cfgGetItem(pCfg, "ratioOfVnodeStreamThreads")->fval;
@@ -972,6 +1005,14 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   }
 
   tsCacheLazyLoadThreshold = cfgGetItem(pCfg, "cacheLazyLoadThreshold")->i32;
+  tsTsdbBlockCacheSize = cfgGetItem(pCfg, "tsdbBlockCacheSize")->i32;
+  tsTagColumnStore = cfgGetItem(pCfg, "tagColumnStore")->bval;
+  tsTagColumnStoreSize = cfgGetItem(pCfg, "tagColumnStoreSize")->i32;
+  tsBgWriteRateLimit = cfgGetItem(pCfg, "bgWriteRateLimit")->i32;
+  tsCommitFileSetThreads = cfgGetItem(pCfg, "commitFileSetThreads")->i32;
+  tsCommitMemBudget = cfgGetItem(pCfg, "commitMemBudget")->i32;
+  tsAdaptiveCompress = cfgGetItem(pCfg, "adaptiveCompress")->bval;
+  tsHllSparsePartial = cfgGetItem(pCfg, "hllSparsePartial")->bval;
 
   tsDisableStream = cfgGetItem(pCfg, "disableStream")->bval;
   tsStreamBufferSize = cfgGetItem(pCfg, "streamBufferSize")->i64;
@@ -981,6 +1022,9 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsKeepTimeOffset = cfgGetItem(pCfg, "keepTimeOffset")->i32;
   tsMaxStreamBackendCache = cfgGetItem(pCfg, "maxStreamBackendCache")->i32;
   tsPQSortMemThreshold = cfgGetItem(pCfg, "pqSortMemThreshold")->i32;
+  tsGroupHashMemThreshold = cfgGetItem(pCfg, "groupHashMemThreshold")->i32;
+  tsHashJoinMemThreshold = cfgGetItem(pCfg, "hashJoinMemThreshold")->i32;
+  tsNumOfSortThreads = cfgGetItem(pCfg, "numOfSortThreads")->i32;
   tsResolveFQDNRetryTime = cfgGetItem(pCfg, "resolveFQDNRetryTime")->i32;
 
   GRANT_CFG_GET;
@@ -1252,6 +1296,8 @@ int32_t taosApplyLocalCfg(SConfig *pCfg, char *name) {
         qDebugFlag = cfgGetItem(pCfg, "qDebugFlag")->i32;
       } else if (strcasecmp("queryPlannerTrace", name) == 0) {
         tsQueryPlannerTrace = cfgGetItem(pCfg, "queryPlannerTrace")->bval;
+      } else if (strcasecmp("queryUseHashJoin", name) == 0) {
+        tsQueryUseHashJoin = cfgGetItem(pCfg, "queryUseHashJoin")->bval;
       } else if (strcasecmp("queryNodeChunkSize", name) == 0) {
         tsQueryNodeChunkSize = cfgGetItem(pCfg, "queryNodeChunkSize")->i32;
       } else if (strcasecmp("queryUseNodeAllocator", name) == 0) {
@@ -1288,6 +1334,8 @@ int32_t taosApplyLocalCfg(SConfig *pCfg, char *name) {
         tstrncpy(tsSmlTsDefaultName, cfgGetItem(pCfg, "smlTsDefaultName")->str, TSDB_COL_NAME_LEN);
       } else if (strcasecmp("smlDot2Underline", name) == 0) {
         tsSmlDot2Underline = cfgGetItem(pCfg, "smlDot2Underline")->bval;
+      } else if (strcasecmp("smlParseThreads", name) == 0) {
+        tsSmlParseThreads = cfgGetItem(pCfg, "smlParseThreads")->i32;
       } else if (strcasecmp("shellActivityTimer", name) == 0) {
         tsShellActivityTimer = cfgGetItem(pCfg, "shellActivityTimer")->i32;
       } else if (strcasecmp("supportVnodes", name) == 0) {
@@ -260,4 +260,85 @@ TEST(testCase, var_dataBlock_split_test) {
   }
 }
 
+TEST(testCase, compressed_block_test) {
+  int32_t numOfRows = 4096;
+
+  SSDataBlock* b = createDataBlock();
+
+  SColumnInfoData infoData = createColumnInfoData(TSDB_DATA_TYPE_TIMESTAMP, 8, 1);
+  blockDataAppendColInfo(b, &infoData);
+  SColumnInfoData infoData1 = createColumnInfoData(TSDB_DATA_TYPE_INT, 4, 2);
+  blockDataAppendColInfo(b, &infoData1);
+  SColumnInfoData infoData2 = createColumnInfoData(TSDB_DATA_TYPE_DOUBLE, 8, 3);
+  blockDataAppendColInfo(b, &infoData2);
+  SColumnInfoData infoData3 = createColumnInfoData(TSDB_DATA_TYPE_BOOL, 1, 4);
+  blockDataAppendColInfo(b, &infoData3);
+  SColumnInfoData infoData4 = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 40, 5);
+  blockDataAppendColInfo(b, &infoData4);
+  SColumnInfoData infoData5 = createColumnInfoData(TSDB_DATA_TYPE_NCHAR, 40, 6);
+  blockDataAppendColInfo(b, &infoData5);
+
+  blockDataEnsureCapacity(b, numOfRows);
+
+  char buf[41] = {0};
+  char buf1[100] = {0};
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int64_t ts = 1700000000000 + i * 1000;
+    int32_t v = i % 100;
+    double  d = i / 10.0;
+    bool    f = (i % 3 == 0);
+    colDataSetVal((SColumnInfoData*)taosArrayGet(b->pDataBlock, 0), i, (const char*)&ts, false);
+    colDataSetVal((SColumnInfoData*)taosArrayGet(b->pDataBlock, 1), i, (const char*)&v, (i % 7 == 0));
+    colDataSetVal((SColumnInfoData*)taosArrayGet(b->pDataBlock, 2), i, (const char*)&d, false);
+    colDataSetVal((SColumnInfoData*)taosArrayGet(b->pDataBlock, 3), i, (const char*)&f, false);
+
+    sprintf(buf, "device-%d", i % 10);
+    STR_TO_VARSTR(buf1, buf)
+    colDataSetVal((SColumnInfoData*)taosArrayGet(b->pDataBlock, 4), i, buf1, (i % 5 == 0));
+    colDataSetNULL((SColumnInfoData*)taosArrayGet(b->pDataBlock, 5), i);
+    b->info.rows++;
+  }
+
+  int32_t numOfCols = taosArrayGetSize(b->pDataBlock);
+  char*   pEncoded = (char*)taosMemoryMalloc(blockGetEncodeSize(b));
+  int32_t len = blockEncode(b, pEncoded, numOfCols);
+
+  char*   pComp = (char*)taosMemoryMalloc(blockGetCompressBound(pEncoded));
+  int32_t compLen = blockCompress(pEncoded, pComp);
+  ASSERT_GT(compLen, 0);
+  ASSERT_LT(compLen, len / 2);
+
+  // the block of blockEncode is restored byte by byte
+  ASSERT_EQ(blockGetDecompressSize(pComp), len);
+  char* pDecomp = (char*)taosMemoryMalloc(len);
+  ASSERT_EQ(blockDecompress(pComp, pDecomp), len);
+  ASSERT_EQ(memcmp(pDecomp, pEncoded, len), 0);
+
+  // and blockDecode reads the compressed block as well
+  SSDataBlock* pDecoded = createOneDataBlock(b, false);
+  ASSERT_EQ(blockDecode(pDecoded, pComp), pComp + compLen);
+  ASSERT_EQ(pDecoded->info.rows, numOfRows);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    for (int32_t j = 0; j < numOfCols; ++j) {
+      SColumnInfoData* pSrc = (SColumnInfoData*)taosArrayGet(b->pDataBlock, j);
+      SColumnInfoData* pDst = (SColumnInfoData*)taosArrayGet(pDecoded->pDataBlock, j);
+      ASSERT_EQ(colDataIsNull_s(pDst, i), colDataIsNull_s(pSrc, i));
+      if (colDataIsNull_s(pSrc, i)) {
+        continue;
+      }
+
+      char* p0 = colDataGetData(pSrc, i);
+      char* p1 = colDataGetData(pDst, i);
+      int32_t bytes = IS_VAR_DATA_TYPE(pSrc->info.type) ? varDataTLen(p0) : pSrc->info.bytes;
+      ASSERT_EQ(memcmp(p0, p1, bytes), 0);
+    }
+  }
+
+  blockDataDestroy(pDecoded);
+  blockDataDestroy(b);
+  taosMemoryFree(pEncoded);
+  taosMemoryFree(pComp);
+  taosMemoryFree(pDecomp);
+}
+
 #pragma GCC diagnostic pop
\ No newline at end of file
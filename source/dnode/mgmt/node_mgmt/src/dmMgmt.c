@@ -16,6 +16,7 @@
 #define _DEFAULT_SOURCE
 #include "dmMgmt.h"
 #include "dmNodes.h"
+#include "executor.h"
 #include "index.h"
 #include "qworker.h"
 #include "tstream.h"
@@ -156,6 +157,11 @@ int32_t dmInitDnode(SDnode *pDnode) {
   indexInit(tsNumOfCommitThreads);
   streamMetaInit();
 
+  if (qInitSortWorkers(tsNumOfSortThreads) != 0) {
+    dError("failed to init sort workers since %s", terrstr());
+    goto _OVER;
+  }
+
   dmReportStartup("dnode-transport", "initialized");
   dDebug("dnode is created, ptr:%p", pDnode);
   code = 0;
@@ -179,6 +185,7 @@ void dmCleanupDnode(SDnode *pDnode) {
   rpcCleanup();
   streamMetaCleanup();
   indexCleanup();
+  qCleanupSortWorkers();
   taosConvDestroy();
   dDebug("dnode is closed, ptr:%p", pDnode);
 }
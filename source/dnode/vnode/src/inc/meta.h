@@ -74,6 +74,11 @@ int32_t metaStatsCacheGet(SMeta* pMeta, int64_t uid, SMetaStbStats* pInfo);
 void    metaUpdateStbStats(SMeta* pMeta, int64_t uid, int64_t delta);
 int32_t metaUidFilterCacheGet(SMeta* pMeta, uint64_t suid, const void* pKey, int32_t keyLen, LRUHandle** pHandle);
 
+void metaTagColStoreUpsert(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid, const void* pTags);
+void metaTagColStoreDel(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid);
+void metaTagColStoreDrop(SMeta* pMeta, tb_uid_t suid);
+void metaTagColStoreClear(SMeta* pMeta);
+
 struct SMeta {
   TdThreadRwlock lock;
 
@@ -74,6 +74,7 @@ typedef struct SDiskDataBuilder SDiskDataBuilder;
 typedef struct SBlkInfo         SBlkInfo;
 typedef struct STsdbDataIter2   STsdbDataIter2;
 typedef struct STsdbFilterInfo  STsdbFilterInfo;
+typedef struct SLastStore       SLastStore;
 
 #define TSDBROW_ROW_FMT ((int8_t)0x0)
 #define TSDBROW_COL_FMT ((int8_t)0x1)
@@ -95,6 +96,8 @@ typedef struct STsdbFilterInfo  STsdbFilterInfo;
 #define FILE_TO_LOGIC_OFFSET(OFFSET, PAGE) ((OFFSET) / (PAGE)*PAGE_CONTENT_SIZE(PAGE) + (OFFSET) % (PAGE))
 #define PAGE_OFFSET(PGNO, PAGE)            (((PGNO)-1) * (PAGE))
 #define OFFSET_PGNO(OFFSET, PAGE)          ((OFFSET) / (PAGE) + 1)
+#define TSDB_READ_MAX_PAGES                256
+#define TSDB_DICT_MAX_SIZE                 256  // entries of the dictionary of a binary/nchar column in a block
 
 static FORCE_INLINE int64_t tsdbLogicToFileSize(int64_t lSize, int32_t szPage) {
   int64_t fOffSet = LOGIC_TO_FILE_OFFSET(lSize, szPage);
@@ -380,8 +383,11 @@ struct STsdb {
   TdThreadMutex        lruMutex;
   SLRUCache           *biCache;
   TdThreadMutex        biMutex;
+  SLRUCache           *bCache;  // decompressed column data of data/stt blocks
   struct STFileSystem *pFS;  // new
   SRocksCache          rCache;
+  SHashObj            *pLastStores;  // suid -> SLastStore*, columnar last values of the scanned super tables
+  int64_t              lastStoreSize;
 };
 
 struct TSDBKEY {
@@ -434,6 +440,7 @@ struct SMemTable {
   int32_t          nTbData;
   int32_t          nBucket;
   STbData        **aBucket;
+  SArray          *aRetiredBucket;  // bucket arrays replaced by rehash, kept for lock-free lookups until destroy
   SRBTree          tbDataTree[1];
 };
 
@@ -650,6 +657,7 @@ typedef struct {
   int64_t   pgno;
   uint8_t  *pBuf;
   int64_t   szFile;
+  uint8_t  *pMBuf;  // staging buffer for multi-page reads
 } STsdbFD;
 
 struct SDelFWriter {
@@ -861,6 +869,10 @@ int32_t tsdbCacheRelease(SLRUCache *pCache, LRUHandle *h);
 int32_t tsdbCacheGetBlockIdx(SLRUCache *pCache, SDataFReader *pFileReader, LRUHandle **handle);
 int32_t tsdbBICacheRelease(SLRUCache *pCache, LRUHandle *h);
 
+bool    tsdbBCacheGetColData(STsdb *pTsdb, int32_t ftype, int32_t fid, int64_t fcid, int64_t offset, SColData *pColData);
+int32_t tsdbBCachePutColData(STsdb *pTsdb, int32_t ftype, int32_t fid, int64_t fcid, int64_t offset,
+                             const SColData *pColData);
+
 int32_t tsdbCacheDeleteLastrow(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
 int32_t tsdbCacheDeleteLast(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
 int32_t tsdbCacheDelete(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
@@ -907,9 +919,9 @@ static FORCE_INLINE TSDBROW *tsdbTbDataIterGet(STbDataIter *pIter) {
 
   pIter->pRow = &pIter->row;
   if (pIter->pNode->flag == TSDBROW_ROW_FMT) {
-    pIter->row = tsdbRowFromTSRow(pIter->pNode->version, pIter->pNode->pData);
+    pIter->row = tsdbRowFromTSRow(pIter->pNode->version, (SRow *)pIter->pNode->pData);
   } else if (pIter->pNode->flag == TSDBROW_COL_FMT) {
-    pIter->row = tsdbRowFromBlockData(pIter->pNode->pData, pIter->pNode->iRow);
+    pIter->row = tsdbRowFromBlockData((SBlockData *)pIter->pNode->pData, pIter->pNode->iRow);
   } else {
     ASSERT(0);
   }
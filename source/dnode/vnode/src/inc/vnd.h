@@ -49,8 +49,7 @@ int32_t vnodeEncodeConfig(const void* pObj, SJson* pJson);
 int32_t vnodeDecodeConfig(const SJson* pJson, void* pObj);
 
 // vnodeModule.c
-int vnodeScheduleTask(int (*execute)(void*), void* arg);
-int vnodeScheduleTaskEx(int tpid, int (*execute)(void*), void* arg);
+int vnodeScheduleInsertTask(int32_t vgId, int (*execute)(void*), void* arg);
 
 // vnodeBufPool.c
 typedef struct SVBufPoolNode SVBufPoolNode;
@@ -109,6 +108,10 @@ int32_t vnodeSyncCommit(SVnode* pVnode);
 int32_t vnodeAsyncCommit(SVnode* pVnode);
 bool    vnodeShouldRollback(SVnode* pVnode);
 
+// vnodeSvr.c
+// moves the rows and columns decoded from the submit message pReq onto a copy of it in the buffer pool
+int32_t vnodeCopySubmitReqToBufPool(SVBufPool* pPool, SSubmitReq2* pSubmitReq, const void* pReq, int32_t len);
+
 // vnodeSync.c
 int32_t vnodeSyncOpen(SVnode* pVnode, char* path);
 int32_t vnodeSyncStart(SVnode* pVnode);
@@ -127,6 +127,18 @@ int   vnodeDecodeInfo(uint8_t* pData, SVnodeInfo* pInfo);
 int32_t vnodeBufPoolRegisterQuery(SVBufPool* pPool, SQueryNode* pQNode);
 void    vnodeBufPoolDeregisterQuery(SVBufPool* pPool, SQueryNode* pQNode, bool proactive);
 
+// task classes of the vnode thread pools, a thread serving several classes picks the first one with tasks
+typedef enum {
+  VND_TASK_COMMIT = 0,
+  VND_TASK_MERGE,      // merge and compact of the tsdb files
+  VND_TASK_RETENTION,  // retention and migration of the tsdb files
+  VND_TASK_INSERT,
+  VND_TASK_CLASS_MAX,
+} EVndTaskClass;
+
+int  vnodeScheduleTaskEx(EVndTaskClass taskClass, int32_t vgId, int (*execute)(void*), void* arg);
+void vnodeThrottleBgWrite(int64_t size);
+
 // meta
 typedef struct SMCtbCursor SMCtbCursor;
 typedef struct SMStbCursor SMStbCursor;
@@ -201,12 +213,16 @@ int32_t tsdbBegin(STsdb* pTsdb);
 // int32_t tsdbPrepareCommit(STsdb* pTsdb);
 // int32_t tsdbCommit(STsdb* pTsdb, SCommitInfo* pInfo);
 int32_t tsdbCacheCommit(STsdb* pTsdb);
+int32_t tsdbCacheDropTable(STsdb* pTsdb, tb_uid_t suid, tb_uid_t uid);
+int32_t tsdbCacheDropSTable(STsdb* pTsdb, tb_uid_t suid);
 int32_t tsdbCompact(STsdb* pTsdb, SCompactInfo* pInfo);
 // int32_t tsdbFinishCommit(STsdb* pTsdb);
 // int32_t tsdbRollbackCommit(STsdb* pTsdb);
 int     tsdbScanAndConvertSubmitMsg(STsdb* pTsdb, SSubmitReq2* pMsg);
 int     tsdbInsertData(STsdb* pTsdb, int64_t version, SSubmitReq2* pMsg, SSubmitRsp2* pRsp);
-int32_t tsdbInsertTableData(STsdb* pTsdb, int64_t version, SSubmitTbData* pSubmitTbData, int32_t* affectedRows);
+// inBufPool: the submitted data lives in the buffer pool in use and is referenced by the memtable instead of copied
+int32_t tsdbInsertTableData(STsdb* pTsdb, int64_t version, SSubmitTbData* pSubmitTbData, bool inBufPool,
+                            int32_t* affectedRows);
 int32_t tsdbDeleteTableData(STsdb* pTsdb, int64_t version, tb_uid_t suid, tb_uid_t uid, TSKEY sKey, TSKEY eKey);
 int32_t tsdbSetKeepCfg(STsdb* pTsdb, STsdbCfg* pCfg);
 
@@ -414,6 +430,9 @@ struct SVnode {
   tsem_t        syncSem;
   int32_t       blockSec;
   int64_t       blockSeq;
+  bool          groupCommit;
+  int32_t       nGroupMsg;
+  SArray*       aGroupRsp;  // SRpcMsg, sent once the group is fsynced
   SQHandle*     pQuery;
 };
 
@@ -37,6 +37,34 @@ typedef struct STagFilterResEntry {
   uint32_t hitTimes;  // queried times for current super table
 } STagFilterResEntry;
 
+// one tag column of a tag store, var-size tags are kept as int32 codes into a dictionary of their distinct values
+typedef struct STagColStoreCol {
+  col_id_t  cid;
+  int8_t    type;
+  int32_t   bytes;      // bytes of a value, or of a dictionary code
+  char*     pData;      // capacity * bytes
+  char*     pNull;      // null bitmap, in the layout of SColumnInfoData
+  SArray*   pDict;      // code -> varstr, var-size tags only
+  SHashObj* pDictCode;  // varstr -> code, var-size tags only
+  int64_t   dictBytes;  // of the values in pDict
+} STagColStoreCol;
+
+// the tags of all child tables of a super table, one row per child table and one array per tag column
+typedef struct STagColStore {
+  int32_t          nCol;
+  STagColStoreCol* aCol;
+  int32_t          nRow;      // rows of dropped tables included
+  int32_t          nDropped;  // rows of dropped tables, their uid is 0
+  int32_t          capacity;
+  tb_uid_t*        aUid;
+  tb_uid_t         maxUid;
+  bool             sorted;  // aUid is in ascending order
+  SHashObj*        pRow;    // uid -> row
+  int64_t          lastUse;  // of the cache clock, under the cache lock
+  int32_t          nRef;     // of the cache and of the queries on the store
+  TdThreadMutex    lock;     // serializes the queries on the store, its writers run alone under the meta write lock
+} STagColStore;
+
 struct SMetaCache {
   // child, normal, super, table entry cache
   struct SEntryCache {
@@ -70,6 +98,12 @@ struct SMetaCache {
   struct STbFilterCache {
     SHashObj* pStb;
   } STbFilterCache;
+
+  struct STagColStoreCache {
+    TdThreadMutex lock;
+    SHashObj*     pStore;  // suid -> STagColStore*
+    int64_t       clock;   // ticks once per query on a store
+  } sTagColStoreCache;
 };
 
 static void entryCacheClose(SMeta* pMeta) {
@@ -108,6 +142,10 @@ static void freeCacheEntryFp(void* param) {
   taosMemoryFreeClear(*p);
 }
 
+static void tagColStoreUnref(STagColStore* pStore);
+
+static void freeTagColStoreFp(void* param) { tagColStoreUnref(*(STagColStore**)param); }
+
 int32_t metaCacheOpen(SMeta* pMeta) {
   int32_t     code = 0;
   SMetaCache* pCache = NULL;
@@ -178,6 +216,16 @@ int32_t metaCacheOpen(SMeta* pMeta) {
     goto _err2;
   }
 
+  pCache->sTagColStoreCache.pStore =
+      taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
+  if (pCache->sTagColStoreCache.pStore == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err2;
+  }
+
+  taosHashSetFreeFp(pCache->sTagColStoreCache.pStore, freeTagColStoreFp);
+  taosThreadMutexInit(&pCache->sTagColStoreCache.lock, NULL);
+
   pMeta->pCache = pCache;
   return code;
 
@@ -205,6 +253,9 @@ void metaCacheClose(SMeta* pMeta) {
 
     taosHashCleanup(pMeta->pCache->STbFilterCache.pStb);
 
+    taosThreadMutexDestroy(&pMeta->pCache->sTagColStoreCache.lock);
+    taosHashCleanup(pMeta->pCache->sTagColStoreCache.pStore);
+
     taosMemoryFree(pMeta->pCache);
     pMeta->pCache = NULL;
   }
@@ -919,4 +970,683 @@ int32_t metaSizeOfTbFilterCache(void* pVnode, int8_t type) {
     return taosHashGetSize(pMeta->pCache->STbFilterCache.pStb);
   }
   return 0;
-}
\ No newline at end of file
+}
+// tag column store ==================
+static void tagColStoreDestroy(STagColStore* pStore) {
+  if (pStore == NULL) {
+    return;
+  }
+
+  for (int32_t i = 0; i < pStore->nCol; i++) {
+    STagColStoreCol* pCol = &pStore->aCol[i];
+    taosMemoryFree(pCol->pData);
+    taosMemoryFree(pCol->pNull);
+    taosArrayDestroyP(pCol->pDict, taosMemoryFree);
+    taosHashCleanup(pCol->pDictCode);
+  }
+
+  taosMemoryFree(pStore->aCol);
+  taosMemoryFree(pStore->aUid);
+  taosHashCleanup(pStore->pRow);
+  taosThreadMutexDestroy(&pStore->lock);
+  taosMemoryFree(pStore);
+}
+
+static void tagColStoreUnref(STagColStore* pStore) {
+  if (pStore != NULL && atomic_sub_fetch_32(&pStore->nRef, 1) == 0) {
+    tagColStoreDestroy(pStore);
+  }
+}
+
+static int32_t tagColStoreCreate(const SSchemaWrapper* pTagSchema, STagColStore** ppStore) {
+  STagColStore* pStore = taosMemoryCalloc(1, sizeof(STagColStore));
+  if (pStore == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  taosThreadMutexInit(&pStore->lock, NULL);
+  pStore->nRef = 1;
+  pStore->sorted = true;
+  pStore->pRow = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
+  pStore->aCol = taosMemoryCalloc(pTagSchema->nCols, sizeof(STagColStoreCol));
+  if (pStore->pRow == NULL || pStore->aCol == NULL) {
+    tagColStoreDestroy(pStore);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pStore->nCol = pTagSchema->nCols;
+  for (int32_t i = 0; i < pStore->nCol; i++) {
+    STagColStoreCol* pCol = &pStore->aCol[i];
+    pCol->cid = pTagSchema->pSchema[i].colId;
+    pCol->type = pTagSchema->pSchema[i].type;
+    if (IS_VAR_DATA_TYPE(pCol->type)) {
+      pCol->bytes = sizeof(int32_t);
+      pCol->pDict = taosArrayInit(64, POINTER_BYTES);
+      pCol->pDictCode = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+      if (pCol->pDict == NULL || pCol->pDictCode == NULL) {
+        tagColStoreDestroy(pStore);
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+    } else {
+      pCol->bytes = tDataTypes[pCol->type].bytes;
+    }
+  }
+
+  *ppStore = pStore;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t tagColStoreEnsureCapacity(STagColStore* pStore, int32_t nRow) {
+  if (nRow <= pStore->capacity) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t capacity = TMAX(TMAX(pStore->capacity * 2, nRow), 256);
+
+  tb_uid_t* aUid = taosMemoryRealloc(pStore->aUid, sizeof(tb_uid_t) * capacity);
+  if (aUid == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  pStore->aUid = aUid;
+
+  for (int32_t i = 0; i < pStore->nCol; i++) {
+    STagColStoreCol* pCol = &pStore->aCol[i];
+
+    char* pData = taosMemoryRealloc(pCol->pData, (int64_t)pCol->bytes * capacity);
+    if (pData == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pCol->pData = pData;
+
+    char* pNull = taosMemoryRealloc(pCol->pNull, BitmapLen(capacity));
+    if (pNull == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    memset(pNull + BitmapLen(pStore->capacity), 0, BitmapLen(capacity) - BitmapLen(pStore->capacity));
+    pCol->pNull = pNull;
+  }
+
+  pStore->capacity = capacity;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t tagColStoreGetCode(STagColStoreCol* pCol, const STagVal* pTagVal, int32_t* pCode) {
+  char    buf[256];
+  int32_t len = VARSTR_HEADER_SIZE + pTagVal->nData;
+  char*   pKey = (len <= sizeof(buf)) ? buf : taosMemoryMalloc(len);
+  if (pKey == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  varDataSetLen(pKey, pTagVal->nData);
+  memcpy(varDataVal(pKey), pTagVal->pData, pTagVal->nData);
+
+  int32_t  code = TSDB_CODE_SUCCESS;
+  int32_t* pFound = taosHashGet(pCol->pDictCode, pKey, len);
+  if (pFound != NULL) {
+    *pCode = *pFound;
+    goto _exit;
+  }
+
+  char* pVal = taosMemoryMalloc(len);
+  if (pVal == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+  memcpy(pVal, pKey, len);
+  pCol->dictBytes += len;
+
+  *pCode = taosArrayGetSize(pCol->pDict);
+  if (taosArrayPush(pCol->pDict, &pVal) == NULL) {
+    taosMemoryFree(pVal);
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  if (taosHashPut(pCol->pDictCode, pKey, len, pCode, sizeof(int32_t)) != 0) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+_exit:
+  if (pKey != buf) taosMemoryFree(pKey);
+  return code;
+}
+
+static int32_t tagColStoreSetRow(STagColStore* pStore, int32_t row, const STag* pTag) {
+  for (int32_t i = 0; i < pStore->nCol; i++) {
+    STagColStoreCol* pCol = &pStore->aCol[i];
+    char*            pData = pCol->pData + (int64_t)pCol->bytes * row;
+
+    STagVal tagVal = {.cid = pCol->cid};
+    if (pTag == NULL || !tTagGet(pTag, &tagVal)) {
+      colDataSetNull_f(pCol->pNull, row);
+      memset(pData, 0, pCol->bytes);
+      continue;
+    }
+
+    colDataClearNull_f(pCol->pNull, row);
+    if (IS_VAR_DATA_TYPE(pCol->type)) {
+      int32_t code = tagColStoreGetCode(pCol, &tagVal, (int32_t*)pData);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    } else {
+      memcpy(pData, &tagVal.i64, pCol->bytes);
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t tagColStorePut(STagColStore* pStore, tb_uid_t uid, const STag* pTag) {
+  int32_t* pRow = taosHashGet(pStore->pRow, &uid, sizeof(uid));
+  if (pRow != NULL) {
+    return tagColStoreSetRow(pStore, *pRow, pTag);
+  }
+
+  int32_t code = tagColStoreEnsureCapacity(pStore, pStore->nRow + 1);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  int32_t row = pStore->nRow;
+  if (taosHashPut(pStore->pRow, &uid, sizeof(uid), &row, sizeof(row)) != 0) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pStore->aUid[row] = uid;
+  pStore->nRow++;
+  if (uid < pStore->maxUid) {
+    pStore->sorted = false;
+  } else {
+    pStore->maxUid = uid;
+  }
+
+  return tagColStoreSetRow(pStore, row, pTag);
+}
+
+// read the tag schema of the super table and the tags of all its child tables from the meta, which the caller has
+// locked for read
+static int32_t tagColStoreBuild(SMeta* pMeta, tb_uid_t suid, STagColStore** ppStore) {
+  int32_t       code = TSDB_CODE_SUCCESS;
+  STagColStore* pStore = NULL;
+  TBC*          pCur = NULL;
+  void*         pKey = NULL;
+  void*         pVal = NULL;
+  int           nKey = 0;
+  int           nVal = 0;
+  int           c = 0;
+
+  SMetaReader mr = {0};
+  metaReaderDoInit(&mr, pMeta, META_READER_NOLOCK);
+  if (metaReaderGetTableEntryByUid(&mr, suid) < 0) {
+    code = terrno;
+    goto _exit;
+  }
+
+  SSchemaWrapper* pTagSchema = &mr.me.stbEntry.schemaTag;
+  if (mr.me.type != TSDB_SUPER_TABLE || pTagSchema->nCols <= 0 ||
+      (pTagSchema->nCols == 1 && pTagSchema->pSchema[0].type == TSDB_DATA_TYPE_JSON)) {
+    code = TSDB_CODE_OPS_NOT_SUPPORT;
+    goto _exit;
+  }
+
+  code = tagColStoreCreate(pTagSchema, &pStore);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _exit;
+  }
+
+  if (tdbTbcOpen(pMeta->pCtbIdx, &pCur, NULL) < 0) {
+    code = TSDB_CODE_FAILED;
+    goto _exit;
+  }
+
+  tdbTbcMoveTo(pCur, &(SCtbIdxKey){.suid = suid, .uid = INT64_MIN}, sizeof(SCtbIdxKey), &c);
+  if (c > 0) {
+    tdbTbcMoveToNext(pCur);
+  }
+
+  while (tdbTbcNext(pCur, &pKey, &nKey, &pVal, &nVal) >= 0) {
+    SCtbIdxKey* pCtbIdxKey = pKey;
+    if (pCtbIdxKey->suid < suid) {
+      continue;
+    } else if (pCtbIdxKey->suid > suid) {
+      break;
+    }
+
+    code = tagColStorePut(pStore, pCtbIdxKey->uid, pVal);
+    if (code != TSDB_CODE_SUCCESS) {
+      goto _exit;
+    }
+  }
+
+  metaDebug("vgId:%d suid:%" PRId64 " tag column store built, tables:%d tags:%d", TD_VID(pMeta->pVnode), suid,
+            pStore->nRow, pStore->nCol);
+
+_exit:
+  if (code != TSDB_CODE_SUCCESS) {
+    tagColStoreDestroy(pStore);
+    pStore = NULL;
+  }
+
+  tdbFree(pKey);
+  tdbFree(pVal);
+  tdbTbcClose(pCur);
+  metaReaderClear(&mr);
+  *ppStore = pStore;
+  return code;
+}
+
+typedef struct {
+  tb_uid_t uid;
+  int32_t  row;
+} STagColStoreRowRef;
+
+static int32_t tagColStoreRowRefCmpr(const void* p1, const void* p2) {
+  tb_uid_t uid1 = ((const STagColStoreRowRef*)p1)->uid;
+  tb_uid_t uid2 = ((const STagColStoreRowRef*)p2)->uid;
+  return (uid1 < uid2) ? -1 : ((uid1 > uid2) ? 1 : 0);
+}
+
+// squeeze out the rows of dropped tables and bring the rows back in uid order, the order the ctb.idx returns them
+static int32_t tagColStoreCompact(STagColStore* pStore) {
+  if (pStore->nDropped == 0 && pStore->sorted) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t             code = TSDB_CODE_SUCCESS;
+  int32_t             nRow = 0;
+  STagColStoreRowRef* aRef = taosMemoryMalloc(sizeof(STagColStoreRowRef) * TMAX(pStore->nRow, 1));
+  if (aRef == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < pStore->nRow; i++) {
+    if (pStore->aUid[i] != 0) {
+      aRef[nRow++] = (STagColStoreRowRef){.uid = pStore->aUid[i], .row = i};
+    }
+  }
+
+  if (!pStore->sorted) {
+    taosSort(aRef, nRow, sizeof(STagColStoreRowRef), tagColStoreRowRefCmpr);
+  }
+
+  for (int32_t i = 0; i < pStore->nCol; i++) {
+    STagColStoreCol* pCol = &pStore->aCol[i];
+
+    char* pData = taosMemoryMalloc((int64_t)pCol->bytes * pStore->capacity);
+    char* pNull = taosMemoryCalloc(1, BitmapLen(pStore->capacity));
+    if (pData == NULL || pNull == NULL) {
+      taosMemoryFree(pData);
+      taosMemoryFree(pNull);
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+
+    for (int32_t j = 0; j < nRow; j++) {
+      int32_t row = aRef[j].row;
+      memcpy(pData + (int64_t)pCol->bytes * j, pCol->pData + (int64_t)pCol->bytes * row, pCol->bytes);
+      if (colDataIsNull_f(pCol->pNull, row)) {
+        colDataSetNull_f(pNull, j);
+      }
+    }
+
+    taosMemoryFree(pCol->pData);
+    taosMemoryFree(pCol->pNull);
+    pCol->pData = pData;
+    pCol->pNull = pNull;
+  }
+
+  taosHashClear(pStore->pRow);
+  for (int32_t j = 0; j < nRow; j++) {
+    pStore->aUid[j] = aRef[j].uid;
+    if (taosHashPut(pStore->pRow, &aRef[j].uid, sizeof(tb_uid_t), &j, sizeof(int32_t)) != 0) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+  }
+
+  pStore->nRow = nRow;
+  pStore->nDropped = 0;
+  pStore->maxUid = (nRow > 0) ? pStore->aUid[nRow - 1] : 0;
+  pStore->sorted = true;
+
+_exit:
+  taosMemoryFree(aRef);
+  return code;
+}
+
+// tag updates leave the old values in the dictionaries, start over once they are mostly garbage
+static bool tagColStoreIsBloated(const STagColStore* pStore) {
+  for (int32_t i = 0; i < pStore->nCol; i++) {
+    const STagColStoreCol* pCol = &pStore->aCol[i];
+    if (pCol->pDict != NULL && taosArrayGetSize(pCol->pDict) > 2 * (pStore->nRow - pStore->nDropped) + 1024) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// approximate, a hash entry is counted as two words over its key and value
+static int64_t tagColStoreSize(const STagColStore* pStore) {
+  int64_t size = sizeof(STagColStore) + (int64_t)(sizeof(tb_uid_t) * 2 + sizeof(int32_t) + 16) * pStore->capacity;
+  for (int32_t i = 0; i < pStore->nCol; i++) {
+    const STagColStoreCol* pCol = &pStore->aCol[i];
+    size += sizeof(STagColStoreCol) + (int64_t)pCol->bytes * pStore->capacity + BitmapLen(pStore->capacity);
+    if (pCol->pDict != NULL) {
+      size += pCol->dictBytes * 2 + (int64_t)taosArrayGetSize(pCol->pDict) * (POINTER_BYTES + sizeof(int32_t) + 16);
+    }
+  }
+
+  return size;
+}
+
+// Keep the stores of the vnode within tagColumnStoreSize by dropping the least recently used ones, the store of suid
+// last. Returns TSDB_CODE_OPS_NOT_SUPPORT if the store of suid alone is over the budget, it is dropped then as well.
+// Called with the cache lock held.
+static int32_t tagColStoreEvict(SMeta* pMeta, tb_uid_t suid) {
+  SHashObj* pStoreHash = pMeta->pCache->sTagColStoreCache.pStore;
+  int64_t   budget = (int64_t)tsTagColumnStoreSize * 1024 * 1024;
+
+  while (true) {
+    int64_t  total = 0;
+    int64_t  oldest = INT64_MAX;
+    tb_uid_t victim = 0;
+
+    void* pIter = taosHashIterate(pStoreHash, NULL);
+    while (pIter != NULL) {
+      STagColStore* pStore = *(STagColStore**)pIter;
+      tb_uid_t      uid = *(tb_uid_t*)taosHashGetKey(pIter, NULL);
+      total += tagColStoreSize(pStore);
+      if (uid != suid && pStore->lastUse < oldest) {
+        oldest = pStore->lastUse;
+        victim = uid;
+      }
+      pIter = taosHashIterate(pStoreHash, pIter);
+    }
+
+    if (total <= budget) {
+      return TSDB_CODE_SUCCESS;
+    }
+
+    if (oldest == INT64_MAX) {
+      metaDebug("vgId:%d suid:%" PRId64 " tag column store of %" PRId64 " bytes over the budget, dropped",
+                TD_VID(pMeta->pVnode), suid, total);
+      taosHashRemove(pStoreHash, &suid, sizeof(suid));
+      return TSDB_CODE_OPS_NOT_SUPPORT;
+    }
+
+    metaDebug("vgId:%d suid:%" PRId64 " tag column store evicted", TD_VID(pMeta->pVnode), victim);
+    taosHashRemove(pStoreHash, &victim, sizeof(victim));
+  }
+}
+
+static STagColStoreCol* tagColStoreGetCol(STagColStore* pStore, col_id_t cid) {
+  for (int32_t i = 0; i < pStore->nCol; i++) {
+    if (pStore->aCol[i].cid == cid) {
+      return &pStore->aCol[i];
+    }
+  }
+
+  return NULL;
+}
+
+static int32_t tagColStoreFillCol(STagColStore* pStore, STagColStoreCol* pCol, const int32_t* aRow, int32_t numOfRows,
+                                  SColumnInfoData* pColInfo) {
+  if (aRow == NULL && !IS_VAR_DATA_TYPE(pCol->type)) {
+    memcpy(pColInfo->pData, pCol->pData, (int64_t)pCol->bytes * numOfRows);
+    memcpy(pColInfo->nullbitmap, pCol->pNull, BitmapLen(numOfRows));
+    pColInfo->hasNull = true;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  for (int32_t i = 0; i < numOfRows; i++) {
+    int32_t row = (aRow == NULL) ? i : aRow[i];
+    if (row < 0 || colDataIsNull_f(pCol->pNull, row)) {
+      colDataSetNULL(pColInfo, i);
+      continue;
+    }
+
+    const char* pData = pCol->pData + (int64_t)pCol->bytes * row;
+    if (IS_VAR_DATA_TYPE(pCol->type)) {
+      pData = taosArrayGetP(pCol->pDict, *(int32_t*)pData);
+    }
+
+    int32_t code = colDataSetVal(pColInfo, i, pData, false);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// the store of the super table with a reference for the caller, built and published if the cache has none
+static int32_t tagColStoreAcquire(SMeta* pMeta, tb_uid_t suid, STagColStore** ppStore) {
+  TdThreadMutex* pLock = &pMeta->pCache->sTagColStoreCache.lock;
+  SHashObj*      pStoreHash = pMeta->pCache->sTagColStoreCache.pStore;
+
+  taosThreadMutexLock(pLock);
+  STagColStore** ppCached = taosHashGet(pStoreHash, &suid, sizeof(suid));
+  STagColStore*  pStore = (ppCached != NULL) ? *ppCached : NULL;
+  if (pStore != NULL) {
+    atomic_add_fetch_32(&pStore->nRef, 1);
+  }
+  taosThreadMutexUnlock(pLock);
+
+  if (pStore != NULL) {
+    *ppStore = pStore;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  // built without the cache lock, so that the queries on the other super tables go on meanwhile
+  int32_t code = tagColStoreBuild(pMeta, suid, &pStore);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  taosThreadMutexLock(pLock);
+  ppCached = taosHashGet(pStoreHash, &suid, sizeof(suid));
+  if (ppCached != NULL) {
+    // another query built it first
+    tagColStoreDestroy(pStore);
+    pStore = *ppCached;
+    atomic_add_fetch_32(&pStore->nRef, 1);
+  } else if (taosHashPut(pStoreHash, &suid, sizeof(suid), &pStore, POINTER_BYTES) != 0) {
+    tagColStoreDestroy(pStore);
+    pStore = NULL;
+    code = TSDB_CODE_OUT_OF_MEMORY;
+  } else {
+    atomic_add_fetch_32(&pStore->nRef, 1);
+  }
+  taosThreadMutexUnlock(pLock);
+
+  *ppStore = pStore;
+  return code;
+}
+
+// drop the store from the cache unless it has been replaced already, the queries on it keep it until they are done
+static void tagColStoreRemove(SMeta* pMeta, tb_uid_t suid, STagColStore* pStore) {
+  TdThreadMutex* pLock = &pMeta->pCache->sTagColStoreCache.lock;
+  SHashObj*      pStoreHash = pMeta->pCache->sTagColStoreCache.pStore;
+
+  taosThreadMutexLock(pLock);
+  STagColStore** ppCached = taosHashGet(pStoreHash, &suid, sizeof(suid));
+  if (ppCached != NULL && *ppCached == pStore) {
+    taosHashRemove(pStoreHash, &suid, sizeof(suid));
+  }
+  taosThreadMutexUnlock(pLock);
+}
+
+// Fill the tag columns of pBlock, the tbname column (colId -1) excluded, for the child tables in pUidTagList, or for
+// all child tables of the super table if the list is empty, in which case their uids are appended to it. Returns
+// TSDB_CODE_OPS_NOT_SUPPORT, with pUidTagList untouched, if the store cannot serve the request.
+//
+// The cache lock is only taken to look up, publish and evict the stores, the store itself is locked while it is
+// compacted and read.
+int32_t metaGetTableTagCols(void* pVnode, uint64_t suid, SArray* pUidTagList, SSDataBlock* pBlock) {
+  SMeta*        pMeta = ((SVnode*)pVnode)->pMeta;
+  int32_t       code = TSDB_CODE_SUCCESS;
+  int32_t       numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  int32_t       numOfTables = taosArrayGetSize(pUidTagList);
+  int32_t*      aRow = NULL;
+  STagColStore* pStore = NULL;
+
+  if (!tsTagColumnStore) {
+    return TSDB_CODE_OPS_NOT_SUPPORT;
+  }
+
+  metaRLock(pMeta);
+
+  code = tagColStoreAcquire(pMeta, suid, &pStore);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _exit;
+  }
+
+  taosThreadMutexLock(&pStore->lock);
+  if (tagColStoreIsBloated(pStore)) {
+    taosThreadMutexUnlock(&pStore->lock);
+    tagColStoreRemove(pMeta, suid, pStore);
+    tagColStoreUnref(pStore);
+
+    code = tagColStoreAcquire(pMeta, suid, &pStore);
+    if (code != TSDB_CODE_SUCCESS) {
+      pStore = NULL;
+      goto _exit;
+    }
+    taosThreadMutexLock(&pStore->lock);
+  }
+
+  code = tagColStoreCompact(pStore);
+  if (code != TSDB_CODE_SUCCESS) {
+    taosThreadMutexUnlock(&pStore->lock);
+    tagColStoreRemove(pMeta, suid, pStore);
+    goto _exit;
+  }
+
+  for (int32_t j = 0; j < numOfCols; j++) {
+    SColumnInfoData* pColInfo = taosArrayGet(pBlock->pDataBlock, j);
+    if (pColInfo->info.colId == -1) {
+      continue;
+    }
+
+    STagColStoreCol* pCol = tagColStoreGetCol(pStore, pColInfo->info.colId);
+    if (pCol == NULL || pCol->type != pColInfo->info.type ||
+        (!IS_VAR_DATA_TYPE(pCol->type) && pCol->bytes != pColInfo->info.bytes)) {
+      code = TSDB_CODE_OPS_NOT_SUPPORT;
+      goto _unlock;
+    }
+  }
+
+  int32_t numOfRows = (numOfTables > 0) ? numOfTables : pStore->nRow;
+  if (numOfTables > 0) {
+    aRow = taosMemoryMalloc(sizeof(int32_t) * numOfTables);
+    if (aRow == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _unlock;
+    }
+
+    for (int32_t i = 0; i < numOfTables; i++) {
+      STUidTagInfo* pInfo = taosArrayGet(pUidTagList, i);
+      int32_t*      pRow = taosHashGet(pStore->pRow, &pInfo->uid, sizeof(tb_uid_t));
+      aRow[i] = (pRow != NULL) ? *pRow : -1;
+    }
+  }
+
+  code = blockDataEnsureCapacity(pBlock, numOfRows);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _unlock;
+  }
+
+  for (int32_t j = 0; j < numOfCols; j++) {
+    SColumnInfoData* pColInfo = taosArrayGet(pBlock->pDataBlock, j);
+    if (pColInfo->info.colId == -1) {
+      continue;
+    }
+
+    code = tagColStoreFillCol(pStore, tagColStoreGetCol(pStore, pColInfo->info.colId), aRow, numOfRows, pColInfo);
+    if (code != TSDB_CODE_SUCCESS) {
+      goto _unlock;
+    }
+  }
+
+  if (numOfTables == 0) {
+    if (taosArrayEnsureCap(pUidTagList, numOfRows) != 0) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _unlock;
+    }
+
+    for (int32_t i = 0; i < numOfRows; i++) {
+      STUidTagInfo info = {.uid = pStore->aUid[i]};
+      taosArrayPush(pUidTagList, &info);
+    }
+  }
+
+  pBlock->info.rows = numOfRows;
+
+_unlock:
+  taosThreadMutexUnlock(&pStore->lock);
+
+  // evicted after the fill, a store over the budget on its own still serves this query
+  if (code == TSDB_CODE_SUCCESS) {
+    TdThreadMutex* pLock = &pMeta->pCache->sTagColStoreCache.lock;
+    taosThreadMutexLock(pLock);
+    pStore->lastUse = ++pMeta->pCache->sTagColStoreCache.clock;
+    (void)tagColStoreEvict(pMeta, suid);
+    taosThreadMutexUnlock(pLock);
+  }
+
+_exit:
+  tagColStoreUnref(pStore);
+  metaULock(pMeta);
+  taosMemoryFree(aRow);
+  return code;
+}
+
+// The store of a super table is built by the first tag query on it and kept up to date from then on by the functions
+// below, which are called with the meta locked for write.
+void metaTagColStoreUpsert(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid, const void* pTags) {
+  TdThreadMutex* pLock = &pMeta->pCache->sTagColStoreCache.lock;
+  taosThreadMutexLock(pLock);
+
+  STagColStore** ppStore = taosHashGet(pMeta->pCache->sTagColStoreCache.pStore, &suid, sizeof(suid));
+  if (ppStore != NULL && tagColStorePut(*ppStore, uid, pTags) != TSDB_CODE_SUCCESS) {
+    // rebuilt by the next query
+    taosHashRemove(pMeta->pCache->sTagColStoreCache.pStore, &suid, sizeof(suid));
+  }
+
+  taosThreadMutexUnlock(pLock);
+}
+
+void metaTagColStoreDel(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid) {
+  TdThreadMutex* pLock = &pMeta->pCache->sTagColStoreCache.lock;
+  taosThreadMutexLock(pLock);
+
+  STagColStore** ppStore = taosHashGet(pMeta->pCache->sTagColStoreCache.pStore, &suid, sizeof(suid));
+  if (ppStore != NULL) {
+    STagColStore* pStore = *ppStore;
+    int32_t*      pRow = taosHashGet(pStore->pRow, &uid, sizeof(uid));
+    if (pRow != NULL) {
+      pStore->aUid[*pRow] = 0;
+      pStore->nDropped++;
+      taosHashRemove(pStore->pRow, &uid, sizeof(uid));
+    }
+  }
+
+  taosThreadMutexUnlock(pLock);
+}
+
+void metaTagColStoreDrop(SMeta* pMeta, tb_uid_t suid) {
+  TdThreadMutex* pLock = &pMeta->pCache->sTagColStoreCache.lock;
+  taosThreadMutexLock(pLock);
+  taosHashRemove(pMeta->pCache->sTagColStoreCache.pStore, &suid, sizeof(suid));
+  taosThreadMutexUnlock(pLock);
+}
+
+void metaTagColStoreClear(SMeta* pMeta) {
+  TdThreadMutex* pLock = &pMeta->pCache->sTagColStoreCache.lock;
+  taosThreadMutexLock(pLock);
+  taosHashClear(pMeta->pCache->sTagColStoreCache.pStore);
+  taosThreadMutexUnlock(pLock);
+}
@@ -61,5 +61,8 @@ int  metaPrepareAsyncCommit(SMeta *pMeta) {
 // abort the meta txn
 int metaAbort(SMeta *pMeta) {
   if (!pMeta->txn) return 0;
+
+  // the tag column stores may hold the aborted changes
+  metaTagColStoreClear(pMeta);
   return tdbAbort(pMeta->pEnv, pMeta->txn);
 }
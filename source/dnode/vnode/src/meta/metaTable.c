@@ -303,6 +303,8 @@ _drop_super_table:
   tdbTbDelete(pMeta->pUidIdx, &pReq->suid, sizeof(tb_uid_t), pMeta->txn);
   tdbTbDelete(pMeta->pSuidIdx, &pReq->suid, sizeof(tb_uid_t), pMeta->txn);
 
+  metaTagColStoreDrop(pMeta, pReq->suid);
+
   metaULock(pMeta);
 
 _exit:
@@ -389,6 +391,8 @@ int metaAlterSTable(SMeta *pMeta, int64_t version, SVCreateStbReq *pReq) {
 
   // metaStatsCacheDrop(pMeta, nStbEntry.uid);
 
+  metaTagColStoreDrop(pMeta, nStbEntry.uid);
+
   metaULock(pMeta);
 
   if (oStbEntry.pBuf) taosMemoryFree(oStbEntry.pBuf);
@@ -1078,6 +1082,7 @@ static int metaDropTableByUid(SMeta *pMeta, tb_uid_t uid, int *type) {
     metaUpdateStbStats(pMeta, e.ctbEntry.suid, -1);
     metaUidCacheClear(pMeta, e.ctbEntry.suid);
     metaTbGroupCacheClear(pMeta, e.ctbEntry.suid);
+    metaTagColStoreDel(pMeta, e.ctbEntry.suid, uid);
   } else if (e.type == TSDB_NORMAL_TABLE) {
     // drop schema.db (todo)
 
@@ -1090,6 +1095,7 @@ static int metaDropTableByUid(SMeta *pMeta, tb_uid_t uid, int *type) {
     metaStatsCacheDrop(pMeta, uid);
     metaUidCacheClear(pMeta, uid);
     metaTbGroupCacheClear(pMeta, uid);
+    metaTagColStoreDrop(pMeta, uid);
     --pMeta->pVnode->config.vndStats.numOfSTables;
   }
 
@@ -1513,6 +1519,7 @@ static int metaUpdateTableTagVal(SMeta *pMeta, int64_t version, SVAlterTbReq *pA
 
   metaUidCacheClear(pMeta, ctbEntry.ctbEntry.suid);
   metaTbGroupCacheClear(pMeta, ctbEntry.ctbEntry.suid);
+  metaTagColStoreUpsert(pMeta, ctbEntry.ctbEntry.suid, uid, ctbEntry.ctbEntry.pTags);
 
   metaULock(pMeta);
 
@@ -2202,6 +2209,8 @@ int metaHandleEntry(SMeta *pMeta, const SMetaEntry *pME) {
     // update tag.idx
     code = metaUpdateTagIdx(pMeta, pME);
     VND_CHECK_CODE(code, line, _err);
+
+    metaTagColStoreUpsert(pMeta, pME->ctbEntry.suid, pME->uid, pME->ctbEntry.pTags);
   } else {
     // update schema.db
     code = metaSaveToSkmDb(pMeta, pME);
@@ -2210,6 +2219,8 @@ int metaHandleEntry(SMeta *pMeta, const SMetaEntry *pME) {
     if (pME->type == TSDB_SUPER_TABLE) {
       code = metaUpdateSuidIdx(pMeta, pME);
       VND_CHECK_CODE(code, line, _err);
+
+      metaTagColStoreDrop(pMeta, pME->uid);
     }
   }
 
@@ -51,6 +51,34 @@ static void tsdbCloseBICache(STsdb *pTsdb) {
   }
 }
 
+static int32_t tsdbOpenBCache(STsdb *pTsdb) {
+  int32_t    code = 0;
+  SLRUCache *pCache = NULL;
+
+  if (tsTsdbBlockCacheSize > 0) {
+    pCache = taosLRUCacheInit((size_t)tsTsdbBlockCacheSize * 1024 * 1024, 0, .5);
+    if (pCache == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _err;
+    }
+
+    taosLRUCacheSetStrictCapacity(pCache, false);
+  }
+
+_err:
+  pTsdb->bCache = pCache;
+  return code;
+}
+
+static void tsdbCloseBCache(STsdb *pTsdb) {
+  SLRUCache *pCache = pTsdb->bCache;
+  if (pCache) {
+    taosLRUCacheEraseUnrefEntries(pCache);
+    taosLRUCacheCleanup(pCache);
+    pTsdb->bCache = NULL;
+  }
+}
+
 #define ROCKS_KEY_LEN (sizeof(tb_uid_t) + sizeof(int16_t) + sizeof(int8_t))
 
 typedef struct {
@@ -333,6 +361,471 @@ int tsdbCacheFlushDirty(const void *key, size_t klen, void *value, void *ud) {
   return 0;
 }
 
+/* columnar last value store ==================================================================================== */
+// The last_row/last values of the child tables of a super table, one array per column and cache type indexed by a
+// dense table slot. A cache scan over the super table resolves the slots of its tables and the indexes of its columns
+// once and then reads the values with a plain loop, instead of a LRU lookup and a copy per table and column.
+//
+// A cell is filled by the scan that misses it (through the LRU and rocks) and is owned by the store from then on:
+// tsdbCacheUpdate updates it in place and tsdbCacheCommit writes it to rocks if dirty. The LRU entry of the cell, if
+// any, is updated along with it but left clean, so that the reads that bypass the store never see an older value.
+// Filling and updating cells both run under lruMutex, so a cell never goes back to an older value than the LRU holds.
+//
+// The stores share the cacheLastSize budget with the LRU: they take at most half of it, and the LRU capacity is the
+// budget less what the stores use.
+#define LAST_CELL_ABSENT ((int8_t)0)
+#define LAST_CELL_CLEAN  ((int8_t)1)
+#define LAST_CELL_DIRTY  ((int8_t)2)
+
+#define LAST_CELL_BYTES  (2 * (sizeof(int8_t) * 2 + sizeof(TSKEY) + sizeof(SValue)))
+#define LAST_STORE_SLOTS 64
+
+typedef struct {
+  int8_t *aState;
+  int8_t *aFlag;
+  TSKEY  *aTs;
+  SValue *aValue;  // pData of var types is owned by the cell
+} SLastCells;
+
+typedef struct {
+  int16_t    cid;
+  int8_t     type;
+  SLastCells cells[2];  // by ltype: last_row, last
+} SLastStoreCol;
+
+struct SLastStore {
+  STsdb         *pTsdb;
+  tb_uid_t       suid;
+  TdThreadRwlock lock;
+  SSHashObj     *pSlots;  // uid -> slot
+  tb_uid_t      *aUid;    // slot -> uid
+  int32_t        nSlot;
+  int32_t        capSlot;
+  SSHashObj     *pCols;  // cid -> index in aCol
+  SArray        *aCol;   // SArray<SLastStoreCol>
+  int64_t        size;   // charged to lastStoreSize
+  int32_t        nRef;   // pLastStores and the readers holding the store
+  bool           dropped;
+};
+
+static void tsdbLastStoreCharge(SLastStore *pStore, int64_t size) {
+  atomic_add_fetch_64(&pStore->size, size);
+  atomic_add_fetch_64(&pStore->pTsdb->lastStoreSize, size);
+}
+
+static int64_t tsdbLastCacheBudget(STsdb *pTsdb) { return (int64_t)pTsdb->pVnode->config.cacheLastSize * 1024 * 1024; }
+
+// give the LRU what the stores leave of the budget, the grown var data of the cells is caught up on the next call
+static void tsdbLastStoreResizeLRU(STsdb *pTsdb) {
+  int64_t capacity = tsdbLastCacheBudget(pTsdb) - atomic_load_64(&pTsdb->lastStoreSize);
+  taosLRUCacheSetCapacity(pTsdb->lruCache, (size_t)TMAX(capacity, 0));
+}
+
+static int32_t tsdbLastCellsResize(SLastCells *pCells, int32_t oldCap, int32_t cap) {
+  if (cap == oldCap) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int8_t *aState = taosMemoryRealloc(pCells->aState, cap * sizeof(int8_t));
+  if (aState == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+  pCells->aState = aState;
+  memset(aState + oldCap, 0, (cap - oldCap) * sizeof(int8_t));
+
+  int8_t *aFlag = taosMemoryRealloc(pCells->aFlag, cap * sizeof(int8_t));
+  if (aFlag == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+  pCells->aFlag = aFlag;
+
+  TSKEY *aTs = taosMemoryRealloc(pCells->aTs, cap * sizeof(TSKEY));
+  if (aTs == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+  pCells->aTs = aTs;
+
+  SValue *aValue = taosMemoryRealloc(pCells->aValue, cap * sizeof(SValue));
+  if (aValue == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+  pCells->aValue = aValue;
+  memset(aValue + oldCap, 0, (cap - oldCap) * sizeof(SValue));
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static void tsdbLastCellsClear(SLastCells *pCells, int8_t type, int32_t nSlot) {
+  if (IS_VAR_DATA_TYPE(type) && pCells->aValue) {
+    for (int32_t i = 0; i < nSlot; ++i) {
+      taosMemoryFree(pCells->aValue[i].pData);
+    }
+  }
+
+  taosMemoryFreeClear(pCells->aState);
+  taosMemoryFreeClear(pCells->aFlag);
+  taosMemoryFreeClear(pCells->aTs);
+  taosMemoryFreeClear(pCells->aValue);
+}
+
+static void tsdbLastCellSet(SLastStore *pStore, SLastCells *pCells, int32_t slot, TSKEY ts, const SColVal *pColVal) {
+  SValue *pValue = &pCells->aValue[slot];
+
+  pCells->aTs[slot] = ts;
+  pCells->aFlag[slot] = pColVal->flag;
+  if (!IS_VAR_DATA_TYPE(pColVal->type)) {
+    *pValue = pColVal->value;
+    return;
+  }
+
+  // the buffer of the cell is at least nData bytes long, it is only replaced by a longer value
+  uint32_t nData = COL_VAL_IS_VALUE(pColVal) ? pColVal->value.nData : 0;
+  if (pValue->nData < nData) {
+    uint8_t *pData = taosMemoryMalloc(nData);
+    if (pData == NULL) {
+      // keep the cell consistent, it stands for a null value until the next update
+      pCells->aFlag[slot] = CV_FLAG_NULL;
+      pValue->nData = 0;
+      return;
+    }
+
+    tsdbLastStoreCharge(pStore, (int64_t)nData - pValue->nData);
+    taosMemoryFree(pValue->pData);
+    pValue->pData = pData;
+  }
+
+  if (nData) {
+    memcpy(pValue->pData, pColVal->value.pData, nData);
+  }
+  pValue->nData = nData;
+}
+
+static void tsdbLastCellGet(SLastStoreCol *pCol, int8_t ltype, int32_t slot, SLastCol *pLastCol) {
+  SLastCells *pCells = &pCol->cells[ltype];
+
+  *pLastCol = (SLastCol){.ts = pCells->aTs[slot],
+                         .colVal = {.cid = pCol->cid, .type = pCol->type, .flag = pCells->aFlag[slot]}};
+  if (IS_VAR_DATA_TYPE(pCol->type)) {
+    pLastCol->colVal.value.nData = pCells->aValue[slot].nData;
+    pLastCol->colVal.value.pData = pCells->aValue[slot].pData;
+  } else {
+    pLastCol->colVal.value = pCells->aValue[slot];
+  }
+}
+
+static SLastStore *tsdbLastStoreOpen(STsdb *pTsdb, tb_uid_t suid) {
+  SLastStore *pStore = taosMemoryCalloc(1, sizeof(SLastStore));
+  if (pStore == NULL) {
+    return NULL;
+  }
+
+  pStore->pTsdb = pTsdb;
+  pStore->suid = suid;
+  pStore->pSlots = tSimpleHashInit(LAST_STORE_SLOTS, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT));
+  pStore->pCols = tSimpleHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_SMALLINT));
+  pStore->aCol = taosArrayInit(16, sizeof(SLastStoreCol));
+  if (pStore->pSlots == NULL || pStore->pCols == NULL || pStore->aCol == NULL) {
+    tSimpleHashCleanup(pStore->pSlots);
+    tSimpleHashCleanup(pStore->pCols);
+    taosArrayDestroy(pStore->aCol);
+    taosMemoryFree(pStore);
+    return NULL;
+  }
+
+  taosThreadRwlockInit(&pStore->lock, NULL);
+  pStore->nRef = 1;
+  return pStore;
+}
+
+static void tsdbLastStoreClose(SLastStore *pStore) {
+  for (int32_t i = 0; i < TARRAY_SIZE(pStore->aCol); ++i) {
+    SLastStoreCol *pCol = TARRAY_GET_ELEM(pStore->aCol, i);
+    tsdbLastCellsClear(&pCol->cells[0], pCol->type, pStore->nSlot);
+    tsdbLastCellsClear(&pCol->cells[1], pCol->type, pStore->nSlot);
+  }
+
+  taosArrayDestroy(pStore->aCol);
+  tSimpleHashCleanup(pStore->pCols);
+  tSimpleHashCleanup(pStore->pSlots);
+  taosMemoryFree(pStore->aUid);
+  taosThreadRwlockDestroy(&pStore->lock);
+  taosMemoryFree(pStore);
+}
+
+static void tsdbLastStoreUnref(SLastStore *pStore) {
+  if (atomic_sub_fetch_32(&pStore->nRef, 1) == 0) {
+    tsdbLastStoreClose(pStore);
+  }
+}
+
+void tsdbCacheReleaseStore(SLastStore *pStore) {
+  if (pStore) {
+    tsdbLastStoreUnref(pStore);
+  }
+}
+
+// the store of a super table, created on the first cache scan of it, called with lruMutex locked
+static SLastStore *tsdbLastStoreAcquire(STsdb *pTsdb, tb_uid_t suid, bool create) {
+  SLastStore **ppStore = taosHashGet(pTsdb->pLastStores, &suid, sizeof(suid));
+  if (ppStore) {
+    return *ppStore;
+  } else if (!create) {
+    return NULL;
+  }
+
+  SLastStore *pStore = tsdbLastStoreOpen(pTsdb, suid);
+  if (pStore == NULL) {
+    return NULL;
+  }
+
+  if (taosHashPut(pTsdb->pLastStores, &suid, sizeof(suid), &pStore, POINTER_BYTES) != 0) {
+    tsdbLastStoreClose(pStore);
+    return NULL;
+  }
+
+  return pStore;
+}
+
+static int32_t tsdbLastStoreGetSlot(SLastStore *pStore, tb_uid_t uid) {
+  int32_t *pSlot = tSimpleHashGet(pStore->pSlots, &uid, sizeof(uid));
+  return pSlot ? *pSlot : -1;
+}
+
+static int32_t tsdbLastStoreGetCol(SLastStore *pStore, int16_t cid) {
+  int32_t *pIdx = tSimpleHashGet(pStore->pCols, &cid, sizeof(cid));
+  return pIdx ? *pIdx : -1;
+}
+
+static int32_t tsdbLastStoreAddCol(SLastStore *pStore, int16_t cid, int8_t type) {
+  SLastStoreCol col = {.cid = cid, .type = type};
+  int32_t       idx = TARRAY_SIZE(pStore->aCol);
+
+  if (tsdbLastCellsResize(&col.cells[0], 0, pStore->capSlot) != TSDB_CODE_SUCCESS ||
+      tsdbLastCellsResize(&col.cells[1], 0, pStore->capSlot) != TSDB_CODE_SUCCESS ||
+      taosArrayPush(pStore->aCol, &col) == NULL) {
+    goto _err;
+  }
+
+  if (tSimpleHashPut(pStore->pCols, &cid, sizeof(cid), &idx, sizeof(idx)) != 0) {
+    taosArrayPop(pStore->aCol);
+    goto _err;
+  }
+
+  tsdbLastStoreCharge(pStore, (int64_t)pStore->capSlot * LAST_CELL_BYTES);
+  tsdbLastStoreResizeLRU(pStore->pTsdb);
+  return idx;
+
+_err:
+  tsdbLastCellsClear(&col.cells[0], type, 0);
+  tsdbLastCellsClear(&col.cells[1], type, 0);
+  return -1;
+}
+
+// -1 once the stores of the vnode use up their half of the cacheLastSize budget, the table is then served by the LRU
+static int32_t tsdbLastStoreAddSlot(SLastStore *pStore, tb_uid_t uid) {
+  STsdb  *pTsdb = pStore->pTsdb;
+  int32_t nCol = TARRAY_SIZE(pStore->aCol);
+
+  if (pStore->nSlot == pStore->capSlot) {
+    int32_t cap = pStore->capSlot ? pStore->capSlot * 2 : LAST_STORE_SLOTS;
+    int64_t size = (int64_t)(cap - pStore->capSlot) * (nCol * LAST_CELL_BYTES + sizeof(tb_uid_t));
+    if (atomic_load_64(&pTsdb->lastStoreSize) + size > tsdbLastCacheBudget(pTsdb) / 2) {
+      return -1;
+    }
+
+    tb_uid_t *aUid = taosMemoryRealloc(pStore->aUid, cap * sizeof(tb_uid_t));
+    if (aUid == NULL) {
+      return -1;
+    }
+    pStore->aUid = aUid;
+
+    for (int32_t i = 0; i < nCol; ++i) {
+      SLastStoreCol *pCol = TARRAY_GET_ELEM(pStore->aCol, i);
+      if (tsdbLastCellsResize(&pCol->cells[0], pStore->capSlot, cap) != TSDB_CODE_SUCCESS ||
+          tsdbLastCellsResize(&pCol->cells[1], pStore->capSlot, cap) != TSDB_CODE_SUCCESS) {
+        // the columns grown so far keep their larger arrays, capSlot only rises once all of them did
+        return -1;
+      }
+    }
+
+    pStore->capSlot = cap;
+    tsdbLastStoreCharge(pStore, size);
+    tsdbLastStoreResizeLRU(pTsdb);
+  }
+
+  int32_t slot = pStore->nSlot;
+  if (tSimpleHashPut(pStore->pSlots, &uid, sizeof(uid), &slot, sizeof(slot)) != 0) {
+    return -1;
+  }
+
+  pStore->aUid[slot] = uid;
+  ++pStore->nSlot;
+  return slot;
+}
+
+// release the slot of a dropped table, the last slot moves into it to keep the slots dense; the capacity stays with the
+// store for the tables added later. The dirty cells go without a flush, nothing reads them any more
+static void tsdbLastStoreFreeSlot(SLastStore *pStore, int32_t slot) {
+  int32_t last = pStore->nSlot - 1;
+
+  for (int32_t i = 0; i < TARRAY_SIZE(pStore->aCol); ++i) {
+    SLastStoreCol *pCol = TARRAY_GET_ELEM(pStore->aCol, i);
+    for (int8_t ltype = 0; ltype < 2; ++ltype) {
+      SLastCells *pCells = &pCol->cells[ltype];
+      if (IS_VAR_DATA_TYPE(pCol->type)) {
+        tsdbLastStoreCharge(pStore, -(int64_t)pCells->aValue[slot].nData);
+        taosMemoryFree(pCells->aValue[slot].pData);
+      }
+
+      pCells->aState[slot] = pCells->aState[last];
+      pCells->aFlag[slot] = pCells->aFlag[last];
+      pCells->aTs[slot] = pCells->aTs[last];
+      pCells->aValue[slot] = pCells->aValue[last];
+
+      pCells->aState[last] = LAST_CELL_ABSENT;
+      pCells->aValue[last] = (SValue){0};
+    }
+  }
+
+  tSimpleHashRemove(pStore->pSlots, &pStore->aUid[slot], sizeof(tb_uid_t));
+  if (slot != last) {
+    pStore->aUid[slot] = pStore->aUid[last];
+    tSimpleHashPut(pStore->pSlots, &pStore->aUid[slot], sizeof(tb_uid_t), &slot, sizeof(slot));
+  }
+  --pStore->nSlot;
+}
+
+// update the cell of a column in the store, false if the store does not hold it and the LRU has to
+static bool tsdbLastStoreUpdate(SLastStore *pStore, int32_t slot, int8_t ltype, TSKEY keyTs, SColVal *pColVal) {
+  if (pStore == NULL) {
+    return false;
+  }
+
+  int32_t iCol = tsdbLastStoreGetCol(pStore, pColVal->cid);
+  if (iCol < 0) {
+    return false;
+  }
+
+  SLastStoreCol *pCol = TARRAY_GET_ELEM(pStore->aCol, iCol);
+  SLastCells    *pCells = &pCol->cells[ltype];
+  if (pCol->type != pColVal->type || pCells->aState[slot] == LAST_CELL_ABSENT) {
+    return false;
+  }
+
+  if (pCells->aTs[slot] <= keyTs) {
+    tsdbLastCellSet(pStore, pCells, slot, keyTs, pColVal);
+    pCells->aState[slot] = LAST_CELL_DIRTY;
+  }
+
+  return true;
+}
+
+static void tsdbLastStoreFlushSlot(SLastStore *pStore, SLastStoreCol *pCol, int8_t ltype, int32_t slot) {
+  SLastCol lastCol = {0};
+
+  tsdbLastCellGet(pCol, ltype, slot, &lastCol);
+  tsdbCachePutBatch(&lastCol, &(SLastKey){.ltype = ltype, .uid = pStore->aUid[slot], .cid = pCol->cid}, ROCKS_KEY_LEN,
+                    &pStore->pTsdb->flushState);
+  pCol->cells[ltype].aState[slot] = LAST_CELL_CLEAN;
+}
+
+// write the dirty cells of all stores to the rocks write batch, called with lruMutex locked
+static void tsdbLastStoreFlush(STsdb *pTsdb) {
+  for (void *p = taosHashIterate(pTsdb->pLastStores, NULL); p; p = taosHashIterate(pTsdb->pLastStores, p)) {
+    SLastStore *pStore = *(SLastStore **)p;
+
+    taosThreadRwlockWrlock(&pStore->lock);
+    for (int32_t i = 0; i < TARRAY_SIZE(pStore->aCol); ++i) {
+      SLastStoreCol *pCol = TARRAY_GET_ELEM(pStore->aCol, i);
+      for (int8_t ltype = 0; ltype < 2; ++ltype) {
+        int8_t *aState = pCol->cells[ltype].aState;
+        for (int32_t slot = 0; slot < pStore->nSlot; ++slot) {
+          if (aState[slot] == LAST_CELL_DIRTY) {
+            tsdbLastStoreFlushSlot(pStore, pCol, ltype, slot);
+          }
+        }
+      }
+    }
+    taosThreadRwlockUnlock(&pStore->lock);
+  }
+}
+
+// drop the cells of a table whose data is being deleted, the dirty ones go to the write batch first so that rocks holds
+// the latest values when tsdbCacheDel checks them against the deleted range; called with lruMutex locked
+static void tsdbLastStoreDel(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid) {
+  SLastStore *pStore = suid ? tsdbLastStoreAcquire(pTsdb, suid, false) : NULL;
+  if (pStore == NULL) {
+    return;
+  }
+
+  taosThreadRwlockWrlock(&pStore->lock);
+  int32_t slot = tsdbLastStoreGetSlot(pStore, uid);
+  for (int32_t i = 0; slot >= 0 && i < TARRAY_SIZE(pStore->aCol); ++i) {
+    SLastStoreCol *pCol = TARRAY_GET_ELEM(pStore->aCol, i);
+    for (int8_t ltype = 0; ltype < 2; ++ltype) {
+      if (pCol->cells[ltype].aState[slot] == LAST_CELL_DIRTY) {
+        tsdbLastStoreFlushSlot(pStore, pCol, ltype, slot);
+      }
+      pCol->cells[ltype].aState[slot] = LAST_CELL_ABSENT;
+    }
+  }
+  taosThreadRwlockUnlock(&pStore->lock);
+}
+
+int32_t tsdbCacheDropTable(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid) {
+  taosThreadMutexLock(&pTsdb->lruMutex);
+
+  // the drop requests of old clients may come without the suid
+  void *p = NULL;
+  while ((p = taosHashIterate(pTsdb->pLastStores, p)) != NULL) {
+    SLastStore *pStore = *(SLastStore **)p;
+    if (suid != 0 && pStore->suid != suid) {
+      continue;
+    }
+
+    taosThreadRwlockWrlock(&pStore->lock);
+    int32_t slot = tsdbLastStoreGetSlot(pStore, uid);
+    if (slot >= 0) {
+      tsdbLastStoreFreeSlot(pStore, slot);
+    }
+    taosThreadRwlockUnlock(&pStore->lock);
+
+    if (slot >= 0 || suid != 0) {
+      taosHashCancelIterate(pTsdb->pLastStores, p);
+      break;
+    }
+  }
+
+  tsdbLastStoreResizeLRU(pTsdb);
+  taosThreadMutexUnlock(&pTsdb->lruMutex);
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t tsdbCacheDropSTable(STsdb *pTsdb, tb_uid_t suid) {
+  taosThreadMutexLock(&pTsdb->lruMutex);
+
+  SLastStore *pStore = tsdbLastStoreAcquire(pTsdb, suid, false);
+  if (pStore) {
+    taosHashRemove(pTsdb->pLastStores, &suid, sizeof(suid));
+
+    // the readers still holding the store no longer fill it, so its size is final
+    pStore->dropped = true;
+    atomic_sub_fetch_64(&pTsdb->lastStoreSize, atomic_load_64(&pStore->size));
+    tsdbLastStoreUnref(pStore);
+
+    tsdbLastStoreResizeLRU(pTsdb);
+  }
+
+  taosThreadMutexUnlock(&pTsdb->lruMutex);
+  return TSDB_CODE_SUCCESS;
+}
+
+static void tsdbCloseLastStores(STsdb *pTsdb) {
+  if (pTsdb->pLastStores == NULL) {
+    return;
+  }
+
+  for (void *p = taosHashIterate(pTsdb->pLastStores, NULL); p; p = taosHashIterate(pTsdb->pLastStores, p)) {
+    tsdbLastStoreUnref(*(SLastStore **)p);
+  }
+
+  taosHashCleanup(pTsdb->pLastStores);
+  pTsdb->pLastStores = NULL;
+  pTsdb->lastStoreSize = 0;
+}
+
 int32_t tsdbCacheCommit(STsdb *pTsdb) {
   int32_t code = 0;
   char   *err = NULL;
@@ -343,6 +836,8 @@ int32_t tsdbCacheCommit(STsdb *pTsdb) {
   taosThreadMutexLock(&pTsdb->lruMutex);
 
   taosLRUCacheApply(pCache, tsdbCacheFlushDirty, &pTsdb->flushState);
+  tsdbLastStoreFlush(pTsdb);
+  tsdbLastStoreResizeLRU(pTsdb);
 
   rocksMayWrite(pTsdb, true, false, false);
   rocksMayWrite(pTsdb, true, true, false);
@@ -407,6 +902,44 @@ typedef struct {
   SLastKey key;
 } SIdxKey;
 
+// update the LRU entry of a column, false if the LRU does not hold it; the entry is left clean if rocks is written from
+// somewhere else
+static bool tsdbCacheUpdateCol(SLRUCache *pCache, SLastKey *key, TSKEY keyTs, SColVal *pColVal, bool dirty) {
+  LRUHandle *h = taosLRUCacheLookup(pCache, key, ROCKS_KEY_LEN);
+  if (!h) {
+    return false;
+  }
+
+  SLastCol *pLastCol = (SLastCol *)taosLRUCacheValue(pCache, h);
+  if (pLastCol->ts <= keyTs) {
+    uint8_t *pVal = NULL;
+    int      nData = pLastCol->colVal.value.nData;
+    if (IS_VAR_DATA_TYPE(pColVal->type)) {
+      pVal = pLastCol->colVal.value.pData;
+    }
+    pLastCol->ts = keyTs;
+    pLastCol->colVal = *pColVal;
+    if (IS_VAR_DATA_TYPE(pColVal->type)) {
+      if (nData < pColVal->value.nData) {
+        taosMemoryFree(pVal);
+        pLastCol->colVal.value.pData = taosMemoryCalloc(1, pColVal->value.nData);
+      } else {
+        pLastCol->colVal.value.pData = pVal;
+      }
+      if (pColVal->value.nData) {
+        memcpy(pLastCol->colVal.value.pData, pColVal->value.pData, pColVal->value.nData);
+      }
+    }
+
+    if (dirty && !pLastCol->dirty) {
+      pLastCol->dirty = 1;
+    }
+  }
+
+  taosLRUCacheRelease(pCache, h, false);
+  return true;
+}
+
 int32_t tsdbCacheUpdate(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, TSDBROW *pRow) {
   int32_t code = 0;
 
@@ -439,43 +972,25 @@ int32_t tsdbCacheUpdate(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, TSDBROW *pRow
   SLRUCache *pCache = pTsdb->lruCache;
 
   taosThreadMutexLock(&pTsdb->lruMutex);
+
+  SLastStore *pStore = suid ? tsdbLastStoreAcquire(pTsdb, suid, false) : NULL;
+  int32_t     slot = -1;
+  if (pStore) {
+    taosThreadRwlockWrlock(&pStore->lock);
+    slot = tsdbLastStoreGetSlot(pStore, uid);
+    if (slot < 0) {
+      taosThreadRwlockUnlock(&pStore->lock);
+      pStore = NULL;
+    }
+  }
+
   for (int i = 0; i < num_keys; ++i) {
     SColVal *pColVal = (SColVal *)taosArrayGet(aColVal, i);
     int16_t  cid = pColVal->cid;
 
-    SLastKey  *key = &(SLastKey){.ltype = 0, .uid = uid, .cid = cid};
-    size_t     klen = ROCKS_KEY_LEN;
-    LRUHandle *h = taosLRUCacheLookup(pCache, key, klen);
-    if (h) {
-      SLastCol *pLastCol = (SLastCol *)taosLRUCacheValue(pCache, h);
-
-      if (pLastCol->ts <= keyTs) {
-        uint8_t *pVal = NULL;
-        int      nData = pLastCol->colVal.value.nData;
-        if (IS_VAR_DATA_TYPE(pColVal->type)) {
-          pVal = pLastCol->colVal.value.pData;
-        }
-        pLastCol->ts = keyTs;
-        pLastCol->colVal = *pColVal;
-        if (IS_VAR_DATA_TYPE(pColVal->type)) {
-          if (nData < pColVal->value.nData) {
-            taosMemoryFree(pVal);
-            pLastCol->colVal.value.pData = taosMemoryCalloc(1, pColVal->value.nData);
-          } else {
-            pLastCol->colVal.value.pData = pVal;
-          }
-          if (pColVal->value.nData) {
-            memcpy(pLastCol->colVal.value.pData, pColVal->value.pData, pColVal->value.nData);
-          }
-        }
-
-        if (!pLastCol->dirty) {
-          pLastCol->dirty = 1;
-        }
-      }
-
-      taosLRUCacheRelease(pCache, h, false);
-    } else {
+    SLastKey *key = &(SLastKey){.ltype = 0, .uid = uid, .cid = cid};
+    bool      stored = tsdbLastStoreUpdate(pStore, slot, 0, keyTs, pColVal);
+    if (!tsdbCacheUpdateCol(pCache, key, keyTs, pColVal, !stored) && !stored) {
       if (!remainCols) {
         remainCols = taosArrayInit(num_keys * 2, sizeof(SIdxKey));
       }
@@ -484,37 +999,8 @@ int32_t tsdbCacheUpdate(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, TSDBROW *pRow
 
     if (COL_VAL_IS_VALUE(pColVal)) {
       key->ltype = 1;
-      LRUHandle *h = taosLRUCacheLookup(pCache, key, klen);
-      if (h) {
-        SLastCol *pLastCol = (SLastCol *)taosLRUCacheValue(pCache, h);
-
-        if (pLastCol->ts <= keyTs) {
-          uint8_t *pVal = NULL;
-          int      nData = pLastCol->colVal.value.nData;
-          if (IS_VAR_DATA_TYPE(pColVal->type)) {
-            pVal = pLastCol->colVal.value.pData;
-          }
-          pLastCol->ts = keyTs;
-          pLastCol->colVal = *pColVal;
-          if (IS_VAR_DATA_TYPE(pColVal->type)) {
-            if (nData < pColVal->value.nData) {
-              taosMemoryFree(pVal);
-              pLastCol->colVal.value.pData = taosMemoryCalloc(1, pColVal->value.nData);
-            } else {
-              pLastCol->colVal.value.pData = pVal;
-            }
-            if (pColVal->value.nData) {
-              memcpy(pLastCol->colVal.value.pData, pColVal->value.pData, pColVal->value.nData);
-            }
-          }
-
-          if (!pLastCol->dirty) {
-            pLastCol->dirty = 1;
-          }
-        }
-
-        taosLRUCacheRelease(pCache, h, false);
-      } else {
+      stored = tsdbLastStoreUpdate(pStore, slot, 1, keyTs, pColVal);
+      if (!tsdbCacheUpdateCol(pCache, key, keyTs, pColVal, !stored) && !stored) {
         if (!remainCols) {
           remainCols = taosArrayInit(num_keys * 2, sizeof(SIdxKey));
         }
@@ -523,6 +1009,10 @@ int32_t tsdbCacheUpdate(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, TSDBROW *pRow
     }
   }
 
+  if (pStore) {
+    taosThreadRwlockUnlock(&pStore->lock);
+  }
+
   if (remainCols) {
     num_keys = TARRAY_SIZE(remainCols);
   }
@@ -964,7 +1454,8 @@ static int32_t tsdbCacheLoadFromRocks(STsdb *pTsdb, tb_uid_t uid, SArray *pLastA
   return code;
 }
 
-int32_t tsdbCacheGetBatch(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArray, SCacheRowsReader *pr, int8_t ltype) {
+static int32_t tsdbCacheGetBatchImp(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArray, SCacheRowsReader *pr, int8_t ltype,
+                                    bool lock) {
   int32_t    code = 0;
   SArray    *remainCols = NULL;
   SLRUCache *pCache = pTsdb->lruCache;
@@ -998,7 +1489,9 @@ int32_t tsdbCacheGetBatch(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArray, SCache
   }
 
   if (remainCols && TARRAY_SIZE(remainCols) > 0) {
-    taosThreadMutexLock(&pTsdb->lruMutex);
+    if (lock) {
+      taosThreadMutexLock(&pTsdb->lruMutex);
+    }
     for (int i = 0; i < TARRAY_SIZE(remainCols);) {
       SIdxKey   *idxKey = &((SIdxKey *)TARRAY_DATA(remainCols))[i];
       LRUHandle *h = taosLRUCacheLookup(pCache, &idxKey->key, ROCKS_KEY_LEN);
@@ -1019,7 +1512,9 @@ int32_t tsdbCacheGetBatch(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArray, SCache
 
     code = tsdbCacheLoadFromRocks(pTsdb, uid, pLastArray, remainCols, pr, ltype);
 
-    taosThreadMutexUnlock(&pTsdb->lruMutex);
+    if (lock) {
+      taosThreadMutexUnlock(&pTsdb->lruMutex);
+    }
 
     if (remainCols) {
       taosArrayDestroy(remainCols);
@@ -1029,6 +1524,171 @@ int32_t tsdbCacheGetBatch(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArray, SCache
   return code;
 }
 
+int32_t tsdbCacheGetBatch(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArray, SCacheRowsReader *pr, int8_t ltype) {
+  return tsdbCacheGetBatchImp(pTsdb, uid, pLastArray, pr, ltype, true);
+}
+
+static int32_t tsdbCacheInitReaderStore(STsdb *pTsdb, SCacheRowsReader *pr) {
+  if (pr->pLastStore == NULL) {
+    taosThreadMutexLock(&pTsdb->lruMutex);
+    pr->pLastStore = tsdbLastStoreAcquire(pTsdb, pr->info.suid, true);
+    if (pr->pLastStore) {
+      atomic_add_fetch_32(&pr->pLastStore->nRef, 1);
+    }
+    taosThreadMutexUnlock(&pTsdb->lruMutex);
+    if (pr->pLastStore == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  if (pr->pStoreCols == NULL) {
+    int32_t nCol = TARRAY_SIZE(pr->pCidList);
+    pr->pStoreCols = taosMemoryMalloc(nCol * sizeof(int32_t));
+    if (pr->pStoreCols == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    memset(pr->pStoreCols, 0xFF, nCol * sizeof(int32_t));
+  }
+
+  if (pr->pStoreSlots == NULL) {
+    pr->pStoreSlots = taosMemoryMalloc(pr->numOfTables * sizeof(int32_t));
+    if (pr->pStoreSlots == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    memset(pr->pStoreSlots, 0xFF, pr->numOfTables * sizeof(int32_t));
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// all columns of the table or none of them, so that a miss goes through the LRU and rocks once for the whole table;
+// called with the store read locked
+static bool tsdbCacheGetFromStore(SLastStore *pStore, int32_t iTable, SArray *pLastArray, SCacheRowsReader *pr,
+                                  int8_t ltype) {
+  int32_t slot = pr->pStoreSlots[iTable];
+  // the slots move when the tables of the store are dropped
+  if (slot < 0 || slot >= pStore->nSlot || pStore->aUid[slot] != pr->pTableList[iTable].uid) {
+    slot = tsdbLastStoreGetSlot(pStore, pr->pTableList[iTable].uid);
+    if (slot < 0) {
+      return false;
+    }
+    pr->pStoreSlots[iTable] = slot;
+  }
+
+  int16_t *aCid = TARRAY_DATA(pr->pCidList);
+  int32_t  nCol = TARRAY_SIZE(pr->pCidList);
+  for (int32_t i = 0; i < nCol; ++i) {
+    if (pr->pStoreCols[i] < 0) {
+      pr->pStoreCols[i] = tsdbLastStoreGetCol(pStore, aCid[i]);
+      if (pr->pStoreCols[i] < 0) {
+        return false;
+      }
+    }
+
+    SLastStoreCol *pCol = TARRAY_GET_ELEM(pStore->aCol, pr->pStoreCols[i]);
+    if (pCol->cells[ltype].aState[slot] == LAST_CELL_ABSENT) {
+      return false;
+    }
+  }
+
+  for (int32_t i = 0; i < nCol; ++i) {
+    SLastCol lastCol;
+    tsdbLastCellGet(TARRAY_GET_ELEM(pStore->aCol, pr->pStoreCols[i]), ltype, slot, &lastCol);
+    reallocVarData(&lastCol.colVal);
+    taosArrayPush(pLastArray, &lastCol);
+  }
+
+  return true;
+}
+
+// hand the values a scan loaded through the LRU and rocks over to the store, and take the values the store already
+// holds from it instead, rocks lags behind the dirty cells; called with lruMutex locked and the store write locked
+static void tsdbCacheFillStore(SLastStore *pStore, int32_t iTable, SArray *pLastArray, SCacheRowsReader *pr,
+                               int8_t ltype) {
+  SLRUCache *pCache = pStore->pTsdb->lruCache;
+  tb_uid_t   uid = pr->pTableList[iTable].uid;
+  int32_t  slot = tsdbLastStoreGetSlot(pStore, uid);
+  if (slot < 0) {
+    slot = tsdbLastStoreAddSlot(pStore, uid);
+    if (slot < 0) {
+      return;
+    }
+  }
+  pr->pStoreSlots[iTable] = slot;
+
+  int16_t *aCid = TARRAY_DATA(pr->pCidList);
+  for (int32_t i = 0; i < TARRAY_SIZE(pLastArray); ++i) {
+    SLastCol *pLastCol = TARRAY_GET_ELEM(pLastArray, i);
+
+    int32_t iCol = tsdbLastStoreGetCol(pStore, aCid[i]);
+    if (iCol < 0) {
+      iCol = tsdbLastStoreAddCol(pStore, aCid[i], pLastCol->colVal.type);
+      if (iCol < 0) {
+        continue;
+      }
+    }
+
+    SLastStoreCol *pCol = TARRAY_GET_ELEM(pStore->aCol, iCol);
+    SLastCells    *pCells = &pCol->cells[ltype];
+    if (pCol->type != pLastCol->colVal.type) {
+      continue;
+    }
+
+    if (pCells->aState[slot] == LAST_CELL_ABSENT) {
+      tsdbLastCellSet(pStore, pCells, slot, pLastCol->ts, &pLastCol->colVal);
+      pCells->aState[slot] = LAST_CELL_CLEAN;
+    } else if (pCells->aTs[slot] >= pLastCol->ts) {
+      if (IS_VAR_DATA_TYPE(pLastCol->colVal.type)) {
+        taosMemoryFree(pLastCol->colVal.value.pData);
+      }
+      tsdbLastCellGet(pCol, ltype, slot, pLastCol);
+      reallocVarData(&pLastCol->colVal);
+
+      // the LRU entry may just have been loaded from rocks
+      SLastKey key = {.ltype = ltype, .uid = uid, .cid = aCid[i]};
+      tsdbCacheUpdateCol(pCache, &key, pLastCol->ts, &pLastCol->colVal, false);
+    }
+  }
+}
+
+// tsdbCacheGetBatch for the iTable-th table of the reader, served by the columnar store of its super table
+int32_t tsdbCacheGetTableBatch(STsdb *pTsdb, int32_t iTable, SArray *pLastArray, SCacheRowsReader *pr, int8_t ltype) {
+  tb_uid_t uid = pr->pTableList[iTable].uid;
+
+  // the cache scans of child tables always carry the suid, normal tables are left to the LRU
+  if (pr->info.suid == 0) {
+    return tsdbCacheGetBatch(pTsdb, uid, pLastArray, pr, ltype);
+  }
+
+  // no fallback to the LRU alone, it does not see the dirty cells of the store once their entries are evicted
+  int32_t code = tsdbCacheInitReaderStore(pTsdb, pr);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  SLastStore *pStore = pr->pLastStore;
+
+  taosThreadRwlockRdlock(&pStore->lock);
+  bool hit = tsdbCacheGetFromStore(pStore, iTable, pLastArray, pr, ltype);
+  taosThreadRwlockUnlock(&pStore->lock);
+  if (hit) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  taosThreadMutexLock(&pTsdb->lruMutex);
+
+  code = tsdbCacheGetBatchImp(pTsdb, uid, pLastArray, pr, ltype, false);
+  if (code == TSDB_CODE_SUCCESS && !pStore->dropped) {
+    taosThreadRwlockWrlock(&pStore->lock);
+    tsdbCacheFillStore(pStore, iTable, pLastArray, pr, ltype);
+    taosThreadRwlockUnlock(&pStore->lock);
+  }
+
+  taosThreadMutexUnlock(&pTsdb->lruMutex);
+
+  return code;
+}
+
 int32_t tsdbCacheDel(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, TSKEY sKey, TSKEY eKey) {
   int32_t code = 0;
   // fetch schema
@@ -1061,6 +1721,7 @@ int32_t tsdbCacheDel(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, TSKEY sKey, TSKE
   size_t *values_list_sizes = taosMemoryCalloc(num_keys * 2, sizeof(size_t));
   char  **errs = taosMemoryCalloc(num_keys * 2, sizeof(char *));
   taosThreadMutexLock(&pTsdb->lruMutex);
+  tsdbLastStoreDel(pTsdb, suid, uid);
   taosThreadMutexLock(&pTsdb->rCache.rMutex);
   rocksMayWrite(pTsdb, true, false, false);
   rocksdb_multi_get(pTsdb->rCache.db, pTsdb->rCache.readoptions, num_keys * 2, (const char *const *)keys_list,
@@ -1149,12 +1810,25 @@ int32_t tsdbOpenCache(STsdb *pTsdb) {
     goto _err;
   }
 
+  code = tsdbOpenBCache(pTsdb);
+  if (code != TSDB_CODE_SUCCESS) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
   code = tsdbOpenRocksCache(pTsdb);
   if (code != TSDB_CODE_SUCCESS) {
     code = TSDB_CODE_OUT_OF_MEMORY;
     goto _err;
   }
 
+  pTsdb->pLastStores = taosHashInit(8, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), true, HASH_ENTRY_LOCK);
+  if (pTsdb->pLastStores == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+  pTsdb->lastStoreSize = 0;
+
   taosLRUCacheSetStrictCapacity(pCache, false);
 
   taosThreadMutexInit(&pTsdb->lruMutex, NULL);
@@ -1177,7 +1851,9 @@ void tsdbCloseCache(STsdb *pTsdb) {
     taosThreadMutexDestroy(&pTsdb->lruMutex);
   }
 
+  tsdbCloseLastStores(pTsdb);
   tsdbCloseBICache(pTsdb);
+  tsdbCloseBCache(pTsdb);
   tsdbCloseRocksCache(pTsdb);
 }
 
@@ -2880,7 +3556,9 @@ int32_t tsdbCacheRelease(SLRUCache *pCache, LRUHandle *h) {
 }
 
 void tsdbCacheSetCapacity(SVnode *pVnode, size_t capacity) {
-  taosLRUCacheSetCapacity(pVnode->pTsdb->lruCache, capacity);
+  // the columnar stores take their part of the budget out of the LRU
+  int64_t left = (int64_t)capacity - atomic_load_64(&pVnode->pTsdb->lastStoreSize);
+  taosLRUCacheSetCapacity(pVnode->pTsdb->lruCache, (size_t)TMAX(left, 0));
 }
 
 size_t tsdbCacheGetCapacity(SVnode *pVnode) { return taosLRUCacheGetCapacity(pVnode->pTsdb->lruCache); }
@@ -2987,3 +3665,126 @@ int32_t tsdbBICacheRelease(SLRUCache *pCache, LRUHandle *h) {
 
   return code;
 }
+
+// block cache: decompressed column data keyed by (file type, file set id, file commit id, block offset, column id).
+// A commit or a merge writes the files of all the file sets it touches under the same commit id, the file set id tells
+// them apart. The pair never gets reused, so entries of removed files are simply aged out.
+typedef struct {
+  int32_t ftype;
+  int32_t fid;
+  int16_t cid;
+  int16_t rsv[3];
+  int64_t fcid;
+  int64_t offset;
+} SBCacheKey;
+
+static void getBCacheKey(int32_t ftype, int32_t fid, int64_t fcid, int64_t offset, int16_t cid, SBCacheKey *key) {
+  memset(key, 0, sizeof(*key));
+  key->ftype = ftype;
+  key->fid = fid;
+  key->cid = cid;
+  key->fcid = fcid;
+  key->offset = offset;
+}
+
+static int32_t tsdbColDataBitmapSize(const SColData *pColData) {
+  switch (pColData->flag) {
+    case (HAS_NULL | HAS_NONE):
+    case (HAS_VALUE | HAS_NONE):
+    case (HAS_VALUE | HAS_NULL):
+      return BIT1_SIZE(pColData->nVal);
+    case (HAS_VALUE | HAS_NULL | HAS_NONE):
+      return BIT2_SIZE(pColData->nVal);
+    default:
+      return 0;
+  }
+}
+
+// the dictionary codes follow the offsets
+static int32_t tsdbColDataOffsetSize(const SColData *pColData) {
+  if (!IS_VAR_DATA_TYPE(pColData->type) || !(pColData->flag & HAS_VALUE)) return 0;
+  return sizeof(int32_t) * pColData->nVal * (pColData->nDict ? 2 : 1);
+}
+
+static void deleteBCache(const void *key, size_t keyLen, void *value, void *ud) {
+  (void)key;
+  (void)keyLen;
+  (void)ud;
+  taosMemoryFree(value);
+}
+
+bool tsdbBCacheGetColData(STsdb *pTsdb, int32_t ftype, int32_t fid, int64_t fcid, int64_t offset, SColData *pColData) {
+  SLRUCache *pCache = pTsdb->bCache;
+  SBCacheKey key;
+  bool       hit = false;
+
+  if (pCache == NULL) return false;
+
+  getBCacheKey(ftype, fid, fcid, offset, pColData->cid, &key);
+  LRUHandle *h = taosLRUCacheLookup(pCache, &key, sizeof(key));
+  if (h == NULL) return false;
+
+  SColData *pCached = (SColData *)taosLRUCacheValue(pCache, h);
+  int32_t   szBitMap = tsdbColDataBitmapSize(pCached);
+  int32_t   szOffset = tsdbColDataOffsetSize(pCached);
+
+  ASSERT(pCached->type == pColData->type);
+
+  if (szBitMap && tRealloc(&pColData->pBitMap, szBitMap)) goto _exit;
+  if (szOffset && tRealloc((uint8_t **)&pColData->aOffset, szOffset)) goto _exit;
+  if (pCached->nData && tRealloc(&pColData->pData, pCached->nData)) goto _exit;
+
+  if (szBitMap) memcpy(pColData->pBitMap, pCached->pBitMap, szBitMap);
+  if (szOffset) memcpy(pColData->aOffset, pCached->aOffset, szOffset);
+  if (pCached->nData) memcpy(pColData->pData, pCached->pData, pCached->nData);
+
+  pColData->smaOn = pCached->smaOn;
+  pColData->numOfNone = pCached->numOfNone;
+  pColData->numOfNull = pCached->numOfNull;
+  pColData->numOfValue = pCached->numOfValue;
+  pColData->nVal = pCached->nVal;
+  pColData->flag = pCached->flag;
+  pColData->nData = pCached->nData;
+  pColData->nDict = pCached->nDict;
+  hit = true;
+
+_exit:
+  taosLRUCacheRelease(pCache, h, false);
+  return hit;
+}
+
+int32_t tsdbBCachePutColData(STsdb *pTsdb, int32_t ftype, int32_t fid, int64_t fcid, int64_t offset,
+                             const SColData *pColData) {
+  SLRUCache *pCache = pTsdb->bCache;
+  SBCacheKey key;
+
+  if (pCache == NULL) return 0;
+
+  // the column data is kept in one piece: SColData | bitmap | offset | data
+  int32_t szBitMap = tsdbColDataBitmapSize(pColData);
+  int32_t szOffset = tsdbColDataOffsetSize(pColData);
+  size_t  charge = sizeof(SColData) + szBitMap + szOffset + pColData->nData;
+
+  SColData *pCached = taosMemoryMalloc(charge);
+  if (pCached == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+  uint8_t *p = (uint8_t *)&pCached[1];
+  *pCached = *pColData;
+  pCached->pBitMap = szBitMap ? p : NULL;
+  memcpy(p, pColData->pBitMap, szBitMap);
+  p += szBitMap;
+  pCached->aOffset = szOffset ? (int32_t *)p : NULL;
+  memcpy(p, pColData->aOffset, szOffset);
+  p += szOffset;
+  pCached->pData = pColData->nData ? p : NULL;
+  memcpy(p, pColData->pData, pColData->nData);
+
+  getBCacheKey(ftype, fid, fcid, offset, pColData->cid, &key);
+  LRUStatus status =
+      taosLRUCacheInsert(pCache, &key, sizeof(key), pCached, charge, deleteBCache, NULL, TAOS_LRU_PRIORITY_LOW, NULL);
+  if (status != TAOS_LRU_STATUS_OK && status != TAOS_LRU_STATUS_OK_OVERWRITTEN) {
+    tsdbTrace("vgId:%d, block cache insert failed, status:%d", TD_VID(pTsdb->pVnode), status);
+  }
+
+  return 0;
+}
@@ -127,6 +127,7 @@ int32_t tsdbReuseCacherowsReader(void* reader, void* pTableIdList, int32_t numOf
   pReader->pTableList = pTableIdList;
   pReader->numOfTables = numOfTables;
   pReader->lastTs = INT64_MIN;
+  taosMemoryFreeClear(pReader->pStoreSlots);
   pReader->pLDataIterArray = destroySttBlockReader(pReader->pLDataIterArray, NULL);
   pReader->pLDataIterArray = taosArrayInit(4, POINTER_BYTES);
 
@@ -232,6 +233,10 @@ void* tsdbCacherowsReaderClose(void* pReader) {
     taosMemoryFree(p->uidList);
   }
 
+  tsdbCacheReleaseStore(p->pLastStore);
+  taosMemoryFree(p->pStoreCols);
+  taosMemoryFree(p->pStoreSlots);
+
   taosMemoryFree(pReader);
   return NULL;
 }
@@ -320,7 +325,7 @@ int32_t tsdbRetrieveCacheRows(void* pReader, SSDataBlock* pResBlock, const int32
     for (int32_t i = 0; i < pr->numOfTables; ++i) {
       tb_uid_t uid = pTableList[i].uid;
 
-      tsdbCacheGetBatch(pr->pTsdb, uid, pRow, pr, ltype);
+      tsdbCacheGetTableBatch(pr->pTsdb, i, pRow, pr, ltype);
       if (TARRAY_SIZE(pRow) <= 0 || COL_VAL_IS_NONE(&((SLastCol*)TARRAY_DATA(pRow))[0].colVal)) {
         taosArrayClearEx(pRow, freeItem);
         continue;
@@ -393,7 +398,7 @@ int32_t tsdbRetrieveCacheRows(void* pReader, SSDataBlock* pResBlock, const int32
     for (int32_t i = pr->tableIndex; i < pr->numOfTables; ++i) {
       tb_uid_t uid = pTableList[i].uid;
 
-      tsdbCacheGetBatch(pr->pTsdb, uid, pRow, pr, ltype);
+      tsdbCacheGetTableBatch(pr->pTsdb, i, pRow, pr, ltype);
       if (TARRAY_SIZE(pRow) <= 0 || COL_VAL_IS_NONE(&((SLastCol*)TARRAY_DATA(pRow))[0].colVal)) {
         taosArrayClearEx(pRow, freeItem);
         continue;
@@ -14,6 +14,7 @@
  */
 
 #include "tsdbCommit2.h"
+#include "vnd.h"
 
 // extern dependencies
 typedef struct {
@@ -451,6 +452,305 @@ _exit:
   return code;
 }
 
+// parallel commit: the file sets a memtable without tombstones touches are known before committing any of them, so
+// each one is committed by its own SCommitter2 and the file operations are concatenated in fid order at the end
+typedef struct {
+  int32_t fid;
+  TSKEY   maxKey;
+  int64_t nRow;
+} SCommitFid;
+
+typedef TARRAY2(SCommitFid) TCommitFidArray;
+
+typedef struct {
+  SCommitter2    *committer;
+  TCommitFidArray fidArray[1];
+  TFileOpArray   *fopArrays;
+  int32_t         nextFid;
+  int32_t         nRunning;
+  int32_t         nRef;
+  int64_t         rowBytes;
+  int64_t         budget;
+  int64_t         inUse;
+  int32_t         code;
+  TdThreadMutex   mutex;
+  TdThreadCond    cond;
+} SCommitParallel;
+
+static int32_t tsdbCommitFidCmprFn(const SCommitFid *fid1, const SCommitFid *fid2) {
+  if (fid1->fid < fid2->fid) return -1;
+  if (fid1->fid > fid2->fid) return 1;
+  return 0;
+}
+
+static int32_t tsdbCommitAddFid(SCommitter2 *committer, TCommitFidArray *fidArray, int32_t fid, int64_t nRow) {
+  SCommitFid  key = {.fid = fid};
+  SCommitFid *commitFid = TARRAY2_SEARCH(fidArray, &key, tsdbCommitFidCmprFn, TD_EQ);
+
+  if (commitFid == NULL) {
+    TSKEY minKey;
+    tsdbFidKeyRange(fid, committer->minutes, committer->precision, &minKey, &key.maxKey);
+    key.nRow = nRow;
+    return TARRAY2_SORT_INSERT(fidArray, key, tsdbCommitFidCmprFn);
+  }
+
+  commitFid->nRow += nRow;
+  return 0;
+}
+
+// the file sets of a table come from its key range, a table across file sets seeks to the first row of each file set
+// it has rows in, and its rows are shared among them by key range, which is enough for the memory budget
+static int32_t tsdbCommitCollectFids(SCommitter2 *committer, TCommitFidArray *fidArray) {
+  int32_t     code = 0;
+  int32_t     lino = 0;
+  SMemTable  *imem = committer->tsdb->imem;
+  SRBTreeIter iter[1] = {tRBTreeIterCreate(imem->tbDataTree, 1)};
+
+  for (SRBTreeNode *node = tRBTreeIterNext(iter); node; node = tRBTreeIterNext(iter)) {
+    STbData *tbData = TCONTAINER_OF(node, STbData, rbtn);
+
+    if (tbData->sl.size == 0) continue;
+
+    int32_t minFid = tsdbKeyFid(tbData->minKey, committer->minutes, committer->precision);
+    int32_t maxFid = tsdbKeyFid(tbData->maxKey, committer->minutes, committer->precision);
+    if (minFid == maxFid) {
+      code = tsdbCommitAddFid(committer, fidArray, minFid, tbData->sl.size);
+      TSDB_CHECK_CODE(code, lino, _exit);
+      continue;
+    }
+
+    double span = (double)tbData->maxKey - (double)tbData->minKey + 1;
+    for (TSKEY from = tbData->minKey; from <= tbData->maxKey;) {
+      STbDataIter tbIter[1];
+      TSDBKEY     fromKey = {.version = VERSION_MIN, .ts = from};
+      TSDBROW    *row;
+
+      tsdbTbDataIterOpen(tbData, &fromKey, 0, tbIter);
+      if ((row = tsdbTbDataIterGet(tbIter)) == NULL) break;
+
+      TSKEY   fidMinKey, fidMaxKey;
+      int32_t fid = tsdbKeyFid(TSDBROW_TS(row), committer->minutes, committer->precision);
+      tsdbFidKeyRange(fid, committer->minutes, committer->precision, &fidMinKey, &fidMaxKey);
+
+      double  share = ((double)TMIN(fidMaxKey, tbData->maxKey) - (double)TMAX(fidMinKey, tbData->minKey) + 1) / span;
+      int64_t nRow = TMAX((int64_t)(tbData->sl.size * share), 1);
+      code = tsdbCommitAddFid(committer, fidArray, fid, nRow);
+      TSDB_CHECK_CODE(code, lino, _exit);
+
+      if (fidMaxKey >= tbData->maxKey) break;
+      from = fidMaxKey + 1;
+    }
+  }
+
+_exit:
+  if (code) {
+    TSDB_ERROR_LOG(TD_VID(committer->tsdb->pVnode), lino, code);
+  }
+  return code;
+}
+
+static int32_t tsdbCommitOneFid(SCommitParallel *parallel, int32_t idx) {
+  int32_t      code = 0;
+  int32_t      lino = 0;
+  SCommitter2 *committer = parallel->committer;
+  SCommitter2  fsetCommitter[1] = {0};
+
+  fsetCommitter->tsdb = committer->tsdb;
+  fsetCommitter->fsetArr = committer->fsetArr;
+  fsetCommitter->minutes = committer->minutes;
+  fsetCommitter->precision = committer->precision;
+  fsetCommitter->minRow = committer->minRow;
+  fsetCommitter->maxRow = committer->maxRow;
+  fsetCommitter->cmprAlg = committer->cmprAlg;
+  fsetCommitter->sttTrigger = committer->sttTrigger;
+  fsetCommitter->szPage = committer->szPage;
+  fsetCommitter->compactVersion = committer->compactVersion;
+  fsetCommitter->ctx->cid = committer->ctx->cid;
+  fsetCommitter->ctx->now = committer->ctx->now;
+  fsetCommitter->ctx->maxDelKey = TSKEY_MIN;
+
+  TSKEY maxKey;
+  tsdbFidKeyRange(TARRAY2_GET(parallel->fidArray, idx).fid, committer->minutes, committer->precision,
+                  &fsetCommitter->ctx->nextKey, &maxKey);
+
+  code = tsdbCommitFileSet(fsetCommitter);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  parallel->fopArrays[idx] = fsetCommitter->fopArray[0];
+  TARRAY2_INIT(fsetCommitter->fopArray);
+
+_exit:
+  if (code) {
+    TSDB_ERROR_LOG(TD_VID(committer->tsdb->pVnode), lino, code);
+  }
+  TARRAY2_DESTROY(fsetCommitter->dataIterArray, NULL);
+  TARRAY2_DESTROY(fsetCommitter->tombIterArray, NULL);
+  TARRAY2_DESTROY(fsetCommitter->sttReaderArray, NULL);
+  TARRAY2_DESTROY(fsetCommitter->fopArray, NULL);
+  return code;
+}
+
+// a file set is started when the memtable rows of the file sets in flight fit the budget, or when nothing else is in
+// flight so that a file set larger than the budget is still committed, alone
+static void tsdbCommitParallelLoop(SCommitParallel *parallel) {
+  for (;;) {
+    taosThreadMutexLock(&parallel->mutex);
+    while (parallel->code == 0 && parallel->nextFid < TARRAY2_SIZE(parallel->fidArray) && parallel->nRunning > 0 &&
+           parallel->inUse + TARRAY2_GET(parallel->fidArray, parallel->nextFid).nRow * parallel->rowBytes >
+               parallel->budget) {
+      taosThreadCondWait(&parallel->cond, &parallel->mutex);
+    }
+    if (parallel->code || parallel->nextFid >= TARRAY2_SIZE(parallel->fidArray)) {
+      taosThreadMutexUnlock(&parallel->mutex);
+      break;
+    }
+    int32_t idx = parallel->nextFid++;
+    int64_t size = TARRAY2_GET(parallel->fidArray, idx).nRow * parallel->rowBytes;
+    parallel->inUse += size;
+    parallel->nRunning++;
+    taosThreadMutexUnlock(&parallel->mutex);
+
+    int32_t code = tsdbCommitOneFid(parallel, idx);
+
+    taosThreadMutexLock(&parallel->mutex);
+    parallel->inUse -= size;
+    parallel->nRunning--;
+    if (code && parallel->code == 0) {
+      parallel->code = code;
+    }
+    taosThreadCondBroadcast(&parallel->cond);
+    taosThreadMutexUnlock(&parallel->mutex);
+  }
+}
+
+static void tsdbCommitParallelUnref(SCommitParallel *parallel) {
+  taosThreadMutexLock(&parallel->mutex);
+  bool last = (--parallel->nRef == 0);
+  taosThreadMutexUnlock(&parallel->mutex);
+
+  if (last) {
+    taosThreadCondDestroy(&parallel->cond);
+    taosThreadMutexDestroy(&parallel->mutex);
+    taosMemoryFree(parallel);
+  }
+}
+
+// a helper of the commit on the vnode commit pool, it may start after the commit is over and find nothing left
+static int32_t tsdbCommitParallelTask(void *arg) {
+  SCommitParallel *parallel = (SCommitParallel *)arg;
+
+  tsdbCommitParallelLoop(parallel);
+  tsdbCommitParallelUnref(parallel);
+  return 0;
+}
+
+// the commit runs the file sets itself along with its helpers and only waits for those in flight, never for a helper
+// still queued, so that commits waiting on each other's helpers cannot hold all the pool threads
+static int32_t tsdbCommitParallel(SCommitter2 *committer, TCommitFidArray *fidArray) {
+  int32_t          code = 0;
+  int32_t          lino = 0;
+  STsdb           *tsdb = committer->tsdb;
+  SCommitParallel *parallel = NULL;
+  TFileOpArray    *fopArrays = NULL;
+  int32_t          nHelper = TMIN(tsCommitFileSetThreads, TARRAY2_SIZE(fidArray)) - 1;
+  int32_t          nScheduled = 0;
+
+  parallel = taosMemoryCalloc(1, sizeof(*parallel));
+  fopArrays = taosMemoryCalloc(TARRAY2_SIZE(fidArray), sizeof(TFileOpArray));
+  if (parallel == NULL || fopArrays == NULL) {
+    taosMemoryFree(parallel);
+    parallel = NULL;
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  parallel->committer = committer;
+  parallel->fidArray[0] = fidArray[0];
+  parallel->fopArrays = fopArrays;
+  parallel->nRef = 1;
+  parallel->rowBytes = TMAX(tsdb->imem->pPool->size / tsdb->imem->nRow, 1);
+  parallel->budget = (int64_t)tsCommitMemBudget << 20;
+  taosThreadMutexInit(&parallel->mutex, NULL);
+  taosThreadCondInit(&parallel->cond, NULL);
+
+  for (; nScheduled < nHelper; nScheduled++) {
+    taosThreadMutexLock(&parallel->mutex);
+    parallel->nRef++;
+    taosThreadMutexUnlock(&parallel->mutex);
+
+    if (vnodeScheduleTaskEx(VND_TASK_COMMIT, TD_VID(tsdb->pVnode), tsdbCommitParallelTask, parallel) != 0) {
+      tsdbWarn("vgId:%d failed to schedule commit helper, commit with %d helpers", TD_VID(tsdb->pVnode), nScheduled);
+      tsdbCommitParallelUnref(parallel);
+      break;
+    }
+  }
+
+  tsdbCommitParallelLoop(parallel);
+
+  taosThreadMutexLock(&parallel->mutex);
+  while (parallel->nRunning > 0) {
+    taosThreadCondWait(&parallel->cond, &parallel->mutex);
+  }
+  code = parallel->code;
+  taosThreadMutexUnlock(&parallel->mutex);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  for (int32_t i = 0; i < TARRAY2_SIZE(fidArray); i++) {
+    code = TARRAY2_APPEND_BATCH(committer->fopArray, TARRAY2_DATA(&fopArrays[i]), TARRAY2_SIZE(&fopArrays[i]));
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+_exit:
+  if (code) {
+    TSDB_ERROR_LOG(TD_VID(tsdb->pVnode), lino, code);
+  } else {
+    tsdbDebug("vgId:%d %s done, %d file sets with %d helpers", TD_VID(tsdb->pVnode), __func__, TARRAY2_SIZE(fidArray),
+              nScheduled);
+  }
+  if (parallel) {
+    tsdbCommitParallelUnref(parallel);
+  }
+  if (fopArrays) {
+    for (int32_t i = 0; i < TARRAY2_SIZE(fidArray); i++) {
+      TARRAY2_DESTROY(&fopArrays[i], NULL);
+    }
+    taosMemoryFree(fopArrays);
+  }
+  return code;
+}
+
+static int32_t tsdbCommitFileSets(SCommitter2 *committer) {
+  int32_t         code = 0;
+  int32_t         lino = 0;
+  SMemTable      *imem = committer->tsdb->imem;
+  TCommitFidArray fidArray[1] = {0};
+
+  // tombstones may spread to file sets with no rows in the memtable, leave them to the file set by file set commit
+  if (tsCommitFileSetThreads > 1 && imem->nDel == 0 &&
+      tsdbKeyFid(imem->minKey, committer->minutes, committer->precision) !=
+          tsdbKeyFid(imem->maxKey, committer->minutes, committer->precision)) {
+    code = tsdbCommitCollectFids(committer, fidArray);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  if (TARRAY2_SIZE(fidArray) > 1) {
+    code = tsdbCommitParallel(committer, fidArray);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  } else {
+    while (committer->ctx->nextKey != TSKEY_MAX) {
+      code = tsdbCommitFileSet(committer);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  }
+
+_exit:
+  if (code) {
+    TSDB_ERROR_LOG(TD_VID(committer->tsdb->pVnode), lino, code);
+  }
+  TARRAY2_DESTROY(fidArray, NULL);
+  return code;
+}
+
 static int32_t tsdbOpenCommitter(STsdb *tsdb, SCommitInfo *info, SCommitter2 *committer) {
   int32_t code = 0;
   int32_t lino = 0;
@@ -572,10 +872,8 @@ int32_t tsdbCommitBegin(STsdb *tsdb, SCommitInfo *info) {
     code = tsdbOpenCommitter(tsdb, info, committer);
     TSDB_CHECK_CODE(code, lino, _exit);
 
-    while (committer->ctx->nextKey != TSKEY_MAX) {
-      code = tsdbCommitFileSet(committer);
-      TSDB_CHECK_CODE(code, lino, _exit);
-    }
+    code = tsdbCommitFileSets(committer);
+    TSDB_CHECK_CODE(code, lino, _exit);
 
     code = tsdbCloseCommitter(committer, code);
     TSDB_CHECK_CODE(code, lino, _exit);
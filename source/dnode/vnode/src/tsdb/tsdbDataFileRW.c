@@ -334,7 +334,10 @@ int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRe
             code = tColDataAppendValue(colData, &COL_VAL_NULL(blockCol->cid, blockCol->type));
             TSDB_CHECK_CODE(code, lino, _exit);
           }
-        } else {
+        } else if (!tsdbBCacheGetColData(reader->config->tsdb, TSDB_FTYPE_DATA,
+                                         reader->config->files[TSDB_FTYPE_DATA].file.fid,
+                                         reader->config->files[TSDB_FTYPE_DATA].file.cid, record->blockOffset,
+                                         colData)) {
           int32_t size1 = blockCol->szBitmap + blockCol->szOffset + blockCol->szValue;
 
           code = tRealloc(&reader->config->bufArr[1], size1);
@@ -348,6 +351,11 @@ int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRe
           code = tsdbDecmprColData(reader->config->bufArr[1], blockCol, hdr->cmprAlg, hdr->nRow, colData,
                                    &reader->config->bufArr[2]);
           TSDB_CHECK_CODE(code, lino, _exit);
+
+          code = tsdbBCachePutColData(reader->config->tsdb, TSDB_FTYPE_DATA,
+                                      reader->config->files[TSDB_FTYPE_DATA].file.fid,
+                                      reader->config->files[TSDB_FTYPE_DATA].file.cid, record->blockOffset, colData);
+          TSDB_CHECK_CODE(code, lino, _exit);
         }
       }
     }
@@ -17,8 +17,6 @@
 #include "tsdbUpgrade.h"
 #include "vnd.h"
 
-extern int vnodeScheduleTask(int (*execute)(void *), void *arg);
-extern int vnodeScheduleTaskEx(int tpid, int (*execute)(void *), void *arg);
 
 #define TSDB_FS_EDIT_MIN TSDB_FEDIT_COMMIT
 #define TSDB_FS_EDIT_MAX (TSDB_FEDIT_MERGE + 1)
@@ -736,6 +734,13 @@ int32_t tsdbFSDestroyRefSnapshot(TFileSetArray **fsetArr) {
 
 const char *gFSBgTaskName[] = {NULL, "MERGE", "RETENTION", "COMPACT"};
 
+static int32_t tsdbFSRunBgTask(void *arg);
+
+static int32_t tsdbFSLaunchBgTask(STFileSystem *fs) {
+  EVndTaskClass taskClass = (fs->bgTaskRunning->type == TSDB_BG_TASK_RETENTION) ? VND_TASK_RETENTION : VND_TASK_MERGE;
+  return vnodeScheduleTaskEx(taskClass, TD_VID(fs->tsdb->pVnode), tsdbFSRunBgTask, fs);
+}
+
 static int32_t tsdbFSRunBgTask(void *arg) {
   STFileSystem *fs = (STFileSystem *)arg;
 
@@ -772,7 +777,7 @@ static int32_t tsdbFSRunBgTask(void *arg) {
       fs->bgTaskRunning->prev->next = fs->bgTaskRunning->next;
       fs->bgTaskRunning->next->prev = fs->bgTaskRunning->prev;
       fs->bgTaskNum--;
-      vnodeScheduleTaskEx(1, tsdbFSRunBgTask, arg);
+      tsdbFSLaunchBgTask(fs);
     }
   }
 
@@ -813,7 +818,7 @@ static int32_t tsdbFSScheduleBgTaskImpl(STFileSystem *fs, EFSBgTaskT   type, int
   if (fs->bgTaskRunning == NULL && fs->bgTaskNum == 0) {
     // launch task directly
     fs->bgTaskRunning = task;
-    vnodeScheduleTaskEx(1, tsdbFSRunBgTask, fs);
+    tsdbFSLaunchBgTask(fs);
   } else {
     // add to the queue tail
     fs->bgTaskNum++;
@@ -34,9 +34,35 @@
 static void    tbDataMovePosTo(STbData *pTbData, SMemSkipListNode **pos, TSDBKEY *pKey, int32_t flags);
 static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid_t uid, STbData **ppTbData);
 static int32_t tsdbInsertRowDataToTable(SMemTable *pMemTable, STbData *pTbData, int64_t version,
-                                        SSubmitTbData *pSubmitTbData, int32_t *affectedRows);
+                                        SSubmitTbData *pSubmitTbData, bool inBufPool, int32_t *affectedRows);
 static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData, int64_t version,
-                                        SSubmitTbData *pSubmitTbData, int32_t *affectedRows);
+                                        SSubmitTbData *pSubmitTbData, bool inBufPool, int32_t *affectedRows);
+
+/*
+ * Inserts of different tables may run on several threads (see numOfVnodeInsertThreads), while a table is only written
+ * by one thread at a time. So the skiplist of a table keeps its single writer, and what is shared is made safe here:
+ * 1. STbData lookup is lock-free. A new STbData is published into its bucket atomically, and rehash never frees the old
+ *    bucket array, so a lookup racing with rehash at worst misses, and then retries under the latch;
+ * 2. the SMemTable key/version range and row count are updated atomically;
+ * 3. the buffer pool is locked when there are insert threads.
+ */
+static FORCE_INLINE void tsdbAtomicMin64(int64_t *ptr, int64_t val) {
+  int64_t old = atomic_load_64(ptr);
+  while (val < old) {
+    int64_t cur = atomic_val_compare_exchange_64(ptr, old, val);
+    if (cur == old) break;
+    old = cur;
+  }
+}
+
+static FORCE_INLINE void tsdbAtomicMax64(int64_t *ptr, int64_t val) {
+  int64_t old = atomic_load_64(ptr);
+  while (val > old) {
+    int64_t cur = atomic_val_compare_exchange_64(ptr, old, val);
+    if (cur == old) break;
+    old = cur;
+  }
+}
 
 static int32_t tTbDataCmprFn(const SRBTreeNode *n1, const SRBTreeNode *n2) {
   STbData *tbData1 = TCONTAINER_OF(n1, STbData, rbtn);
@@ -90,24 +116,32 @@ void tsdbMemTableDestroy(SMemTable *pMemTable, bool proactive) {
   if (pMemTable) {
     vnodeBufPoolUnRef(pMemTable->pPool, proactive);
     taosMemoryFree(pMemTable->aBucket);
+    taosArrayDestroyP(pMemTable->aRetiredBucket, taosMemoryFree);
     taosMemoryFree(pMemTable);
   }
 }
 
 static FORCE_INLINE STbData *tsdbGetTbDataFromMemTableImpl(SMemTable *pMemTable, tb_uid_t suid, tb_uid_t uid) {
-  STbData *pTbData = pMemTable->aBucket[TABS(uid) % pMemTable->nBucket];
+  // rehash publishes the new bucket array before its size, so the index is always inside the loaded array
+  int32_t   nBucket = atomic_load_32(&pMemTable->nBucket);
+  STbData **aBucket = (STbData **)atomic_load_ptr(&pMemTable->aBucket);
+  STbData  *pTbData = (STbData *)atomic_load_ptr(&aBucket[TABS(uid) % nBucket]);
 
   while (pTbData) {
     if (pTbData->uid == uid) break;
-    pTbData = pTbData->next;
+    pTbData = (STbData *)atomic_load_ptr(&pTbData->next);
   }
 
   return pTbData;
 }
 
 STbData *tsdbGetTbDataFromMemTable(SMemTable *pMemTable, tb_uid_t suid, tb_uid_t uid) {
-  STbData *pTbData;
+  STbData *pTbData = tsdbGetTbDataFromMemTableImpl(pMemTable, suid, uid);
+  if (pTbData) {
+    return pTbData;
+  }
 
+  // the lock-free lookup may miss a table being moved by rehash
   taosRLockLatch(&pMemTable->latch);
   pTbData = tsdbGetTbDataFromMemTableImpl(pMemTable, suid, uid);
   taosRUnLockLatch(&pMemTable->latch);
@@ -115,7 +149,8 @@ STbData *tsdbGetTbDataFromMemTable(SMemTable *pMemTable, tb_uid_t suid, tb_uid_t
   return pTbData;
 }
 
-int32_t tsdbInsertTableData(STsdb *pTsdb, int64_t version, SSubmitTbData *pSubmitTbData, int32_t *affectedRows) {
+int32_t tsdbInsertTableData(STsdb *pTsdb, int64_t version, SSubmitTbData *pSubmitTbData, bool inBufPool,
+                            int32_t *affectedRows) {
   int32_t    code = 0;
   SMemTable *pMemTable = pTsdb->mem;
   STbData   *pTbData = NULL;
@@ -130,15 +165,15 @@ int32_t tsdbInsertTableData(STsdb *pTsdb, int64_t version, SSubmitTbData *pSubmi
 
   // do insert impl
   if (pSubmitTbData->flags & SUBMIT_REQ_COLUMN_DATA_FORMAT) {
-    code = tsdbInsertColDataToTable(pMemTable, pTbData, version, pSubmitTbData, affectedRows);
+    code = tsdbInsertColDataToTable(pMemTable, pTbData, version, pSubmitTbData, inBufPool, affectedRows);
   } else {
-    code = tsdbInsertRowDataToTable(pMemTable, pTbData, version, pSubmitTbData, affectedRows);
+    code = tsdbInsertRowDataToTable(pMemTable, pTbData, version, pSubmitTbData, inBufPool, affectedRows);
   }
   if (code) goto _err;
 
   // update
-  pMemTable->minVer = TMIN(pMemTable->minVer, version);
-  pMemTable->maxVer = TMAX(pMemTable->maxVer, version);
+  tsdbAtomicMin64(&pMemTable->minVer, version);
+  tsdbAtomicMax64(&pMemTable->maxVer, version);
 
   return code;
 
@@ -334,9 +369,15 @@ void tsdbMemTableCountRows(SMemTable *pMemTable, SSHashObj *pTableMap, int64_t *
 static int32_t tsdbMemTableRehash(SMemTable *pMemTable) {
   int32_t code = 0;
 
+  if (pMemTable->aRetiredBucket == NULL && (pMemTable->aRetiredBucket = taosArrayInit(4, POINTER_BYTES)) == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
   int32_t   nBucket = pMemTable->nBucket * 2;
   STbData **aBucket = (STbData **)taosMemoryCalloc(nBucket, sizeof(STbData *));
-  if (aBucket == NULL) {
+  if (aBucket == NULL || taosArrayPush(pMemTable->aRetiredBucket, &pMemTable->aBucket) == NULL) {
+    taosMemoryFree(aBucket);
     code = TSDB_CODE_OUT_OF_MEMORY;
     goto _exit;
   }
@@ -348,16 +389,15 @@ static int32_t tsdbMemTableRehash(SMemTable *pMemTable) {
       STbData *pNext = pTbData->next;
 
       int32_t idx = TABS(pTbData->uid) % nBucket;
-      pTbData->next = aBucket[idx];
+      atomic_store_ptr(&pTbData->next, aBucket[idx]);
       aBucket[idx] = pTbData;
 
       pTbData = pNext;
     }
   }
 
-  taosMemoryFree(pMemTable->aBucket);
-  pMemTable->nBucket = nBucket;
-  pMemTable->aBucket = aBucket;
+  atomic_store_ptr(&pMemTable->aBucket, aBucket);
+  atomic_store_32(&pMemTable->nBucket, nBucket);
 
 _exit:
   return code;
@@ -404,6 +444,14 @@ static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid
 
   taosWLockLatch(&pMemTable->latch);
 
+  // the table may be created by another insert thread in the meantime, the allocated one is left in the pool
+  STbData *pExist = tsdbGetTbDataFromMemTableImpl(pMemTable, suid, uid);
+  if (pExist) {
+    taosWUnLockLatch(&pMemTable->latch);
+    pTbData = pExist;
+    goto _exit;
+  }
+
   if (pMemTable->nTbData >= pMemTable->nBucket) {
     code = tsdbMemTableRehash(pMemTable);
     if (code) {
@@ -414,7 +462,7 @@ static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid
 
   int32_t idx = TABS(uid) % pMemTable->nBucket;
   pTbData->next = pMemTable->aBucket[idx];
-  pMemTable->aBucket[idx] = pTbData;
+  atomic_store_ptr(&pMemTable->aBucket[idx], pTbData);
   pMemTable->nTbData++;
 
   tRBTreePut(pMemTable->tbDataTree, pTbData->rbtn);
@@ -510,9 +558,9 @@ static void tbDataMovePosTo(STbData *pTbData, SMemSkipListNode **pos, TSDBKEY *p
   }
 }
 
-static FORCE_INLINE int8_t tsdbMemSkipListRandLevel(SMemSkipList *pSl) {
+static FORCE_INLINE int8_t tsdbMemSkipListRandLevel(SMemSkipList *pSl, int8_t curLevel) {
   int8_t level = 1;
-  int8_t tlevel = TMIN(pSl->maxLevel, pSl->level + 1);
+  int8_t tlevel = TMIN(pSl->maxLevel, curLevel + 1);
 
   while ((taosRandR(&pSl->seed) & 0x3) == 0 && level < tlevel) {
     level++;
@@ -520,35 +568,77 @@ static FORCE_INLINE int8_t tsdbMemSkipListRandLevel(SMemSkipList *pSl) {
 
   return level;
 }
-static int32_t tbDataDoPut(SMemTable *pMemTable, STbData *pTbData, SMemSkipListNode **pos, TSDBROW *pRow,
-                           int8_t forward) {
-  int32_t           code = 0;
+
+// the nodes of the rows of one submission, and the rows too unless they are already in the buffer pool, are carved
+// from a single allocation, so their levels are drawn before any of them is put
+typedef struct {
+  char   *pBuf;
+  int8_t *aLevel;
+  int32_t iNode;
+  bool    copyRow;
+  int8_t  aLevelBuf[256];
+} SMemNodeAlloc;
+
+static int32_t tbDataAllocNodes(SMemTable *pMemTable, STbData *pTbData, int32_t nRow, SRow **aRow, bool copyRow,
+                                SMemNodeAlloc *pAlloc) {
+  SVBufPool *pPool = pMemTable->pTsdb->pVnode->inUse;
+  int8_t     level = pTbData->sl.level;
+  int64_t    size = 0;
+
+  pAlloc->iNode = 0;
+  pAlloc->copyRow = copyRow;
+  if (nRow <= sizeof(pAlloc->aLevelBuf)) {
+    pAlloc->aLevel = pAlloc->aLevelBuf;
+  } else if ((pAlloc->aLevel = taosMemoryMalloc(nRow)) == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t iRow = 0; iRow < nRow; iRow++) {
+    pAlloc->aLevel[iRow] = tsdbMemSkipListRandLevel(&pTbData->sl, level);
+    level = TMAX(level, pAlloc->aLevel[iRow]);
+    size += SL_NODE_SIZE(pAlloc->aLevel[iRow]);
+    if (copyRow) {
+      size += ALIGN8(aRow[iRow]->len);
+    }
+  }
+
+  if (size > INT32_MAX || (pAlloc->pBuf = vnodeBufPoolMallocAligned(pPool, size)) == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  return 0;
+}
+
+static void tbDataFreeNodeAlloc(SMemNodeAlloc *pAlloc) {
+  if (pAlloc->aLevel != NULL && pAlloc->aLevel != pAlloc->aLevelBuf) {
+    taosMemoryFree(pAlloc->aLevel);
+  }
+  pAlloc->aLevel = NULL;
+}
+
+static void tbDataDoPut(STbData *pTbData, SMemSkipListNode **pos, TSDBROW *pRow, SMemNodeAlloc *pAlloc,
+                        int8_t forward) {
   int8_t            level;
   SMemSkipListNode *pNode = NULL;
-  SVBufPool        *pPool = pMemTable->pTsdb->pVnode->inUse;
   int64_t           nSize;
 
   // create node
-  level = tsdbMemSkipListRandLevel(&pTbData->sl);
+  level = pAlloc->aLevel[pAlloc->iNode++];
   nSize = SL_NODE_SIZE(level);
-  if (pRow->type == TSDBROW_ROW_FMT) {
-    pNode = (SMemSkipListNode *)vnodeBufPoolMallocAligned(pPool, nSize + pRow->pTSRow->len);
-  } else if (pRow->type == TSDBROW_COL_FMT) {
-    pNode = (SMemSkipListNode *)vnodeBufPoolMallocAligned(pPool, nSize);
-  } else {
-    ASSERT(0);
-  }
-  if (pNode == NULL) {
-    code = TSDB_CODE_OUT_OF_MEMORY;
-    goto _exit;
-  }
+  pNode = (SMemSkipListNode *)pAlloc->pBuf;
+  pAlloc->pBuf += nSize;
 
   pNode->level = level;
   pNode->flag = pRow->type;
   if (pRow->type == TSDBROW_ROW_FMT) {
     pNode->version = pRow->version;
-    pNode->pData = (char *)pNode + nSize;
-    memcpy(pNode->pData, pRow->pTSRow, pRow->pTSRow->len);
+    if (pAlloc->copyRow) {
+      pNode->pData = pAlloc->pBuf;
+      memcpy(pNode->pData, pRow->pTSRow, pRow->pTSRow->len);
+      pAlloc->pBuf += ALIGN8(pRow->pTSRow->len);
+    } else {
+      pNode->pData = pRow->pTSRow;
+    }
   } else if (pRow->type == TSDBROW_COL_FMT) {
     pNode->iRow = pRow->iRow;
     pNode->pData = pRow->pBlockData;
@@ -594,14 +684,12 @@ static int32_t tbDataDoPut(SMemTable *pMemTable, STbData *pTbData, SMemSkipListN
   if (pTbData->sl.level < pNode->level) {
     pTbData->sl.level = pNode->level;
   }
-
-_exit:
-  return code;
 }
 
 static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData, int64_t version,
-                                        SSubmitTbData *pSubmitTbData, int32_t *affectedRows) {
-  int32_t code = 0;
+                                        SSubmitTbData *pSubmitTbData, bool inBufPool, int32_t *affectedRows) {
+  int32_t       code = 0;
+  SMemNodeAlloc nodeAlloc = {0};
 
   SVBufPool *pPool = pMemTable->pTsdb->pVnode->inUse;
   int32_t    nColData = TARRAY_SIZE(pSubmitTbData->aCol);
@@ -611,7 +699,7 @@ static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData,
   ASSERT(aColData[0].type == TSDB_DATA_TYPE_TIMESTAMP);
   ASSERT(aColData[0].flag == HAS_VALUE);
 
-  // copy and construct block data
+  // construct block data, the columns are copied unless they are in the buffer pool already
   SBlockData *pBlockData = vnodeBufPoolMalloc(pPool, sizeof(*pBlockData));
   if (pBlockData == NULL) {
     code = TSDB_CODE_OUT_OF_MEMORY;
@@ -631,12 +719,16 @@ static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData,
     pBlockData->aVersion[i] = version;
   }
 
-  pBlockData->aTSKEY = vnodeBufPoolMalloc(pPool, aColData[0].nData);
-  if (pBlockData->aTSKEY == NULL) {
-    code = TSDB_CODE_OUT_OF_MEMORY;
-    goto _exit;
+  if (inBufPool) {
+    pBlockData->aTSKEY = (TSKEY *)aColData[0].pData;
+  } else {
+    pBlockData->aTSKEY = vnodeBufPoolMalloc(pPool, aColData[0].nData);
+    if (pBlockData->aTSKEY == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+    memcpy(pBlockData->aTSKEY, aColData[0].pData, aColData[0].nData);
   }
-  memcpy(pBlockData->aTSKEY, aColData[0].pData, aColData[0].nData);
 
   pBlockData->nColData = nColData - 1;
   pBlockData->aColData = vnodeBufPoolMalloc(pPool, sizeof(SColData) * pBlockData->nColData);
@@ -645,11 +737,19 @@ static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData,
     goto _exit;
   }
 
-  for (int32_t iColData = 0; iColData < pBlockData->nColData; ++iColData) {
-    code = tColDataCopy(&aColData[iColData + 1], &pBlockData->aColData[iColData], (xMallocFn)vnodeBufPoolMalloc, pPool);
-    if (code) goto _exit;
+  if (inBufPool) {
+    memcpy(pBlockData->aColData, &aColData[1], sizeof(SColData) * pBlockData->nColData);
+  } else {
+    for (int32_t iColData = 0; iColData < pBlockData->nColData; ++iColData) {
+      code =
+          tColDataCopy(&aColData[iColData + 1], &pBlockData->aColData[iColData], (xMallocFn)vnodeBufPoolMalloc, pPool);
+      if (code) goto _exit;
+    }
   }
 
+  code = tbDataAllocNodes(pMemTable, pTbData, pBlockData->nRow, NULL, false, &nodeAlloc);
+  if (code) goto _exit;
+
   // loop to add each row to the skiplist
   SMemSkipListNode *pos[SL_MAX_LEVEL];
   TSDBROW           tRow = tsdbRowFromBlockData(pBlockData, 0);
@@ -658,7 +758,7 @@ static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData,
 
   // first row
   tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_BACKWARD);
-  if ((code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 0))) goto _exit;
+  tbDataDoPut(pTbData, pos, &tRow, &nodeAlloc, 0);
   pTbData->minKey = TMIN(pTbData->minKey, key.ts);
   lRow = tRow;
 
@@ -676,7 +776,7 @@ static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData,
         tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_FROM_POS);
       }
 
-      if ((code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 1))) goto _exit;
+      tbDataDoPut(pTbData, pos, &tRow, &nodeAlloc, 1);
       lRow = tRow;
 
       ++tRow.iRow;
@@ -692,18 +792,19 @@ static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData,
   }
 
   // SMemTable
-  pMemTable->minKey = TMIN(pMemTable->minKey, pTbData->minKey);
-  pMemTable->maxKey = TMAX(pMemTable->maxKey, pTbData->maxKey);
-  pMemTable->nRow += pBlockData->nRow;
+  tsdbAtomicMin64(&pMemTable->minKey, pTbData->minKey);
+  tsdbAtomicMax64(&pMemTable->maxKey, pTbData->maxKey);
+  atomic_add_fetch_64(&pMemTable->nRow, pBlockData->nRow);
 
   if (affectedRows) *affectedRows = pBlockData->nRow;
 
 _exit:
+  tbDataFreeNodeAlloc(&nodeAlloc);
   return code;
 }
 
 static int32_t tsdbInsertRowDataToTable(SMemTable *pMemTable, STbData *pTbData, int64_t version,
-                                        SSubmitTbData *pSubmitTbData, int32_t *affectedRows) {
+                                        SSubmitTbData *pSubmitTbData, bool inBufPool, int32_t *affectedRows) {
   int32_t code = 0;
 
   int32_t           nRow = TARRAY_SIZE(pSubmitTbData->aRowP);
@@ -713,13 +814,17 @@ static int32_t tsdbInsertRowDataToTable(SMemTable *pMemTable, STbData *pTbData,
   TSDBROW           tRow = {.type = TSDBROW_ROW_FMT, .version = version};
   int32_t           iRow = 0;
   TSDBROW           lRow;
+  SMemNodeAlloc     nodeAlloc = {0};
+
+  // rows in the buffer pool are referenced by the nodes, the others are copied after them
+  code = tbDataAllocNodes(pMemTable, pTbData, nRow, aRow, !inBufPool, &nodeAlloc);
+  if (code) goto _exit;
 
   // backward put first data
   tRow.pTSRow = aRow[iRow++];
   key.ts = tRow.pTSRow->ts;
   tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_BACKWARD);
-  code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 0);
-  if (code) goto _exit;
+  tbDataDoPut(pTbData, pos, &tRow, &nodeAlloc, 0);
   lRow = tRow;
 
   pTbData->minKey = TMIN(pTbData->minKey, key.ts);
@@ -738,8 +843,7 @@ static int32_t tsdbInsertRowDataToTable(SMemTable *pMemTable, STbData *pTbData,
         tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_FROM_POS);
       }
 
-      code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 1);
-      if (code) goto _exit;
+      tbDataDoPut(pTbData, pos, &tRow, &nodeAlloc, 1);
 
       lRow = tRow;
 
@@ -755,13 +859,14 @@ static int32_t tsdbInsertRowDataToTable(SMemTable *pMemTable, STbData *pTbData,
   }
 
   // SMemTable
-  pMemTable->minKey = TMIN(pMemTable->minKey, pTbData->minKey);
-  pMemTable->maxKey = TMAX(pMemTable->maxKey, pTbData->maxKey);
-  pMemTable->nRow += nRow;
+  tsdbAtomicMin64(&pMemTable->minKey, pTbData->minKey);
+  tsdbAtomicMax64(&pMemTable->maxKey, pTbData->maxKey);
+  atomic_add_fetch_64(&pMemTable->nRow, nRow);
 
   if (affectedRows) *affectedRows = nRow;
 
 _exit:
+  tbDataFreeNodeAlloc(&nodeAlloc);
   return code;
 }
 
@@ -858,6 +858,41 @@ static void copyNumericCols(const SColData* pData, SFileBlockDumpInfo* pDumpInfo
   }
 }
 
+// the rows of a dictionary encoded column share the payload of their code: each distinct value is copied once and
+// the later rows only point at it
+static int32_t copyDictCols(SColData* pData, SFileBlockDumpInfo* pDumpInfo, SColumnInfoData* pColData,
+                            int32_t dumpedRows, bool asc, int32_t colIndex, SBlockLoadSuppInfo* pSupInfo) {
+  int32_t  aDictOffset[TSDB_DICT_MAX_SIZE];
+  int32_t* aCode = pData->aOffset + pData->nVal;
+  int32_t  step = asc ? 1 : -1;
+  SColVal  cv = {0};
+
+  ASSERT(pData->nDict <= tListLen(aDictOffset));
+  memset(aDictOffset, 0xff, sizeof(int32_t) * pData->nDict);
+  pColData->fromDict = true;
+
+  int32_t rowIndex = 0;
+  for (int32_t j = pDumpInfo->rowIndex; rowIndex < dumpedRows; j += step, rowIndex++) {
+    int32_t iDict = aCode[j];
+    if (aDictOffset[iDict] >= 0 && tColDataGetBitValue(pData, j) == 2) {
+      pColData->varmeta.offset[rowIndex] = aDictOffset[iDict];
+      continue;
+    }
+
+    tColDataGetValue(pData, j, &cv);
+    int32_t code = doCopyColVal(pColData, rowIndex, colIndex, &cv, pSupInfo);
+    if (code) {
+      return code;
+    }
+
+    if (COL_VAL_IS_VALUE(&cv)) {
+      aDictOffset[iDict] = pColData->varmeta.offset[rowIndex];
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader) {
   SReaderStatus*      pStatus = &pReader->status;
   SDataBlockIter*     pBlockIter = &pStatus->blockIter;
@@ -973,6 +1008,11 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader) {
       } else {
         if (IS_MATHABLE_TYPE(pColData->info.type)) {
           copyNumericCols(pData, pDumpInfo, pColData, dumpedRows, asc);
+        } else if (pData->nDict > 0) {
+          code = copyDictCols(pData, pDumpInfo, pColData, dumpedRows, asc, i, pSupInfo);
+          if (code) {
+            return code;
+          }
         } else {  // varchar/nchar type
           for (int32_t j = pDumpInfo->rowIndex; rowIndex < dumpedRows; j += step) {
             tColDataGetValue(pData, j, &cv);
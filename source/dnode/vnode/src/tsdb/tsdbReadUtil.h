@@ -283,9 +283,14 @@ typedef struct SCacheRowsReader {
   STsdbReadSnap*          pReadSnap;
   char*                   idstr;
   int64_t                 lastTs;
+  SLastStore*             pLastStore;   // columnar last values of the super table, NULL until the first retrieve
+  int32_t*                pStoreCols;   // index of each queried column in the store, -1 if not there yet
+  int32_t*                pStoreSlots;  // slot of each queried table in the store, -1 if not there yet
 } SCacheRowsReader;
 
 int32_t tsdbCacheGetBatch(STsdb* pTsdb, tb_uid_t uid, SArray* pLastArray, SCacheRowsReader* pr, int8_t ltype);
+int32_t tsdbCacheGetTableBatch(STsdb* pTsdb, int32_t iTable, SArray* pLastArray, SCacheRowsReader* pr, int8_t ltype);
+void    tsdbCacheReleaseStore(SLastStore* pStore);
 
 #ifdef __cplusplus
 }
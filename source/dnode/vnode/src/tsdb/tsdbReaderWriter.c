@@ -72,6 +72,7 @@ void tsdbCloseFile(STsdbFD **ppFD) {
   STsdbFD *pFD = *ppFD;
   if (pFD) {
     taosMemoryFree(pFD->pBuf);
+    tFree(pFD->pMBuf);
     taosCloseFile(&pFD->pFD);
     taosMemoryFree(pFD);
     *ppFD = NULL;
@@ -90,6 +91,7 @@ static int32_t tsdbWriteFilePage(STsdbFD *pFD) {
 
     taosCalcChecksumAppend(0, pFD->pBuf, pFD->szPage);
 
+    vnodeThrottleBgWrite(pFD->szPage);
     n = taosWriteFile(pFD->pFD, pFD->pBuf, pFD->szPage);
     if (n < 0) {
       code = TAOS_SYSTEM_ERROR(errno);
@@ -173,6 +175,44 @@ _exit:
   return code;
 }
 
+// read nPage consecutive pages with one pread into pFD->pMBuf, the last one is kept in pFD->pBuf as page cache
+static int32_t tsdbReadFilePages(STsdbFD *pFD, int64_t pgno, int32_t nPage) {
+  int32_t code = 0;
+  int64_t size = (int64_t)nPage * pFD->szPage;
+
+  code = tRealloc(&pFD->pMBuf, size);
+  if (code) goto _exit;
+
+  // read
+  int64_t offset = PAGE_OFFSET(pgno, pFD->szPage);
+  int64_t n = 0;
+  while (n < size) {
+    int64_t nRead = taosPReadFile(pFD->pFD, pFD->pMBuf + n, size - n, offset + n);
+    if (nRead < 0) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      goto _exit;
+    } else if (nRead == 0) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      goto _exit;
+    }
+    n += nRead;
+  }
+
+  // check
+  for (int32_t iPage = 0; iPage < nPage; iPage++) {
+    if (pgno + iPage > 1 && !taosCheckChecksumWhole(pFD->pMBuf + (int64_t)iPage * pFD->szPage, pFD->szPage)) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      goto _exit;
+    }
+  }
+
+  memcpy(pFD->pBuf, pFD->pMBuf + (int64_t)(nPage - 1) * pFD->szPage, pFD->szPage);
+  pFD->pgno = pgno + nPage - 1;
+
+_exit:
+  return code;
+}
+
 int32_t tsdbReadFile(STsdbFD *pFD, int64_t offset, uint8_t *pBuf, int64_t size) {
   int32_t code = 0;
   int64_t n = 0;
@@ -185,17 +225,40 @@ int32_t tsdbReadFile(STsdbFD *pFD, int64_t offset, uint8_t *pBuf, int64_t size)
   ASSERT(bOffset < szPgCont);
 
   while (n < size) {
-    if (pFD->pgno != pgno) {
+    if (pFD->pgno == pgno) {
+      int64_t nRead = TMIN(szPgCont - bOffset, size - n);
+      memcpy(pBuf + n, pFD->pBuf + bOffset, nRead);
+
+      n += nRead;
+      pgno++;
+      bOffset = 0;
+      continue;
+    }
+
+    // number of pages still to read, stop before the cached page
+    int64_t nPage = (bOffset + size - n + szPgCont - 1) / szPgCont;
+    if (pFD->pgno > pgno && pFD->pgno < pgno + nPage) {
+      nPage = pFD->pgno - pgno;
+    }
+    nPage = TMIN(nPage, TSDB_READ_MAX_PAGES);
+
+    if (nPage == 1) {
       code = tsdbReadFilePage(pFD, pgno);
       if (code) goto _exit;
+      continue;
     }
 
-    int64_t nRead = TMIN(szPgCont - bOffset, size - n);
-    memcpy(pBuf + n, pFD->pBuf + bOffset, nRead);
+    code = tsdbReadFilePages(pFD, pgno, nPage);
+    if (code) goto _exit;
 
-    n += nRead;
-    pgno++;
-    bOffset = 0;
+    for (int64_t iPage = 0; iPage < nPage; iPage++) {
+      int64_t nRead = TMIN(szPgCont - bOffset, size - n);
+      memcpy(pBuf + n, pFD->pMBuf + iPage * pFD->szPage + bOffset, nRead);
+
+      n += nRead;
+      pgno++;
+      bOffset = 0;
+    }
   }
 
 _exit:
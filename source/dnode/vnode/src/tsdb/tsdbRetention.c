@@ -16,6 +16,8 @@
 #include "tsdb.h"
 #include "tsdbFS2.h"
 
+#define TSDB_RETENTION_COPY_CHUNK (4 * 1024 * 1024)
+
 typedef struct {
   STsdb  *tsdb;
   int32_t szPage;
@@ -59,10 +61,19 @@ static int32_t tsdbDoCopyFile(SRTNer *rtner, const STFileObj *from, const STFile
   if (fdTo == NULL) code = terrno;
   TSDB_CHECK_CODE(code, lino, _exit);
 
-  int64_t n = taosFSendFile(fdTo, fdFrom, 0, tsdbLogicToFileSize(from->f->size, rtner->szPage));
-  if (n < 0) {
-    code = TAOS_SYSTEM_ERROR(errno);
-    TSDB_CHECK_CODE(code, lino, _exit);
+  // copy in chunks, so that bgWriteRateLimit can pace the migration
+  int64_t size = tsdbLogicToFileSize(from->f->size, rtner->szPage);
+  for (int64_t done = 0; done < size;) {
+    int64_t offset = done;
+    int64_t nChunk = TMIN(size - done, TSDB_RETENTION_COPY_CHUNK);
+
+    vnodeThrottleBgWrite(nChunk);
+    int64_t n = taosFSendFile(fdTo, fdFrom, &offset, nChunk);
+    if (n <= 0) {
+      code = (n < 0) ? TAOS_SYSTEM_ERROR(errno) : TSDB_CODE_FILE_CORRUPTED;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+    done += n;
   }
   taosCloseFile(&fdFrom);
   taosCloseFile(&fdTo);
@@ -288,7 +288,8 @@ int32_t tsdbSttFileReadBlockDataByColumn(SSttFileReader *reader, const SSttBlk *
             code = tColDataAppendValue(colData, &COL_VAL_NULL(blockCol->cid, blockCol->type));
             TSDB_CHECK_CODE(code, lino, _exit);
           }
-        } else {
+        } else if (!tsdbBCacheGetColData(reader->config->tsdb, TSDB_FTYPE_STT, reader->config->file->fid,
+                                         reader->config->file->cid, sttBlk->bInfo.offset, colData)) {
           int32_t size1 = blockCol->szBitmap + blockCol->szOffset + blockCol->szValue;
 
           code = tRealloc(&reader->config->bufArr[1], size1);
@@ -301,6 +302,10 @@ int32_t tsdbSttFileReadBlockDataByColumn(SSttFileReader *reader, const SSttBlk *
           code = tsdbDecmprColData(reader->config->bufArr[1], blockCol, hdr->cmprAlg, hdr->nRow, colData,
                                    &reader->config->bufArr[2]);
           TSDB_CHECK_CODE(code, lino, _exit);
+
+          code = tsdbBCachePutColData(reader->config->tsdb, TSDB_FTYPE_STT, reader->config->file->fid,
+                                      reader->config->file->cid, sttBlk->bInfo.offset, colData);
+          TSDB_CHECK_CODE(code, lino, _exit);
         }
       }
     }
@@ -1559,8 +1559,13 @@ int32_t tsdbCmprData(uint8_t *pIn, int32_t szIn, int8_t type, int8_t cmprAlg, ui
       if (code) goto _exit;
     }
 
-    *szOut =
-        tDataTypes[type].compFunc(pIn, szIn, szIn / tDataTypes[type].bytes, *ppOut + nOut, size, cmprAlg, *ppBuf, size);
+    if (tsAdaptiveCompress && tsIsAdaptiveType(type)) {
+      *szOut = tsCompressAdaptive(type, pIn, szIn, szIn / tDataTypes[type].bytes, *ppOut + nOut, size, cmprAlg,
+                                  *ppBuf, size);
+    } else {
+      *szOut = tDataTypes[type].compFunc(pIn, szIn, szIn / tDataTypes[type].bytes, *ppOut + nOut, size, cmprAlg,
+                                         *ppBuf, size);
+    }
     if (*szOut <= 0) {
       code = TSDB_CODE_COMPRESS_ERROR;
       goto _exit;
@@ -1587,8 +1592,15 @@ int32_t tsdbDecmprData(uint8_t *pIn, int32_t szIn, int8_t type, int8_t cmprAlg,
       if (code) goto _exit;
     }
 
-    int32_t size = tDataTypes[type].decompFunc(pIn, szIn, szOut / tDataTypes[type].bytes, *ppOut, szOut, cmprAlg,
-                                               *ppBuf, szOut + COMP_OVERFLOW_BYTES);
+    // blocks of the types that may have been encoded adaptively, whatever tsAdaptiveCompress is now
+    int32_t size;
+    if (tsIsAdaptiveType(type)) {
+      size = tsDecompressAdaptive(type, pIn, szIn, szOut / tDataTypes[type].bytes, *ppOut, szOut, cmprAlg,
+                                  *ppBuf, szOut + COMP_OVERFLOW_BYTES);
+    } else {
+      size = tDataTypes[type].decompFunc(pIn, szIn, szOut / tDataTypes[type].bytes, *ppOut, szOut, cmprAlg, *ppBuf,
+                                         szOut + COMP_OVERFLOW_BYTES);
+    }
     if (size <= 0) {
       code = TSDB_CODE_COMPRESS_ERROR;
       goto _exit;
@@ -1601,9 +1613,148 @@ _exit:
   return code;
 }
 
+// dictionary of a binary/nchar column ======================================
+// A column with few distinct values in a block keeps the code of each row in place of the offsets and the dictionary
+// in place of the values: TSDB_DICT_HEAD | nDict | length of each entry | entries. No string codec output starts
+// with TSDB_DICT_HEAD.
+#define TSDB_DICT_HEAD     (COMP_ADAPT_FLAG | 2)
+#define TSDB_DICT_MIN_ROWS 16
+#define TSDB_DICT_SLOTS    1024
+
+typedef struct {
+  int32_t nDict;
+  int32_t aLen[TSDB_DICT_MAX_SIZE];
+  int32_t aStart[TSDB_DICT_MAX_SIZE];
+  int16_t aSlot[TSDB_DICT_SLOTS];
+} STsdbDict;
+
+static FORCE_INLINE int32_t tsdbDictSize(STsdbDict *pDict) {
+  int32_t size = sizeof(uint8_t) + sizeof(int32_t) * (pDict->nDict + 1);
+  for (int32_t iDict = 0; iDict < pDict->nDict; iDict++) {
+    size += pDict->aLen[iDict];
+  }
+  return size;
+}
+
+// gives up as soon as the column has more distinct values than half of its rows or than TSDB_DICT_MAX_SIZE
+static bool tsdbBuildColDict(SColData *pColData, STsdbDict *pDict, int32_t *aCode) {
+  int32_t maxDict = TMIN(TSDB_DICT_MAX_SIZE, pColData->nVal / 2);
+
+  pDict->nDict = 0;
+  memset(pDict->aSlot, 0xff, sizeof(pDict->aSlot));
+  for (int32_t iVal = 0; iVal < pColData->nVal; iVal++) {
+    int32_t  start = pColData->aOffset[iVal];
+    int32_t  len = ((iVal < pColData->nVal - 1) ? pColData->aOffset[iVal + 1] : pColData->nData) - start;
+    uint32_t slot = MurmurHash3_32((const char *)pColData->pData + start, len) & (TSDB_DICT_SLOTS - 1);
+
+    for (;;) {
+      int32_t iDict = pDict->aSlot[slot];
+      if (iDict < 0) {
+        if (pDict->nDict >= maxDict) return false;
+
+        iDict = pDict->nDict++;
+        pDict->aLen[iDict] = len;
+        pDict->aStart[iDict] = start;
+        pDict->aSlot[slot] = iDict;
+      } else if (pDict->aLen[iDict] != len ||
+                 memcmp(pColData->pData + pDict->aStart[iDict], pColData->pData + start, len) != 0) {
+        slot = (slot + 1) & (TSDB_DICT_SLOTS - 1);
+        continue;
+      }
+
+      aCode[iVal] = iDict;
+      break;
+    }
+  }
+
+  return true;
+}
+
+static void tsdbPutColDict(SColData *pColData, STsdbDict *pDict, uint8_t *p) {
+  int32_t n = 0;
+
+  n += tPutU8(p + n, TSDB_DICT_HEAD);
+  n += tPutI32(p + n, pDict->nDict);
+  for (int32_t iDict = 0; iDict < pDict->nDict; iDict++) {
+    n += tPutI32(p + n, pDict->aLen[iDict]);
+  }
+  for (int32_t iDict = 0; iDict < pDict->nDict; iDict++) {
+    memcpy(p + n, pColData->pData + pDict->aStart[iDict], pDict->aLen[iDict]);
+    n += pDict->aLen[iDict];
+  }
+}
+
+// rebuilds the offsets and the values of the column from the codes in aOffset and the dictionary, and keeps the
+// codes after the offsets for the reader
+static int32_t tsdbGetColDict(uint8_t *pIn, int32_t szIn, SColData *pColData) {
+  int32_t code = 0;
+  int32_t nDict;
+  int32_t aLen[TSDB_DICT_MAX_SIZE];
+  int32_t aStart[TSDB_DICT_MAX_SIZE];
+  int32_t n = sizeof(uint8_t);
+
+  if (szIn < n + (int32_t)sizeof(int32_t)) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+    goto _exit;
+  }
+  n += tGetI32(pIn + n, &nDict);
+  if (nDict <= 0 || nDict > TSDB_DICT_MAX_SIZE || szIn < n + (int32_t)sizeof(int32_t) * nDict) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+    goto _exit;
+  }
+
+  int32_t size = 0;
+  for (int32_t iDict = 0; iDict < nDict; iDict++) {
+    n += tGetI32(pIn + n, &aLen[iDict]);
+    if (aLen[iDict] < 0 || aLen[iDict] > szIn) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      goto _exit;
+    }
+    aStart[iDict] = size;
+    size += aLen[iDict];
+  }
+  if (n + size != szIn) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+    goto _exit;
+  }
+
+  code = tRealloc((uint8_t **)&pColData->aOffset, sizeof(int32_t) * pColData->nVal * 2);
+  if (code) goto _exit;
+  code = tRealloc(&pColData->pData, pColData->nData);
+  if (code) goto _exit;
+
+  int32_t *aCode = pColData->aOffset + pColData->nVal;
+  memcpy(aCode, pColData->aOffset, sizeof(int32_t) * pColData->nVal);
+
+  uint8_t *pEntry = pIn + n;
+  int32_t  nData = 0;
+  for (int32_t iVal = 0; iVal < pColData->nVal; iVal++) {
+    int32_t iDict = aCode[iVal];
+    if (iDict < 0 || iDict >= nDict || nData + aLen[iDict] > pColData->nData) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      goto _exit;
+    }
+
+    pColData->aOffset[iVal] = nData;
+    memcpy(pColData->pData + nData, pEntry + aStart[iDict], aLen[iDict]);
+    nData += aLen[iDict];
+  }
+  if (nData != pColData->nData) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+    goto _exit;
+  }
+
+  pColData->nDict = nDict;
+
+_exit:
+  return code;
+}
+
 int32_t tsdbCmprColData(SColData *pColData, int8_t cmprAlg, SBlockCol *pBlockCol, uint8_t **ppOut, int32_t nOut,
                         uint8_t **ppBuf) {
-  int32_t code = 0;
+  int32_t    code = 0;
+  int32_t   *aCode = NULL;
+  STsdbDict *pDict = NULL;
 
   ASSERT(pColData->flag && (pColData->flag != HAS_NONE) && (pColData->flag != HAS_NULL));
 
@@ -1611,6 +1762,21 @@ int32_t tsdbCmprColData(SColData *pColData, int8_t cmprAlg, SBlockCol *pBlockCol
   pBlockCol->szOffset = 0;
   pBlockCol->szValue = 0;
 
+  // dictionary, of the columns whose distinct values take well under half of the values
+  if (cmprAlg != NO_COMPRESSION && tsAdaptiveCompress && IS_STR_DATA_TYPE(pColData->type) &&
+      (pColData->flag & HAS_VALUE) && pColData->nVal >= TSDB_DICT_MIN_ROWS) {
+    aCode = taosMemoryMalloc(sizeof(int32_t) * pColData->nVal);
+    pDict = taosMemoryMalloc(sizeof(STsdbDict));
+    if (aCode == NULL || pDict == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+
+    if (!tsdbBuildColDict(pColData, pDict, aCode) || tsdbDictSize(pDict) > pColData->nData / 2) {
+      taosMemoryFreeClear(pDict);
+    }
+  }
+
   int32_t size = 0;
   // bitmap
   if (pColData->flag != HAS_VALUE) {
@@ -1629,14 +1795,20 @@ int32_t tsdbCmprColData(SColData *pColData, int8_t cmprAlg, SBlockCol *pBlockCol
 
   // offset
   if (IS_VAR_DATA_TYPE(pColData->type) && pColData->flag != (HAS_NULL | HAS_NONE)) {
-    code = tsdbCmprData((uint8_t *)pColData->aOffset, sizeof(int32_t) * pColData->nVal, TSDB_DATA_TYPE_INT, cmprAlg,
-                        ppOut, nOut + size, &pBlockCol->szOffset, ppBuf);
+    code = tsdbCmprData(pDict ? (uint8_t *)aCode : (uint8_t *)pColData->aOffset, sizeof(int32_t) * pColData->nVal,
+                        TSDB_DATA_TYPE_INT, cmprAlg, ppOut, nOut + size, &pBlockCol->szOffset, ppBuf);
     if (code) goto _exit;
   }
   size += pBlockCol->szOffset;
 
   // value
-  if ((pColData->flag != (HAS_NULL | HAS_NONE)) && pColData->nData) {
+  if (pDict) {
+    pBlockCol->szValue = tsdbDictSize(pDict);
+    code = tRealloc(ppOut, nOut + size + pBlockCol->szValue);
+    if (code) goto _exit;
+
+    tsdbPutColDict(pColData, pDict, *ppOut + nOut + size);
+  } else if ((pColData->flag != (HAS_NULL | HAS_NONE)) && pColData->nData) {
     code = tsdbCmprData((uint8_t *)pColData->pData, pColData->nData, pColData->type, cmprAlg, ppOut, nOut + size,
                         &pBlockCol->szValue, ppBuf);
     if (code) goto _exit;
@@ -1644,6 +1816,8 @@ int32_t tsdbCmprColData(SColData *pColData, int8_t cmprAlg, SBlockCol *pBlockCol
   size += pBlockCol->szValue;
 
 _exit:
+  taosMemoryFree(aCode);
+  taosMemoryFree(pDict);
   return code;
 }
 
@@ -1657,6 +1831,7 @@ int32_t tsdbDecmprColData(uint8_t *pIn, SBlockCol *pBlockCol, int8_t cmprAlg, in
   pColData->flag = pBlockCol->flag;
   pColData->nVal = nVal;
   pColData->nData = pBlockCol->szOrigin;
+  pColData->nDict = 0;
 
   uint8_t *p = pIn;
   // bitmap
@@ -1682,7 +1857,16 @@ int32_t tsdbDecmprColData(uint8_t *pIn, SBlockCol *pBlockCol, int8_t cmprAlg, in
   p += pBlockCol->szOffset;
 
   // value
-  if (pBlockCol->szValue) {
+  if (pBlockCol->szValue && cmprAlg != NO_COMPRESSION && IS_STR_DATA_TYPE(pColData->type) &&
+      p[0] == TSDB_DICT_HEAD) {
+    if (pBlockCol->szOffset == 0) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      goto _exit;
+    }
+
+    code = tsdbGetColDict(p, pBlockCol->szValue, pColData);
+    if (code) goto _exit;
+  } else if (pBlockCol->szValue) {
     code = tsdbDecmprData(p, pBlockCol->szValue, pColData->type, cmprAlg, &pColData->pData, pColData->nData, ppBuf);
     if (code) goto _exit;
   }
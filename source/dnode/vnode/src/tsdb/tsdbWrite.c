@@ -47,7 +47,7 @@ int tsdbInsertData(STsdb *pTsdb, int64_t version, SSubmitReq2 *pMsg, SSubmitRsp2
 
   // loop to insert
   for (int32_t i = 0; i < arrSize; ++i) {
-    if ((terrno = tsdbInsertTableData(pTsdb, version, taosArrayGet(pMsg->aSubmitTbData, i), &affectedrows)) < 0) {
+    if ((terrno = tsdbInsertTableData(pTsdb, version, taosArrayGet(pMsg->aSubmitTbData, i), false, &affectedrows)) < 0) {
       return -1;
     }
   }
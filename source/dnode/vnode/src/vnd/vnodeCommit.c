@@ -393,7 +393,7 @@ int vnodeAsyncCommit(SVnode *pVnode) {
   }
 
   // schedule the task
-  code = vnodeScheduleTask(vnodeCommitTask, pInfo);
+  code = vnodeScheduleTaskEx(VND_TASK_COMMIT, TD_VID(pVnode), vnodeCommitTask, pInfo);
 
 _exit:
   if (code) {
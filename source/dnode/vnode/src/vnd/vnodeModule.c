@@ -23,24 +23,52 @@ struct SVnodeTask {
   void* arg;
 };
 
+// the tasks of one vnode in one task class
+typedef struct SVnodeTaskQueue SVnodeTaskQueue;
+struct SVnodeTaskQueue {
+  SVnodeTaskQueue* next;  // in the ring of the class while it has tasks
+  SVnodeTaskQueue* prev;
+  int32_t          vgId;
+  SVnodeTask       tasks;
+};
+
 typedef struct {
-  int           nthreads;
-  TdThread*     threads;
-  TdThreadMutex mutex;
-  TdThreadCond  hasTask;
-  SVnodeTask    queue;
+  int32_t         nTask;
+  SVnodeTaskQueue ring;     // the vnodes with tasks, served round robin
+  SHashObj*       pQueues;  // vgId -> SVnodeTaskQueue*
+} SVnodeTaskClass;
+
+typedef struct {
+  int          nthreads;
+  TdThread*    threads;
+  uint32_t     classes;  // the task classes its threads serve
+  TdThreadCond hasTask;
 } SVnodeThreadPool;
 
+typedef struct {
+  TdThreadMutex mutex;
+  int64_t       avail;  // bytes, negative while writers wait for their debt
+  int64_t       lastMs;
+} SVnodeIoLimiter;
+
 struct SVnodeGlobal {
   int8_t           init;
   int8_t           stop;
-  SVnodeThreadPool tp[2];
+  TdThreadMutex    mutex;
+  SVnodeTaskClass  classes[VND_TASK_CLASS_MAX];
+  SVnodeThreadPool tp[3];  // commit, background and insert
+  SVnodeIoLimiter  ioLimiter;
 };
 
 struct SVnodeGlobal vnodeGlobal;
 
+// the class of the task the thread is running
+static threadlocal int32_t vnodeTaskClass = -1;
+
 static void* loop(void* arg);
 
+static void freeTaskQueueFp(void* param) { taosMemoryFree(*(SVnodeTaskQueue**)param); }
+
 int vnodeInit(int nthreads) {
   int8_t init;
   int    ret;
@@ -51,26 +79,43 @@ int vnodeInit(int nthreads) {
   }
   vnodeGlobal.stop = 0;
 
-  for (int32_t i = 0; i < ARRAY_SIZE(vnodeGlobal.tp); i++) {
-    taosThreadMutexInit(&vnodeGlobal.tp[i].mutex, NULL);
-    taosThreadCondInit(&vnodeGlobal.tp[i].hasTask, NULL);
+  taosThreadMutexInit(&vnodeGlobal.mutex, NULL);
+  for (int32_t i = 0; i < VND_TASK_CLASS_MAX; i++) {
+    SVnodeTaskClass* pClass = &vnodeGlobal.classes[i];
+    pClass->nTask = 0;
+    pClass->ring.next = &pClass->ring;
+    pClass->ring.prev = &pClass->ring;
+    pClass->pQueues = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), false, HASH_NO_LOCK);
+    if (pClass->pQueues == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      vError("failed to init vnode module since:%s", tstrerror(terrno));
+      return -1;
+    }
+    taosHashSetFreeFp(pClass->pQueues, freeTaskQueueFp);
+  }
 
-    taosThreadMutexLock(&vnodeGlobal.tp[i].mutex);
+  taosThreadMutexInit(&vnodeGlobal.ioLimiter.mutex, NULL);
+  vnodeGlobal.ioLimiter.avail = 0;
+  vnodeGlobal.ioLimiter.lastMs = taosGetTimestampMs();
 
-    vnodeGlobal.tp[i].queue.next = &vnodeGlobal.tp[i].queue;
-    vnodeGlobal.tp[i].queue.prev = &vnodeGlobal.tp[i].queue;
+  // the background threads take queued commits before their own tasks, so commits never wait behind merges
+  vnodeGlobal.tp[0].classes = 1u << VND_TASK_COMMIT;
+  vnodeGlobal.tp[1].classes = (1u << VND_TASK_COMMIT) | (1u << VND_TASK_MERGE) | (1u << VND_TASK_RETENTION);
+  vnodeGlobal.tp[2].classes = 1u << VND_TASK_INSERT;
 
-    taosThreadMutexUnlock(&(vnodeGlobal.tp[i].mutex));
+  for (int32_t i = 0; i < ARRAY_SIZE(vnodeGlobal.tp); i++) {
+    taosThreadCondInit(&vnodeGlobal.tp[i].hasTask, NULL);
 
-    vnodeGlobal.tp[i].nthreads = nthreads;
-    vnodeGlobal.tp[i].threads = taosMemoryCalloc(nthreads, sizeof(TdThread));
+    // the vnode write thread takes a share of the inserts itself
+    vnodeGlobal.tp[i].nthreads = (i == 2) ? tsNumOfVnodeInsertThreads - 1 : nthreads;
+    vnodeGlobal.tp[i].threads = taosMemoryCalloc(TMAX(vnodeGlobal.tp[i].nthreads, 1), sizeof(TdThread));
     if (vnodeGlobal.tp[i].threads == NULL) {
       terrno = TSDB_CODE_OUT_OF_MEMORY;
       vError("failed to init vnode module since:%s", tstrerror(terrno));
       return -1;
     }
 
-    for (int j = 0; j < nthreads; j++) {
+    for (int j = 0; j < vnodeGlobal.tp[i].nthreads; j++) {
       taosThreadCreate(&(vnodeGlobal.tp[i].threads[j]), NULL, loop, &vnodeGlobal.tp[i]);
     }
   }
@@ -92,12 +137,14 @@ void vnodeCleanup() {
   if (init == 0) return;
 
   // set stop
+  taosThreadMutexLock(&vnodeGlobal.mutex);
   vnodeGlobal.stop = 1;
   for (int32_t i = 0; i < ARRAY_SIZE(vnodeGlobal.tp); i++) {
-    taosThreadMutexLock(&(vnodeGlobal.tp[i].mutex));
     taosThreadCondBroadcast(&(vnodeGlobal.tp[i].hasTask));
-    taosThreadMutexUnlock(&(vnodeGlobal.tp[i].mutex));
+  }
+  taosThreadMutexUnlock(&vnodeGlobal.mutex);
 
+  for (int32_t i = 0; i < ARRAY_SIZE(vnodeGlobal.tp); i++) {
     // wait for threads
     for (int j = 0; j < vnodeGlobal.tp[i].nthreads; j++) {
       taosThreadJoin(vnodeGlobal.tp[i].threads[j], NULL);
@@ -106,16 +153,23 @@ void vnodeCleanup() {
     // clear source
     taosMemoryFreeClear(vnodeGlobal.tp[i].threads);
     taosThreadCondDestroy(&(vnodeGlobal.tp[i].hasTask));
-    taosThreadMutexDestroy(&(vnodeGlobal.tp[i].mutex));
   }
 
+  for (int32_t i = 0; i < VND_TASK_CLASS_MAX; i++) {
+    taosHashCleanup(vnodeGlobal.classes[i].pQueues);
+    vnodeGlobal.classes[i].pQueues = NULL;
+  }
+  taosThreadMutexDestroy(&vnodeGlobal.mutex);
+  taosThreadMutexDestroy(&vnodeGlobal.ioLimiter.mutex);
+
   walCleanUp();
   tqCleanUp();
   smaCleanUp();
 }
 
-int vnodeScheduleTaskEx(int tpid, int (*execute)(void*), void* arg) {
-  SVnodeTask* pTask;
+int vnodeScheduleTaskEx(EVndTaskClass taskClass, int32_t vgId, int (*execute)(void*), void* arg) {
+  SVnodeTask*      pTask;
+  SVnodeTaskClass* pClass = &vnodeGlobal.classes[taskClass];
 
   ASSERT(!vnodeGlobal.stop);
 
@@ -128,54 +182,148 @@ int vnodeScheduleTaskEx(int tpid, int (*execute)(void*), void* arg) {
   pTask->execute = execute;
   pTask->arg = arg;
 
-  taosThreadMutexLock(&(vnodeGlobal.tp[tpid].mutex));
-  pTask->next = &vnodeGlobal.tp[tpid].queue;
-  pTask->prev = vnodeGlobal.tp[tpid].queue.prev;
-  vnodeGlobal.tp[tpid].queue.prev->next = pTask;
-  vnodeGlobal.tp[tpid].queue.prev = pTask;
-  taosThreadCondSignal(&(vnodeGlobal.tp[tpid].hasTask));
-  taosThreadMutexUnlock(&(vnodeGlobal.tp[tpid].mutex));
+  taosThreadMutexLock(&vnodeGlobal.mutex);
+
+  SVnodeTaskQueue** ppQueue = taosHashGet(pClass->pQueues, &vgId, sizeof(vgId));
+  SVnodeTaskQueue*  pQueue = (ppQueue != NULL) ? *ppQueue : NULL;
+  if (pQueue == NULL) {
+    pQueue = taosMemoryCalloc(1, sizeof(*pQueue));
+    if (pQueue == NULL || taosHashPut(pClass->pQueues, &vgId, sizeof(vgId), &pQueue, POINTER_BYTES) != 0) {
+      taosThreadMutexUnlock(&vnodeGlobal.mutex);
+      taosMemoryFree(pQueue);
+      taosMemoryFree(pTask);
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+
+    pQueue->vgId = vgId;
+    pQueue->tasks.next = &pQueue->tasks;
+    pQueue->tasks.prev = &pQueue->tasks;
+  }
+
+  // join the ring of the class behind the vnodes already waiting
+  if (pQueue->tasks.next == &pQueue->tasks) {
+    pQueue->next = &pClass->ring;
+    pQueue->prev = pClass->ring.prev;
+    pClass->ring.prev->next = pQueue;
+    pClass->ring.prev = pQueue;
+  }
+
+  pTask->next = &pQueue->tasks;
+  pTask->prev = pQueue->tasks.prev;
+  pQueue->tasks.prev->next = pTask;
+  pQueue->tasks.prev = pTask;
+  pClass->nTask++;
+
+  for (int32_t i = 0; i < ARRAY_SIZE(vnodeGlobal.tp); i++) {
+    if (vnodeGlobal.tp[i].classes & (1u << taskClass)) {
+      taosThreadCondSignal(&(vnodeGlobal.tp[i].hasTask));
+    }
+  }
+  taosThreadMutexUnlock(&vnodeGlobal.mutex);
 
   return 0;
 }
 
-int vnodeScheduleTask(int (*execute)(void*), void* arg) { return vnodeScheduleTaskEx(0, execute, arg); }
+int vnodeScheduleInsertTask(int32_t vgId, int (*execute)(void*), void* arg) {
+  if (vnodeGlobal.tp[2].nthreads <= 0) {
+    return -1;
+  }
+  return vnodeScheduleTaskEx(VND_TASK_INSERT, vgId, execute, arg);
+}
+
+// Charge a write of a merge, compact or retention task against bgWriteRateLimit and sleep off the debt once the
+// background writes of all vnodes run ahead of it. Writes of other tasks pass through.
+void vnodeThrottleBgWrite(int64_t size) {
+  int64_t rate = (int64_t)tsBgWriteRateLimit * 1024 * 1024;
+  if (rate <= 0 || (vnodeTaskClass != VND_TASK_MERGE && vnodeTaskClass != VND_TASK_RETENTION)) {
+    return;
+  }
+
+  SVnodeIoLimiter* pLimiter = &vnodeGlobal.ioLimiter;
+  taosThreadMutexLock(&pLimiter->mutex);
+
+  // refill, and keep at most one second of budget for bursts
+  int64_t nowMs = taosGetTimestampMs();
+  int64_t elapsed = TMAX(TMIN(nowMs - pLimiter->lastMs, 1000), 0);
+  pLimiter->avail = TMIN(pLimiter->avail + rate * elapsed / 1000, rate);
+  pLimiter->lastMs = nowMs;
+
+  pLimiter->avail -= size;
+  int64_t waitMs = (pLimiter->avail < 0) ? -pLimiter->avail * 1000 / rate : 0;
+
+  taosThreadMutexUnlock(&pLimiter->mutex);
+
+  if (waitMs > 0) {
+    taosMsleep(waitMs);
+  }
+}
 
 /* ------------------------ STATIC METHODS ------------------------ */
+// the first task of the highest priority class the pool serves, the vnodes of a class take turns
+static SVnodeTask* vnodeNextTask(SVnodeThreadPool* tp, int32_t* pTaskClass) {
+  for (int32_t i = 0; i < VND_TASK_CLASS_MAX; i++) {
+    SVnodeTaskClass* pClass = &vnodeGlobal.classes[i];
+    if ((tp->classes & (1u << i)) == 0 || pClass->nTask == 0) {
+      continue;
+    }
+
+    SVnodeTaskQueue* pQueue = pClass->ring.next;
+    SVnodeTask*      pTask = pQueue->tasks.next;
+    pTask->prev->next = pTask->next;
+    pTask->next->prev = pTask->prev;
+    pClass->nTask--;
+
+    // leave the ring, and rejoin it at the tail if more tasks are queued
+    pQueue->prev->next = pQueue->next;
+    pQueue->next->prev = pQueue->prev;
+    if (pQueue->tasks.next != &pQueue->tasks) {
+      pQueue->next = &pClass->ring;
+      pQueue->prev = pClass->ring.prev;
+      pClass->ring.prev->next = pQueue;
+      pClass->ring.prev = pQueue;
+    }
+
+    *pTaskClass = i;
+    return pTask;
+  }
+
+  return NULL;
+}
+
 static void* loop(void* arg) {
   SVnodeThreadPool* tp = (SVnodeThreadPool*)arg;
   SVnodeTask*       pTask;
-  int               ret;
+  int32_t           taskClass = -1;
 
   if (tp == &vnodeGlobal.tp[0]) {
     setThreadName("vnode-commit");
   } else if (tp == &vnodeGlobal.tp[1]) {
     setThreadName("vnode-merge");
+  } else if (tp == &vnodeGlobal.tp[2]) {
+    setThreadName("vnode-insert");
   }
 
   for (;;) {
-    taosThreadMutexLock(&(tp->mutex));
+    taosThreadMutexLock(&vnodeGlobal.mutex);
     for (;;) {
-      pTask = tp->queue.next;
-      if (pTask == &tp->queue) {
-        // no task
-        if (vnodeGlobal.stop) {
-          taosThreadMutexUnlock(&(tp->mutex));
-          return NULL;
-        } else {
-          taosThreadCondWait(&(tp->hasTask), &(tp->mutex));
-        }
-      } else {
-        // has task
-        pTask->prev->next = pTask->next;
-        pTask->next->prev = pTask->prev;
+      pTask = vnodeNextTask(tp, &taskClass);
+      if (pTask != NULL) {
         break;
       }
-    }
 
-    taosThreadMutexUnlock(&(tp->mutex));
+      // no task
+      if (vnodeGlobal.stop) {
+        taosThreadMutexUnlock(&vnodeGlobal.mutex);
+        return NULL;
+      }
+      taosThreadCondWait(&(tp->hasTask), &vnodeGlobal.mutex);
+    }
+    taosThreadMutexUnlock(&vnodeGlobal.mutex);
 
+    vnodeTaskClass = taskClass;
     pTask->execute(pTask->arg);
+    vnodeTaskClass = -1;
     taosMemoryFree(pTask);
   }
 
@@ -927,6 +927,8 @@ static int32_t vnodeProcessDropStbReq(SVnode *pVnode, int64_t ver, void *pReq, i
     goto _exit;
   }
 
+  tsdbCacheDropSTable(pVnode->pTsdb, req.suid);
+
   if (tqUpdateTbUidList(pVnode->pTq, tbUidList, false) < 0) {
     rcode = terrno;
     goto _exit;
@@ -1038,7 +1040,10 @@ static int32_t vnodeProcessDropTbReq(SVnode *pVnode, int64_t ver, void *pReq, in
       }
     } else {
       dropTbRsp.code = TSDB_CODE_SUCCESS;
-      if (tbUid > 0) tdFetchTbUidList(pVnode->pSma, &pStore, pDropTbReq->suid, tbUid);
+      if (tbUid > 0) {
+        tdFetchTbUidList(pVnode->pSma, &pStore, pDropTbReq->suid, tbUid);
+        tsdbCacheDropTable(pVnode->pTsdb, pDropTbReq->suid, tbUid);
+      }
     }
 
     taosArrayPush(rsp.pArray, &dropTbRsp);
@@ -1272,6 +1277,178 @@ static int32_t vnodeRebuildSubmitReqMsg(SSubmitReq2 *pSubmitReq, void **ppMsg) {
   return code;
 }
 
+#define VNODE_PARALLEL_INSERT_MIN_ROWS 4096
+
+typedef struct {
+  TdThreadMutex mutex;
+  TdThreadCond  cond;
+  int32_t       nRunning;
+} SVInsertLatch;
+
+typedef struct {
+  SVnode        *pVnode;
+  int64_t        ver;
+  SSubmitReq2   *pSubmitReq;
+  bool           inBufPool;
+  int32_t        iTask;
+  int32_t        nTask;
+  int32_t        code;
+  int32_t        affectedRows;
+  SVInsertLatch *pLatch;
+} SVInsertTask;
+
+// the tables are partitioned by uid, so all data of a table is inserted by the same task in the submitted order
+static int32_t vnodeDoInsertTask(SVInsertTask *pTask) {
+  SSubmitReq2 *pSubmitReq = pTask->pSubmitReq;
+
+  for (int32_t i = 0; i < TARRAY_SIZE(pSubmitReq->aSubmitTbData); ++i) {
+    SSubmitTbData *pSubmitTbData = taosArrayGet(pSubmitReq->aSubmitTbData, i);
+    if (TABS(pSubmitTbData->uid) % pTask->nTask != pTask->iTask) {
+      continue;
+    }
+
+    int32_t affectedRows = 0;
+    pTask->code =
+        tsdbInsertTableData(pTask->pVnode->pTsdb, pTask->ver, pSubmitTbData, pTask->inBufPool, &affectedRows);
+    if (pTask->code) {
+      break;
+    }
+
+    pTask->affectedRows += affectedRows;
+  }
+
+  return pTask->code;
+}
+
+static int vnodeExecInsertTask(void *arg) {
+  SVInsertTask  *pTask = (SVInsertTask *)arg;
+  SVInsertLatch *pLatch = pTask->pLatch;
+
+  vnodeDoInsertTask(pTask);
+
+  taosThreadMutexLock(&pLatch->mutex);
+  if (--pLatch->nRunning == 0) {
+    taosThreadCondSignal(&pLatch->cond);
+  }
+  taosThreadMutexUnlock(&pLatch->mutex);
+  return 0;
+}
+
+static int32_t vnodeGetNumOfInsertTasks(SVnode *pVnode, SSubmitReq2 *pSubmitReq) {
+  int32_t nTbData = TARRAY_SIZE(pSubmitReq->aSubmitTbData);
+  if (tsNumOfVnodeInsertThreads <= 1 || nTbData <= 1) {
+    return 1;
+  }
+
+  int64_t nRow = 0;
+  for (int32_t i = 0; i < nTbData; ++i) {
+    SSubmitTbData *pSubmitTbData = taosArrayGet(pSubmitReq->aSubmitTbData, i);
+    if (pSubmitTbData->flags & SUBMIT_REQ_COLUMN_DATA_FORMAT) {
+      nRow += ((SColData *)TARRAY_DATA(pSubmitTbData->aCol))[0].nVal;
+    } else {
+      nRow += TARRAY_SIZE(pSubmitTbData->aRowP);
+    }
+  }
+
+  // small batches are not worth the thread switch
+  if (nRow < VNODE_PARALLEL_INSERT_MIN_ROWS) {
+    return 1;
+  }
+
+  return TMIN(tsNumOfVnodeInsertThreads, nTbData);
+}
+
+// insert the data of different tables on the insert threads, the write thread takes the first share itself
+static int32_t vnodeInsertTableDataInParallel(SVnode *pVnode, int64_t ver, SSubmitReq2 *pSubmitReq, bool inBufPool,
+                                              int32_t nTask, int32_t *affectedRows) {
+  int32_t       code = 0;
+  SVInsertLatch latch = {.nRunning = 0};
+  SVInsertTask *aTask = taosMemoryCalloc(nTask, sizeof(SVInsertTask));
+  if (aTask == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  taosThreadMutexInit(&latch.mutex, NULL);
+  taosThreadCondInit(&latch.cond, NULL);
+
+  for (int32_t i = 0; i < nTask; ++i) {
+    aTask[i] = (SVInsertTask){.pVnode = pVnode,
+                              .ver = ver,
+                              .pSubmitReq = pSubmitReq,
+                              .inBufPool = inBufPool,
+                              .iTask = i,
+                              .nTask = nTask,
+                              .pLatch = &latch};
+  }
+
+  for (int32_t i = 1; i < nTask; ++i) {
+    taosThreadMutexLock(&latch.mutex);
+    latch.nRunning++;
+    taosThreadMutexUnlock(&latch.mutex);
+
+    if (vnodeScheduleInsertTask(TD_VID(pVnode), vnodeExecInsertTask, &aTask[i]) != 0) {
+      taosThreadMutexLock(&latch.mutex);
+      latch.nRunning--;
+      taosThreadMutexUnlock(&latch.mutex);
+
+      vnodeDoInsertTask(&aTask[i]);
+    }
+  }
+
+  vnodeDoInsertTask(&aTask[0]);
+
+  taosThreadMutexLock(&latch.mutex);
+  while (latch.nRunning > 0) {
+    taosThreadCondWait(&latch.cond, &latch.mutex);
+  }
+  taosThreadMutexUnlock(&latch.mutex);
+
+  for (int32_t i = 0; i < nTask; ++i) {
+    if (aTask[i].code && code == 0) {
+      code = aTask[i].code;
+    }
+    *affectedRows += aTask[i].affectedRows;
+  }
+
+  taosThreadCondDestroy(&latch.cond);
+  taosThreadMutexDestroy(&latch.mutex);
+  taosMemoryFree(aTask);
+  return code;
+}
+
+static FORCE_INLINE void *vnodeRebasePtr(void *p, const void *pFrom, void *pTo) {
+  return p ? POINTER_SHIFT(pTo, POINTER_DISTANCE(p, pFrom)) : NULL;
+}
+
+int32_t vnodeCopySubmitReqToBufPool(SVBufPool *pPool, SSubmitReq2 *pSubmitReq, const void *pReq, int32_t len) {
+  void *pBuf = vnodeBufPoolMallocAligned(pPool, len);
+  if (pBuf == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  memcpy(pBuf, pReq, len);
+
+  // the rows and columns are decoded in place, move them onto the copy
+  for (int32_t i = 0; i < TARRAY_SIZE(pSubmitReq->aSubmitTbData); ++i) {
+    SSubmitTbData *pSubmitTbData = taosArrayGet(pSubmitReq->aSubmitTbData, i);
+
+    if (pSubmitTbData->flags & SUBMIT_REQ_COLUMN_DATA_FORMAT) {
+      SColData *aColData = (SColData *)TARRAY_DATA(pSubmitTbData->aCol);
+      for (int32_t iCol = 0; iCol < TARRAY_SIZE(pSubmitTbData->aCol); ++iCol) {
+        aColData[iCol].pBitMap = vnodeRebasePtr(aColData[iCol].pBitMap, pReq, pBuf);
+        aColData[iCol].aOffset = vnodeRebasePtr(aColData[iCol].aOffset, pReq, pBuf);
+        aColData[iCol].pData = vnodeRebasePtr(aColData[iCol].pData, pReq, pBuf);
+      }
+    } else {
+      SRow **aRow = (SRow **)TARRAY_DATA(pSubmitTbData->aRowP);
+      for (int32_t iRow = 0; iRow < TARRAY_SIZE(pSubmitTbData->aRowP); ++iRow) {
+        aRow[iRow] = vnodeRebasePtr(aRow[iRow], pReq, pBuf);
+      }
+    }
+  }
+
+  return 0;
+}
+
 static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t ver, void *pReq, int32_t len, SRpcMsg *pRsp) {
   int32_t code = 0;
   terrno = 0;
@@ -1285,6 +1462,7 @@ static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t ver, void *pReq, in
   pRsp->code = TSDB_CODE_SUCCESS;
 
   void           *pAllocMsg = NULL;
+  bool            inBufPool = false;
   SSubmitReq2Msg *pMsg = (SSubmitReq2Msg *)pReq;
   if (0 == pMsg->version) {
     code = vnodeSubmitReqConvertToSubmitReq2(pVnode, (SSubmitReq *)pMsg, pSubmitReq);
@@ -1408,8 +1586,17 @@ static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t ver, void *pReq, in
     }
   }
 
+  // only a submit passing the checks takes room in the buffer pool, the memtable then references its rows and columns
+  // instead of copying them one by one
+  if (pAllocMsg == NULL) {
+    inBufPool = (vnodeCopySubmitReqToBufPool(pVnode->inUse, pSubmitReq, pReq, len) == 0);
+  }
+
   vDebug("vgId:%d, submit block size %d", TD_VID(pVnode), (int32_t)taosArrayGetSize(pSubmitReq->aSubmitTbData));
 
+  // tables are created first if the data is inserted by several threads
+  int32_t nInsertTask = vnodeGetNumOfInsertTasks(pVnode, pSubmitReq);
+
   // loop to handle
   for (int32_t i = 0; i < TARRAY_SIZE(pSubmitReq->aSubmitTbData); ++i) {
     SSubmitTbData *pSubmitTbData = taosArrayGet(pSubmitReq->aSubmitTbData, i);
@@ -1458,9 +1645,13 @@ static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t ver, void *pReq, in
       }
     }
 
+    if (nInsertTask > 1) {
+      continue;
+    }
+
     // insert data
     int32_t affectedRows;
-    code = tsdbInsertTableData(pVnode->pTsdb, ver, pSubmitTbData, &affectedRows);
+    code = tsdbInsertTableData(pVnode->pTsdb, ver, pSubmitTbData, inBufPool, &affectedRows);
     if (code) goto _exit;
 
     code = metaUpdateChangeTime(pVnode->pMeta, pSubmitTbData->uid, pSubmitTbData->ctimeMs);
@@ -1469,6 +1660,19 @@ static int32_t vnodeProcessSubmitReq(SVnode *pVnode, int64_t ver, void *pReq, in
     pSubmitRsp->affectedRows += affectedRows;
   }
 
+  if (nInsertTask > 1) {
+    code = vnodeInsertTableDataInParallel(pVnode, ver, pSubmitReq, inBufPool, nInsertTask,
+                                          &pSubmitRsp->affectedRows);
+    if (code) goto _exit;
+
+    for (int32_t i = 0; i < TARRAY_SIZE(pSubmitReq->aSubmitTbData); ++i) {
+      SSubmitTbData *pSubmitTbData = taosArrayGet(pSubmitReq->aSubmitTbData, i);
+
+      code = metaUpdateChangeTime(pVnode->pMeta, pSubmitTbData->uid, pSubmitTbData->ctimeMs);
+      if (code) goto _exit;
+    }
+  }
+
   // update the affected table uid list
   if (taosArrayGetSize(newTbUids) > 0) {
     vDebug("vgId:%d, add %d table into query table list in handling submit", TD_VID(pVnode),
@@ -18,6 +18,9 @@
 
 #define BATCH_ENABLE 0
 
+// proposals in one wal fsync at most, well inside the sync negotiation window
+#define VNODE_GROUP_COMMIT_SIZE 256
+
 static inline bool vnodeIsMsgWeak(tmsg_t type) { return false; }
 
 static inline void vnodeWaitBlockMsg(SVnode *pVnode, const SRpcMsg *pMsg) {
@@ -80,7 +83,11 @@ static void inline vnodeHandleWriteMsg(SVnode *pVnode, SRpcMsg *pMsg) {
     vGError("vgId:%d, msg:%p failed to apply right now since %s", pVnode->config.vgId, pMsg, terrstr());
   }
   if (rsp.info.handle != NULL) {
-    tmsgSendRsp(&rsp);
+    if (pVnode->groupCommit) {
+      taosArrayPush(pVnode->aGroupRsp, &rsp);
+    } else {
+      tmsgSendRsp(&rsp);
+    }
   } else {
     if (rsp.pCont) {
       rpcFreeCont(rsp.pCont);
@@ -88,6 +95,41 @@ static void inline vnodeHandleWriteMsg(SVnode *pVnode, SRpcMsg *pMsg) {
   }
 }
 
+// With the wal fsynced on every write, the proposals of one write-queue batch share an fsync. They are applied as they
+// are proposed, their responses wait for the fsync.
+static void vnodeBeginGroupCommit(SVnode *pVnode, int32_t numOfMsgs) {
+  if (pVnode->groupCommit || numOfMsgs <= 1) return;
+  if (pVnode->pWal->cfg.level != TAOS_WAL_FSYNC || pVnode->pWal->cfg.fsyncPeriod != 0) return;
+
+  // reserved up front, so that holding a response never fails
+  SArray *aRsp = taosArrayInit(TMIN(numOfMsgs, VNODE_GROUP_COMMIT_SIZE), sizeof(SRpcMsg));
+  if (aRsp == NULL) return;
+
+  if (!syncBeginGroupCommit(pVnode->sync)) {
+    taosArrayDestroy(aRsp);
+    return;
+  }
+
+  pVnode->groupCommit = true;
+  pVnode->nGroupMsg = 0;
+  pVnode->aGroupRsp = aRsp;
+}
+
+static void vnodeEndGroupCommit(SVnode *pVnode) {
+  if (!pVnode->groupCommit) return;
+
+  syncEndGroupCommit(pVnode->sync);
+  vTrace("vgId:%d, group commit of %d msgs done", pVnode->config.vgId, pVnode->nGroupMsg);
+
+  for (int32_t i = 0; i < taosArrayGetSize(pVnode->aGroupRsp); i++) {
+    tmsgSendRsp(taosArrayGet(pVnode->aGroupRsp, i));
+  }
+  taosArrayDestroy(pVnode->aGroupRsp);
+  pVnode->aGroupRsp = NULL;
+  pVnode->nGroupMsg = 0;
+  pVnode->groupCommit = false;
+}
+
 static void vnodeHandleProposeError(SVnode *pVnode, SRpcMsg *pMsg, int32_t code) {
   if (code == TSDB_CODE_SYN_NOT_LEADER || code == TSDB_CODE_SYN_RESTORING) {
     vnodeRedirectRpcMsg(pVnode, pMsg, code);
@@ -104,6 +146,13 @@ static void vnodeHandleProposeError(SVnode *pVnode, SRpcMsg *pMsg, int32_t code)
 static int32_t inline vnodeProposeMsg(SVnode *pVnode, SRpcMsg *pMsg, bool isWeak) {
   int64_t seq = 0;
 
+  // a blocking msg, a vnode commit among them, goes after what is grouped before it is on disk
+  if (vnodeIsMsgBlock(pMsg->msgType)) {
+    vnodeEndGroupCommit(pVnode);
+  } else if (pVnode->groupCommit) {
+    pVnode->nGroupMsg++;
+  }
+
   taosThreadMutexLock(&pVnode->lock);
   int32_t code = syncPropose(pVnode->sync, pMsg, isWeak, &seq);
   bool    wait = (code == 0 && vnodeIsMsgBlock(pMsg->msgType));
@@ -299,12 +348,17 @@ void vnodeProposeWriteMsg(SQueueInfo *pInfo, STaosQall *qall, int32_t numOfMsgs)
       continue;
     }
 
+    if (pVnode->nGroupMsg >= VNODE_GROUP_COMMIT_SIZE) vnodeEndGroupCommit(pVnode);
+    if (!vnodeIsMsgBlock(pMsg->msgType)) vnodeBeginGroupCommit(pVnode, numOfMsgs - msg);
+
     code = vnodeProposeMsg(pVnode, pMsg, isWeak);
 
     vGTrace("vgId:%d, msg:%p is freed, code:0x%x", vgId, pMsg, code);
     rpcFreeCont(pMsg->pCont);
     taosFreeQitem(pMsg);
   }
+
+  vnodeEndGroupCommit(pVnode);
 }
 
 #endif
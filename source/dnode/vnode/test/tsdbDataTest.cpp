@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "tglobal.h"
+#include "tsdb.h"
+
+namespace {
+
+// a null is an absent optional
+typedef std::vector<std::pair<bool, std::string>> SColValues;
+
+void tsdbTestBuildColData(SColData *pColData, int8_t type, const SColValues &values) {
+  tColDataInit(pColData, 2, type, 0);
+  for (size_t i = 0; i < values.size(); i++) {
+    SColVal cv;
+    if (values[i].first) {
+      cv = COL_VAL_VALUE(2, type, ((SValue){.nData = (uint32_t)values[i].second.size(),
+                                            .pData = (uint8_t *)values[i].second.data()}));
+    } else {
+      cv = COL_VAL_NULL(2, type);
+    }
+    ASSERT_EQ(tColDataAppendValue(pColData, &cv), 0);
+  }
+}
+
+// compresses the column and reads it back, nDict is that of the column read
+void tsdbTestRoundTrip(int8_t type, int8_t cmprAlg, const SColValues &values, int32_t *nDict) {
+  SColData colData = {0};
+  SColData outData = {0};
+  uint8_t *aBuf[2] = {0};
+  uint8_t *pOut = NULL;
+
+  tsdbTestBuildColData(&colData, type, values);
+
+  SBlockCol blockCol = {.cid = colData.cid,
+                        .type = colData.type,
+                        .smaOn = colData.smaOn,
+                        .flag = colData.flag,
+                        .szOrigin = colData.nData};
+  ASSERT_EQ(tsdbCmprColData(&colData, cmprAlg, &blockCol, &pOut, 0, &aBuf[0]), 0);
+
+  tColDataInit(&outData, colData.cid, colData.type, 0);
+  ASSERT_EQ(tsdbDecmprColData(pOut, &blockCol, cmprAlg, colData.nVal, &outData, &aBuf[1]), 0);
+  *nDict = outData.nDict;
+
+  ASSERT_EQ(outData.nVal, (int32_t)values.size());
+  ASSERT_EQ(outData.nData, colData.nData);
+  for (int32_t i = 0; i < outData.nVal; i++) {
+    SColVal cv;
+    tColDataGetValue(&outData, i, &cv);
+    ASSERT_EQ(COL_VAL_IS_VALUE(&cv), values[i].first) << "row " << i;
+    if (values[i].first) {
+      ASSERT_EQ(std::string((char *)cv.value.pData, cv.value.nData), values[i].second) << "row " << i;
+    }
+  }
+
+  // the codes kept for the reader stand for the values of the rows, one code per value
+  int32_t                       *aCode = outData.aOffset + outData.nVal;
+  std::map<std::string, int32_t> codes;
+  std::set<int32_t>              used;
+  for (int32_t i = 0; i < outData.nVal && outData.nDict > 0; i++) {
+    ASSERT_GE(aCode[i], 0);
+    ASSERT_LT(aCode[i], outData.nDict);
+    if (values[i].first) {
+      auto it = codes.insert({values[i].second, aCode[i]});
+      ASSERT_EQ(it.first->second, aCode[i]) << "row " << i;
+      if (it.second) {
+        ASSERT_TRUE(used.insert(aCode[i]).second) << "row " << i;
+      }
+    }
+  }
+
+  tColDataDestroy(&colData);
+  tColDataDestroy(&outData);
+  tFree(pOut);
+  tFree(aBuf[0]);
+  tFree(aBuf[1]);
+}
+
+class TsdbColDictTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    adaptiveCompress = tsAdaptiveCompress;
+    tsAdaptiveCompress = true;
+  }
+  void TearDown() override { tsAdaptiveCompress = adaptiveCompress; }
+
+  bool adaptiveCompress;
+};
+
+}  // namespace
+
+TEST_F(TsdbColDictTest, lowCardinality) {
+  const char *status[] = {"OK", "WARN", "ERROR", "", "a much longer status value to make the dictionary worth it"};
+  SColValues  values;
+  for (int32_t i = 0; i < 1000; i++) {
+    values.push_back({true, status[(i * 7 + i / 3) % 5]});
+  }
+
+  int8_t types[] = {TSDB_DATA_TYPE_BINARY, TSDB_DATA_TYPE_NCHAR};
+  int8_t algs[] = {ONE_STAGE_COMP, TWO_STAGE_COMP};
+  for (int8_t type : types) {
+    for (int8_t cmprAlg : algs) {
+      int32_t nDict = 0;
+      tsdbTestRoundTrip(type, cmprAlg, values, &nDict);
+      ASSERT_EQ(nDict, 5);
+    }
+  }
+
+  // never without compression
+  int32_t nDict = 0;
+  tsdbTestRoundTrip(TSDB_DATA_TYPE_BINARY, NO_COMPRESSION, values, &nDict);
+  ASSERT_EQ(nDict, 0);
+}
+
+TEST_F(TsdbColDictTest, withNulls) {
+  SColValues values;
+  for (int32_t i = 0; i < 600; i++) {
+    if (i % 3 == 0 || (i >= 200 && i < 260)) {
+      values.push_back({false, ""});
+    } else {
+      values.push_back({true, "value of group " + std::to_string(i % 11)});
+    }
+  }
+
+  int32_t nDict = 0;
+  tsdbTestRoundTrip(TSDB_DATA_TYPE_BINARY, TWO_STAGE_COMP, values, &nDict);
+  ASSERT_GT(nDict, 0);
+  ASSERT_LE(nDict, 12);  // the nulls have no payload, they share the empty entry
+}
+
+TEST_F(TsdbColDictTest, allDistinct) {
+  SColValues values;
+  for (int32_t i = 0; i < 1000; i++) {
+    values.push_back({true, "distinct value " + std::to_string(i * 7919)});
+  }
+
+  int32_t nDict = -1;
+  tsdbTestRoundTrip(TSDB_DATA_TYPE_BINARY, TWO_STAGE_COMP, values, &nDict);
+  ASSERT_EQ(nDict, 0);
+
+  // one past the largest dictionary
+  values.clear();
+  for (int32_t i = 0; i < 4 * TSDB_DICT_MAX_SIZE; i++) {
+    values.push_back({true, "v" + std::to_string(i % (TSDB_DICT_MAX_SIZE + 1))});
+  }
+  tsdbTestRoundTrip(TSDB_DATA_TYPE_BINARY, TWO_STAGE_COMP, values, &nDict);
+  ASSERT_EQ(nDict, 0);
+}
+
+TEST_F(TsdbColDictTest, singleValue) {
+  SColValues values(4096, {true, "the only value of the column"});
+
+  int32_t nDict = 0;
+  tsdbTestRoundTrip(TSDB_DATA_TYPE_BINARY, ONE_STAGE_COMP, values, &nDict);
+  ASSERT_EQ(nDict, 1);
+
+  // too few rows for a dictionary
+  SColValues few(8, {true, "the only value of the column"});
+  tsdbTestRoundTrip(TSDB_DATA_TYPE_BINARY, ONE_STAGE_COMP, few, &nDict);
+  ASSERT_EQ(nDict, 0);
+}
+
+TEST_F(TsdbColDictTest, adaptiveCompressOff) {
+  tsAdaptiveCompress = false;
+
+  SColValues values(1000, {true, "OK"});
+  int32_t    nDict = -1;
+  tsdbTestRoundTrip(TSDB_DATA_TYPE_BINARY, TWO_STAGE_COMP, values, &nDict);
+  ASSERT_EQ(nDict, 0);
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "tglobal.h"
+#include "tsdb.h"
+#include "vnd.h"
+
+namespace {
+
+const int32_t nWriter = 4;
+const int32_t nReader = 2;
+const int32_t nTablePerWriter = 200;
+const int32_t nRound = 10;
+const int32_t nRowPerRound = 10;
+const TSKEY   startTs = 1640966400000;
+const int64_t suid = 1000;
+
+class TsdbMemTableTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    SSchema aSchema[] = {
+        {.type = TSDB_DATA_TYPE_TIMESTAMP, .colId = PRIMARYKEY_TIMESTAMP_COL_ID, .bytes = 8},
+        {.type = TSDB_DATA_TYPE_BIGINT, .colId = 2, .bytes = 8},
+    };
+    pTSchema = tBuildTSchema(aSchema, 2, 1);
+    ASSERT_NE(pTSchema, nullptr);
+
+    // the pools of a vnode with insert threads are locked
+    insertThreads = tsNumOfVnodeInsertThreads;
+    tsNumOfVnodeInsertThreads = nWriter;
+
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    ASSERT_NE(pVnode, nullptr);
+    pVnode->config.szBuf = 16 << 20;
+    pVnode->config.tsdbCfg.slLevel = 5;
+    ASSERT_EQ(vnodeOpenBufPool(pVnode), 0);
+    ASSERT_NE(pVnode->freeList->lock, nullptr);
+    // as vnodeBegin takes the pool
+    pVnode->inUse = pVnode->freeList;
+    pVnode->inUse->nRef = 1;
+    pVnode->freeList = pVnode->inUse->freeNext;
+    pVnode->inUse->freeNext = NULL;
+
+    pTsdb = (STsdb *)taosMemoryCalloc(1, sizeof(STsdb));
+    ASSERT_NE(pTsdb, nullptr);
+    pTsdb->pVnode = pVnode;
+    ASSERT_EQ(tsdbMemTableCreate(pTsdb, &pTsdb->mem), 0);
+  }
+
+  void TearDown() override {
+    if (pTsdb) {
+      tsdbMemTableDestroy(pTsdb->mem, false);
+      taosMemoryFree(pTsdb);
+    }
+    if (pVnode) {
+      vnodeCloseBufPool(pVnode);
+      taosMemoryFree(pVnode);
+    }
+    taosMemoryFree(pTSchema);
+    tsNumOfVnodeInsertThreads = insertThreads;
+  }
+
+  // the rounds of a table go in pairs, the later first, so that rows also land before the existing ones
+  void writeTables(int32_t iWriter) {
+    for (int32_t r = 0; r < nRound; r++) {
+      int32_t round = r ^ 1;
+      for (int32_t i = 0; i < nTablePerWriter; i++) {
+        SSubmitTbData tbData = {.suid = suid, .uid = (int64_t)(i * nWriter + iWriter + 1), .sver = 1};
+        tbData.aRowP = taosArrayInit(nRowPerRound, sizeof(SRow *));
+        for (int32_t j = 0; j < nRowPerRound; j++) {
+          TSKEY   ts = startTs + round * nRowPerRound + j;
+          SArray *aColVal = taosArrayInit(2, sizeof(SColVal));
+          SColVal cv = COL_VAL_VALUE(PRIMARYKEY_TIMESTAMP_COL_ID, TSDB_DATA_TYPE_TIMESTAMP, ((SValue){.val = ts}));
+          taosArrayPush(aColVal, &cv);
+          cv = COL_VAL_VALUE(2, TSDB_DATA_TYPE_BIGINT, ((SValue){.val = ts * 2 + tbData.uid}));
+          taosArrayPush(aColVal, &cv);
+
+          SRow *pRow = NULL;
+          ASSERT_EQ(tRowBuild(aColVal, pTSchema, &pRow), 0);
+          taosArrayPush(tbData.aRowP, &pRow);
+          taosArrayDestroy(aColVal);
+        }
+
+        int32_t affectedRows = 0;
+        ASSERT_EQ(tsdbInsertTableData(pTsdb, ++version, &tbData, false, &affectedRows), 0);
+        ASSERT_EQ(affectedRows, nRowPerRound);
+        taosArrayDestroyP(tbData.aRowP, (FDelete)tRowDestroy);
+      }
+    }
+  }
+
+  // the rows of a table found while it is written, in key order and from its writer
+  void readTables(int32_t iReader) {
+    uint64_t seed = iReader + 1;
+    while (nWriting.load() > 0) {
+      seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+      int64_t  uid = (int64_t)((seed >> 16) % (nWriter * nTablePerWriter)) + 1;
+      STbData *pTbData = tsdbGetTbDataFromMemTable(pTsdb->mem, suid, uid);
+      if (pTbData == NULL) {
+        continue;
+      }
+      ASSERT_EQ(pTbData->uid, uid);
+
+      STbDataIter iter;
+      TSKEY       lastTs = TSKEY_MIN;
+      tsdbTbDataIterOpen(pTbData, NULL, 0, &iter);
+      for (TSDBROW *pRow; (pRow = tsdbTbDataIterGet(&iter)) != NULL; tsdbTbDataIterNext(&iter)) {
+        SColVal cv;
+        tsdbRowGetColVal(pRow, pTSchema, 1, &cv);
+        ASSERT_GT(TSDBROW_TS(pRow), lastTs);
+        ASSERT_EQ(cv.value.val, TSDBROW_TS(pRow) * 2 + uid);
+        lastTs = TSDBROW_TS(pRow);
+      }
+    }
+  }
+
+  STSchema            *pTSchema = NULL;
+  SVnode              *pVnode = NULL;
+  STsdb               *pTsdb = NULL;
+  int32_t              insertThreads = 0;
+  std::atomic<int64_t> version{0};
+  std::atomic<int32_t> nWriting{0};
+};
+
+}  // namespace
+
+TEST_F(TsdbMemTableTest, concurrentInsertAndLookup) {
+  std::vector<std::thread> threads;
+  nWriting = nWriter;
+  for (int32_t i = 0; i < nWriter; i++) {
+    threads.emplace_back([this, i] {
+      writeTables(i);
+      nWriting--;
+    });
+  }
+  for (int32_t i = 0; i < nReader; i++) {
+    threads.emplace_back([this, i] { readTables(i); });
+  }
+  for (std::thread &t : threads) {
+    t.join();
+  }
+
+  SMemTable *pMemTable = pTsdb->mem;
+  int64_t    nTable = nWriter * nTablePerWriter;
+  int64_t    nRowPerTable = nRound * nRowPerRound;
+  ASSERT_EQ(pMemTable->nTbData, nTable);
+  ASSERT_EQ(pMemTable->nRow, nTable * nRowPerTable);
+  ASSERT_EQ(pMemTable->minKey, startTs);
+  ASSERT_EQ(pMemTable->maxKey, startTs + nRowPerTable - 1);
+  ASSERT_EQ(pMemTable->minVer, 1);
+  ASSERT_EQ(pMemTable->maxVer, nTable * nRound);
+
+  // each table once, with all its rows in key order
+  for (int64_t uid = 1; uid <= nTable; uid++) {
+    STbData *pTbData = tsdbGetTbDataFromMemTable(pMemTable, suid, uid);
+    ASSERT_NE(pTbData, nullptr) << "uid " << uid;
+    ASSERT_EQ(pTbData->sl.size, nRowPerTable);
+
+    STbDataIter iter;
+    int64_t     n = 0;
+    tsdbTbDataIterOpen(pTbData, NULL, 0, &iter);
+    for (TSDBROW *pRow; (pRow = tsdbTbDataIterGet(&iter)) != NULL; tsdbTbDataIterNext(&iter)) {
+      SColVal cv;
+      tsdbRowGetColVal(pRow, pTSchema, 1, &cv);
+      ASSERT_EQ(TSDBROW_TS(pRow), startTs + n);
+      ASSERT_EQ(cv.value.val, TSDBROW_TS(pRow) * 2 + uid);
+      n++;
+    }
+    ASSERT_EQ(n, nRowPerTable);
+  }
+
+  int32_t nTbData = 0;
+  for (SRBTreeIter rbIter = tRBTreeIterCreate(pMemTable->tbDataTree, 1); tRBTreeIterNext(&rbIter) != NULL;) {
+    nTbData++;
+  }
+  ASSERT_EQ(nTbData, nTable);
+}
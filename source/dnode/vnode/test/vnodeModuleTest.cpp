@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "tglobal.h"
+#include "vnd.h"
+
+namespace {
+
+std::mutex               doneMutex;
+std::vector<std::string> done;
+
+// a task that keeps its thread until it is opened
+struct SGate {
+  std::atomic<bool> started{false};
+  std::atomic<bool> open{false};
+};
+
+int runGate(void *arg) {
+  SGate *pGate = (SGate *)arg;
+  pGate->started = true;
+  while (!pGate->open.load()) {
+    taosMsleep(1);
+  }
+  return 0;
+}
+
+int runNamed(void *arg) {
+  std::lock_guard<std::mutex> guard(doneMutex);
+  done.push_back((const char *)arg);
+  return 0;
+}
+
+// a merge or commit task writing 1 MB at a time
+struct SWriter {
+  int32_t           nMB;
+  int64_t           elapsedMs;
+  std::atomic<bool> finished{false};
+};
+
+int runWriter(void *arg) {
+  SWriter *pWriter = (SWriter *)arg;
+  int64_t  startMs = taosGetTimestampMs();
+  for (int32_t i = 0; i < pWriter->nMB; i++) {
+    vnodeThrottleBgWrite(1 << 20);
+  }
+  pWriter->elapsedMs = taosGetTimestampMs() - startMs;
+  pWriter->finished = true;
+  return 0;
+}
+
+template <typename F>
+void waitFor(F cond) {
+  for (int32_t i = 0; i < 10000 && !cond(); i++) {
+    taosMsleep(1);
+  }
+  ASSERT_TRUE(cond());
+}
+
+class VnodeModuleTest : public ::testing::Test {
+ protected:
+  // one commit thread, one background thread and one insert thread
+  static void SetUpTestCase() {
+    insertThreads = tsNumOfVnodeInsertThreads;
+    rateLimit = tsBgWriteRateLimit;
+    tsNumOfVnodeInsertThreads = 2;
+    ASSERT_EQ(vnodeInit(1), 0);
+  }
+
+  static void TearDownTestCase() {
+    vnodeCleanup();
+    tsNumOfVnodeInsertThreads = insertThreads;
+    tsBgWriteRateLimit = rateLimit;
+  }
+
+  void SetUp() override { done.clear(); }
+
+  static int32_t insertThreads;
+  static int32_t rateLimit;
+};
+
+int32_t VnodeModuleTest::insertThreads = 0;
+int32_t VnodeModuleTest::rateLimit = 0;
+
+}  // namespace
+
+TEST_F(VnodeModuleTest, classPriorityAndRoundRobin) {
+  // the merge gate can only go to the background thread, the commit gate then to the idle commit thread
+  SGate mergeGate, commitGate;
+  ASSERT_EQ(vnodeScheduleTaskEx(VND_TASK_MERGE, 100, runGate, &mergeGate), 0);
+  waitFor([&] { return mergeGate.started.load(); });
+  ASSERT_EQ(vnodeScheduleTaskEx(VND_TASK_COMMIT, 100, runGate, &commitGate), 0);
+  waitFor([&] { return commitGate.started.load(); });
+
+  ASSERT_EQ(vnodeScheduleTaskEx(VND_TASK_RETENTION, 1, runNamed, (void *)"r1"), 0);
+  ASSERT_EQ(vnodeScheduleTaskEx(VND_TASK_MERGE, 1, runNamed, (void *)"m1"), 0);
+  ASSERT_EQ(vnodeScheduleTaskEx(VND_TASK_MERGE, 1, runNamed, (void *)"m2"), 0);
+  ASSERT_EQ(vnodeScheduleTaskEx(VND_TASK_MERGE, 1, runNamed, (void *)"m3"), 0);
+  ASSERT_EQ(vnodeScheduleTaskEx(VND_TASK_MERGE, 2, runNamed, (void *)"m4"), 0);
+  ASSERT_EQ(vnodeScheduleTaskEx(VND_TASK_MERGE, 3, runNamed, (void *)"m5"), 0);
+  ASSERT_EQ(vnodeScheduleTaskEx(VND_TASK_COMMIT, 2, runNamed, (void *)"c1"), 0);
+  ASSERT_EQ(vnodeScheduleTaskEx(VND_TASK_COMMIT, 2, runNamed, (void *)"c2"), 0);
+
+  // the commits first, then the merges of the vnodes in turn, then the retention
+  mergeGate.open = true;
+  waitFor([] {
+    std::lock_guard<std::mutex> guard(doneMutex);
+    return done.size() == 8;
+  });
+  commitGate.open = true;
+
+  std::vector<std::string> expect = {"c1", "c2", "m1", "m4", "m5", "m2", "m3", "r1"};
+  ASSERT_EQ(done, expect);
+}
+
+TEST_F(VnodeModuleTest, insertRoundRobin) {
+  SGate gate;
+  ASSERT_EQ(vnodeScheduleInsertTask(100, runGate, &gate), 0);
+  waitFor([&] { return gate.started.load(); });
+
+  ASSERT_EQ(vnodeScheduleInsertTask(1, runNamed, (void *)"a1"), 0);
+  ASSERT_EQ(vnodeScheduleInsertTask(1, runNamed, (void *)"a2"), 0);
+  ASSERT_EQ(vnodeScheduleInsertTask(1, runNamed, (void *)"a3"), 0);
+  ASSERT_EQ(vnodeScheduleInsertTask(2, runNamed, (void *)"b1"), 0);
+  ASSERT_EQ(vnodeScheduleInsertTask(2, runNamed, (void *)"b2"), 0);
+  ASSERT_EQ(vnodeScheduleInsertTask(3, runNamed, (void *)"c1"), 0);
+
+  gate.open = true;
+  waitFor([] {
+    std::lock_guard<std::mutex> guard(doneMutex);
+    return done.size() == 6;
+  });
+
+  std::vector<std::string> expect = {"a1", "b1", "c1", "a2", "b2", "a3"};
+  ASSERT_EQ(done, expect);
+}
+
+TEST_F(VnodeModuleTest, throttledBgWrite) {
+  // 128 MB at 64 MB/s: the burst of at most one second, then the rest at the rate
+  tsBgWriteRateLimit = 64;
+
+  SWriter merge;
+  merge.nMB = 128;
+  ASSERT_EQ(vnodeScheduleTaskEx(VND_TASK_MERGE, 1, runWriter, &merge), 0);
+  waitFor([&] { return merge.finished.load(); });
+  EXPECT_GE(merge.elapsedMs, 900);
+  EXPECT_LE(merge.elapsedMs, 4000);
+
+  // commits are not throttled
+  SWriter commit;
+  commit.nMB = 128;
+  ASSERT_EQ(vnodeScheduleTaskEx(VND_TASK_COMMIT, 1, runWriter, &commit), 0);
+  waitFor([&] { return commit.finished.load(); });
+  EXPECT_LT(commit.elapsedMs, 200);
+
+  tsBgWriteRateLimit = 0;
+}
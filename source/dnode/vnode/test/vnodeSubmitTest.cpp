@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "vnd.h"
+
+namespace {
+
+const int32_t nRow = 300;
+const TSKEY   startTs = 1640966400000;
+
+std::string vnodeTestBinary(int32_t i) { return "value " + std::to_string(i * 31); }
+
+// every 7th binary is null
+bool vnodeTestIsNull(int32_t i) { return i % 7 == 3; }
+
+void vnodeTestCheckColVal(const SColVal &cv, int8_t type, int32_t i) {
+  if (type == TSDB_DATA_TYPE_TIMESTAMP) {
+    ASSERT_TRUE(COL_VAL_IS_VALUE(&cv));
+    ASSERT_EQ(cv.value.val, startTs + i);
+  } else if (type == TSDB_DATA_TYPE_INT) {
+    ASSERT_TRUE(COL_VAL_IS_VALUE(&cv));
+    ASSERT_EQ((int32_t)cv.value.val, i * 3);
+  } else if (vnodeTestIsNull(i)) {
+    ASSERT_TRUE(COL_VAL_IS_NULL(&cv)) << "row " << i;
+  } else {
+    ASSERT_TRUE(COL_VAL_IS_VALUE(&cv)) << "row " << i;
+    ASSERT_EQ(std::string((char *)cv.value.pData, cv.value.nData), vnodeTestBinary(i)) << "row " << i;
+  }
+}
+
+class VnodeSubmitTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    SSchema aSchema[] = {
+        {.type = TSDB_DATA_TYPE_TIMESTAMP, .colId = PRIMARYKEY_TIMESTAMP_COL_ID, .bytes = 8},
+        {.type = TSDB_DATA_TYPE_INT, .colId = 2, .bytes = 4},
+        {.type = TSDB_DATA_TYPE_BINARY, .colId = 3, .bytes = 32 + VARSTR_HEADER_SIZE},
+    };
+    pTSchema = tBuildTSchema(aSchema, 3, 1);
+    ASSERT_NE(pTSchema, nullptr);
+
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    ASSERT_NE(pVnode, nullptr);
+    pVnode->config.szBuf = 1 << 20;
+    ASSERT_EQ(vnodeOpenBufPool(pVnode), 0);
+  }
+
+  void TearDown() override {
+    vnodeCloseBufPool(pVnode);
+    taosMemoryFree(pVnode);
+    taosMemoryFree(pTSchema);
+  }
+
+  SColVal colVal(int32_t iCol, int32_t i, std::string &buf) {
+    const STColumn *pCol = &pTSchema->columns[iCol];
+    if (pCol->type == TSDB_DATA_TYPE_TIMESTAMP) {
+      return COL_VAL_VALUE(pCol->colId, pCol->type, ((SValue){.val = startTs + i}));
+    } else if (pCol->type == TSDB_DATA_TYPE_INT) {
+      return COL_VAL_VALUE(pCol->colId, pCol->type, ((SValue){.val = i * 3}));
+    } else if (vnodeTestIsNull(i)) {
+      return COL_VAL_NULL(pCol->colId, pCol->type);
+    }
+    buf = vnodeTestBinary(i);
+    return COL_VAL_VALUE(pCol->colId, pCol->type,
+                         ((SValue){.nData = (uint32_t)buf.size(), .pData = (uint8_t *)buf.data()}));
+  }
+
+  // a table of rows and a table of columns, with the same values
+  void buildSubmitReq(SSubmitReq2 *pReq) {
+    pReq->aSubmitTbData = taosArrayInit(2, sizeof(SSubmitTbData));
+
+    SSubmitTbData rowData = {.suid = 0, .uid = 100, .sver = 1};
+    rowData.aRowP = taosArrayInit(nRow, sizeof(SRow *));
+    for (int32_t i = 0; i < nRow; i++) {
+      std::string buf;
+      SArray     *aColVal = taosArrayInit(pTSchema->numOfCols, sizeof(SColVal));
+      for (int32_t iCol = 0; iCol < pTSchema->numOfCols; iCol++) {
+        SColVal cv = colVal(iCol, i, buf);
+        taosArrayPush(aColVal, &cv);
+      }
+      SRow *pRow = NULL;
+      ASSERT_EQ(tRowBuild(aColVal, pTSchema, &pRow), 0);
+      taosArrayPush(rowData.aRowP, &pRow);
+      taosArrayDestroy(aColVal);
+    }
+    taosArrayPush(pReq->aSubmitTbData, &rowData);
+
+    SSubmitTbData colData = {.flags = SUBMIT_REQ_COLUMN_DATA_FORMAT, .suid = 0, .uid = 101, .sver = 1};
+    colData.aCol = taosArrayInit(pTSchema->numOfCols, sizeof(SColData));
+    for (int32_t iCol = 0; iCol < pTSchema->numOfCols; iCol++) {
+      SColData *pColData = (SColData *)taosArrayReserve(colData.aCol, 1);
+      tColDataInit(pColData, pTSchema->columns[iCol].colId, pTSchema->columns[iCol].type, 0);
+      for (int32_t i = 0; i < nRow; i++) {
+        std::string buf;
+        SColVal     cv = colVal(iCol, i, buf);
+        ASSERT_EQ(tColDataAppendValue(pColData, &cv), 0);
+      }
+    }
+    taosArrayPush(pReq->aSubmitTbData, &colData);
+  }
+
+  STSchema *pTSchema = NULL;
+  SVnode   *pVnode = NULL;
+};
+
+}  // namespace
+
+TEST_F(VnodeSubmitTest, copyToBufPool) {
+  SSubmitReq2 req = {0};
+  buildSubmitReq(&req);
+
+  int32_t  code = 0;
+  uint32_t len = 0;
+  tEncodeSize(tEncodeSubmitReq, &req, len, code);
+  ASSERT_EQ(code, 0);
+  std::vector<uint8_t> msg(len);
+  SEncoder             ec = {0};
+  tEncoderInit(&ec, msg.data(), len);
+  ASSERT_EQ(tEncodeSubmitReq(&ec, &req), 0);
+  tEncoderClear(&ec);
+  tDestroySubmitReq(&req, TSDB_MSG_FLG_ENCODE);
+
+  SSubmitReq2 decoded = {0};
+  SDecoder    dc = {0};
+  tDecoderInit(&dc, msg.data(), len);
+  ASSERT_EQ(tDecodeSubmitReq(&dc, &decoded), 0);
+  tDecoderClear(&dc);
+
+  SVBufPool *pPool = pVnode->freeList;
+  int64_t    size = pPool->size;
+  ASSERT_EQ(vnodeCopySubmitReqToBufPool(pPool, &decoded, msg.data(), len), 0);
+  ASSERT_GE(pPool->size - size, len);
+
+  // nothing may point into the message any more
+  std::fill(msg.begin(), msg.end(), 0xff);
+  uint8_t *pBegin = pPool->node.data;
+  uint8_t *pEnd = pPool->ptr;
+
+  SSubmitTbData *pRowData = (SSubmitTbData *)taosArrayGet(decoded.aSubmitTbData, 0);
+  ASSERT_EQ(TARRAY_SIZE(pRowData->aRowP), nRow);
+  for (int32_t i = 0; i < nRow; i++) {
+    SRow *pRow = *(SRow **)taosArrayGet(pRowData->aRowP, i);
+    ASSERT_TRUE((uint8_t *)pRow >= pBegin && (uint8_t *)pRow + pRow->len <= pEnd);
+    for (int32_t iCol = 0; iCol < pTSchema->numOfCols; iCol++) {
+      SColVal cv;
+      ASSERT_EQ(tRowGet(pRow, pTSchema, iCol, &cv), 0);
+      vnodeTestCheckColVal(cv, pTSchema->columns[iCol].type, i);
+    }
+  }
+
+  SSubmitTbData *pColData = (SSubmitTbData *)taosArrayGet(decoded.aSubmitTbData, 1);
+  ASSERT_EQ(TARRAY_SIZE(pColData->aCol), pTSchema->numOfCols);
+  for (int32_t iCol = 0; iCol < pTSchema->numOfCols; iCol++) {
+    SColData *pCol = (SColData *)taosArrayGet(pColData->aCol, iCol);
+    ASSERT_TRUE(pCol->pData >= pBegin && pCol->pData + pCol->nData <= pEnd);
+    ASSERT_EQ(pCol->nVal, nRow);
+    for (int32_t i = 0; i < nRow; i++) {
+      SColVal cv;
+      tColDataGetValue(pCol, i, &cv);
+      vnodeTestCheckColVal(cv, pCol->type, i);
+    }
+  }
+
+  tDestroySubmitReq(&decoded, TSDB_MSG_FLG_DECODE);
+}
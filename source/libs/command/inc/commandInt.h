@@ -96,6 +96,9 @@ extern "C" {
 #define EXPLAIN_OFFSET_FORMAT "offset=%" PRId64
 #define EXPLAIN_SOFFSET_FORMAT "soffset=%" PRId64
 #define EXPLAIN_PARTITIONS_FORMAT "partitions=%d"
+#define EXPLAIN_GROUP_SPILL_FORMAT "Group Hash Spill: loops=%d groups=%" PRId64
+#define EXPLAIN_HASH_JOIN_FORMAT "Hash %s"
+#define EXPLAIN_HASH_JOIN_BUILD_FORMAT "Hash Build: side=%s rows=%" PRId64 " spilled_partitions=%d"
 
 #define COMMAND_RESET_LOG "resetLog"
 #define COMMAND_SCHEDULE_POLICY "schedulePolicy"
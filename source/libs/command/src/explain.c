@@ -586,6 +586,77 @@ int32_t qExplainResNodeToRowsImpl(SExplainResNode *pResNode, SExplainCtx *ctx, i
       }
       break;
     }
+    case QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN: {
+      SHashJoinPhysiNode *pJoinNode = (SHashJoinPhysiNode *)pNode;
+      EXPLAIN_ROW_NEW(level, EXPLAIN_HASH_JOIN_FORMAT, EXPLAIN_JOIN_STRING(pJoinNode->joinType));
+      EXPLAIN_ROW_APPEND(EXPLAIN_LEFT_PARENTHESIS_FORMAT);
+      if (pResNode->pExecInfo) {
+        QRY_ERR_RET(qExplainBufAppendExecInfo(pResNode->pExecInfo, tbuf, &tlen));
+        EXPLAIN_ROW_APPEND(EXPLAIN_BLANK_FORMAT);
+      }
+      EXPLAIN_ROW_APPEND(EXPLAIN_COLUMNS_FORMAT, pJoinNode->pTargets->length);
+      EXPLAIN_ROW_APPEND(EXPLAIN_BLANK_FORMAT);
+      EXPLAIN_ROW_APPEND(EXPLAIN_WIDTH_FORMAT, pJoinNode->node.pOutputDataBlockDesc->totalRowSize);
+      EXPLAIN_ROW_APPEND(EXPLAIN_BLANK_FORMAT);
+      EXPLAIN_ROW_APPEND(EXPLAIN_RIGHT_PARENTHESIS_FORMAT);
+      EXPLAIN_ROW_END();
+      QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level));
+
+      if (pResNode->pExecInfo) {
+        int32_t nodeNum = taosArrayGetSize(pResNode->pExecInfo);
+        for (int32_t i = 0; i < nodeNum; ++i) {
+          SExplainExecInfo  *execInfo = taosArrayGet(pResNode->pExecInfo, i);
+          SHashJoinExecInfo *pExecInfo = (SHashJoinExecInfo *)execInfo->verboseInfo;
+          if (execInfo->verboseLen != sizeof(SHashJoinExecInfo)) {
+            continue;
+          }
+
+          EXPLAIN_ROW_NEW(level + 1, EXPLAIN_HASH_JOIN_BUILD_FORMAT, pExecInfo->buildSide == 0 ? "left" : "right",
+                          pExecInfo->buildRows, pExecInfo->spillPartitions);
+          if (pExecInfo->spillPartitions > 0) {
+            if (pExecInfo->spillBytes > 1024 * 1024) {
+              EXPLAIN_ROW_APPEND("  Written:%.2f Mb", pExecInfo->spillBytes / (1024 * 1024.0));
+            } else {
+              EXPLAIN_ROW_APPEND("  Written:%.2f Kb", pExecInfo->spillBytes / 1024.0);
+            }
+          }
+          EXPLAIN_ROW_END();
+          QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level + 1));
+        }
+      }
+
+      if (verbose) {
+        EXPLAIN_ROW_NEW(level + 1, EXPLAIN_OUTPUT_FORMAT);
+        EXPLAIN_ROW_APPEND(EXPLAIN_COLUMNS_FORMAT,
+                           nodesGetOutputNumFromSlotList(pJoinNode->node.pOutputDataBlockDesc->pSlots));
+        EXPLAIN_ROW_APPEND(EXPLAIN_BLANK_FORMAT);
+        EXPLAIN_ROW_APPEND(EXPLAIN_WIDTH_FORMAT, pJoinNode->node.pOutputDataBlockDesc->outputRowSize);
+        EXPLAIN_ROW_APPEND_LIMIT(pJoinNode->node.pLimit);
+        EXPLAIN_ROW_APPEND_SLIMIT(pJoinNode->node.pSlimit);
+        EXPLAIN_ROW_END();
+        QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level + 1));
+
+        if (pJoinNode->node.pConditions) {
+          EXPLAIN_ROW_NEW(level + 1, EXPLAIN_FILTER_FORMAT);
+          QRY_ERR_RET(nodesNodeToSQL(pJoinNode->node.pConditions, tbuf + VARSTR_HEADER_SIZE,
+                                     TSDB_EXPLAIN_RESULT_ROW_SIZE, &tlen));
+          EXPLAIN_ROW_END();
+          QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level + 1));
+        }
+
+        EXPLAIN_ROW_NEW(level + 1, EXPLAIN_ON_CONDITIONS_FORMAT);
+        QRY_ERR_RET(
+            nodesNodeToSQL(pJoinNode->pMergeCondition, tbuf + VARSTR_HEADER_SIZE, TSDB_EXPLAIN_RESULT_ROW_SIZE, &tlen));
+        if (pJoinNode->pOnConditions) {
+          EXPLAIN_ROW_APPEND(" AND ");
+          QRY_ERR_RET(
+              nodesNodeToSQL(pJoinNode->pOnConditions, tbuf + VARSTR_HEADER_SIZE, TSDB_EXPLAIN_RESULT_ROW_SIZE, &tlen));
+        }
+        EXPLAIN_ROW_END();
+        QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level + 1));
+      }
+      break;
+    }
     case QUERY_NODE_PHYSICAL_PLAN_HASH_AGG: {
       SAggPhysiNode *pAggNode = (SAggPhysiNode *)pNode;
       EXPLAIN_ROW_NEW(level, EXPLAIN_AGG_FORMAT);
@@ -610,6 +681,26 @@ int32_t qExplainResNodeToRowsImpl(SExplainResNode *pResNode, SExplainCtx *ctx, i
       EXPLAIN_ROW_END();
       QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level));
 
+      if (pResNode->pExecInfo) {
+        int32_t nodeNum = taosArrayGetSize(pResNode->pExecInfo);
+        for (int32_t i = 0; i < nodeNum; ++i) {
+          SExplainExecInfo *execInfo = taosArrayGet(pResNode->pExecInfo, i);
+          SGroupbyExecInfo *pExecInfo = (SGroupbyExecInfo *)execInfo->verboseInfo;
+          if (execInfo->verboseLen != sizeof(SGroupbyExecInfo) || pExecInfo->spillLoops == 0) {
+            continue;
+          }
+
+          EXPLAIN_ROW_NEW(level + 1, EXPLAIN_GROUP_SPILL_FORMAT, pExecInfo->spillLoops, pExecInfo->spillGroups);
+          if (pExecInfo->spillBytes > 1024 * 1024) {
+            EXPLAIN_ROW_APPEND("  Written:%.2f Mb", pExecInfo->spillBytes / (1024 * 1024.0));
+          } else {
+            EXPLAIN_ROW_APPEND("  Written:%.2f Kb", pExecInfo->spillBytes / 1024.0);
+          }
+          EXPLAIN_ROW_END();
+          QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level + 1));
+        }
+      }
+
       if (verbose) {
         EXPLAIN_ROW_NEW(level + 1, EXPLAIN_OUTPUT_FORMAT);
         EXPLAIN_ROW_APPEND(EXPLAIN_COLUMNS_FORMAT,
@@ -21,6 +21,7 @@ extern "C" {
 #endif
 
 #include "thash.h"
+#include "tpagedbuf.h"
 
 enum {
   LINEAR_HASH_STATIS = 0x1,
@@ -29,12 +30,21 @@ enum {
 
 typedef struct SLHashObj SLHashObj;
 
+typedef struct SLHashIter {
+  int32_t bucketId;
+  int32_t pageIndex;
+  int32_t offset;  // of the next node in the page, 0 before the first one
+} SLHashIter;
+
 SLHashObj* tHashInit(int32_t inMemPages, int32_t pageSize, _hash_fn_t fn, int32_t numOfTuplePerPage);
 void*      tHashCleanup(SLHashObj* pHashObj);
 
 int32_t tHashPut(SLHashObj* pHashObj, const void* key, size_t keyLen, void* data, size_t size);
 char*   tHashGet(SLHashObj* pHashObj, const void* key, size_t keyLen);
 int32_t tHashRemove(SLHashObj* pHashObj, const void* key, size_t keyLen);
+char*   tHashIterate(SLHashObj* pHashObj, SLHashIter* pIter, char** pKey, size_t* keyLen);
+int64_t             tHashGetSize(const SLHashObj* pHashObj);
+SDiskbasedBufStatis tHashGetBufStatis(const SLHashObj* pHashObj);
 
 void tHashPrint(const SLHashObj* pHashObj, int32_t type);
 
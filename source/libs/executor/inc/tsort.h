@@ -47,6 +47,7 @@ typedef struct SSortSource {
   };
   int64_t fetchUs;
   int64_t fetchNum;
+  char*   pKeys;  // normalized sort keys of the rows in src.pBlock
 } SSortSource;
 
 typedef struct SMsortComparParam {
@@ -60,6 +61,7 @@ typedef struct SMsortComparParam {
   int32_t tsSlotId;
   int32_t order;
   __compar_fn_t cmpFn;
+  int32_t normKeyLen;  // length of the memcmp-able sort key of one row, 0 if the keys are not normalized
 } SMsortComparParam;
 
 typedef struct SSortHandle  SSortHandle;
@@ -121,6 +123,7 @@ int32_t tsortSetComparFp(SSortHandle* pHandle, _sort_merge_compar_fn_t fp);
  * 
 */
 void tsortSetMergeLimit(SSortHandle* pHandle, int64_t mergeLimit);
+
 /**
  *
  */
@@ -489,6 +489,14 @@ int32_t doInitAggInfoSup(SAggSupporter* pAggSup, SqlFunctionCtx* pCtx, int32_t n
     return code;
   }
 
+  // result pages of many groups/windows are spilled without blocking the query thread
+  setBufPageCompressOnDisk(pAggSup->pResultBuf, true);
+  code = dBufSetAsyncIo(pAggSup->pResultBuf, TMAX(defaultPgsz * 2, defaultBufsz / 4));
+  if (code != TSDB_CODE_SUCCESS) {
+    qError("Init agg result buf io failed since %s, %s", tstrerror(code), pKey);
+    return code;
+  }
+
   return code;
 }
 
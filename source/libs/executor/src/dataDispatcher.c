@@ -48,6 +48,9 @@ typedef struct SDataDispatchHandle {
   bool                queryEnd;
   uint64_t            useconds;
   uint64_t            cachedSize;
+  int8_t              compress;  // set once the fetcher accepts compressed blocks
+  char*               pCompBuf;
+  int32_t             compBufSize;
   TdThreadMutex       mutex;
 } SDataDispatchHandle;
 
@@ -60,6 +63,57 @@ typedef struct SDataDispatchHandle {
 // The length of bitmap is decided by number of rows of this data block, and the length of each column data is
 // recorded in the first segment, next to the struct header
 // clang-format on
+// compressColData: -1 never compresses, 0 always does, any other value does if a column is larger than it
+static bool needCompress(const char* pData, int32_t numOfCols) {
+  if (tsCompressColData < 0) {
+    return false;
+  } else if (tsCompressColData == 0) {
+    return true;
+  }
+
+  const int32_t* colSizes =
+      (const int32_t*)(pData + blockDataGetSerialMetaSize(numOfCols) - numOfCols * sizeof(int32_t));
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    if (htonl(colSizes[i]) > tsCompressColData) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// replace the encoded block of the entry with its compressed form if that is smaller
+static void compressDataCacheEntry(SDataDispatchHandle* pHandle, SDataDispatchBuf* pBuf) {
+  SDataCacheEntry* pEntry = (SDataCacheEntry*)pBuf->pData;
+  if (!needCompress(pEntry->data, pEntry->numOfCols)) {
+    return;
+  }
+
+  int32_t bound = blockGetCompressBound(pEntry->data);
+  if (pHandle->compBufSize < bound) {
+    char* p = taosMemoryRealloc(pHandle->pCompBuf, bound);
+    if (p == NULL) {
+      return;
+    }
+    pHandle->pCompBuf = p;
+    pHandle->compBufSize = bound;
+  }
+
+  int32_t len = blockCompress(pEntry->data, pHandle->pCompBuf);
+  if (len <= 0 || len >= pEntry->dataLen) {
+    return;
+  }
+
+  memcpy(pEntry->data, pHandle->pCompBuf, len);
+  pEntry->dataLen = len;
+  pEntry->compressed = 1;
+
+  char* p = taosMemoryRealloc(pBuf->pData, sizeof(SDataCacheEntry) + len);
+  if (p != NULL) {
+    pBuf->pData = p;
+    pBuf->allocSize = sizeof(SDataCacheEntry) + len;
+  }
+}
+
 static void toDataCacheEntry(SDataDispatchHandle* pHandle, const SInputData* pInput, SDataDispatchBuf* pBuf) {
   int32_t numOfCols = 0;
   SNode*  pNode;
@@ -80,6 +134,11 @@ static void toDataCacheEntry(SDataDispatchHandle* pHandle, const SInputData* pIn
   //  ASSERT(pEntry->numOfRows == *(int32_t*)(pEntry->data + 8));
   //  ASSERT(pEntry->numOfCols == *(int32_t*)(pEntry->data + 8 + 4));
 
+  if (atomic_load_8(&pHandle->compress)) {
+    compressDataCacheEntry(pHandle, pBuf);
+    pEntry = (SDataCacheEntry*)pBuf->pData;
+  }
+
   pBuf->useSize += pEntry->dataLen;
 
   atomic_add_fetch_64(&pHandle->cachedSize, pEntry->dataLen);
@@ -216,6 +275,7 @@ static int32_t destroyDataSinker(SDataSinkHandle* pHandle) {
   SDataDispatchHandle* pDispatcher = (SDataDispatchHandle*)pHandle;
   atomic_sub_fetch_64(&gDataSinkStat.cachedSize, pDispatcher->cachedSize);
   taosMemoryFreeClear(pDispatcher->nextOutput.pData);
+  taosMemoryFreeClear(pDispatcher->pCompBuf);
   while (!taosQueueEmpty(pDispatcher->pDataBlocks)) {
     SDataDispatchBuf* pBuf = NULL;
     taosReadQitem(pDispatcher->pDataBlocks, (void**)&pBuf);
@@ -230,6 +290,11 @@ static int32_t destroyDataSinker(SDataSinkHandle* pHandle) {
   return TSDB_CODE_SUCCESS;
 }
 
+static void setCompress(struct SDataSinkHandle* pHandle) {
+  SDataDispatchHandle* pDispatcher = (SDataDispatchHandle*)pHandle;
+  atomic_store_8(&pDispatcher->compress, 1);
+}
+
 static int32_t getCacheSize(struct SDataSinkHandle* pHandle, uint64_t* size) {
   SDataDispatchHandle* pDispatcher = (SDataDispatchHandle*)pHandle;
 
@@ -249,6 +314,7 @@ int32_t createDataDispatcher(SDataSinkManager* pManager, const SDataSinkNode* pD
   dispatcher->sink.fGetData = getDataBlock;
   dispatcher->sink.fDestroy = destroyDataSinker;
   dispatcher->sink.fGetCacheSize = getCacheSize;
+  dispatcher->sink.fSetCompress = setCompress;
   dispatcher->pManager = pManager;
   dispatcher->pSchema = pDataSink->pInputDataBlockDesc;
   dispatcher->status = DS_BUF_EMPTY;
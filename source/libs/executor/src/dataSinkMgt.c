@@ -83,6 +83,13 @@ int32_t dsGetCacheSize(DataSinkHandle handle, uint64_t* pSize) {
   return pHandleImpl->fGetCacheSize(pHandleImpl, pSize);
 }
 
+void dsSetCompressResult(DataSinkHandle handle) {
+  SDataSinkHandle* pHandleImpl = (SDataSinkHandle*)handle;
+  if (pHandleImpl->fSetCompress != NULL) {
+    pHandleImpl->fSetCompress(pHandleImpl);
+  }
+}
+
 void dsScheduleProcess(void* ahandle, void* pItem) {
   // todo
 }
@@ -22,6 +22,7 @@
 #include "query.h"
 #include "querytask.h"
 #include "tdatablock.h"
+#include "tglobal.h"
 #include "thash.h"
 #include "tmsg.h"
 #include "tname.h"
@@ -429,6 +430,7 @@ int32_t doSendFetchDataRequest(SExchangeInfo* pExchangeInfo, SExecTaskInfo* pTas
     req.taskId = pSource->taskId;
     req.queryId = pTaskInfo->id.queryId;
     req.execId = pSource->execId;
+    req.compressed = (tsCompressColData >= 0);
 
     int32_t msgSize = tSerializeSResFetchReq(NULL, 0, &req);
     if (msgSize < 0) {
@@ -491,7 +493,12 @@ void updateLoadRemoteInfo(SLoadRemoteDataInfo* pInfo, int64_t numOfRows, int32_t
 int32_t extractDataBlockFromFetchRsp(SSDataBlock* pRes, char* pData, SArray* pColList, char** pNextStart) {
   if (pColList == NULL) {  // data from other sources
     blockDataCleanup(pRes);
-    *pNextStart = (char*)blockDecode(pRes, pData);
+    const char* pNext = blockDecode(pRes, pData);
+    if (pNext == NULL) {
+      return TSDB_CODE_INVALID_MSG;
+    }
+
+    *pNextStart = (char*)pNext;
   } else {  // extract data according to pColList
     char* pStart = pData;
 
@@ -514,7 +521,11 @@ int32_t extractDataBlockFromFetchRsp(SSDataBlock* pRes, char* pData, SArray* pCo
       blockDataAppendColInfo(pBlock, &idata);
     }
 
-    blockDecode(pBlock, pStart);
+    if (blockDecode(pBlock, pStart) == NULL) {
+      blockDataDestroy(pBlock);
+      return TSDB_CODE_INVALID_MSG;
+    }
+
     blockDataEnsureCapacity(pRes, pBlock->info.rows);
 
     // data from mnode
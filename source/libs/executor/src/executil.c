@@ -49,6 +49,8 @@ static int32_t      getTableList(void* pVnode, SScanPhysiNode* pScanNode, SNode*
                                  STableListInfo* pListInfo, uint8_t* digest, const char* idstr, SStorageAPI* pStorageAPI);
 static SSDataBlock* createTagValBlockForFilter(SArray* pColList, int32_t numOfTables, SArray* pUidTagList, void* pVnode,
                                                SStorageAPI* pStorageAPI);
+static int32_t      createTagValBlockFromStore(SArray* pColList, SArray* pUidTagList, uint64_t suid, void* pVnode,
+                                               SStorageAPI* pStorageAPI, SSDataBlock** ppBlock);
 
 static int64_t getLimit(const SNode* pLimit) { return NULL == pLimit ? -1 : ((SLimitNode*)pLimit)->limit; }
 static int64_t getOffset(const SNode* pLimit) { return NULL == pLimit ? -1 : ((SLimitNode*)pLimit)->offset; }
@@ -517,16 +519,19 @@ int32_t getColInfoResultForGroupby(void* pVnode, SNodeList* group, STableListInf
     taosArrayPush(pUidTagList, &info);
   }
 
-  code = pAPI->metaFn.getTableTags(pVnode, pTableListInfo->idInfo.suid, pUidTagList);
+  code = createTagValBlockFromStore(ctx.cInfoList, pUidTagList, pTableListInfo->idInfo.suid, pVnode, pAPI, &pResBlock);
   if (code != TSDB_CODE_SUCCESS) {
-    goto end;
-  }
+    code = pAPI->metaFn.getTableTags(pVnode, pTableListInfo->idInfo.suid, pUidTagList);
+    if (code != TSDB_CODE_SUCCESS) {
+      goto end;
+    }
 
-  int32_t numOfTables = taosArrayGetSize(pUidTagList);
-  pResBlock = createTagValBlockForFilter(ctx.cInfoList, numOfTables, pUidTagList, pVnode, pAPI);
-  if (pResBlock == NULL) {
-    code = terrno;
-    goto end;
+    int32_t numOfTables = taosArrayGetSize(pUidTagList);
+    pResBlock = createTagValBlockForFilter(ctx.cInfoList, numOfTables, pUidTagList, pVnode, pAPI);
+    if (pResBlock == NULL) {
+      code = terrno;
+      goto end;
+    }
   }
 
   //  int64_t st1 = taosGetTimestampUs();
@@ -846,6 +851,21 @@ static int32_t optimizeTbnameInCondImpl(void* pVnode, SArray* pExistedUidList, S
   return -1;
 }
 
+static void setTbNameColVal(SColumnInfoData* pColInfo, int32_t row, STUidTagInfo* p1, void* pVnode,
+                            SStorageAPI* pStorageAPI) {
+  char str[TSDB_TABLE_FNAME_LEN + VARSTR_HEADER_SIZE] = {0};
+  if (p1->name != NULL) {
+    STR_TO_VARSTR(str, p1->name);
+  } else {  // name is not retrieved during filter
+    pStorageAPI->metaFn.getTableNameByUid(pVnode, p1->uid, str);
+  }
+
+  colDataSetVal(pColInfo, row, str, false);
+#if TAG_FILTER_DEBUG
+  qDebug("tagfilter uid:%ld, tbname:%s", *uid, str + 2);
+#endif
+}
+
 static SSDataBlock* createTagValBlockForFilter(SArray* pColList, int32_t numOfTables, SArray* pUidTagList, void* pVnode,
                                                SStorageAPI* pStorageAPI) {
   SSDataBlock* pResBlock = createDataBlock();
@@ -878,17 +898,7 @@ static SSDataBlock* createTagValBlockForFilter(SArray* pColList, int32_t numOfTa
       SColumnInfoData* pColInfo = (SColumnInfoData*)taosArrayGet(pResBlock->pDataBlock, j);
 
       if (pColInfo->info.colId == -1) {  // tbname
-        char str[TSDB_TABLE_FNAME_LEN + VARSTR_HEADER_SIZE] = {0};
-        if (p1->name != NULL) {
-          STR_TO_VARSTR(str, p1->name);
-        } else {  // name is not retrieved during filter
-          pStorageAPI->metaFn.getTableNameByUid(pVnode, p1->uid, str);
-        }
-
-        colDataSetVal(pColInfo, i, str, false);
-#if TAG_FILTER_DEBUG
-        qDebug("tagfilter uid:%ld, tbname:%s", *uid, str + 2);
-#endif
+        setTbNameColVal(pColInfo, i, p1, pVnode, pStorageAPI);
       } else {
         STagVal tagVal = {0};
         tagVal.cid = pColInfo->info.colId;
@@ -928,6 +938,44 @@ static SSDataBlock* createTagValBlockForFilter(SArray* pColList, int32_t numOfTa
   return pResBlock;
 }
 
+// Read the tag columns from the columnar tag store of the vnode, which scans a tag column of all child tables without
+// decoding the tag of each of them. If pUidTagList is empty, the uids of all child tables are added to it. The store
+// does not serve json tags, so callers fall back to createTagValBlockForFilter on any error.
+static int32_t createTagValBlockFromStore(SArray* pColList, SArray* pUidTagList, uint64_t suid, void* pVnode,
+                                          SStorageAPI* pStorageAPI, SSDataBlock** ppBlock) {
+  SSDataBlock* pResBlock = createDataBlock();
+  if (pResBlock == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pColList); ++i) {
+    SColumnInfoData colInfo = {0};
+    colInfo.info = *(SColumnInfo*)taosArrayGet(pColList, i);
+    blockDataAppendColInfo(pResBlock, &colInfo);
+  }
+
+  int32_t code = pStorageAPI->metaFn.getTableTagCols(pVnode, suid, pUidTagList, pResBlock);
+  if (code != TSDB_CODE_SUCCESS) {
+    blockDataDestroy(pResBlock);
+    return code;
+  }
+
+  int32_t numOfCols = taosArrayGetSize(pResBlock->pDataBlock);
+  for (int32_t j = 0; j < numOfCols; j++) {
+    SColumnInfoData* pColInfo = (SColumnInfoData*)taosArrayGet(pResBlock->pDataBlock, j);
+    if (pColInfo->info.colId != -1) {
+      continue;
+    }
+
+    for (int32_t i = 0; i < pResBlock->info.rows; i++) {
+      setTbNameColVal(pColInfo, i, taosArrayGet(pUidTagList, i), pVnode, pStorageAPI);
+    }
+  }
+
+  *ppBlock = pResBlock;
+  return TSDB_CODE_SUCCESS;
+}
+
 static void doSetQualifiedUid(SArray* pUidList, const SArray* pUidTagList, bool* pResultList) {
   taosArrayClear(pUidList);
 
@@ -1004,10 +1052,18 @@ static int32_t doFilterByTagCond(STableListInfo* pListInfo, SArray* pUidList, SN
     }
     terrno = 0;
   } else {
-    if ((condType == FILTER_NO_LOGIC || condType == FILTER_AND) && status != SFLT_NOT_INDEX) {
-      code = pAPI->metaFn.getTableTagsByUid(pVnode, pListInfo->idInfo.suid, pUidTagList);
-    } else {
-      code = pAPI->metaFn.getTableTags(pVnode, pListInfo->idInfo.suid, pUidTagList);
+    bool byUid = (condType == FILTER_NO_LOGIC || condType == FILTER_AND) && status != SFLT_NOT_INDEX;
+    if (byUid && taosArrayGetSize(pUidTagList) == 0) {  // no table left by the tag index
+      goto end;
+    }
+
+    code = createTagValBlockFromStore(ctx.cInfoList, pUidTagList, pListInfo->idInfo.suid, pVnode, pAPI, &pResBlock);
+    if (code != TSDB_CODE_SUCCESS) {
+      if (byUid) {
+        code = pAPI->metaFn.getTableTagsByUid(pVnode, pListInfo->idInfo.suid, pUidTagList);
+      } else {
+        code = pAPI->metaFn.getTableTags(pVnode, pListInfo->idInfo.suid, pUidTagList);
+      }
     }
     if (code != TSDB_CODE_SUCCESS) {
       qError("failed to get table tags from meta, reason:%s, suid:%" PRIu64, tstrerror(code), pListInfo->idInfo.suid);
@@ -1021,10 +1077,12 @@ static int32_t doFilterByTagCond(STableListInfo* pListInfo, SArray* pUidList, SN
     goto end;
   }
 
-  pResBlock = createTagValBlockForFilter(ctx.cInfoList, numOfTables, pUidTagList, pVnode, pAPI);
   if (pResBlock == NULL) {
-    code = terrno;
-    goto end;
+    pResBlock = createTagValBlockForFilter(ctx.cInfoList, numOfTables, pUidTagList, pVnode, pAPI);
+    if (pResBlock == NULL) {
+      code = terrno;
+      goto end;
+    }
   }
 
   //  int64_t st1 = taosGetTimestampUs();
@@ -347,10 +347,6 @@ bool functionNeedToExecute(SqlFunctionCtx* pCtx) {
     return false;
   }
 
-  if (pCtx->scanFlag == PRE_SCAN) {
-    return fmIsRepeatScanFunc(pCtx->functionId);
-  }
-
   if (isRowEntryCompleted(pResInfo)) {
     return false;
   }
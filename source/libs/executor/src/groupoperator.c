@@ -25,19 +25,33 @@
 #include "operator.h"
 #include "querytask.h"
 #include "tcompare.h"
+#include "tglobal.h"
 #include "thash.h"
+#include "tlinearhash.h"
 #include "ttypes.h"
 
+// When the in-memory group hash exceeds the memory threshold, its entries are moved into a page based linear hash,
+// and looked up there again when a spilled group shows up in later data blocks.
+typedef struct SGroupSpillInfo {
+  int64_t    memThreshold;  // threshold of the in-memory group hash in bytes, 0 means never spill
+  SLHashObj* pHash;         // spilled group key -> SResultRowPosition
+  SArray*    pRows;         // SArray<SResKeyPos>, result row positions of the spilled groups being returned
+  SLHashIter iter;          // the next spilled group to return
+  bool       drained;       // all spilled groups have been returned
+  int32_t    loops;
+} SGroupSpillInfo;
+
 typedef struct SGroupbyOperatorInfo {
-  SOptrBasicInfo binfo;
-  SAggSupporter  aggSup;
-  SArray*        pGroupCols;     // group by columns, SArray<SColumn>
-  SArray*        pGroupColVals;  // current group column values, SArray<SGroupKeys>
-  bool           isInit;         // denote if current val is initialized or not
-  char*          keyBuf;         // group by keys for hash
-  int32_t        groupKeyLen;    // total group by column width
-  SGroupResInfo  groupResInfo;
-  SExprSupp      scalarSup;
+  SOptrBasicInfo  binfo;
+  SAggSupporter   aggSup;
+  SArray*         pGroupCols;     // group by columns, SArray<SColumn>
+  SArray*         pGroupColVals;  // current group column values, SArray<SGroupKeys>
+  bool            isInit;         // denote if current val is initialized or not
+  char*           keyBuf;         // group by keys for hash
+  int32_t         groupKeyLen;    // total group by column width
+  SGroupResInfo   groupResInfo;
+  SExprSupp       scalarSup;
+  SGroupSpillInfo spill;
 } SGroupbyOperatorInfo;
 
 // The sort in partition may be needed later.
@@ -63,6 +77,7 @@ static int32_t* setupColumnOffset(const SSDataBlock* pBlock, int32_t rowCapacity
 static int32_t  setGroupResultOutputBuf(SOperatorInfo* pOperator, SOptrBasicInfo* binfo, int32_t numOfCols, char* pData,
                                         int16_t bytes, uint64_t groupId, SDiskbasedBuf* pBuf, SAggSupporter* pAggSup);
 static SArray*  extractColumnInfo(SNodeList* pNodeList);
+static int32_t  loadSpilledGroupRes(SGroupbyOperatorInfo* pInfo, int32_t batchSize);
 
 static void freeGroupKey(void* param) {
   SGroupKeys* pKey = (SGroupKeys*)param;
@@ -83,6 +98,10 @@ static void destroyGroupOperatorInfo(void* param) {
 
   cleanupGroupResInfo(&pInfo->groupResInfo);
   cleanupAggSup(&pInfo->aggSup);
+  if (pInfo->spill.pHash != NULL) {
+    tHashCleanup(pInfo->spill.pHash);
+  }
+  taosArrayDestroy(pInfo->spill.pRows);
   taosMemoryFreeClear(param);
 }
 
@@ -315,8 +334,8 @@ static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
     len = buildGroupKeys(pInfo->keyBuf, pInfo->pGroupColVals);
     int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), pOperator->exprSupp.numOfExprs, pInfo->keyBuf,
                                           len, pBlock->info.id.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
-    if (ret != TSDB_CODE_SUCCESS) {  // null data, too many state code
-      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_APP_ERROR);
+    if (ret != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, ret);
     }
 
     int32_t rowIndex = j - num;
@@ -334,7 +353,7 @@ static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
     int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), pOperator->exprSupp.numOfExprs, pInfo->keyBuf,
                                           len, pBlock->info.id.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
     if (ret != TSDB_CODE_SUCCESS) {
-      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_APP_ERROR);
+      T_LONG_JMP(pTaskInfo->env, ret);
     }
 
     int32_t rowIndex = pBlock->info.rows - num;
@@ -349,10 +368,17 @@ static SSDataBlock* buildGroupResultDataBlock(SOperatorInfo* pOperator) {
 
   SSDataBlock* pRes = pInfo->binfo.pRes;
   while (1) {
+    if (pInfo->spill.pHash != NULL && !pInfo->spill.drained && !hasRemainResults(&pInfo->groupResInfo)) {
+      int32_t code = loadSpilledGroupRes(pInfo, pOperator->resultInfo.capacity);
+      if (code != TSDB_CODE_SUCCESS) {
+        T_LONG_JMP(pOperator->pTaskInfo->env, code);
+      }
+    }
+
     doBuildResultDatablock(pOperator, &pInfo->binfo, &pInfo->groupResInfo, pInfo->aggSup.pResultBuf);
     doFilter(pRes, pOperator->exprSupp.pFilterInfo, NULL);
 
-    if (!hasRemainResults(&pInfo->groupResInfo)) {
+    if (!hasRemainResults(&pInfo->groupResInfo) && (pInfo->spill.pHash == NULL || pInfo->spill.drained)) {
       setOperatorCompleted(pOperator);
       break;
     }
@@ -366,6 +392,113 @@ static SSDataBlock* buildGroupResultDataBlock(SOperatorInfo* pOperator) {
   return (pRes->info.rows == 0) ? NULL : pRes;
 }
 
+static int32_t doSpillGroupHash(SGroupbyOperatorInfo* pInfo) {
+  SGroupSpillInfo* pSpill = &pInfo->spill;
+  SSHashObj*       pHashmap = pInfo->aggSup.pResultRowHashTable;
+
+  if (pSpill->pHash == NULL) {
+    int32_t  tupleSize = sizeof(int32_t) + GET_RES_WINDOW_KEY_LEN(pInfo->groupKeyLen) + sizeof(SResultRowPosition);
+    uint32_t pageSize = 0;
+    uint32_t bufSize = 0;
+    int32_t  code = getBufferPgSize(tupleSize, &pageSize, &bufSize);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    pSpill->pHash = tHashInit(bufSize / pageSize, pageSize, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY),
+                              (pageSize - sizeof(SFilePage)) / tupleSize);
+    if (pSpill->pHash == NULL) {
+      return terrno;
+    }
+  }
+
+  void*   pData = NULL;
+  int32_t iter = 0;
+  size_t  keyLen = 0;
+  while ((pData = tSimpleHashIterate(pHashmap, pData, &iter)) != NULL) {
+    void* key = tSimpleHashGetKey(pData, &keyLen);
+
+    // the group has been reloaded from the on-disk hash, it is there already
+    if (tHashGet(pSpill->pHash, key, keyLen) != NULL) {
+      continue;
+    }
+
+    int32_t code = tHashPut(pSpill->pHash, key, keyLen, pData, sizeof(SResultRowPosition));
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  tSimpleHashClear(pHashmap);
+  pSpill->loops += 1;
+  return TSDB_CODE_SUCCESS;
+}
+
+// put the result row position of a spilled group back to the in-memory hash, so that it can be found again.
+static int32_t doReloadSpilledGroup(SGroupbyOperatorInfo* pInfo, char* pData, int16_t bytes, uint64_t groupId) {
+  SAggSupporter* pSup = &pInfo->aggSup;
+  int32_t        keyLen = GET_RES_WINDOW_KEY_LEN(bytes);
+
+  SET_RES_WINDOW_KEY(pSup->keyBuf, pData, bytes, groupId);
+  *(uint64_t*)pSup->keyBuf = calcGroupId(pSup->keyBuf, keyLen);
+
+  if (tSimpleHashGet(pSup->pResultRowHashTable, pSup->keyBuf, keyLen) != NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  char* p = tHashGet(pInfo->spill.pHash, pSup->keyBuf, keyLen);
+  if (p != NULL) {
+    SResultRowPosition pos;
+    memcpy(&pos, p, sizeof(SResultRowPosition));
+    return tSimpleHashPut(pSup->pResultRowHashTable, pSup->keyBuf, keyLen, &pos, sizeof(SResultRowPosition));
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+// the result row positions of the next batch of spilled groups, so that only one batch of them is in memory at a time
+static int32_t loadSpilledGroupRes(SGroupbyOperatorInfo* pInfo, int32_t batchSize) {
+  SGroupSpillInfo* pSpill = &pInfo->spill;
+  SGroupResInfo*   pGroupResInfo = &pInfo->groupResInfo;
+
+  cleanupGroupResInfo(pGroupResInfo);
+  if (pSpill->pRows == NULL) {
+    pSpill->pRows = taosArrayInit(batchSize, sizeof(SResKeyPos));
+    if (pSpill->pRows == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+  taosArrayClear(pSpill->pRows);
+
+  while (taosArrayGetSize(pSpill->pRows) < batchSize) {
+    char*  key = NULL;
+    size_t keyLen = 0;
+    char*  pData = tHashIterate(pSpill->pHash, &pSpill->iter, &key, &keyLen);
+    if (pData == NULL) {
+      pSpill->drained = true;
+      break;
+    }
+
+    SResKeyPos pos = {.groupId = *(uint64_t*)key};
+    memcpy(&pos.pos, pData, sizeof(SResultRowPosition));
+    if (taosArrayPush(pSpill->pRows, &pos) == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  int32_t size = taosArrayGetSize(pSpill->pRows);
+  pGroupResInfo->pRows = taosArrayInit(size, POINTER_BYTES);
+  if (pGroupResInfo->pRows == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  for (int32_t i = 0; i < size; ++i) {
+    void* p = taosArrayGet(pSpill->pRows, i);
+    if (taosArrayPush(pGroupResInfo->pRows, &p) == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
 static SSDataBlock* hashGroupbyAggregate(SOperatorInfo* pOperator) {
   if (pOperator->status == OP_EXEC_DONE) {
     return NULL;
@@ -403,6 +536,16 @@ static SSDataBlock* hashGroupbyAggregate(SOperatorInfo* pOperator) {
     }
 
     doHashGroupbyAgg(pOperator, pBlock);
+
+    if (pInfo->spill.memThreshold > 0 &&
+        tSimpleHashGetMemSize(pInfo->aggSup.pResultRowHashTable) > pInfo->spill.memThreshold) {
+      int32_t code = doSpillGroupHash(pInfo);
+      if (code != TSDB_CODE_SUCCESS) {
+        T_LONG_JMP(pTaskInfo->env, code);
+      }
+      qDebug("%s group hash spilled, loops:%d, groups:%" PRId64, GET_TASKID(pTaskInfo), pInfo->spill.loops,
+             tHashGetSize(pInfo->spill.pHash));
+    }
   }
 
   pOperator->status = OP_RES_TO_RETURN;
@@ -421,12 +564,40 @@ static SSDataBlock* hashGroupbyAggregate(SOperatorInfo* pOperator) {
     }
   }
 #endif
-  initGroupedResultInfo(&pInfo->groupResInfo, pInfo->aggSup.pResultRowHashTable, 0);
+  if (pInfo->spill.pHash != NULL) {
+    int32_t code = doSpillGroupHash(pInfo);
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+
+    // every group is in the on-disk hash now, and is returned from there a batch at a time
+    cleanupGroupResInfo(&pInfo->groupResInfo);
+  } else {
+    initGroupedResultInfo(&pInfo->groupResInfo, pInfo->aggSup.pResultRowHashTable, 0);
+  }
 
   pOperator->cost.openCost = (taosGetTimestampUs() - st) / 1000.0;
   return buildGroupResultDataBlock(pOperator);
 }
 
+static int32_t getGroupbyExplainExecInfo(SOperatorInfo* pOptr, void** pOptrExplain, uint32_t* len) {
+  SGroupbyOperatorInfo* pInfo = (SGroupbyOperatorInfo*)pOptr->info;
+  SGroupbyExecInfo*     pExecInfo = taosMemoryCalloc(1, sizeof(SGroupbyExecInfo));
+  if (pExecInfo == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pExecInfo->spillLoops = pInfo->spill.loops;
+  if (pInfo->spill.pHash != NULL) {
+    pExecInfo->spillGroups = tHashGetSize(pInfo->spill.pHash);
+    pExecInfo->spillBytes = tHashGetBufStatis(pInfo->spill.pHash).flushBytes;
+  }
+
+  *pOptrExplain = pExecInfo;
+  *len = sizeof(SGroupbyExecInfo);
+  return TSDB_CODE_SUCCESS;
+}
+
 SOperatorInfo* createGroupOperatorInfo(SOperatorInfo* downstream, SAggPhysiNode* pAggNode, SExecTaskInfo* pTaskInfo) {
   int32_t               code = TSDB_CODE_SUCCESS;
   SGroupbyOperatorInfo* pInfo = taosMemoryCalloc(1, sizeof(SGroupbyOperatorInfo));
@@ -472,6 +643,8 @@ SOperatorInfo* createGroupOperatorInfo(SOperatorInfo* downstream, SAggPhysiNode*
     goto _error;
   }
 
+  pInfo->spill.memThreshold = tsGroupHashMemThreshold * 1024 * 1024L;
+
   initResultRowInfo(&pInfo->binfo.resultRowInfo);
   setOperatorInfo(pOperator, "GroupbyAggOperator", 0, true, OP_NOT_OPENED, pInfo, pTaskInfo);
 
@@ -480,7 +653,7 @@ SOperatorInfo* createGroupOperatorInfo(SOperatorInfo* downstream, SAggPhysiNode*
   pInfo->binfo.outputTsOrder = pAggNode->node.outputTsOrder;
 
   pOperator->fpSet = createOperatorFpSet(optrDummyOpenFn, hashGroupbyAggregate, NULL, destroyGroupOperatorInfo,
-                                         optrDefaultBufFn, NULL);
+                                         optrDefaultBufFn, getGroupbyExplainExecInfo);
   code = appendDownstream(pOperator, &downstream, 1);
   if (code != TSDB_CODE_SUCCESS) {
     goto _error;
@@ -931,6 +1104,14 @@ int32_t setGroupResultOutputBuf(SOperatorInfo* pOperator, SOptrBasicInfo* binfo,
   SResultRowInfo* pResultRowInfo = &binfo->resultRowInfo;
   SqlFunctionCtx* pCtx = pOperator->exprSupp.pCtx;
 
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  if (pInfo->spill.pHash != NULL) {
+    int32_t code = doReloadSpilledGroup(pInfo, pData, bytes, groupId);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
   SResultRow* pResultRow =
       doSetResultOutBufByKey(pBuf, pResultRowInfo, (char*)pData, bytes, true, groupId, pTaskInfo, false, pAggSup, false);
 
@@ -0,0 +1,924 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "executorInt.h"
+#include "filter.h"
+#include "function.h"
+#include "operator.h"
+#include "os.h"
+#include "querynodes.h"
+#include "querytask.h"
+#include "tdatablock.h"
+#include "tglobal.h"
+#include "thash.h"
+#include "tpagedbuf.h"
+#include "tsimplehash.h"
+
+#define HJOIN_PARTITION_BITS 4
+#define HJOIN_PARTITION_NUM  (1 << HJOIN_PARTITION_BITS)
+#define HJOIN_MIN_PAGE_SIZE  (64 * 1024)
+#define HJOIN_STAGE_ROWS     4096
+#define HJOIN_ROW_NONE       (-1)
+
+#define HJOIN_PARTITION_ID(_h) ((_h) >> (32 - HJOIN_PARTITION_BITS))
+
+typedef struct SHJoinPartition {
+  SSDataBlock* pBuild;       // build rows, or the rows waiting to be written out once the partition is spilled
+  SArray*      pNext;        // int32_t, the next row in pBuild with the same key
+  SSHashObj*   pTable;       // key -> int32_t, the first row in pBuild with this key
+  SArray*      pBuildPages;  // int32_t, pages of the spilled build rows
+  SSDataBlock* pProbe;       // probe rows waiting to be written out
+  SArray*      pProbePages;  // int32_t, pages of the spilled probe rows
+  bool         spilled;
+} SHJoinPartition;
+
+typedef struct SHJoinTarget {
+  int32_t side;  // 0: left child, 1: right child
+  int32_t slotId;
+} SHJoinTarget;
+
+typedef struct SHJoinOperatorInfo {
+  SSDataBlock*      pRes;
+  SNode*            pCondAfterJoin;
+  SHJoinTarget*     pTargets;
+  SArray*           pKeyCols[2];     // SColumn, the hash key columns of the left and right child
+  char*             keyBuf;
+  int32_t           keyLen;
+  _hash_fn_t        hashFn;
+  int32_t           buildSide;
+  SArray*           pPrefetched[2];  // SSDataBlock*, blocks read ahead to pick the build side
+  SHJoinPartition   parts[HJOIN_PARTITION_NUM];
+  int64_t           memThreshold;
+  int32_t           rowSize;
+  SDiskbasedBuf*    pBuf;
+  bool              built;
+  bool              buildEof;
+  bool              probeEof;
+  int32_t           spillIdx;        // the spilled partition being joined after the probe side is exhausted
+  int32_t           spillPageIdx;
+  SSDataBlock*      pProbeBlock;     // the probe block being joined
+  SSDataBlock*      pOwnedProbe;     // the probe block owned by the operator, released once joined
+  int32_t           probeRow;
+  int32_t           matchRow;
+  SHashJoinExecInfo execInfo;
+} SHJoinOperatorInfo;
+
+static SSDataBlock* doHashJoin(SOperatorInfo* pOperator);
+static void         destroyHashJoinOperator(void* param);
+
+static int32_t hJoinExtractKeyColsFromOper(SHJoinOperatorInfo* pInfo, SOperatorInfo** pDownstream,
+                                           SOperatorNode* pOperNode) {
+  if (QUERY_NODE_COLUMN != nodeType(pOperNode->pLeft) || QUERY_NODE_COLUMN != nodeType(pOperNode->pRight)) {
+    return TSDB_CODE_QRY_INVALID_INPUT;
+  }
+
+  SColumn left = {0};
+  SColumn right = {0};
+  if (((SColumnNode*)pOperNode->pLeft)->dataBlockId == pDownstream[0]->resultDataBlockId) {
+    left = extractColumnFromColumnNode((SColumnNode*)pOperNode->pLeft);
+    right = extractColumnFromColumnNode((SColumnNode*)pOperNode->pRight);
+  } else {
+    left = extractColumnFromColumnNode((SColumnNode*)pOperNode->pRight);
+    right = extractColumnFromColumnNode((SColumnNode*)pOperNode->pLeft);
+  }
+
+  if (taosArrayPush(pInfo->pKeyCols[0], &left) == NULL || taosArrayPush(pInfo->pKeyCols[1], &right) == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  pInfo->keyLen += TMAX(left.bytes, right.bytes);
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinExtractKeyCols(SHJoinOperatorInfo* pInfo, SOperatorInfo** pDownstream, SNode* pCond) {
+  if (pCond == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (QUERY_NODE_LOGIC_CONDITION == nodeType(pCond) &&
+      LOGIC_COND_TYPE_AND == ((SLogicConditionNode*)pCond)->condType) {
+    SNode* pNode = NULL;
+    FOREACH(pNode, ((SLogicConditionNode*)pCond)->pParameterList) {
+      if (QUERY_NODE_OPERATOR != nodeType(pNode)) {
+        return TSDB_CODE_QRY_INVALID_INPUT;
+      }
+      int32_t code = hJoinExtractKeyColsFromOper(pInfo, pDownstream, (SOperatorNode*)pNode);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    }
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (QUERY_NODE_OPERATOR == nodeType(pCond)) {
+    return hJoinExtractKeyColsFromOper(pInfo, pDownstream, (SOperatorNode*)pCond);
+  }
+  return TSDB_CODE_QRY_INVALID_INPUT;
+}
+
+static int32_t hJoinInitTargets(SHJoinOperatorInfo* pInfo, SOperatorInfo** pDownstream, SExprInfo* pExprInfo,
+                                int32_t numOfExprs) {
+  pInfo->pTargets = taosMemoryCalloc(numOfExprs, sizeof(SHJoinTarget));
+  if (pInfo->pTargets == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < numOfExprs; ++i) {
+    SColumn* pCol = pExprInfo[i].base.pParam[0].pCol;
+    pInfo->pTargets[i].side = (pCol->dataBlockId == pDownstream[0]->resultDataBlockId) ? 0 : 1;
+    pInfo->pTargets[i].slotId = pCol->slotId;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinInitCond(SHJoinOperatorInfo* pInfo, SHashJoinPhysiNode* pJoinNode) {
+  if (pJoinNode->pOnConditions != NULL && pJoinNode->node.pConditions != NULL) {
+    pInfo->pCondAfterJoin = nodesMakeNode(QUERY_NODE_LOGIC_CONDITION);
+    if (pInfo->pCondAfterJoin == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    SLogicConditionNode* pLogicCond = (SLogicConditionNode*)(pInfo->pCondAfterJoin);
+    pLogicCond->condType = LOGIC_COND_TYPE_AND;
+    int32_t code = nodesListMakeAppend(&pLogicCond->pParameterList, nodesCloneNode(pJoinNode->pOnConditions));
+    if (code == TSDB_CODE_SUCCESS) {
+      code = nodesListMakeAppend(&pLogicCond->pParameterList, nodesCloneNode(pJoinNode->node.pConditions));
+    }
+    return code;
+  } else if (pJoinNode->pOnConditions != NULL) {
+    pInfo->pCondAfterJoin = nodesCloneNode(pJoinNode->pOnConditions);
+  } else if (pJoinNode->node.pConditions != NULL) {
+    pInfo->pCondAfterJoin = nodesCloneNode(pJoinNode->node.pConditions);
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinGetExplainExecInfo(SOperatorInfo* pOptr, void** pOptrExplain, uint32_t* len) {
+  SHJoinOperatorInfo* pInfo = (SHJoinOperatorInfo*)pOptr->info;
+  SHashJoinExecInfo*  pExecInfo = taosMemoryCalloc(1, sizeof(SHashJoinExecInfo));
+  if (pExecInfo == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  *pExecInfo = pInfo->execInfo;
+  if (pInfo->pBuf != NULL) {
+    pExecInfo->spillBytes = getDBufStatis(pInfo->pBuf).flushBytes;
+  }
+
+  *pOptrExplain = pExecInfo;
+  *len = sizeof(SHashJoinExecInfo);
+  return TSDB_CODE_SUCCESS;
+}
+
+SOperatorInfo* createHashJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t numOfDownstream,
+                                          SHashJoinPhysiNode* pJoinNode, SExecTaskInfo* pTaskInfo) {
+  SHJoinOperatorInfo* pInfo = taosMemoryCalloc(1, sizeof(SHJoinOperatorInfo));
+  SOperatorInfo*      pOperator = taosMemoryCalloc(1, sizeof(SOperatorInfo));
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (pOperator == NULL || pInfo == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _error;
+  }
+
+  if (numOfDownstream != 2 || pJoinNode->joinType != JOIN_TYPE_INNER) {
+    code = TSDB_CODE_QRY_INVALID_INPUT;
+    goto _error;
+  }
+
+  int32_t numOfCols = 0;
+  pInfo->pRes = createDataBlockFromDescNode(pJoinNode->node.pOutputDataBlockDesc);
+
+  SExprInfo* pExprInfo = createExprInfo(pJoinNode->pTargets, NULL, &numOfCols);
+  initResultSizeInfo(&pOperator->resultInfo, 4096);
+  code = blockDataEnsureCapacity(pInfo->pRes, pOperator->resultInfo.capacity);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  setOperatorInfo(pOperator, "HashJoinOperator", QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN, false, OP_NOT_OPENED, pInfo,
+                  pTaskInfo);
+  pOperator->exprSupp.pExprInfo = pExprInfo;
+  pOperator->exprSupp.numOfExprs = numOfCols;
+
+  pInfo->buildSide = 1;
+  pInfo->hashFn = taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY);
+  pInfo->memThreshold = tsHashJoinMemThreshold * 1024 * 1024L;
+  pInfo->spillIdx = -1;
+  pInfo->matchRow = HJOIN_ROW_NONE;
+
+  SNode* pChild = NULL;
+  FOREACH(pChild, pJoinNode->node.pChildren) {
+    pInfo->rowSize = TMAX(pInfo->rowSize, ((SPhysiNode*)pChild)->pOutputDataBlockDesc->totalRowSize);
+  }
+
+  code = hJoinInitTargets(pInfo, pDownstream, pExprInfo, numOfCols);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  pInfo->pKeyCols[0] = taosArrayInit(4, sizeof(SColumn));
+  pInfo->pKeyCols[1] = taosArrayInit(4, sizeof(SColumn));
+  if (pInfo->pKeyCols[0] == NULL || pInfo->pKeyCols[1] == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _error;
+  }
+
+  code = hJoinExtractKeyCols(pInfo, pDownstream, pJoinNode->pMergeCondition);
+  if (code == TSDB_CODE_SUCCESS) {
+    code = hJoinExtractKeyCols(pInfo, pDownstream, pJoinNode->pColEqualOnConditions);
+  }
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  pInfo->keyBuf = taosMemoryCalloc(1, pInfo->keyLen + 1);
+  if (pInfo->keyBuf == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _error;
+  }
+
+  code = hJoinInitCond(pInfo, pJoinNode);
+  if (code == TSDB_CODE_SUCCESS) {
+    code = filterInitFromNode(pInfo->pCondAfterJoin, &pOperator->exprSupp.pFilterInfo, 0);
+  }
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  pOperator->fpSet = createOperatorFpSet(optrDummyOpenFn, doHashJoin, NULL, destroyHashJoinOperator,
+                                         optrDefaultBufFn, hJoinGetExplainExecInfo);
+  code = appendDownstream(pOperator, pDownstream, numOfDownstream);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  return pOperator;
+
+_error:
+  if (pInfo != NULL) {
+    destroyHashJoinOperator(pInfo);
+  }
+
+  taosMemoryFree(pOperator);
+  pTaskInfo->code = code;
+  return NULL;
+}
+
+static void hJoinDestroyBlockList(SArray* pBlocks) {
+  for (int32_t i = 0; i < taosArrayGetSize(pBlocks); ++i) {
+    blockDataDestroy(taosArrayGetP(pBlocks, i));
+  }
+  taosArrayDestroy(pBlocks);
+}
+
+static void hJoinResetPartition(SHJoinPartition* pPart) {
+  pPart->pBuild = blockDataDestroy(pPart->pBuild);
+  taosArrayDestroy(pPart->pNext);
+  pPart->pNext = NULL;
+  tSimpleHashCleanup(pPart->pTable);
+  pPart->pTable = NULL;
+}
+
+static void destroyHashJoinOperator(void* param) {
+  SHJoinOperatorInfo* pInfo = (SHJoinOperatorInfo*)param;
+
+  for (int32_t i = 0; i < HJOIN_PARTITION_NUM; ++i) {
+    SHJoinPartition* pPart = &pInfo->parts[i];
+    hJoinResetPartition(pPart);
+    blockDataDestroy(pPart->pProbe);
+    taosArrayDestroy(pPart->pBuildPages);
+    taosArrayDestroy(pPart->pProbePages);
+  }
+
+  hJoinDestroyBlockList(pInfo->pPrefetched[0]);
+  hJoinDestroyBlockList(pInfo->pPrefetched[1]);
+  blockDataDestroy(pInfo->pOwnedProbe);
+  destroyDiskbasedBuf(pInfo->pBuf);
+
+  taosArrayDestroy(pInfo->pKeyCols[0]);
+  taosArrayDestroy(pInfo->pKeyCols[1]);
+  taosMemoryFreeClear(pInfo->keyBuf);
+  taosMemoryFreeClear(pInfo->pTargets);
+  nodesDestroyNode(pInfo->pCondAfterJoin);
+
+  pInfo->pRes = blockDataDestroy(pInfo->pRes);
+  taosMemoryFreeClear(param);
+}
+
+// return the length of the key, or -1 if any key column of the row is null, which never matches
+static int32_t hJoinFillKeyBuf(const SArray* pKeyCols, const SSDataBlock* pBlock, int32_t rowIndex, char* pKey) {
+  char*  pStart = pKey;
+  size_t numOfCols = taosArrayGetSize(pKeyCols);
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    const SColumn*   pCol = taosArrayGet(pKeyCols, i);
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, pCol->slotId);
+    if (colDataIsNull_s(pColInfoData, rowIndex)) {
+      return -1;
+    }
+
+    char*   val = colDataGetData(pColInfoData, rowIndex);
+    int32_t len = pCol->bytes;
+    if (pCol->type == TSDB_DATA_TYPE_JSON) {
+      len = getJsonValueLen(val);
+    } else if (IS_VAR_DATA_TYPE(pCol->type)) {
+      len = varDataTLen(val);
+    }
+    memcpy(pStart, val, len);
+    pStart += len;
+  }
+
+  return (int32_t)(pStart - pKey);
+}
+
+static int32_t hJoinCopyRow(SSDataBlock* pDst, const SSDataBlock* pSrc, int32_t rowIndex) {
+  if (pDst->info.rows >= pDst->info.capacity) {
+    int32_t code = blockDataEnsureCapacity(pDst, TMAX(pDst->info.capacity * 2, 1024));
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  size_t numOfCols = taosArrayGetSize(pSrc->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pSrcCol = taosArrayGet(pSrc->pDataBlock, i);
+    SColumnInfoData* pDstCol = taosArrayGet(pDst->pDataBlock, i);
+    if (colDataIsNull_s(pSrcCol, rowIndex)) {
+      colDataSetNULL(pDstCol, pDst->info.rows);
+    } else {
+      int32_t code = colDataSetVal(pDstCol, pDst->info.rows, colDataGetData(pSrcCol, rowIndex), false);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    }
+  }
+
+  pDst->info.rows += 1;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinWritePages(SHJoinOperatorInfo* pInfo, SSDataBlock* pBlock, SArray** ppPageIds,
+                               const char* idStr) {
+  if (pBlock == NULL || pBlock->info.rows == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (pInfo->pBuf == NULL) {
+    if (!osTempSpaceAvailable()) {
+      qError("%s hash join spill failed since no disk space, tempDir:%s", idStr, tsTempDir);
+      return TSDB_CODE_NO_DISKSPACE;
+    }
+
+    uint32_t pageSize = 0;
+    uint32_t bufSize = 0;
+    int32_t  code = getBufferPgSize(pInfo->rowSize, &pageSize, &bufSize);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    pageSize = TMAX(pageSize, HJOIN_MIN_PAGE_SIZE);
+    bufSize = TMAX(bufSize, pageSize * 4);
+    code = createDiskbasedBuf(&pInfo->pBuf, pageSize, bufSize, "hashJoinBuf", tsTempDir);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  if (*ppPageIds == NULL) {
+    *ppPageIds = taosArrayInit(4, sizeof(int32_t));
+    if (*ppPageIds == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  int32_t start = 0;
+  while (start < pBlock->info.rows) {
+    int32_t stop = 0;
+    int32_t code = blockDataSplitRows(pBlock, pBlock->info.hasVarCol, start, &stop, getBufPageSize(pInfo->pBuf));
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    SSDataBlock* p = blockDataExtractBlock(pBlock, start, stop - start + 1);
+    if (p == NULL) {
+      return terrno;
+    }
+
+    int32_t pageId = -1;
+    void*   pPage = getNewBufPage(pInfo->pBuf, &pageId);
+    if (pPage == NULL) {
+      blockDataDestroy(p);
+      return terrno;
+    }
+
+    blockDataToBuf(pPage, p);
+    setBufPageDirty(pPage, true);
+    releaseBufPage(pInfo->pBuf, pPage);
+    blockDataDestroy(p);
+
+    if (taosArrayPush(*ppPageIds, &pageId) == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    start = stop + 1;
+  }
+
+  blockDataCleanup(pBlock);
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinReadPage(SHJoinOperatorInfo* pInfo, int32_t pageId, SSDataBlock* pBlock) {
+  void* pPage = getBufPage(pInfo->pBuf, pageId);
+  if (pPage == NULL) {
+    return terrno;
+  }
+
+  int32_t code = blockDataFromBuf(pBlock, pPage);
+  // each spilled page is read only once
+  dBufSetBufPageRecycled(pInfo->pBuf, pPage);
+  return code;
+}
+
+static int32_t hJoinInsertRow(SHJoinPartition* pPart, const char* pKey, int32_t keyLen) {
+  int32_t  row = pPart->pBuild->info.rows - 1;
+  int32_t  next = HJOIN_ROW_NONE;
+  int32_t* pHead = tSimpleHashGet(pPart->pTable, pKey, keyLen);
+  if (pHead != NULL) {
+    next = *pHead;
+    *pHead = row;
+  } else {
+    int32_t code = tSimpleHashPut(pPart->pTable, pKey, keyLen, &row, sizeof(int32_t));
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  return taosArrayPush(pPart->pNext, &next) == NULL ? TSDB_CODE_OUT_OF_MEMORY : TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinAddBuildRow(SHJoinOperatorInfo* pInfo, SHJoinPartition* pPart, const SSDataBlock* pBlock,
+                                int32_t rowIndex, int32_t keyLen) {
+  if (pPart->pBuild == NULL) {
+    pPart->pBuild = createOneDataBlock(pBlock, false);
+    if (pPart->pBuild == NULL) {
+      return terrno;
+    }
+  }
+
+  int32_t code = hJoinCopyRow(pPart->pBuild, pBlock, rowIndex);
+  if (code != TSDB_CODE_SUCCESS || pPart->spilled) {
+    return code;
+  }
+
+  if (pPart->pTable == NULL) {
+    pPart->pTable = tSimpleHashInit(1024, pInfo->hashFn);
+    pPart->pNext = taosArrayInit(1024, sizeof(int32_t));
+    if (pPart->pTable == NULL || pPart->pNext == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+  return hJoinInsertRow(pPart, pInfo->keyBuf, keyLen);
+}
+
+static int64_t hJoinGetPartitionMemSize(const SHJoinPartition* pPart) {
+  int64_t size = 0;
+  if (pPart->pBuild != NULL) {
+    size += blockDataGetSize(pPart->pBuild);
+  }
+  if (pPart->pTable != NULL) {
+    size += tSimpleHashGetMemSize(pPart->pTable) + taosArrayGetSize(pPart->pNext) * sizeof(int32_t);
+  }
+  return size;
+}
+
+static int32_t hJoinSpillPartitions(SHJoinOperatorInfo* pInfo, const char* idStr) {
+  int64_t memSize = 0;
+  int64_t maxSize = 0;
+  int32_t maxIdx = -1;
+
+  for (int32_t i = 0; i < HJOIN_PARTITION_NUM; ++i) {
+    SHJoinPartition* pPart = &pInfo->parts[i];
+    int64_t          size = hJoinGetPartitionMemSize(pPart);
+    memSize += size;
+
+    if (pPart->spilled) {
+      // flush the staged build rows of the spilled partition once they fill a page
+      if (pPart->pBuild != NULL && size >= HJOIN_MIN_PAGE_SIZE) {
+        int32_t code = hJoinWritePages(pInfo, pPart->pBuild, &pPart->pBuildPages, idStr);
+        if (code != TSDB_CODE_SUCCESS) {
+          return code;
+        }
+      }
+    } else if (size > maxSize) {
+      maxSize = size;
+      maxIdx = i;
+    }
+  }
+
+  while (memSize > pInfo->memThreshold && maxIdx >= 0) {
+    SHJoinPartition* pPart = &pInfo->parts[maxIdx];
+    int32_t          code = hJoinWritePages(pInfo, pPart->pBuild, &pPart->pBuildPages, idStr);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    tSimpleHashCleanup(pPart->pTable);
+    pPart->pTable = NULL;
+    taosArrayDestroy(pPart->pNext);
+    pPart->pNext = NULL;
+    pPart->spilled = true;
+    pInfo->execInfo.spillPartitions += 1;
+    memSize -= maxSize;
+    qDebug("%s hash join partition:%d spilled, size:%" PRId64, idStr, maxIdx, maxSize);
+
+    maxSize = 0;
+    maxIdx = -1;
+    for (int32_t i = 0; i < HJOIN_PARTITION_NUM; ++i) {
+      int64_t size = pInfo->parts[i].spilled ? 0 : hJoinGetPartitionMemSize(&pInfo->parts[i]);
+      if (size > maxSize) {
+        maxSize = size;
+        maxIdx = i;
+      }
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinAddBuildBlock(SHJoinOperatorInfo* pInfo, const SSDataBlock* pBlock, const char* idStr) {
+  SArray* pKeyCols = pInfo->pKeyCols[pInfo->buildSide];
+
+  for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+    int32_t keyLen = hJoinFillKeyBuf(pKeyCols, pBlock, i, pInfo->keyBuf);
+    if (keyLen < 0) {
+      continue;
+    }
+
+    uint32_t         hashVal = pInfo->hashFn(pInfo->keyBuf, keyLen);
+    SHJoinPartition* pPart = &pInfo->parts[HJOIN_PARTITION_ID(hashVal)];
+    int32_t          code = hJoinAddBuildRow(pInfo, pPart, pBlock, i, keyLen);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+    pInfo->execInfo.buildRows += 1;
+  }
+
+  return hJoinSpillPartitions(pInfo, idStr);
+}
+
+// Read the two children in turns until one of them is exhausted, so that the hash table is built on the smaller one. Stop reading ahead once the buffered blocks exceed the memory threshold.
+static int32_t hJoinPrefetch(SOperatorInfo* pOperator) {
+  SHJoinOperatorInfo* pInfo = pOperator->info;
+  int64_t             bufSize = 0;
+
+  pInfo->pPrefetched[0] = taosArrayInit(4, POINTER_BYTES);
+  pInfo->pPrefetched[1] = taosArrayInit(4, POINTER_BYTES);
+  if (pInfo->pPrefetched[0] == NULL || pInfo->pPrefetched[1] == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  while (bufSize <= pInfo->memThreshold) {
+    for (int32_t side = 0; side < 2; ++side) {
+      SOperatorInfo* pDownstream = pOperator->pDownstream[side];
+      SSDataBlock*   pBlock = pDownstream->fpSet.getNextFn(pDownstream);
+      if (pBlock == NULL) {
+        pInfo->buildSide = side;
+        pInfo->buildEof = true;
+        return TSDB_CODE_SUCCESS;
+      }
+
+      SSDataBlock* pCopy = createOneDataBlock(pBlock, true);
+      if (pCopy == NULL) {
+        return terrno;
+      }
+      if (taosArrayPush(pInfo->pPrefetched[side], &pCopy) == NULL) {
+        blockDataDestroy(pCopy);
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+      bufSize += blockDataGetSize(pCopy);
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinBuild(SOperatorInfo* pOperator) {
+  SHJoinOperatorInfo* pInfo = pOperator->info;
+  const char*         idStr = GET_TASKID(pOperator->pTaskInfo);
+  int32_t             code = TSDB_CODE_SUCCESS;
+
+  code = hJoinPrefetch(pOperator);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  SArray* pBuildBlocks = pInfo->pPrefetched[pInfo->buildSide];
+  for (int32_t i = 0; i < taosArrayGetSize(pBuildBlocks); ++i) {
+    SSDataBlock** ppBlock = taosArrayGet(pBuildBlocks, i);
+    code = hJoinAddBuildBlock(pInfo, *ppBlock, idStr);
+    *ppBlock = blockDataDestroy(*ppBlock);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+  taosArrayClear(pBuildBlocks);
+
+  SOperatorInfo* pDownstream = pOperator->pDownstream[pInfo->buildSide];
+  while (!pInfo->buildEof) {
+    SSDataBlock* pBlock = pDownstream->fpSet.getNextFn(pDownstream);
+    if (pBlock == NULL) {
+      break;
+    }
+
+    code = hJoinAddBuildBlock(pInfo, pBlock, idStr);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  for (int32_t i = 0; i < HJOIN_PARTITION_NUM; ++i) {
+    SHJoinPartition* pPart = &pInfo->parts[i];
+    if (pPart->spilled) {
+      code = hJoinWritePages(pInfo, pPart->pBuild, &pPart->pBuildPages, idStr);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    }
+  }
+
+  pInfo->execInfo.buildSide = pInfo->buildSide;
+  qDebug("%s hash join build done, build side:%d, rows:%" PRId64 ", spilled partitions:%d", idStr, pInfo->buildSide,
+         pInfo->execInfo.buildRows, pInfo->execInfo.spillPartitions);
+  return TSDB_CODE_SUCCESS;
+}
+
+// load the next spilled partition into memory, *pLoaded is false if there is none left
+static int32_t hJoinLoadSpilledPartition(SHJoinOperatorInfo* pInfo, bool* pLoaded) {
+  *pLoaded = false;
+
+  if (pInfo->spillIdx >= 0) {
+    SHJoinPartition* pPart = &pInfo->parts[pInfo->spillIdx];
+    hJoinResetPartition(pPart);
+    pPart->pProbe = blockDataDestroy(pPart->pProbe);
+  }
+
+  for (pInfo->spillIdx += 1; pInfo->spillIdx < HJOIN_PARTITION_NUM; ++pInfo->spillIdx) {
+    SHJoinPartition* pPart = &pInfo->parts[pInfo->spillIdx];
+    if (!pPart->spilled) {
+      continue;
+    }
+
+    // the probe rows of a partition without any build row never match
+    if (taosArrayGetSize(pPart->pProbePages) == 0 || taosArrayGetSize(pPart->pBuildPages) == 0) {
+      continue;
+    }
+
+    SSDataBlock* pBlock = createOneDataBlock(pPart->pBuild, false);
+    if (pBlock == NULL) {
+      return terrno;
+    }
+
+    pPart->spilled = false;
+    pPart->pTable = tSimpleHashInit(1024, pInfo->hashFn);
+    pPart->pNext = taosArrayInit(1024, sizeof(int32_t));
+    if (pPart->pTable == NULL || pPart->pNext == NULL) {
+      blockDataDestroy(pBlock);
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    SArray* pKeyCols = pInfo->pKeyCols[pInfo->buildSide];
+    for (int32_t i = 0; i < taosArrayGetSize(pPart->pBuildPages); ++i) {
+      int32_t code = hJoinReadPage(pInfo, *(int32_t*)taosArrayGet(pPart->pBuildPages, i), pBlock);
+      for (int32_t j = 0; code == TSDB_CODE_SUCCESS && j < pBlock->info.rows; ++j) {
+        int32_t keyLen = hJoinFillKeyBuf(pKeyCols, pBlock, j, pInfo->keyBuf);
+        code = hJoinCopyRow(pPart->pBuild, pBlock, j);
+        if (code == TSDB_CODE_SUCCESS) {
+          code = hJoinInsertRow(pPart, pInfo->keyBuf, keyLen);
+        }
+      }
+      if (code != TSDB_CODE_SUCCESS) {
+        blockDataDestroy(pBlock);
+        return code;
+      }
+    }
+
+    blockDataDestroy(pBlock);
+    pInfo->spillPageIdx = 0;
+    *pLoaded = true;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinNextProbeBlock(SOperatorInfo* pOperator, SSDataBlock** ppBlock) {
+  SHJoinOperatorInfo* pInfo = pOperator->info;
+  const char*         idStr = GET_TASKID(pOperator->pTaskInfo);
+  int32_t             probeSide = 1 - pInfo->buildSide;
+  SArray*             pPrefetched = pInfo->pPrefetched[probeSide];
+
+  *ppBlock = NULL;
+  pInfo->pOwnedProbe = blockDataDestroy(pInfo->pOwnedProbe);
+
+  if (taosArrayGetSize(pPrefetched) > 0) {
+    pInfo->pOwnedProbe = taosArrayGetP(pPrefetched, 0);
+    taosArrayRemove(pPrefetched, 0);
+    *ppBlock = pInfo->pOwnedProbe;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (!pInfo->probeEof) {
+    SOperatorInfo* pDownstream = pOperator->pDownstream[probeSide];
+    *ppBlock = pDownstream->fpSet.getNextFn(pDownstream);
+    if (*ppBlock != NULL) {
+      return TSDB_CODE_SUCCESS;
+    }
+
+    pInfo->probeEof = true;
+    for (int32_t i = 0; i < HJOIN_PARTITION_NUM; ++i) {
+      SHJoinPartition* pPart = &pInfo->parts[i];
+      int32_t          code = hJoinWritePages(pInfo, pPart->pProbe, &pPart->pProbePages, idStr);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    }
+  }
+
+  // join the spilled partitions one by one
+  while (pInfo->spillIdx < HJOIN_PARTITION_NUM) {
+    SHJoinPartition* pPart = (pInfo->spillIdx >= 0) ? &pInfo->parts[pInfo->spillIdx] : NULL;
+    if (pPart != NULL && pInfo->spillPageIdx < taosArrayGetSize(pPart->pProbePages)) {
+      int32_t pageId = *(int32_t*)taosArrayGet(pPart->pProbePages, pInfo->spillPageIdx++);
+      int32_t code = hJoinReadPage(pInfo, pageId, pPart->pProbe);
+      if (code == TSDB_CODE_SUCCESS) {
+        *ppBlock = pPart->pProbe;
+      }
+      return code;
+    }
+
+    bool    loaded = false;
+    int32_t code = hJoinLoadSpilledPartition(pInfo, &loaded);
+    if (code != TSDB_CODE_SUCCESS || !loaded) {
+      return code;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static void hJoinAppendResRow(SOperatorInfo* pOperator, SSDataBlock* pRes, const SSDataBlock* pProbe,
+                              int32_t probeRow, const SSDataBlock* pBuild, int32_t buildRow) {
+  SHJoinOperatorInfo* pInfo = pOperator->info;
+  int32_t             probeSide = 1 - pInfo->buildSide;
+
+  for (int32_t i = 0; i < pOperator->exprSupp.numOfExprs; ++i) {
+    SColumnInfoData*    pDst = taosArrayGet(pRes->pDataBlock, i);
+    const SHJoinTarget* pTarget = &pInfo->pTargets[i];
+
+    const SSDataBlock* pSrcBlock = (pTarget->side == probeSide) ? pProbe : pBuild;
+    int32_t            rowIndex = (pTarget->side == probeSide) ? probeRow : buildRow;
+
+    SColumnInfoData* pSrc = taosArrayGet(pSrcBlock->pDataBlock, pTarget->slotId);
+    if (colDataIsNull_s(pSrc, rowIndex)) {
+      colDataSetNULL(pDst, pRes->info.rows);
+    } else {
+      colDataSetVal(pDst, pRes->info.rows, colDataGetData(pSrc, rowIndex), false);
+    }
+  }
+
+  pRes->info.rows += 1;
+}
+
+// Join the rows of the current probe block until it is exhausted or the result block is full. The rows whose
+// partition has been spilled are staged and joined after the probe side is exhausted.
+static int32_t hJoinProbe(SOperatorInfo* pOperator, SSDataBlock* pRes) {
+  SHJoinOperatorInfo* pInfo = pOperator->info;
+  SSDataBlock*        pProbe = pInfo->pProbeBlock;
+  SArray*             pKeyCols = pInfo->pKeyCols[1 - pInfo->buildSide];
+  const char*         idStr = GET_TASKID(pOperator->pTaskInfo);
+  int32_t             threshold = pOperator->resultInfo.threshold;
+
+  for (; pInfo->probeRow < pProbe->info.rows; ++pInfo->probeRow) {
+    int32_t          row = pInfo->probeRow;
+    SHJoinPartition* pPart = NULL;
+
+    if (pInfo->matchRow == HJOIN_ROW_NONE) {
+      if (pRes->info.rows >= threshold) {
+        return TSDB_CODE_SUCCESS;
+      }
+
+      int32_t keyLen = hJoinFillKeyBuf(pKeyCols, pProbe, row, pInfo->keyBuf);
+      if (keyLen >= 0) {
+        uint32_t hashVal = pInfo->hashFn(pInfo->keyBuf, keyLen);
+        pPart = &pInfo->parts[HJOIN_PARTITION_ID(hashVal)];
+        if (pPart->spilled && !pInfo->probeEof) {
+          if (pPart->pProbe == NULL) {
+            pPart->pProbe = createOneDataBlock(pProbe, false);
+            if (pPart->pProbe == NULL) {
+              return terrno;
+            }
+          }
+          int32_t code = hJoinCopyRow(pPart->pProbe, pProbe, row);
+          if (code == TSDB_CODE_SUCCESS && pPart->pProbe->info.rows >= HJOIN_STAGE_ROWS) {
+            code = hJoinWritePages(pInfo, pPart->pProbe, &pPart->pProbePages, idStr);
+          }
+          if (code != TSDB_CODE_SUCCESS) {
+            return code;
+          }
+          continue;
+        }
+
+        if (pPart->pTable != NULL) {
+          int32_t* pHead = tSimpleHashGet(pPart->pTable, pInfo->keyBuf, keyLen);
+          if (pHead != NULL) {
+            pInfo->matchRow = *pHead;
+          }
+        }
+      }
+    } else {
+      int32_t keyLen = hJoinFillKeyBuf(pKeyCols, pProbe, row, pInfo->keyBuf);
+      pPart = &pInfo->parts[HJOIN_PARTITION_ID(pInfo->hashFn(pInfo->keyBuf, keyLen))];
+    }
+
+    while (pInfo->matchRow != HJOIN_ROW_NONE) {
+      if (pRes->info.rows >= threshold) {
+        return TSDB_CODE_SUCCESS;
+      }
+      hJoinAppendResRow(pOperator, pRes, pProbe, row, pPart->pBuild, pInfo->matchRow);
+      pInfo->matchRow = *(int32_t*)taosArrayGet(pPart->pNext, pInfo->matchRow);
+    }
+  }
+
+  pInfo->pProbeBlock = NULL;
+  return TSDB_CODE_SUCCESS;
+}
+
+static SSDataBlock* doHashJoin(SOperatorInfo* pOperator) {
+  SHJoinOperatorInfo* pInfo = pOperator->info;
+  SExecTaskInfo*      pTaskInfo = pOperator->pTaskInfo;
+  SSDataBlock*        pRes = pInfo->pRes;
+  int32_t             code = TSDB_CODE_SUCCESS;
+
+  if (pOperator->status == OP_EXEC_DONE) {
+    return NULL;
+  }
+
+  if (!pInfo->built) {
+    code = hJoinBuild(pOperator);
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+    pInfo->built = true;
+  }
+
+  blockDataCleanup(pRes);
+  while (true) {
+    bool eof = false;
+    while (pRes->info.rows < pOperator->resultInfo.threshold) {
+      if (pInfo->pProbeBlock == NULL) {
+        code = hJoinNextProbeBlock(pOperator, &pInfo->pProbeBlock);
+        if (code != TSDB_CODE_SUCCESS) {
+          T_LONG_JMP(pTaskInfo->env, code);
+        }
+        if (pInfo->pProbeBlock == NULL) {
+          eof = true;
+          break;
+        }
+        pInfo->probeRow = 0;
+        pInfo->matchRow = HJOIN_ROW_NONE;
+      }
+
+      code = hJoinProbe(pOperator, pRes);
+      if (code != TSDB_CODE_SUCCESS) {
+        T_LONG_JMP(pTaskInfo->env, code);
+      }
+    }
+
+    if (pOperator->exprSupp.pFilterInfo != NULL) {
+      doFilter(pRes, pOperator->exprSupp.pFilterInfo, NULL);
+    }
+
+    if (pRes->info.rows > 0) {
+      pRes->info.dataLoad = 1;
+      pRes->info.scanFlag = MAIN_SCAN;
+      pOperator->resultInfo.totalRows += pRes->info.rows;
+      return pRes;
+    }
+
+    if (eof) {
+      setOperatorCompleted(pOperator);
+      return NULL;
+    }
+  }
+}
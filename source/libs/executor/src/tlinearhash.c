@@ -210,7 +210,7 @@ static int32_t doAddNewBucket(SLHashObj* pHashObj) {
       return TSDB_CODE_OUT_OF_MEMORY;
     }
 
-    memset(p + POINTER_BYTES * pHashObj->numOfBuckets, 0, newLen - pHashObj->numOfBuckets);
+    memset(p + POINTER_BYTES * pHashObj->numOfBuckets, 0, POINTER_BYTES * (newLen - pHashObj->numOfBuckets));
     pHashObj->pBucket = (SLHashBucket**)p;
     pHashObj->numOfAlloc = newLen;
   }
@@ -301,7 +301,10 @@ void* tHashCleanup(SLHashObj* pHashObj) {
 int32_t tHashPut(SLHashObj* pHashObj, const void* key, size_t keyLen, void* data, size_t size) {
   if (pHashObj->bits == 0) {
     SLHashBucket* pBucket = pHashObj->pBucket[0];
-    doAddToBucket(pHashObj, pBucket, 0, key, keyLen, data, size);
+    int32_t       code = doAddToBucket(pHashObj, pBucket, 0, key, keyLen, data, size);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
   } else {
     int32_t hashVal = pHashObj->hashFn(key, keyLen);
     int32_t v = doGetBucketIdFromHashVal(hashVal, pHashObj->bits);
@@ -360,8 +363,12 @@ int32_t tHashPut(SLHashObj* pHashObj, const void* key, size_t keyLen, void* data
           ASSERT(v1 == newBucketId);
           //          printf("move key:%d to 0x%x bucket, remain items:%d\n", *(int32_t*)k, v1, pBucket->size - 1);
           SLHashBucket* pNewBucket = pHashObj->pBucket[newBucketId];
-          doAddToBucket(pHashObj, pNewBucket, newBucketId, (void*)GET_LHASH_NODE_KEY(pNode), pNode->keyLen,
-                        GET_LHASH_NODE_KEY(pNode), pNode->dataLen);
+          int32_t code = doAddToBucket(pHashObj, pNewBucket, newBucketId, (void*)GET_LHASH_NODE_KEY(pNode),
+                                       pNode->keyLen, GET_LHASH_NODE_DATA(pNode), pNode->dataLen);
+          if (code != TSDB_CODE_SUCCESS) {
+            releaseBufPage(pHashObj->pBuf, p);
+            return code;
+          }
           doRemoveFromBucket(p, pNode, pBucket);
         } else {
           //          printf("check key:%d, located into: %d, skip it\n", *(int*) k, v1);
@@ -378,6 +385,10 @@ int32_t tHashPut(SLHashObj* pHashObj, const void* key, size_t keyLen, void* data
   return TSDB_CODE_SUCCESS;
 }
 
+int64_t tHashGetSize(const SLHashObj* pHashObj) { return pHashObj->size; }
+
+SDiskbasedBufStatis tHashGetBufStatis(const SLHashObj* pHashObj) { return getDBufStatis(pHashObj->pBuf); }
+
 char* tHashGet(SLHashObj* pHashObj, const void* key, size_t keyLen) {
   int32_t hashv = pHashObj->hashFn(key, keyLen);
 
@@ -394,7 +405,7 @@ char* tHashGet(SLHashObj* pHashObj, const void* key, size_t keyLen) {
     SFilePage* p = getBufPage(pHashObj->pBuf, pageId);
 
     char* pStart = p->data;
-    while (pStart - p->data < p->num) {
+    while (pStart - ((char*)p) < p->num) {
       SLHashNode* pNode = (SLHashNode*)pStart;
 
       char* k = GET_LHASH_NODE_KEY(pNode);
@@ -412,6 +423,41 @@ char* tHashGet(SLHashObj* pHashObj, const void* key, size_t keyLen) {
   return NULL;
 }
 
+// the data of the next node, bucket by bucket and page by page, valid until the next page of the hash is loaded
+char* tHashIterate(SLHashObj* pHashObj, SLHashIter* pIter, char** pKey, size_t* keyLen) {
+  while (pIter->bucketId < pHashObj->numOfBuckets) {
+    SLHashBucket* pBucket = pHashObj->pBucket[pIter->bucketId];
+    if (pIter->pageIndex >= taosArrayGetSize(pBucket->pPageIdList)) {
+      pIter->bucketId += 1;
+      pIter->pageIndex = 0;
+      pIter->offset = 0;
+      continue;
+    }
+
+    int32_t    pageId = *(int32_t*)taosArrayGet(pBucket->pPageIdList, pIter->pageIndex);
+    SFilePage* p = getBufPage(pHashObj->pBuf, pageId);
+    if (pIter->offset == 0) {
+      pIter->offset = p->data - (char*)p;
+    }
+
+    if (pIter->offset < p->num) {
+      SLHashNode* pNode = (SLHashNode*)((char*)p + pIter->offset);
+      pIter->offset += GET_LHASH_NODE_LEN(pNode);
+      releaseBufPage(pHashObj->pBuf, p);
+
+      *pKey = GET_LHASH_NODE_KEY(pNode);
+      *keyLen = pNode->keyLen;
+      return GET_LHASH_NODE_DATA(pNode);
+    }
+
+    releaseBufPage(pHashObj->pBuf, p);
+    pIter->pageIndex += 1;
+    pIter->offset = 0;
+  }
+
+  return NULL;
+}
+
 int32_t tHashRemove(SLHashObj* pHashObj, const void* key, size_t keyLen) {
   // todo
   return TSDB_CODE_SUCCESS;
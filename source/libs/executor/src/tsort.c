@@ -13,15 +13,18 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "executor.h"
 #include "query.h"
 #include "tcommon.h"
 
 #include "tcompare.h"
 #include "tdatablock.h"
 #include "tdef.h"
+#include "tglobal.h"
 #include "theap.h"
 #include "tlosertree.h"
 #include "tpagedbuf.h"
+#include "tsched.h"
 #include "tsort.h"
 #include "tutil.h"
 #include "tsimplehash.h"
@@ -69,10 +72,426 @@ struct SSortHandle {
   _sort_fetch_block_fn_t  fetchfp;
   _sort_merge_compar_fn_t comparFn;
   SMultiwayMergeTreeInfo* pMergeTree;
+
+  bool          normKeyInited;
+  int32_t       numOfThreads;
+  TdThreadMutex bufLock;  // serializes the access to pBuf when merge groups run concurrently
 };
 
+typedef struct SSortWorkerTask {
+  void* (*fp)(void*);
+  void*  param;
+  tsem_t done;
+  bool   scheduled;
+} SSortWorkerTask;
+
+typedef struct SSortRunTask {
+  SSortHandle*    pHandle;
+  SSDataBlock*    pBlock;
+  SArray*         pOrderInfo;  // private copy, blockDataSort caches the column pointers in it
+  SSortWorkerTask worker;
+  int32_t         code;
+  int64_t         elapsed;
+} SSortRunTask;
+
+typedef struct SSortMergeTask {
+  SSortHandle*            pHandle;
+  SMsortComparParam       cmpParam;
+  SMultiwayMergeTreeInfo* pTree;
+  SSDataBlock*            pBlock;
+  SArray*                 pPageIdList;
+  int32_t                 numOfCompleted;
+  int32_t                 start;
+  int32_t                 end;
+  int32_t                 capacity;
+  SSortWorkerTask         worker;
+  int32_t                 code;
+} SSortMergeTask;
+
 static int32_t msortComparFn(const void* pLeft, const void* pRight, void* param);
 
+/*
+ * The sort runs and the merge groups of all the sort handles are executed by the sort workers, which the dnode
+ * creates at startup. The tasks run on the query thread if the workers are not available.
+ */
+#define SORT_WORKER_QUEUE_SIZE 1024
+
+static SSchedQueue sortWorkers = {0};
+static bool        sortWorkersReady = false;
+
+int32_t qInitSortWorkers(int32_t numOfThreads) {
+  if (sortWorkersReady || numOfThreads <= 1) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  memset(&sortWorkers, 0, sizeof(sortWorkers));
+  if (taosInitScheduler(SORT_WORKER_QUEUE_SIZE, numOfThreads, "tsort", &sortWorkers) == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    qError("failed to init %d sort workers", numOfThreads);
+    return terrno;
+  }
+
+  sortWorkersReady = true;
+  return TSDB_CODE_SUCCESS;
+}
+
+void qCleanupSortWorkers() {
+  if (sortWorkersReady) {
+    sortWorkersReady = false;
+    taosCleanUpScheduler(&sortWorkers);
+  }
+}
+
+static void doSortWorkerTask(SSchedMsg* pMsg) {
+  SSortWorkerTask* pTask = pMsg->ahandle;
+  pTask->fp(pTask->param);
+  tsem_post(&pTask->done);
+}
+
+static void startSortWorkerTask(SSortWorkerTask* pTask, void* (*fp)(void*), void* param, const char* idStr) {
+  pTask->fp = fp;
+  pTask->param = param;
+  pTask->scheduled = false;
+  if (sortWorkersReady && tsem_init(&pTask->done, 0, 0) == 0) {
+    SSchedMsg msg = {.fp = doSortWorkerTask, .ahandle = pTask};
+    if (taosScheduleTask(&sortWorkers, &msg) == 0) {
+      pTask->scheduled = true;
+      return;
+    }
+
+    tsem_destroy(&pTask->done);
+    qWarn("%s failed to schedule the sort task, run it on the query thread", idStr);
+  }
+
+  fp(param);
+}
+
+static void waitSortWorkerTask(SSortWorkerTask* pTask) {
+  if (pTask->scheduled) {
+    tsem_wait(&pTask->done);
+    tsem_destroy(&pTask->done);
+    pTask->scheduled = false;
+  }
+}
+
+static FORCE_INLINE void sortLockBuf(SSortHandle* pHandle) {
+  if (pHandle->numOfThreads > 1) {
+    taosThreadMutexLock(&pHandle->bufLock);
+  }
+}
+
+static FORCE_INLINE void sortUnlockBuf(SSortHandle* pHandle) {
+  if (pHandle->numOfThreads > 1) {
+    taosThreadMutexUnlock(&pHandle->bufLock);
+  }
+}
+
+/*
+ * Normalized sort keys
+ *
+ * The order columns of a row are encoded into one byte string whose memcmp order is the order of the rows, so that
+ * the sorted runs are generated by a radix sort and the merge compares the rows with one memcmp. Every order column
+ * is encoded as a null flag byte followed by the value, in big-endian with the sign bit flipped, padded to the column
+ * width for the var types and followed by the data length. The value bytes are inverted for the desc order.
+ */
+#define SORT_NORM_KEY_MAX_LEN     512
+#define SORT_RADIX_SORT_THRESHOLD 32
+
+static int32_t sortGetNormKeyColLen(const SColumnInfoData* pCol) {
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_UTINYINT:
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_UINT:
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+    case TSDB_DATA_TYPE_FLOAT:
+    case TSDB_DATA_TYPE_DOUBLE:
+    case TSDB_DATA_TYPE_VARCHAR:
+    case TSDB_DATA_TYPE_GEOMETRY:
+    case TSDB_DATA_TYPE_NCHAR:
+      // the var data header is moved behind the data padded to the column width
+      return 1 + pCol->info.bytes;
+    default:
+      return -1;
+  }
+}
+
+static int32_t sortGetNormKeyLen(SArray* pSortInfo, const SSDataBlock* pBlock) {
+  int32_t len = 0;
+  for (int32_t i = 0; i < taosArrayGetSize(pSortInfo); ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pSortInfo, i);
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pOrder->slotId);
+    if (pCol == NULL) {
+      return 0;
+    }
+
+    int32_t colLen = sortGetNormKeyColLen(pCol);
+    if (colLen < 0) {
+      return 0;
+    }
+    len += colLen;
+  }
+
+  return (len <= SORT_NORM_KEY_MAX_LEN) ? len : 0;
+}
+
+static FORCE_INLINE void sortPutBigEndian(char* p, uint64_t v, int32_t bytes) {
+  for (int32_t i = bytes - 1; i >= 0; --i) {
+    p[i] = (char)(v & 0xFF);
+    v >>= 8;
+  }
+}
+
+static void sortEncodeNormKeyVal(char* p, const SColumnInfoData* pCol, const char* pData) {
+  int32_t bytes = pCol->info.bytes;
+
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      *(uint8_t*)p = (uint8_t)(*(int8_t*)pData) ^ 0x80u;
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      sortPutBigEndian(p, (uint16_t)(*(int16_t*)pData) ^ 0x8000u, bytes);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      sortPutBigEndian(p, (uint32_t)(*(int32_t*)pData) ^ 0x80000000u, bytes);
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      sortPutBigEndian(p, (uint64_t)(*(int64_t*)pData) ^ 0x8000000000000000ull, bytes);
+      break;
+    case TSDB_DATA_TYPE_UTINYINT:
+      *(uint8_t*)p = *(uint8_t*)pData;
+      break;
+    case TSDB_DATA_TYPE_USMALLINT:
+      sortPutBigEndian(p, *(uint16_t*)pData, bytes);
+      break;
+    case TSDB_DATA_TYPE_UINT:
+      sortPutBigEndian(p, *(uint32_t*)pData, bytes);
+      break;
+    case TSDB_DATA_TYPE_UBIGINT:
+      sortPutBigEndian(p, *(uint64_t*)pData, bytes);
+      break;
+    case TSDB_DATA_TYPE_FLOAT: {
+      // nan is the smallest value, and -0.0 equals to 0.0, as the float comparators do
+      float    v = GET_FLOAT_VAL(pData);
+      uint32_t bits = 0;
+      if (!isnan(v)) {
+        v = (v == 0) ? 0 : v;
+        memcpy(&bits, &v, sizeof(bits));
+        bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+      }
+      sortPutBigEndian(p, bits, bytes);
+      break;
+    }
+    case TSDB_DATA_TYPE_DOUBLE: {
+      double   v = GET_DOUBLE_VAL(pData);
+      uint64_t bits = 0;
+      if (!isnan(v)) {
+        v = (v == 0) ? 0 : v;
+        memcpy(&bits, &v, sizeof(bits));
+        bits = (bits & 0x8000000000000000ull) ? ~bits : (bits | 0x8000000000000000ull);
+      }
+      sortPutBigEndian(p, bits, bytes);
+      break;
+    }
+    case TSDB_DATA_TYPE_NCHAR: {
+      int32_t len = varDataLen(pData);
+      for (int32_t i = 0; i < len; i += sizeof(TdUcs4)) {
+        sortPutBigEndian(p + i, *(uint32_t*)(varDataVal(pData) + i), sizeof(TdUcs4));
+      }
+      memset(p + len, 0, bytes - VARSTR_HEADER_SIZE - len);
+      sortPutBigEndian(p + bytes - VARSTR_HEADER_SIZE, len, VARSTR_HEADER_SIZE);
+      break;
+    }
+    default: {  // varchar and geometry
+      int32_t len = varDataLen(pData);
+      memcpy(p, varDataVal(pData), len);
+      memset(p + len, 0, bytes - VARSTR_HEADER_SIZE - len);
+      sortPutBigEndian(p + bytes - VARSTR_HEADER_SIZE, len, VARSTR_HEADER_SIZE);
+      break;
+    }
+  }
+}
+
+/*
+ * encode the normalized keys of the rows [0, rows) of the block into pKeys, the key of row i starts at i * stride
+ */
+static void sortEncodeNormKeys(SArray* pSortInfo, const SSDataBlock* pBlock, int32_t rows, char* pKeys,
+                               int32_t stride) {
+  int32_t offset = 0;
+  for (int32_t i = 0; i < taosArrayGetSize(pSortInfo); ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pSortInfo, i);
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pOrder->slotId);
+    int32_t          valLen = sortGetNormKeyColLen(pCol) - 1;
+    char             nullFlag = pOrder->nullFirst ? 0 : 1;
+    bool             desc = (pOrder->order == TSDB_ORDER_DESC);
+
+    for (int32_t j = 0; j < rows; ++j) {
+      char* p = pKeys + (int64_t)j * stride + offset;
+      if (colDataIsNull_s(pCol, j)) {
+        p[0] = nullFlag;
+        memset(p + 1, 0, valLen);
+        continue;
+      }
+
+      p[0] = !nullFlag;
+      sortEncodeNormKeyVal(p + 1, pCol, colDataGetData(pCol, j));
+      if (desc) {
+        for (int32_t k = 1; k <= valLen; ++k) {
+          p[k] = ~p[k];
+        }
+      }
+    }
+
+    offset += valLen + 1;
+  }
+}
+
+/*
+ * Sort the fixed width entries by the first keyLen bytes with a msd radix sort, the sort is stable. pBuf has the same
+ * size as pEntries.
+ */
+static void sortRadixSortNormKeys(char* pEntries, char* pBuf, int32_t num, int32_t width, int32_t keyLen,
+                                  int32_t depth) {
+  while (depth < keyLen) {
+    if (num <= SORT_RADIX_SORT_THRESHOLD) {
+      // insertion sort, the first entry of pBuf is used as the swap space
+      for (int32_t i = 1; i < num; ++i) {
+        char* pCur = pEntries + (int64_t)i * width;
+        int32_t j = i;
+        while (j > 0 && memcmp(pCur - width + depth, pCur + depth, keyLen - depth) > 0) {
+          memcpy(pBuf, pCur, width);
+          memcpy(pCur, pCur - width, width);
+          memcpy(pCur - width, pBuf, width);
+          pCur -= width;
+          --j;
+        }
+      }
+      return;
+    }
+
+    int32_t count[256] = {0};
+    for (int32_t i = 0; i < num; ++i) {
+      count[(uint8_t)pEntries[(int64_t)i * width + depth]] += 1;
+    }
+
+    // all entries share this byte, move to the next one
+    if (count[(uint8_t)pEntries[depth]] == num) {
+      depth += 1;
+      continue;
+    }
+
+    int32_t start[256];
+    int32_t pos = 0;
+    for (int32_t b = 0; b < 256; ++b) {
+      start[b] = pos;
+      pos += count[b];
+    }
+
+    for (int32_t i = 0; i < num; ++i) {
+      char* p = pEntries + (int64_t)i * width;
+      memcpy(pBuf + (int64_t)(start[(uint8_t)p[depth]]++) * width, p, width);
+    }
+    memcpy(pEntries, pBuf, (int64_t)num * width);
+
+    pos = 0;
+    for (int32_t b = 0; b < 256; ++b) {
+      if (count[b] > 1) {
+        sortRadixSortNormKeys(pEntries + (int64_t)pos * width, pBuf + (int64_t)pos * width, count[b], width, keyLen,
+                              depth + 1);
+      }
+      pos += count[b];
+    }
+    return;
+  }
+}
+
+/*
+ * sort the rows of the block by the normalized keys, the row index is appended to the key of each row to reorder the
+ * block after the keys are sorted.
+ */
+static int32_t sortBlockByNormKeys(SSDataBlock* pBlock, SArray* pSortInfo, int32_t keyLen) {
+  int32_t rows = pBlock->info.rows;
+  if (rows <= 1) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t  width = keyLen + sizeof(int32_t);
+  char*    pEntries = taosMemoryMalloc((int64_t)rows * width);
+  char*    pBuf = taosMemoryMalloc((int64_t)rows * width);
+  int32_t* index = taosMemoryMalloc(rows * sizeof(int32_t));
+  if (pEntries == NULL || pBuf == NULL || index == NULL) {
+    taosMemoryFree(pEntries);
+    taosMemoryFree(pBuf);
+    taosMemoryFree(index);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  sortEncodeNormKeys(pSortInfo, pBlock, rows, pEntries, width);
+  for (int32_t i = 0; i < rows; ++i) {
+    memcpy(pEntries + (int64_t)i * width + keyLen, &i, sizeof(int32_t));
+  }
+
+  sortRadixSortNormKeys(pEntries, pBuf, rows, width, keyLen, 0);
+
+  for (int32_t i = 0; i < rows; ++i) {
+    memcpy(&index[i], pEntries + (int64_t)i * width + keyLen, sizeof(int32_t));
+  }
+  taosMemoryFree(pEntries);
+  taosMemoryFree(pBuf);
+
+  int32_t code = blockDataReorder(pBlock, index);
+  taosMemoryFree(index);
+  return code;
+}
+
+static int32_t sortBlock(SSortHandle* pHandle, SSDataBlock* pBlock, SArray* pOrderInfo) {
+  if (pHandle->cmpParam.normKeyLen > 0) {
+    return sortBlockByNormKeys(pBlock, pOrderInfo, pHandle->cmpParam.normKeyLen);
+  }
+  return blockDataSort(pBlock, pOrderInfo);
+}
+
+/*
+ * The keys are normalized only for the sort of a single source with the default comparator, and only if all order
+ * columns can be encoded. The sources of a multi-source merge are not guaranteed to share one schema.
+ */
+static void sortInitNormKey(SSortHandle* pHandle, const SSDataBlock* pBlock) {
+  if (pHandle->normKeyInited || pBlock == NULL) {
+    return;
+  }
+
+  pHandle->normKeyInited = true;
+  if (pHandle->type != SORT_SINGLESOURCE_SORT || pHandle->comparFn != msortComparFn) {
+    return;
+  }
+
+  pHandle->cmpParam.normKeyLen = sortGetNormKeyLen(pHandle->pSortInfo, pBlock);
+  qDebug("%s normalized sort key length:%d", pHandle->idStr, pHandle->cmpParam.normKeyLen);
+}
+
+static int32_t sortSourceEncodeKeys(const SMsortComparParam* pParam, SSortSource* pSource) {
+  if (pParam->normKeyLen == 0 || pSource->src.pBlock == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t rows = pSource->src.pBlock->info.rows;
+  char*   p = taosMemoryRealloc(pSource->pKeys, (int64_t)TMAX(rows, 1) * pParam->normKeyLen);
+  if (p == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pSource->pKeys = p;
+  sortEncodeNormKeys(pParam->orderInfo, pSource->src.pBlock, rows, p, pParam->normKeyLen);
+  return TSDB_CODE_SUCCESS;
+}
+
 // | offset[0] | offset[1] |....| nullbitmap | data |...|
 static void* createTuple(uint32_t columnNum, uint32_t tupleLen) {
   uint32_t totalLen = sizeof(uint32_t) * columnNum + BitmapLen(columnNum) + tupleLen;
@@ -199,6 +618,8 @@ SSortHandle* tsortCreateSortHandle(SArray* pSortInfo, int32_t type, int32_t page
   }
 
   pSortHandle->mergeLimit = -1;
+  pSortHandle->numOfThreads = sortWorkersReady ? sortWorkers.numOfThreads : 1;
+  taosThreadMutexInit(&pSortHandle->bufLock, NULL);
 
   pSortHandle->pOrderedSource = taosArrayInit(4, POINTER_BYTES);
   pSortHandle->cmpParam.orderInfo = pSortInfo;
@@ -227,6 +648,7 @@ static int32_t sortComparCleanup(SMsortComparParam* cmpParam) {
     if (pSource->pageIdList) {
       taosArrayDestroy(pSource->pageIdList);
     }
+    taosMemoryFreeClear(pSource->pKeys);
     taosMemoryFreeClear(pSource);
     cmpParam->pSources[i] = NULL;
   }
@@ -262,6 +684,7 @@ void tsortClearOrderdSource(SArray* pOrderedSource, int64_t *fetchUs, int64_t *f
       (*pSource)->src.pBlock = NULL;
     }
 
+    taosMemoryFreeClear((*pSource)->pKeys);
     taosMemoryFreeClear(*pSource);
   }
 
@@ -287,6 +710,7 @@ void tsortDestroySortHandle(SSortHandle* pSortHandle) {
   qDebug("all source fetch time: %" PRId64 "us num:%" PRId64 " %s", fetchUs, fetchNum, pSortHandle->idStr);
   
   taosArrayDestroy(pSortHandle->pOrderedSource);
+  taosThreadMutexDestroy(&pSortHandle->bufLock);
   taosMemoryFreeClear(pSortHandle);
 }
 
@@ -319,6 +743,14 @@ static int32_t doAddNewExternalMemSource(SDiskbasedBuf* pBuf, SArray* pAllSource
   return blockDataEnsureCapacity(pSource->src.pBlock, numOfRows);
 }
 
+// spilled pages are compressed, written behind and prefetched by the io thread of the paged buffer
+static int32_t sortInitBufIo(SSortHandle* pHandle) {
+  setBufPageCompressOnDisk(pHandle->pBuf, true);
+
+  int64_t maxInflight = TMAX((int64_t)pHandle->pageSize * 2, (int64_t)pHandle->numOfPages * pHandle->pageSize / 4);
+  return dBufSetAsyncIo(pHandle->pBuf, maxInflight);
+}
+
 static int32_t doAddToBuf(SSDataBlock* pDataBlock, SSortHandle* pHandle) {
   int32_t start = 0;
 
@@ -335,6 +767,11 @@ static int32_t doAddToBuf(SSDataBlock* pDataBlock, SSortHandle* pHandle) {
     if (code != TSDB_CODE_SUCCESS) {
       return code;
     }
+
+    code = sortInitBufIo(pHandle);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
   }
 
   SArray* pPageIdList = taosArrayInit(4, sizeof(int32_t));
@@ -375,13 +812,21 @@ static int32_t doAddToBuf(SSDataBlock* pDataBlock, SSortHandle* pHandle) {
   return doAddNewExternalMemSource(pHandle->pBuf, pHandle->pOrderedSource, pBlock, &pHandle->sourceId, pPageIdList);
 }
 
-static void setCurrentSourceDone(SSortSource* pSource, SSortHandle* pHandle) {
+static void setCurrentSourceDone(SSortSource* pSource, int32_t* numOfCompleted) {
   pSource->src.rowIndex = -1;
-  ++pHandle->numOfCompletedSources;
+  ++(*numOfCompleted);
+}
+
+// the pages of a sorted run are consumed in order, read the next one while the current one is merged
+static void sortPrefetchNextPage(SSortHandle* pHandle, SSortSource* pSource) {
+  int32_t next = pSource->pageIndex + 1;
+  if (next < taosArrayGetSize(pSource->pageIdList)) {
+    dBufPrefetchPage(pHandle->pBuf, *(int32_t*)taosArrayGet(pSource->pageIdList, next));
+  }
 }
 
 static int32_t sortComparInit(SMsortComparParam* pParam, SArray* pSources, int32_t startIndex, int32_t endIndex,
-                              SSortHandle* pHandle) {
+                              SSortHandle* pHandle, int32_t* numOfCompleted) {
   pParam->pSources = taosArrayGet(pSources, startIndex);
   pParam->numOfSources = (endIndex - startIndex + 1);
 
@@ -402,6 +847,12 @@ static int32_t sortComparInit(SMsortComparParam* pParam, SArray* pSources, int32
       terrno = code;
       return code;
     }
+
+    code = sortInitBufIo(pHandle);
+    if (code != TSDB_CODE_SUCCESS) {
+      terrno = code;
+      return code;
+    }
   }
 
   if (pHandle->type == SORT_SINGLESOURCE_SORT) {
@@ -410,24 +861,30 @@ static int32_t sortComparInit(SMsortComparParam* pParam, SArray* pSources, int32
 
       // set current source is done
       if (taosArrayGetSize(pSource->pageIdList) == 0) {
-        setCurrentSourceDone(pSource, pHandle);
+        setCurrentSourceDone(pSource, numOfCompleted);
         continue;
       }
 
       int32_t* pPgId = taosArrayGet(pSource->pageIdList, pSource->pageIndex);
 
+      sortLockBuf(pHandle);
       void* pPage = getBufPage(pHandle->pBuf, *pPgId);
       if (NULL == pPage) {
+        sortUnlockBuf(pHandle);
         return terrno;
       }
       
       code = blockDataFromBuf(pSource->src.pBlock, pPage);
+      releaseBufPage(pHandle->pBuf, pPage);
+      sortPrefetchNextPage(pHandle, pSource);
+      sortUnlockBuf(pHandle);
+      if (code == TSDB_CODE_SUCCESS) {
+        code = sortSourceEncodeKeys(pParam, pSource);
+      }
       if (code != TSDB_CODE_SUCCESS) {
         terrno = code;
         return code;
       }
-
-      releaseBufPage(pHandle->pBuf, pPage);
     }
   } else {
     qDebug("start init for the multiway merge sort, %s", pHandle->idStr);
@@ -439,7 +896,7 @@ static int32_t sortComparInit(SMsortComparParam* pParam, SArray* pSources, int32
 
       // set current source is done
       if (pSource->src.pBlock == NULL) {
-        setCurrentSourceDone(pSource, pHandle);
+        setCurrentSourceDone(pSource, numOfCompleted);
       }
     }
 
@@ -486,22 +943,30 @@ static int32_t adjustMergeTreeForNextTuple(SSortSource* pSource, SMultiwayMergeT
         pSource->src.rowIndex = -1;
         pSource->pageIndex = -1;
         pSource->src.pBlock = blockDataDestroy(pSource->src.pBlock);
+        taosMemoryFreeClear(pSource->pKeys);
       } else {
         if (pSource->pageIndex % 512 == 0) qDebug("begin source %p page %d", pSource, pSource->pageIndex);
 
         int32_t* pPgId = taosArrayGet(pSource->pageIdList, pSource->pageIndex);
 
+        sortLockBuf(pHandle);
         void*   pPage = getBufPage(pHandle->pBuf, *pPgId);
         if (pPage == NULL) {
+          sortUnlockBuf(pHandle);
           qError("failed to get buffer, code:%s", tstrerror(terrno));
           return terrno;
         }
 
         int32_t code = blockDataFromBuf(pSource->src.pBlock, pPage);
+        releaseBufPage(pHandle->pBuf, pPage);
+        sortPrefetchNextPage(pHandle, pSource);
+        sortUnlockBuf(pHandle);
+        if (code == TSDB_CODE_SUCCESS) {
+          code = sortSourceEncodeKeys((SMsortComparParam*)pTree->param, pSource);
+        }
         if (code != TSDB_CODE_SUCCESS) {
           return code;
         }
-        releaseBufPage(pHandle->pBuf, pPage);
       }
     } else {
       int64_t st = taosGetTimestampUs();      
@@ -536,31 +1001,31 @@ static int32_t adjustMergeTreeForNextTuple(SSortSource* pSource, SMultiwayMergeT
   return TSDB_CODE_SUCCESS;
 }
 
-static SSDataBlock* getSortedBlockDataInner(SSortHandle* pHandle, SMsortComparParam* cmpParam, int32_t capacity) {
-  blockDataCleanup(pHandle->pDataBlock);
+static SSDataBlock* getSortedBlockDataInner(SSortMergeTask* pTask) {
+  blockDataCleanup(pTask->pBlock);
 
   while (1) {
-    if (cmpParam->numOfSources == pHandle->numOfCompletedSources) {
+    if (pTask->cmpParam.numOfSources == pTask->numOfCompleted) {
       break;
     }
 
-    int32_t index = tMergeTreeGetChosenIndex(pHandle->pMergeTree);
+    int32_t index = tMergeTreeGetChosenIndex(pTask->pTree);
 
-    SSortSource* pSource = (*cmpParam).pSources[index];
-    appendOneRowToDataBlock(pHandle->pDataBlock, pSource->src.pBlock, &pSource->src.rowIndex);
+    SSortSource* pSource = pTask->cmpParam.pSources[index];
+    appendOneRowToDataBlock(pTask->pBlock, pSource->src.pBlock, &pSource->src.rowIndex);
 
-    int32_t code = adjustMergeTreeForNextTuple(pSource, pHandle->pMergeTree, pHandle, &pHandle->numOfCompletedSources);
+    int32_t code = adjustMergeTreeForNextTuple(pSource, pTask->pTree, pTask->pHandle, &pTask->numOfCompleted);
     if (code != TSDB_CODE_SUCCESS) {
-      terrno = code;
+      pTask->code = code;
       return NULL;
     }
 
-    if (pHandle->pDataBlock->info.rows >= capacity) {
-      return pHandle->pDataBlock;
+    if (pTask->pBlock->info.rows >= pTask->capacity) {
+      return pTask->pBlock;
     }
   }
 
-  return (pHandle->pDataBlock->info.rows > 0) ? pHandle->pDataBlock : NULL;
+  return (pTask->pBlock->info.rows > 0) ? pTask->pBlock : NULL;
 }
 
 int32_t msortComparFn(const void* pLeft, const void* pRight, void* param) {
@@ -592,6 +1057,13 @@ int32_t msortComparFn(const void* pLeft, const void* pRight, void* param) {
     }
   }
 
+  if (pParam->normKeyLen > 0) {
+    int32_t len = pParam->normKeyLen;
+    int32_t ret = memcmp(pLeftSource->pKeys + (int64_t)pLeftSource->src.rowIndex * len,
+                         pRightSource->pKeys + (int64_t)pRightSource->src.rowIndex * len, len);
+    return (ret == 0) ? 0 : ((ret < 0) ? -1 : 1);
+  }
+
   if (pParam->sortType == SORT_BLOCK_TS_MERGE) {
     SColumnInfoData* pLeftColInfoData = TARRAY_GET_ELEM(pLeftBlock->pDataBlock, pParam->tsSlotId);
     SColumnInfoData* pRightColInfoData = TARRAY_GET_ELEM(pRightBlock->pDataBlock, pParam->tsSlotId);
@@ -654,6 +1126,75 @@ int32_t msortComparFn(const void* pLeft, const void* pRight, void* param) {
   return 0;
 }
 
+static void* doMergeSortGroup(void* param) {
+  SSortMergeTask* pTask = param;
+  SSortHandle*    pHandle = pTask->pHandle;
+
+  pTask->code = sortComparInit(&pTask->cmpParam, pHandle->pOrderedSource, pTask->start, pTask->end, pHandle,
+                               &pTask->numOfCompleted);
+  if (pTask->code != TSDB_CODE_SUCCESS) {
+    return NULL;
+  }
+
+  pTask->code = tMergeTreeCreate(&pTask->pTree, pTask->cmpParam.numOfSources, &pTask->cmpParam, pHandle->comparFn);
+  if (pTask->code != TSDB_CODE_SUCCESS) {
+    return NULL;
+  }
+
+  int64_t nMergedRows = 0;
+  while (1) {
+    if (tsortIsClosed(pHandle)) {
+      pTask->code = TSDB_CODE_TSC_QUERY_CANCELLED;
+      break;
+    }
+
+    SSDataBlock* pDataBlock = getSortedBlockDataInner(pTask);
+    if (pDataBlock == NULL) {
+      break;
+    }
+
+    sortLockBuf(pHandle);
+    int32_t pageId = -1;
+    void*   pPage = getNewBufPage(pHandle->pBuf, &pageId);
+    if (pPage == NULL) {
+      pTask->code = terrno;
+      sortUnlockBuf(pHandle);
+      break;
+    }
+
+    if (taosArrayPush(pTask->pPageIdList, &pageId) == NULL) {
+      pTask->code = TSDB_CODE_OUT_OF_MEMORY;
+      releaseBufPage(pHandle->pBuf, pPage);
+      sortUnlockBuf(pHandle);
+      break;
+    }
+
+    int32_t size =
+        blockDataGetSize(pDataBlock) + sizeof(int32_t) + taosArrayGetSize(pDataBlock->pDataBlock) * sizeof(int32_t);
+    ASSERT(size <= getBufPageSize(pHandle->pBuf));
+
+    blockDataToBuf(pPage, pDataBlock);
+
+    setBufPageDirty(pPage, true);
+    releaseBufPage(pHandle->pBuf, pPage);
+    sortUnlockBuf(pHandle);
+    nMergedRows += pDataBlock->info.rows;
+
+    blockDataCleanup(pDataBlock);
+    if ((pHandle->mergeLimit != -1) && (nMergedRows >= pHandle->mergeLimit)) {
+      break;
+    }
+  }
+
+  return NULL;
+}
+
+static void startMergeSortGroup(SSortMergeTask* pTask) {
+  startSortWorkerTask(&pTask->worker, doMergeSortGroup, pTask, pTask->pHandle->idStr);
+}
+
+static void waitMergeSortGroup(SSortMergeTask* pTask) { waitSortWorkerTask(&pTask->worker); }
+
 static int32_t doInternalMergeSort(SSortHandle* pHandle) {
   size_t numOfSources = taosArrayGetSize(pHandle->pOrderedSource);
   if (numOfSources == 0) {
@@ -685,88 +1226,89 @@ static int32_t doInternalMergeSort(SSortHandle* pHandle) {
   size_t numOfSorted = taosArrayGetSize(pHandle->pOrderedSource);
   for (int32_t t = 0; t < sortPass; ++t) {
     int64_t st = taosGetTimestampUs();
-
-    SArray* pResList = taosArrayInit(4, POINTER_BYTES);
+    int32_t code = TSDB_CODE_SUCCESS;
 
     int32_t numOfInputSources = pHandle->numOfPages;
     int32_t sortGroup = (numOfSorted + numOfInputSources - 1) / numOfInputSources;
 
+    // The groups of one pass merge disjoint sources, so they run concurrently once all the sources are spilled pages.
+    // The sources of a multi-source merge are fetched from the downstream operators, on the query thread only.
+    int32_t numOfThreads = 1;
+    if (pHandle->type == SORT_SINGLESOURCE_SORT) {
+      numOfThreads = TMIN(pHandle->numOfThreads, sortGroup);
+    }
+
+    SSortMergeTask* pTasks = taosMemoryCalloc(sortGroup, sizeof(SSortMergeTask));
+    if (pTasks == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
     // Only *numOfInputSources* can be loaded into buffer to perform the external sort.
     for (int32_t i = 0; i < sortGroup; ++i) {
-      qDebug("internal merge sort pass %d group %d. num input sources %d ", t, i, numOfInputSources);
-      pHandle->sourceId += 1;
-
-      int32_t end = (i + 1) * numOfInputSources - 1;
-      if (end > numOfSorted - 1) {
-        end = numOfSorted - 1;
+      SSortMergeTask* pTask = &pTasks[i];
+      pTask->pHandle = pHandle;
+      pTask->cmpParam = pHandle->cmpParam;
+      pTask->cmpParam.pSources = NULL;
+      pTask->cmpParam.numOfSources = 0;
+      pTask->start = i * numOfInputSources;
+      pTask->end = TMIN((i + 1) * numOfInputSources, numOfSorted) - 1;
+      pTask->capacity = numOfRows;
+      pTask->pBlock = createOneDataBlock(pHandle->pDataBlock, false);
+      pTask->pPageIdList = taosArrayInit(4, sizeof(int32_t));
+      if (pTask->pBlock == NULL || pTask->pPageIdList == NULL ||
+          blockDataEnsureCapacity(pTask->pBlock, numOfRows) != TSDB_CODE_SUCCESS) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
       }
+    }
 
-      pHandle->cmpParam.numOfSources = end - i * numOfInputSources + 1;
-
-      int32_t code = sortComparInit(&pHandle->cmpParam, pHandle->pOrderedSource, i * numOfInputSources, end, pHandle);
-      if (code != TSDB_CODE_SUCCESS) {
-        taosArrayDestroy(pResList);
-        return code;
+    if (code == TSDB_CODE_SUCCESS && numOfThreads > 1) {
+      qDebug("%s internal merge sort pass %d, %d groups, %d in flight", pHandle->idStr, t, sortGroup, numOfThreads);
+      for (int32_t i = 0; i < sortGroup; ++i) {
+        if (i >= numOfThreads) {
+          waitMergeSortGroup(&pTasks[i - numOfThreads]);
+        }
+        startMergeSortGroup(&pTasks[i]);
       }
-
-      code =
-          tMergeTreeCreate(&pHandle->pMergeTree, pHandle->cmpParam.numOfSources, &pHandle->cmpParam, pHandle->comparFn);
-      if (code != TSDB_CODE_SUCCESS) {
-        taosArrayDestroy(pResList);
-        return code;
+      for (int32_t i = 0; i < sortGroup; ++i) {
+        waitMergeSortGroup(&pTasks[i]);
       }
-
-      int nMergedRows = 0;
-
-      SArray* pPageIdList = taosArrayInit(4, sizeof(int32_t));
-      while (1) {
-        if (tsortIsClosed(pHandle)) {
-          code = terrno = TSDB_CODE_TSC_QUERY_CANCELLED;
-          return code;
-        }
-
-        SSDataBlock* pDataBlock = getSortedBlockDataInner(pHandle, &pHandle->cmpParam, numOfRows);
-        if (pDataBlock == NULL) {
+    } else if (code == TSDB_CODE_SUCCESS) {
+      for (int32_t i = 0; i < sortGroup; ++i) {
+        qDebug("internal merge sort pass %d group %d. num input sources %d ", t, i, numOfInputSources);
+        doMergeSortGroup(&pTasks[i]);
+        if (pTasks[i].code != TSDB_CODE_SUCCESS) {
           break;
         }
+      }
+    }
 
-        int32_t pageId = -1;
-        void*   pPage = getNewBufPage(pHandle->pBuf, &pageId);
-        if (pPage == NULL) {
-          taosArrayDestroy(pResList);
-          taosArrayDestroy(pPageIdList);
-          return terrno;
-        }
-
-        taosArrayPush(pPageIdList, &pageId);
-
-        int32_t size =
-            blockDataGetSize(pDataBlock) + sizeof(int32_t) + taosArrayGetSize(pDataBlock->pDataBlock) * sizeof(int32_t);
-        ASSERT(size <= getBufPageSize(pHandle->pBuf));
-
-        blockDataToBuf(pPage, pDataBlock);
-
-        setBufPageDirty(pPage, true);
-        releaseBufPage(pHandle->pBuf, pPage);
-        nMergedRows += pDataBlock->info.rows;
-
-        blockDataCleanup(pDataBlock);
-        if ((pHandle->mergeLimit != -1) && (nMergedRows >= pHandle->mergeLimit)) {
-          break;
-        }        
+    SArray* pResList = taosArrayInit(sortGroup, POINTER_BYTES);
+    for (int32_t i = 0; i < sortGroup; ++i) {
+      SSortMergeTask* pTask = &pTasks[i];
+      if (code == TSDB_CODE_SUCCESS) {
+        code = pTask->code;
       }
 
-      sortComparCleanup(&pHandle->cmpParam);
-      tMergeTreeDestroy(&pHandle->pMergeTree);
-      pHandle->numOfCompletedSources = 0;
+      sortComparCleanup(&pTask->cmpParam);
+      tMergeTreeDestroy(&pTask->pTree);
+      blockDataDestroy(pTask->pBlock);
 
-      SSDataBlock* pBlock = createOneDataBlock(pHandle->pDataBlock, false);
-      code = doAddNewExternalMemSource(pHandle->pBuf, pResList, pBlock, &pHandle->sourceId, pPageIdList);
-      if (code != TSDB_CODE_SUCCESS) {
-        taosArrayDestroy(pResList);
-        return code;
+      if (code == TSDB_CODE_SUCCESS) {
+        pHandle->sourceId += 1;
+        SSDataBlock* pBlock = createOneDataBlock(pHandle->pDataBlock, false);
+        code = doAddNewExternalMemSource(pHandle->pBuf, pResList, pBlock, &pHandle->sourceId, pTask->pPageIdList);
+      } else {
+        taosArrayDestroy(pTask->pPageIdList);
       }
     }
+    taosMemoryFree(pTasks);
+
+    if (code != TSDB_CODE_SUCCESS) {
+      tsortClearOrderdSource(pResList, NULL, NULL);
+      taosArrayDestroy(pResList);
+      terrno = code;
+      return code;
+    }
 
     tsortClearOrderdSource(pHandle->pOrderedSource, NULL, NULL);
     taosArrayAddAll(pHandle->pOrderedSource, pResList);
@@ -815,6 +1357,11 @@ static int32_t createPageBuf(SSortHandle* pHandle) {
     if (code != TSDB_CODE_SUCCESS) {
       return code;
     }
+
+    code = sortInitBufIo(pHandle);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
   }
   return 0;
 }
@@ -1078,9 +1625,96 @@ static int32_t createBlocksMergeSortInitialSources(SSortHandle* pHandle) {
   return TSDB_CODE_SUCCESS;
 }
 
+static void* doSortRun(void* param) {
+  SSortRunTask* pTask = param;
+
+  int64_t p = taosGetTimestampUs();
+  pTask->code = sortBlock(pTask->pHandle, pTask->pBlock, pTask->pOrderInfo);
+  if (pTask->code == TSDB_CODE_SUCCESS && pTask->pHandle->pqMaxRows > 0) {
+    blockDataKeepFirstNRows(pTask->pBlock, pTask->pHandle->pqMaxRows);
+  }
+  pTask->elapsed = taosGetTimestampUs() - p;
+  return NULL;
+}
+
+static void destroySortRunTask(SSortRunTask* pTask) {
+  waitSortWorkerTask(&pTask->worker);
+  blockDataDestroy(pTask->pBlock);
+  taosArrayDestroy(pTask->pOrderInfo);
+  taosMemoryFree(pTask);
+}
+
+/*
+ * Wait for the oldest run in flight and flush it into the page buffer. Runs are flushed in the order they are
+ * generated, the page buffer is only touched by the query thread.
+ */
+static int32_t finishSortRun(SSortHandle* pHandle, SArray* pRuns) {
+  SSortRunTask* pTask = taosArrayGetP(pRuns, 0);
+  taosArrayRemove(pRuns, 0);
+
+  waitSortWorkerTask(&pTask->worker);
+
+  pHandle->sortElapsed += pTask->elapsed;
+
+  int32_t code = pTask->code;
+  if (code == TSDB_CODE_SUCCESS) {
+    code = doAddToBuf(pTask->pBlock, pHandle);
+  }
+
+  destroySortRunTask(pTask);
+  return code;
+}
+
+static void clearSortRuns(SArray* pRuns) {
+  for (int32_t i = 0; i < taosArrayGetSize(pRuns); ++i) {
+    destroySortRunTask(taosArrayGetP(pRuns, i));
+  }
+  taosArrayClear(pRuns);
+}
+
+/*
+ * Hand the accumulated rows over to the sort workers, at most numOfThreads runs are in flight, which bounds the memory
+ * used by the run generation to numOfThreads sort buffers.
+ */
+static int32_t submitSortRun(SSortHandle* pHandle, SArray* pRuns) {
+  if (taosArrayGetSize(pRuns) >= pHandle->numOfThreads) {
+    int32_t code = finishSortRun(pHandle, pRuns);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  SSortRunTask* pTask = taosMemoryCalloc(1, sizeof(SSortRunTask));
+  if (pTask == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pTask->pHandle = pHandle;
+  pTask->pOrderInfo = taosArrayDup(pHandle->pSortInfo, NULL);
+  pTask->pBlock = pHandle->pDataBlock;
+  pHandle->pDataBlock = createOneDataBlock(pTask->pBlock, false);
+  if (pTask->pOrderInfo == NULL || pHandle->pDataBlock == NULL) {
+    if (pHandle->pDataBlock == NULL) {
+      pHandle->pDataBlock = pTask->pBlock;
+      pTask->pBlock = NULL;
+    }
+    destroySortRunTask(pTask);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  if (taosArrayPush(pRuns, &pTask) == NULL) {
+    destroySortRunTask(pTask);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  startSortWorkerTask(&pTask->worker, doSortRun, pTask, pHandle->idStr);
+  return TSDB_CODE_SUCCESS;
+}
+
 static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
   int32_t code = 0;
   size_t  sortBufSize = pHandle->numOfPages * pHandle->pageSize;
+  SArray* pRuns = NULL;
 
   SSortSource** pSource = taosArrayGet(pHandle->pOrderedSource, 0);
   SSortSource*  source = *pSource;
@@ -1088,6 +1722,14 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
 
   tsortClearOrderdSource(pHandle->pOrderedSource, NULL, NULL);
 
+  if (pHandle->numOfThreads > 1) {
+    pRuns = taosArrayInit(pHandle->numOfThreads, POINTER_BYTES);
+    if (pRuns == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _end;
+    }
+  }
+
   while (1) {
     SSDataBlock* pBlock = pHandle->fetchfp(source->param);
     if (pBlock == NULL) {
@@ -1096,12 +1738,17 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
 
     if (pHandle->pDataBlock == NULL) {
       uint32_t numOfCols = taosArrayGetSize(pBlock->pDataBlock);
-      pHandle->pageSize = getProperSortPageSize(blockDataGetRowSize(pBlock), numOfCols);
+      if (pHandle->pageSize <= 0) {
+        pHandle->pageSize = getProperSortPageSize(blockDataGetRowSize(pBlock), numOfCols);
+      }
 
       // todo, number of pages are set according to the total available sort buffer
-      pHandle->numOfPages = 1024;
+      if (pHandle->numOfPages <= 0) {
+        pHandle->numOfPages = 1024;
+      }
       sortBufSize = pHandle->numOfPages * pHandle->pageSize;
       pHandle->pDataBlock = createOneDataBlock(pBlock, false);
+      sortInitNormKey(pHandle, pHandle->pDataBlock);
     }
 
     if (pHandle->beforeFp != NULL) {
@@ -1110,33 +1757,24 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
 
     code = blockDataMerge(pHandle->pDataBlock, pBlock);
     if (code != TSDB_CODE_SUCCESS) {
-      if (source->param && !source->onlyRef) {
-        taosMemoryFree(source->param);
-      }
-      if (!source->onlyRef && source->src.pBlock) {
-        blockDataDestroy(source->src.pBlock);
-        source->src.pBlock = NULL;
-      }
-      taosMemoryFree(source);
-      return code;
+      goto _end;
     }
 
     size_t size = blockDataGetSize(pHandle->pDataBlock);
     if (size > sortBufSize) {
+      if (pRuns != NULL) {
+        code = submitSortRun(pHandle, pRuns);
+        if (code != TSDB_CODE_SUCCESS) {
+          goto _end;
+        }
+        continue;
+      }
+
       // Perform the in-memory sort and then flush data in the buffer into disk.
       int64_t p = taosGetTimestampUs();
-      code = blockDataSort(pHandle->pDataBlock, pHandle->pSortInfo);
+      code = sortBlock(pHandle, pHandle->pDataBlock, pHandle->pSortInfo);
       if (code != 0) {
-        if (source->param && !source->onlyRef) {
-          taosMemoryFree(source->param);
-        }
-        if (!source->onlyRef && source->src.pBlock) {
-          blockDataDestroy(source->src.pBlock);
-          source->src.pBlock = NULL;
-        }
-
-        taosMemoryFree(source);
-        return code;
+        goto _end;
       }
 
       int64_t el = taosGetTimestampUs() - p;
@@ -1144,16 +1782,26 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
       if (pHandle->pqMaxRows > 0) blockDataKeepFirstNRows(pHandle->pDataBlock, pHandle->pqMaxRows);
       code = doAddToBuf(pHandle->pDataBlock, pHandle);
       if (code != TSDB_CODE_SUCCESS) {
-        return code;
+        goto _end;
       }
     }
   }
 
-  if (source->param && !source->onlyRef) {
-    taosMemoryFree(source->param);
-  }
+  // The last run is sorted by the workers as well if some runs are still in flight, and all of them are flushed
+  // before the merge starts.
+  if (pRuns != NULL && taosArrayGetSize(pRuns) > 0) {
+    if (pHandle->pDataBlock->info.rows > 0) {
+      code = submitSortRun(pHandle, pRuns);
+    }
 
-  taosMemoryFree(source);
+    while (code == TSDB_CODE_SUCCESS && taosArrayGetSize(pRuns) > 0) {
+      code = finishSortRun(pHandle, pRuns);
+    }
+
+    if (code != TSDB_CODE_SUCCESS) {
+      goto _end;
+    }
+  }
 
   if (pHandle->pDataBlock != NULL && pHandle->pDataBlock->info.rows > 0) {
     size_t size = blockDataGetSize(pHandle->pDataBlock);
@@ -1161,9 +1809,9 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
     // Perform the in-memory sort and then flush data in the buffer into disk.
     int64_t p = taosGetTimestampUs();
 
-    code = blockDataSort(pHandle->pDataBlock, pHandle->pSortInfo);
+    code = sortBlock(pHandle, pHandle->pDataBlock, pHandle->pSortInfo);
     if (code != 0) {
-      return code;
+      goto _end;
     }
 
     if (pHandle->pqMaxRows > 0) blockDataKeepFirstNRows(pHandle->pDataBlock, pHandle->pqMaxRows);
@@ -1178,11 +1826,25 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
       pHandle->loops = 1;
       pHandle->tupleHandle.rowIndex = -1;
       pHandle->tupleHandle.pBlock = pHandle->pDataBlock;
-      return 0;
     } else {
       code = doAddToBuf(pHandle->pDataBlock, pHandle);
     }
   }
+
+_end:
+  if (pRuns != NULL) {
+    clearSortRuns(pRuns);
+    taosArrayDestroy(pRuns);
+  }
+
+  if (source->param && !source->onlyRef) {
+    taosMemoryFree(source->param);
+  }
+  if (!source->onlyRef && source->src.pBlock) {
+    blockDataDestroy(source->src.pBlock);
+    source->src.pBlock = NULL;
+  }
+  taosMemoryFree(source);
   return code;
 }
 
@@ -1219,7 +1881,8 @@ static bool tsortOpenForBufMergeSort(SSortHandle* pHandle) {
     return 0;
   }
 
-  code = sortComparInit(&pHandle->cmpParam, pHandle->pOrderedSource, 0, numOfSources - 1, pHandle);
+  code = sortComparInit(&pHandle->cmpParam, pHandle->pOrderedSource, 0, numOfSources - 1, pHandle,
+                        &pHandle->numOfCompletedSources);
   if (code != TSDB_CODE_SUCCESS) {
     return code;
   }
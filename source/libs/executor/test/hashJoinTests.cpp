@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#include "os.h"
+
+#include "executorInt.h"
+#include "operator.h"
+#include "plannodes.h"
+#include "querytask.h"
+#include "tdatablock.h"
+#include "tglobal.h"
+
+namespace {
+
+const int32_t hjTestBlockRows = 1000;
+const int64_t hjTestTsStart = 1648791213000;
+
+// The rows of a child, in blocks of hjTestBlockRows: ts (slot 0), key (slot 1, null every nullEvery rows) and the row
+// number (slot 2), which tells the rows apart in the join result.
+struct SHJoinTestInput {
+  int32_t      numOfRows;
+  int32_t      tsMod;
+  int32_t      keyMod;
+  int32_t      nullEvery;
+  int32_t      current;
+  SSDataBlock* pBlock;
+
+  int64_t ts(int64_t r) const { return hjTestTsStart + r % tsMod; }
+  bool    isNull(int64_t r) const { return r % nullEvery == 0; }
+  int32_t key(int64_t r) const { return (int32_t)((r * 7) % keyMod); }
+};
+
+SSDataBlock* hjTestGetNext(SOperatorInfo* pOperator) {
+  SHJoinTestInput* pInput = (SHJoinTestInput*)pOperator->info;
+  if (pInput->current >= pInput->numOfRows) {
+    return NULL;
+  }
+
+  SSDataBlock* pBlock = pInput->pBlock;
+  blockDataCleanup(pBlock);
+  blockDataEnsureCapacity(pBlock, hjTestBlockRows);
+
+  int32_t rows = std::min(hjTestBlockRows, pInput->numOfRows - pInput->current);
+  for (int32_t i = 0; i < rows; ++i) {
+    int64_t r = pInput->current + i;
+    int64_t ts = pInput->ts(r);
+    int32_t key = pInput->key(r);
+    colDataSetVal((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0), i, (const char*)&ts, false);
+    if (pInput->isNull(r)) {
+      colDataSetNULL((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1), i);
+    } else {
+      colDataSetVal((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1), i, (const char*)&key, false);
+    }
+    colDataSetVal((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 2), i, (const char*)&r, false);
+  }
+
+  pBlock->info.rows = rows;
+  pInput->current += rows;
+  return pBlock;
+}
+
+void hjTestDestroyInput(void* param) {
+  SHJoinTestInput* pInput = (SHJoinTestInput*)param;
+  blockDataDestroy(pInput->pBlock);
+  delete pInput;
+}
+
+SOperatorInfo* hjTestCreateInput(const SHJoinTestInput& input, int16_t blockId) {
+  SHJoinTestInput* pInput = new SHJoinTestInput(input);
+  pInput->current = 0;
+  pInput->pBlock = createDataBlock();
+
+  SColumnInfoData ts = createColumnInfoData(TSDB_DATA_TYPE_TIMESTAMP, sizeof(int64_t), 1);
+  SColumnInfoData key = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 2);
+  SColumnInfoData row = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 3);
+  blockDataAppendColInfo(pInput->pBlock, &ts);
+  blockDataAppendColInfo(pInput->pBlock, &key);
+  blockDataAppendColInfo(pInput->pBlock, &row);
+
+  SOperatorInfo* pOperator = (SOperatorInfo*)taosMemoryCalloc(1, sizeof(SOperatorInfo));
+  pOperator->info = pInput;
+  pOperator->resultDataBlockId = blockId;
+  pOperator->fpSet.getNextFn = hjTestGetNext;
+  pOperator->fpSet.closeFn = hjTestDestroyInput;
+  return pOperator;
+}
+
+SNode* hjTestMakeColumn(int16_t blockId, int16_t slotId, int8_t type) {
+  SColumnNode* pCol = (SColumnNode*)nodesMakeNode(QUERY_NODE_COLUMN);
+  pCol->dataBlockId = blockId;
+  pCol->slotId = slotId;
+  pCol->node.resType.type = type;
+  pCol->node.resType.bytes = tDataTypes[type].bytes;
+  return (SNode*)pCol;
+}
+
+SNode* hjTestMakeEqual(int8_t type, int16_t slotId) {
+  SOperatorNode* pOper = (SOperatorNode*)nodesMakeNode(QUERY_NODE_OPERATOR);
+  pOper->opType = OP_TYPE_EQUAL;
+  pOper->node.resType.type = TSDB_DATA_TYPE_BOOL;
+  pOper->node.resType.bytes = sizeof(bool);
+  pOper->pLeft = hjTestMakeColumn(1, slotId, type);
+  pOper->pRight = hjTestMakeColumn(2, slotId, type);
+  return (SNode*)pOper;
+}
+
+SDataBlockDescNode* hjTestMakeDesc(int16_t blockId, const std::vector<int8_t>& types) {
+  SDataBlockDescNode* pDesc = (SDataBlockDescNode*)nodesMakeNode(QUERY_NODE_DATABLOCK_DESC);
+  pDesc->dataBlockId = blockId;
+  for (size_t i = 0; i < types.size(); ++i) {
+    SSlotDescNode* pSlot = (SSlotDescNode*)nodesMakeNode(QUERY_NODE_SLOT_DESC);
+    pSlot->slotId = i;
+    pSlot->dataType.type = types[i];
+    pSlot->dataType.bytes = tDataTypes[types[i]].bytes;
+    pSlot->output = true;
+    nodesListMakeAppend(&pDesc->pSlots, (SNode*)pSlot);
+    pDesc->totalRowSize += pSlot->dataType.bytes;
+  }
+  pDesc->outputRowSize = pDesc->totalRowSize;
+  return pDesc;
+}
+
+// SELECT t1.r, t2.r FROM t1 JOIN t2 ON t1.ts = t2.ts AND t1.key = t2.key
+SHashJoinPhysiNode* hjTestMakeJoinNode() {
+  SHashJoinPhysiNode* pJoin = (SHashJoinPhysiNode*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN);
+  pJoin->joinType = JOIN_TYPE_INNER;
+  pJoin->pMergeCondition = hjTestMakeEqual(TSDB_DATA_TYPE_TIMESTAMP, 0);
+  pJoin->pColEqualOnConditions = hjTestMakeEqual(TSDB_DATA_TYPE_INT, 1);
+  pJoin->node.pOutputDataBlockDesc = hjTestMakeDesc(3, {TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_BIGINT});
+
+  for (int16_t blockId = 1; blockId <= 2; ++blockId) {
+    SPhysiNode* pChild = (SPhysiNode*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_PROJECT);
+    pChild->pOutputDataBlockDesc =
+        hjTestMakeDesc(blockId, {TSDB_DATA_TYPE_TIMESTAMP, TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_BIGINT});
+    nodesListMakeAppend(&pJoin->node.pChildren, (SNode*)pChild);
+
+    STargetNode* pTarget = (STargetNode*)nodesMakeNode(QUERY_NODE_TARGET);
+    pTarget->dataBlockId = 3;
+    pTarget->slotId = blockId - 1;
+    pTarget->pExpr = hjTestMakeColumn(blockId, 2, TSDB_DATA_TYPE_BIGINT);
+    nodesListMakeAppend(&pJoin->pTargets, (SNode*)pTarget);
+  }
+
+  return pJoin;
+}
+
+typedef std::vector<std::pair<int64_t, int64_t>> SHJoinTestRows;
+
+// the rows of the join, as the merge join produces them, only not in ts order
+SHJoinTestRows hjTestExpected(const SHJoinTestInput& left, const SHJoinTestInput& right) {
+  std::multimap<std::pair<int64_t, int32_t>, int64_t> rightRows;
+  for (int64_t r = 0; r < right.numOfRows; ++r) {
+    if (!right.isNull(r)) {
+      rightRows.insert({{right.ts(r), right.key(r)}, r});
+    }
+  }
+
+  SHJoinTestRows rows;
+  for (int64_t l = 0; l < left.numOfRows; ++l) {
+    if (left.isNull(l)) {
+      continue;
+    }
+    auto range = rightRows.equal_range({left.ts(l), left.key(l)});
+    for (auto it = range.first; it != range.second; ++it) {
+      rows.push_back({l, it->second});
+    }
+  }
+
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+
+class HashJoinTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    memThreshold = tsHashJoinMemThreshold;
+    strcpy(tsTempDir, "/tmp");
+    tsTempSpace.size.avail = INT64_MAX;
+    pTaskInfo = (SExecTaskInfo*)taosMemoryCalloc(1, sizeof(SExecTaskInfo));
+    pTaskInfo->id.str = taosStrdup("hashJoinTest");
+  }
+
+  void TearDown() override {
+    tsHashJoinMemThreshold = memThreshold;
+    taosMemoryFree(pTaskInfo->id.str);
+    taosMemoryFree(pTaskInfo);
+  }
+
+  void run(const SHJoinTestInput& left, const SHJoinTestInput& right, SHashJoinExecInfo* pExecInfo) {
+    SHashJoinPhysiNode* pJoin = hjTestMakeJoinNode();
+    SOperatorInfo*      pDownstream[2] = {hjTestCreateInput(left, 1), hjTestCreateInput(right, 2)};
+    SOperatorInfo*      pOperator = createHashJoinOperatorInfo(pDownstream, 2, pJoin, pTaskInfo);
+    ASSERT_NE(pOperator, nullptr);
+
+    SHJoinTestRows rows;
+    while (true) {
+      SSDataBlock* pBlock = pOperator->fpSet.getNextFn(pOperator);
+      if (pBlock == NULL) {
+        break;
+      }
+      ASSERT_GT(pBlock->info.rows, 0);
+
+      SColumnInfoData* pLeft = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0);
+      SColumnInfoData* pRight = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1);
+      for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+        ASSERT_FALSE(colDataIsNull_s(pLeft, i));
+        ASSERT_FALSE(colDataIsNull_s(pRight, i));
+        rows.push_back({*(int64_t*)colDataGetData(pLeft, i), *(int64_t*)colDataGetData(pRight, i)});
+      }
+    }
+
+    std::sort(rows.begin(), rows.end());
+    SHJoinTestRows expected = hjTestExpected(left, right);
+    ASSERT_EQ(rows.size(), expected.size());
+    ASSERT_TRUE(rows == expected);
+
+    void*    pExplain = NULL;
+    uint32_t len = 0;
+    ASSERT_EQ(pOperator->fpSet.getExplainFn(pOperator, &pExplain, &len), TSDB_CODE_SUCCESS);
+    ASSERT_EQ(len, sizeof(SHashJoinExecInfo));
+    *pExecInfo = *(SHashJoinExecInfo*)pExplain;
+    taosMemoryFree(pExplain);
+
+    destroyOperator(pOperator);
+    nodesDestroyNode((SNode*)pJoin);
+  }
+
+  int32_t        memThreshold;
+  SExecTaskInfo* pTaskInfo;
+};
+
+}  // namespace
+
+TEST_F(HashJoinTest, buildOnSmallerSide) {
+  SHJoinTestInput large = {.numOfRows = 20000, .tsMod = 50, .keyMod = 300, .nullEvery = 97};
+  SHJoinTestInput small = {.numOfRows = 3500, .tsMod = 50, .keyMod = 300, .nullEvery = 89};
+
+  SHashJoinExecInfo execInfo = {0};
+  run(large, small, &execInfo);
+  ASSERT_EQ(execInfo.buildSide, 1);
+  ASSERT_EQ(execInfo.spillPartitions, 0);
+
+  run(small, large, &execInfo);
+  ASSERT_EQ(execInfo.buildSide, 0);
+  ASSERT_EQ(execInfo.spillPartitions, 0);
+}
+
+TEST_F(HashJoinTest, emptyInput) {
+  SHJoinTestInput empty = {.numOfRows = 0, .tsMod = 50, .keyMod = 300, .nullEvery = 97};
+  SHJoinTestInput rows = {.numOfRows = 2500, .tsMod = 50, .keyMod = 300, .nullEvery = 97};
+
+  SHashJoinExecInfo execInfo = {0};
+  run(empty, rows, &execInfo);
+  run(rows, empty, &execInfo);
+}
+
+TEST_F(HashJoinTest, noMatch) {
+  SHJoinTestInput left = {.numOfRows = 3000, .tsMod = 50, .keyMod = 300, .nullEvery = 97};
+  SHJoinTestInput right = {.numOfRows = 3000, .tsMod = 7, .keyMod = 1, .nullEvery = 2};
+
+  // the keys of the right rows are 0, only the left rows of ts 0 to 6 and key 0 match
+  SHashJoinExecInfo execInfo = {0};
+  run(left, right, &execInfo);
+}
+
+TEST_F(HashJoinTest, spill) {
+  tsHashJoinMemThreshold = 1;
+
+  // both sides are well over the threshold, some partitions of the build side are spilled
+  SHJoinTestInput left = {.numOfRows = 60000, .tsMod = 1000, .keyMod = 40000, .nullEvery = 101};
+  SHJoinTestInput right = {.numOfRows = 80000, .tsMod = 1000, .keyMod = 40000, .nullEvery = 89};
+
+  SHashJoinExecInfo execInfo = {0};
+  run(left, right, &execInfo);
+  ASSERT_GT(execInfo.spillPartitions, 0);
+  ASSERT_GT(execInfo.buildRows, 0);
+}
+
+#pragma GCC diagnostic pop
@@ -15,6 +15,7 @@
 
 #include <gtest/gtest.h>
 #include <iostream>
+#include <vector>
 #include "executorInt.h"
 #include "tlinearhash.h"
 
@@ -70,4 +71,48 @@ TEST(testCase, linear_hash_Tests) {
   int64_t et2 = taosGetTimestampUs();
   printf("linear hash time:%.2f ms, buildHash:%.2f ms, hash:%.2f\n", (et1 - st) / 1000.0, (et - st) / 1000.0,
          (et2 - et1) / 1000.0);
-}
\ No newline at end of file
+}
+
+TEST(testCase, linear_hash_value_Tests) {
+  strcpy(tsTempDir, "/tmp/");
+  tsTempSpace.size.avail = INT64_MAX;
+
+  _hash_fn_t fn = taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT);
+  SLHashObj* pHashObj = tHashInit(64, 512, fn, 40);
+  ASSERT_NE(pHashObj, nullptr);
+
+  const int32_t num = 200000;
+  for (int32_t i = 0; i < num; ++i) {
+    int64_t v = i * 3LL;
+    ASSERT_EQ(tHashPut(pHashObj, &i, sizeof(i), &v, sizeof(v)), 0);
+  }
+  ASSERT_EQ(tHashGetSize(pHashObj), num);
+
+  // values must survive the bucket split
+  for (int32_t i = 0; i < num; ++i) {
+    char* v = tHashGet(pHashObj, &i, sizeof(i));
+    ASSERT_NE(v, nullptr);
+    ASSERT_EQ(*(int64_t*)v, i * 3LL);
+  }
+
+  int32_t k = num + 1;
+  ASSERT_EQ(tHashGet(pHashObj, &k, sizeof(k)), nullptr);
+
+  // every key once, with its value
+  std::vector<bool> seen(num, false);
+  SLHashIter        iter = {0};
+  char*             key = NULL;
+  size_t            keyLen = 0;
+  int32_t           n = 0;
+  for (char* v; (v = tHashIterate(pHashObj, &iter, &key, &keyLen)) != NULL; ++n) {
+    ASSERT_EQ(keyLen, sizeof(int32_t));
+    int32_t i = *(int32_t*)key;
+    ASSERT_TRUE(i >= 0 && i < num && !seen[i]);
+    ASSERT_EQ(*(int64_t*)v, i * 3LL);
+    seen[i] = true;
+  }
+  ASSERT_EQ(n, num);
+  ASSERT_EQ(tHashIterate(pHashObj, &iter, &key, &keyLen), nullptr);
+
+  tHashCleanup(pHashObj);
+}
@@ -193,6 +193,180 @@ int32_t docomp(const void* p1, const void* p2, void* param) {
 
   return 0;
 }
+
+typedef struct {
+  int64_t      total;
+  int64_t      cur;
+  int32_t      pageRows;
+  uint64_t     seed;
+  SSDataBlock* pBlock;
+} _benchInfo;
+
+SSDataBlock* getRandomBigintBlock(void* param) {
+  _benchInfo* pInfo = (_benchInfo*)param;
+  if (pInfo->cur >= pInfo->total) {
+    return NULL;
+  }
+
+  SSDataBlock* pBlock = pInfo->pBlock;
+  blockDataCleanup(pBlock);
+  blockDataEnsureCapacity(pBlock, pInfo->pageRows);
+
+  SColumnInfoData* pKeyCol = static_cast<SColumnInfoData*>(TARRAY_GET_ELEM(pBlock->pDataBlock, 0));
+  SColumnInfoData* pValCol = static_cast<SColumnInfoData*>(TARRAY_GET_ELEM(pBlock->pDataBlock, 1));
+
+  int32_t rows = 0;
+  for (; rows < pInfo->pageRows && pInfo->cur < pInfo->total; ++rows, ++pInfo->cur) {
+    pInfo->seed = pInfo->seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    int64_t key = (int64_t)(pInfo->seed >> 16);
+    int64_t val = pInfo->cur;
+    colDataSetVal(pKeyCol, rows, reinterpret_cast<const char*>(&key), false);
+    colDataSetVal(pValCol, rows, reinterpret_cast<const char*>(&val), false);
+  }
+
+  pBlock->info.rows = rows;
+  return pBlock;
+}
+
+SSDataBlock* getMultiColBlock(void* param) {
+  _benchInfo* pInfo = (_benchInfo*)param;
+  if (pInfo->cur >= pInfo->total) {
+    return NULL;
+  }
+
+  SSDataBlock* pBlock = pInfo->pBlock;
+  blockDataCleanup(pBlock);
+  blockDataEnsureCapacity(pBlock, pInfo->pageRows);
+
+  SColumnInfoData* pIntCol = static_cast<SColumnInfoData*>(TARRAY_GET_ELEM(pBlock->pDataBlock, 0));
+  SColumnInfoData* pStrCol = static_cast<SColumnInfoData*>(TARRAY_GET_ELEM(pBlock->pDataBlock, 1));
+  SColumnInfoData* pDblCol = static_cast<SColumnInfoData*>(TARRAY_GET_ELEM(pBlock->pDataBlock, 2));
+
+  int32_t rows = 0;
+  for (; rows < pInfo->pageRows && pInfo->cur < pInfo->total; ++rows, ++pInfo->cur) {
+    pInfo->seed = pInfo->seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    uint64_t r = pInfo->seed >> 16;
+
+    int32_t iv = (int32_t)(r % 64) - 32;
+    if (r % 7 == 0) {
+      colDataSetNULL(pIntCol, rows);
+    } else {
+      colDataSetVal(pIntCol, rows, reinterpret_cast<const char*>(&iv), false);
+    }
+
+    char    str[16] = {0};
+    int32_t len = (r >> 8) % 4;
+    for (int32_t i = 0; i < len; ++i) {
+      varDataVal(str)[i] = 'a' + ((r >> (12 + i * 2)) % 3);
+    }
+    varDataSetLen(str, len);
+    colDataSetVal(pStrCol, rows, str, false);
+
+    double dv = ((double)((r >> 20) % 2000) - 1000) / 8;
+    colDataSetVal(pDblCol, rows, reinterpret_cast<const char*>(&dv), false);
+  }
+
+  pBlock->info.rows = rows;
+  return pBlock;
+}
+
+typedef struct {
+  bool    intNull;
+  int32_t intVal;
+  char    strVal[16];
+  double  dblVal;
+} _multiColRow;
+
+void getMultiColRow(STupleHandle* pTupleHandle, _multiColRow* pRow) {
+  pRow->intNull = tsortIsNullVal(pTupleHandle, 0);
+  if (!pRow->intNull) {
+    pRow->intVal = *(int32_t*)tsortGetValue(pTupleHandle, 0);
+  }
+
+  char* pStr = (char*)tsortGetValue(pTupleHandle, 1);
+  memcpy(pRow->strVal, pStr, varDataTLen(pStr));
+  pRow->dblVal = *(double*)tsortGetValue(pTupleHandle, 2);
+}
+
+// order by c0 desc nulls last, c1 asc, c2 desc
+int32_t compareMultiColRow(const _multiColRow* pLeft, const _multiColRow* pRight) {
+  if (pLeft->intNull != pRight->intNull) {
+    return pLeft->intNull ? 1 : -1;
+  }
+  if (!pLeft->intNull && pLeft->intVal != pRight->intVal) {
+    return pLeft->intVal > pRight->intVal ? -1 : 1;
+  }
+
+  int32_t ret = compareLenPrefixedStr(pLeft->strVal, pRight->strVal);
+  if (ret != 0) {
+    return ret;
+  }
+
+  return compareDoubleValDesc(&pLeft->dblVal, &pRight->dblVal);
+}
+
+// sort numOfRows random keys on numOfThreads sort workers, returns the elapsed time in us
+int64_t runParallelSort(int64_t numOfRows, int32_t numOfThreads, int32_t pageSize, int32_t numOfPages) {
+  EXPECT_EQ(qInitSortWorkers(numOfThreads), TSDB_CODE_SUCCESS);
+
+  SBlockOrderInfo oi = {0};
+  oi.order = TSDB_ORDER_ASC;
+  oi.slotId = 0;
+  oi.nullFirst = true;
+  SArray* orderInfo = taosArrayInit(1, sizeof(SBlockOrderInfo));
+  taosArrayPush(orderInfo, &oi);
+
+  _benchInfo* pInfo = static_cast<_benchInfo*>(taosMemoryCalloc(1, sizeof(_benchInfo)));
+  pInfo->total = numOfRows;
+  pInfo->pageRows = 4096;
+  pInfo->seed = 7;
+  pInfo->pBlock = createDataBlock();
+  SColumnInfoData keyCol = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 1);
+  SColumnInfoData valCol = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 2);
+  blockDataAppendColInfo(pInfo->pBlock, &keyCol);
+  blockDataAppendColInfo(pInfo->pBlock, &valCol);
+  SSDataBlock* pBlock = pInfo->pBlock;
+
+  SSortHandle* phandle = tsortCreateSortHandle(orderInfo, SORT_SINGLESOURCE_SORT, pageSize, numOfPages, NULL,
+                                               "parallel_sort", 0, 0, 0);
+  tsortSetFetchRawDataFp(phandle, getRandomBigintBlock, NULL, NULL);
+
+  // the sort handle releases the source and its param once the sorted runs are generated
+  SSortSource* ps = static_cast<SSortSource*>(taosMemoryCalloc(1, sizeof(SSortSource)));
+  ps->param = pInfo;
+  ps->onlyRef = false;
+  tsortAddSource(phandle, ps);
+
+  int64_t st = taosGetTimestampUs();
+  int32_t code = tsortOpen(phandle);
+  EXPECT_EQ(code, TSDB_CODE_SUCCESS);
+
+  int64_t rows = 0;
+  int64_t sum = 0;
+  int64_t prev = INT64_MIN;
+  while (1) {
+    STupleHandle* pTupleHandle = tsortNextTuple(phandle);
+    if (pTupleHandle == NULL) {
+      break;
+    }
+
+    int64_t key = *(int64_t*)tsortGetValue(pTupleHandle, 0);
+    EXPECT_LE(prev, key);
+    prev = key;
+    sum += *(int64_t*)tsortGetValue(pTupleHandle, 1);
+    rows += 1;
+  }
+  int64_t el = taosGetTimestampUs() - st;
+
+  EXPECT_EQ(rows, numOfRows);
+  EXPECT_EQ(sum, numOfRows * (numOfRows - 1) / 2);
+
+  tsortDestroySortHandle(phandle);
+  blockDataDestroy(pBlock);
+  taosArrayDestroy(orderInfo);
+  qCleanupSortWorkers();
+  return el;
+}
 }  // namespace
 
 #if 0
@@ -393,4 +567,104 @@ TEST(testCase, ordered_merge_sort_Test) {
 
 #endif
 
+TEST(testCase, parallel_external_sort_Test) {
+  strcpy(tsTempDir, "/tmp/");
+  tsTempSpace.size.avail = INT64_MAX;
+
+  // a small sort buffer forces several intermediate merge passes
+  for (int32_t numOfThreads = 1; numOfThreads <= 4; ++numOfThreads) {
+    runParallelSort(50000, numOfThreads, 4096, 4);
+  }
+
+  // a larger buffer on more workers, and a single run
+  runParallelSort(50000, 8, 4096, 16);
+  runParallelSort(1000, 4, -1, -1);
+}
+
+// the rows sorted per second by the number of sort workers, run with --gtest_also_run_disabled_tests
+TEST(testCase, DISABLED_parallel_external_sort_bench) {
+  strcpy(tsTempDir, "/tmp/");
+  tsTempSpace.size.avail = INT64_MAX;
+
+  const int64_t numOfRows = 2000000;
+  for (int32_t numOfThreads = 1; numOfThreads <= 8; numOfThreads *= 2) {
+    int64_t el = runParallelSort(numOfRows, numOfThreads, -1, -1);
+    printf("sort %" PRId64 " rows, threads:%d, elapsed:%.2f ms, %.2f rows/s\n", numOfRows, numOfThreads, el / 1000.0,
+           numOfRows * 1000000.0 / el);
+  }
+}
+
+TEST(testCase, normalized_key_sort_Test) {
+  strcpy(tsTempDir, "/tmp/");
+  tsTempSpace.size.avail = INT64_MAX;
+
+  SBlockOrderInfo oi[3] = {0};
+  oi[0].order = TSDB_ORDER_DESC;
+  oi[0].slotId = 0;
+  oi[0].nullFirst = false;
+  oi[1].order = TSDB_ORDER_ASC;
+  oi[1].slotId = 1;
+  oi[1].nullFirst = true;
+  oi[2].order = TSDB_ORDER_DESC;
+  oi[2].slotId = 2;
+  oi[2].nullFirst = true;
+  SArray* orderInfo = taosArrayInit(3, sizeof(SBlockOrderInfo));
+  for (int32_t i = 0; i < 3; ++i) {
+    taosArrayPush(orderInfo, &oi[i]);
+  }
+
+  // in memory sort, and external sort with several merge passes
+  int32_t pageSize[2] = {-1, 4096};
+  int32_t numOfPages[2] = {-1, 4};
+  for (int32_t k = 0; k < 2; ++k) {
+    const int64_t numOfRows = 100000;
+    _benchInfo*   pInfo = static_cast<_benchInfo*>(taosMemoryCalloc(1, sizeof(_benchInfo)));
+    pInfo->total = numOfRows;
+    pInfo->pageRows = 1000;
+    pInfo->seed = 11;
+    pInfo->pBlock = createDataBlock();
+    SColumnInfoData intCol = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1);
+    SColumnInfoData strCol = createColumnInfoData(TSDB_DATA_TYPE_VARCHAR, 8 + VARSTR_HEADER_SIZE, 2);
+    SColumnInfoData dblCol = createColumnInfoData(TSDB_DATA_TYPE_DOUBLE, sizeof(double), 3);
+    blockDataAppendColInfo(pInfo->pBlock, &intCol);
+    blockDataAppendColInfo(pInfo->pBlock, &strCol);
+    blockDataAppendColInfo(pInfo->pBlock, &dblCol);
+    SSDataBlock* pBlock = pInfo->pBlock;
+
+    SSortHandle* phandle = tsortCreateSortHandle(orderInfo, SORT_SINGLESOURCE_SORT, pageSize[k], numOfPages[k], NULL,
+                                                 "norm_key_sort", 0, 0, 0);
+    tsortSetFetchRawDataFp(phandle, getMultiColBlock, NULL, NULL);
+
+    SSortSource* ps = static_cast<SSortSource*>(taosMemoryCalloc(1, sizeof(SSortSource)));
+    ps->param = pInfo;
+    ps->onlyRef = false;
+    tsortAddSource(phandle, ps);
+
+    ASSERT_EQ(tsortOpen(phandle), TSDB_CODE_SUCCESS);
+
+    _multiColRow prev = {0};
+    _multiColRow cur = {0};
+    int64_t      rows = 0;
+    while (1) {
+      STupleHandle* pTupleHandle = tsortNextTuple(phandle);
+      if (pTupleHandle == NULL) {
+        break;
+      }
+
+      getMultiColRow(pTupleHandle, &cur);
+      if (rows > 0) {
+        ASSERT_LE(compareMultiColRow(&prev, &cur), 0);
+      }
+      prev = cur;
+      rows += 1;
+    }
+    EXPECT_EQ(rows, numOfRows);
+
+    tsortDestroySortHandle(phandle);
+    blockDataDestroy(pBlock);
+  }
+
+  taosArrayDestroy(orderInfo);
+}
+
 #pragma GCC diagnostic pop
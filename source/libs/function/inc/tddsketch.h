@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_DDSKETCH_H
+#define TDENGINE_DDSKETCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "os.h"
+
+#define DDSKETCH_RELATIVE_ACCURACY 0.02
+#define DDSKETCH_NUM_OF_BINS       512
+
+// the bins of the values of one sign, bins[i] counts the values of key (offset + i)
+typedef struct SDDSketchStore {
+  int64_t count;
+  int32_t offset;
+  int64_t bins[DDSKETCH_NUM_OF_BINS];
+} SDDSketchStore;
+
+// The sketch has no pointers and a fixed size, so that it can be copied as it is into the result row, the partial
+// results exchanged between nodes and the stream state.
+typedef struct SDDSketch {
+  int64_t        count;
+  int64_t        zeroCount;
+  double         min;
+  double         max;
+  SDDSketchStore pos;
+  SDDSketchStore neg;
+} SDDSketch;
+
+#define DDSKETCH_SIZE sizeof(SDDSketch)
+
+SDDSketch* tDDSketchCreateFrom(void* pBuf);
+void       tDDSketchAdd(SDDSketch* pSketch, double val);
+void       tDDSketchMerge(SDDSketch* pSketch, const SDDSketch* pInput);
+double     tDDSketchQuantile(const SDDSketch* pSketch, double q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_DDSKETCH_H
@@ -59,6 +59,8 @@ typedef struct tMemBucket {
   int32_t            maxCapacity;  // maximum allowed number of elements that can be sort directly to get the result
   int32_t            bufPageSize;  // disk page size
   MinMaxEntry        range;        // value range
+  double             slotSpan;     // value span of each slot, a power of two
+  double             slotStart;    // value of the first slot in slot spans
   int32_t            times;        // count that has been checked for deciding the correct data value buckets.
   __compar_fn_t      comparFn;
   tMemBucketSlot    *pSlots;
@@ -20,6 +20,7 @@
 #include "querynodes.h"
 #include "tcompare.h"
 #include "tdatablock.h"
+#include "tddsketch.h"
 #include "tdigest.h"
 #include "tfunctionInt.h"
 #include "tglobal.h"
@@ -36,6 +37,8 @@
 #define HLL_BUCKETS     (1 << HLL_BUCKET_BITS)
 #define HLL_BUCKET_MASK (HLL_BUCKETS - 1)
 #define HLL_ALPHA_INF   0.721347520444481703680  // constant for 0.5/ln(2)
+#define HLL_ENTRY_BYTES 3                        // bytes of a set bucket in a sparse partial result
+#define HLL_SPARSE_FLAG 1                        // format of a sparse partial result, the byte after the counters
 
 // typedef struct SMinmaxResInfo {
 //   bool      assign;  // assign the first value or not
@@ -89,10 +92,6 @@ typedef struct SLeastSQRInfo {
 typedef struct SPercentileInfo {
   double      result;
   tMemBucket* pMemBucket;
-  int32_t     stage;
-  double      minval;
-  double      maxval;
-  int64_t     numOfElems;
 } SPercentileInfo;
 
 typedef struct SAPercentileInfo {
@@ -101,12 +100,14 @@ typedef struct SAPercentileInfo {
   int8_t          algo;
   SHistogramInfo* pHisto;
   TDigest*        pTDigest;
+  SDDSketch*      pDDSketch;
 } SAPercentileInfo;
 
 typedef enum {
   APERCT_ALGO_UNKNOWN = 0,
   APERCT_ALGO_DEFAULT,
   APERCT_ALGO_TDIGEST,
+  APERCT_ALGO_DDSKETCH,
 } EAPerctAlgoType;
 
 typedef struct SDiffInfo {
@@ -1615,11 +1616,8 @@ bool percentileFunctionSetup(SqlFunctionCtx* pCtx, SResultRowEntryInfo* pResultI
     return false;
   }
 
-  // in the first round, get the min-max value of all involved data
   SPercentileInfo* pInfo = GET_ROWCELL_INTERBUF(pResultInfo);
-  SET_DOUBLE_VAL(&pInfo->minval, DBL_MAX);
-  SET_DOUBLE_VAL(&pInfo->maxval, -DBL_MAX);
-  pInfo->numOfElems = 0;
+  pInfo->pMemBucket = NULL;
 
   return true;
 }
@@ -1633,87 +1631,76 @@ int32_t percentileFunction(SqlFunctionCtx* pCtx) {
 
   SColumnInfoData* pCol = pInput->pData[0];
   int32_t          type = pCol->info.type;
+  int32_t          start = pInput->startRowIndex;
 
   SPercentileInfo* pInfo = GET_ROWCELL_INTERBUF(pResInfo);
-  if (pCtx->scanFlag == MAIN_SCAN && pInfo->stage == 0) {
-    pInfo->stage += 1;
 
-    // all data are null, set it completed
-    if (pInfo->numOfElems == 0) {
-      pResInfo->complete = true;
-      return TSDB_CODE_SUCCESS;
-    } else {
-      pInfo->pMemBucket = tMemBucketCreate(pCol->info.bytes, type, pInfo->minval, pInfo->maxval);
-    }
-  }
+  // the buckets are sized by the value range of the first block with data, and widened when later values fall out of
+  // it, so that the data is scanned only once
+  if (pInfo->pMemBucket == NULL) {
+    double minval = DBL_MAX, maxval = -DBL_MAX;
 
-  // the first stage, only acquire the min/max value
-  if (pInfo->stage == 0) {
     if (pCtx->input.colDataSMAIsSet) {
-      double tmin = 0.0, tmax = 0.0;
-      if (IS_SIGNED_NUMERIC_TYPE(type)) {
-        tmin = (double)GET_INT64_VAL(&pAgg->min);
-        tmax = (double)GET_INT64_VAL(&pAgg->max);
-      } else if (IS_FLOAT_TYPE(type)) {
-        tmin = GET_DOUBLE_VAL(&pAgg->min);
-        tmax = GET_DOUBLE_VAL(&pAgg->max);
-      } else if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
-        tmin = (double)GET_UINT64_VAL(&pAgg->min);
-        tmax = (double)GET_UINT64_VAL(&pAgg->max);
-      }
-
-      if (GET_DOUBLE_VAL(&pInfo->minval) > tmin) {
-        SET_DOUBLE_VAL(&pInfo->minval, tmin);
-      }
-
-      if (GET_DOUBLE_VAL(&pInfo->maxval) < tmax) {
-        SET_DOUBLE_VAL(&pInfo->maxval, tmax);
+      if (pAgg->numOfNull < pInput->numOfRows) {
+        if (IS_SIGNED_NUMERIC_TYPE(type)) {
+          minval = (double)GET_INT64_VAL(&pAgg->min);
+          maxval = (double)GET_INT64_VAL(&pAgg->max);
+        } else if (IS_FLOAT_TYPE(type)) {
+          minval = GET_DOUBLE_VAL(&pAgg->min);
+          maxval = GET_DOUBLE_VAL(&pAgg->max);
+        } else if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+          minval = (double)GET_UINT64_VAL(&pAgg->min);
+          maxval = (double)GET_UINT64_VAL(&pAgg->max);
+        }
       }
-
-      pInfo->numOfElems += (pInput->numOfRows - pAgg->numOfNull);
     } else {
-      // check the valid data one by one
-      int32_t start = pInput->startRowIndex;
       for (int32_t i = start; i < pInput->numOfRows + start; ++i) {
         if (colDataIsNull_f(pCol->nullbitmap, i)) {
           continue;
         }
 
-        char* data = colDataGetData(pCol, i);
-
         double v = 0;
-        GET_TYPED_DATA(v, double, type, data);
-        if (v < GET_DOUBLE_VAL(&pInfo->minval)) {
-          SET_DOUBLE_VAL(&pInfo->minval, v);
+        GET_TYPED_DATA(v, double, type, colDataGetData(pCol, i));
+        if (isfinite(v)) {
+          minval = TMIN(minval, v);
+          maxval = TMAX(maxval, v);
         }
+      }
+    }
 
-        if (v > GET_DOUBLE_VAL(&pInfo->maxval)) {
-          SET_DOUBLE_VAL(&pInfo->maxval, v);
-        }
+    // all data are null
+    if (minval > maxval) {
+      return TSDB_CODE_SUCCESS;
+    }
 
-        pInfo->numOfElems += 1;
-      }
+    pInfo->pMemBucket = tMemBucketCreate(pCol->info.bytes, type, minval, maxval);
+    if (pInfo->pMemBucket == NULL) {
+      return terrno != 0 ? terrno : TSDB_CODE_OUT_OF_MEMORY;
     }
+  }
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (!pCol->hasNull) {
+    numOfElems = pInput->numOfRows;
+    code = tMemBucketPut(pInfo->pMemBucket, colDataGetData(pCol, start), numOfElems);
   } else {
-    // the second stage, calculate the true percentile value
-    int32_t start = pInput->startRowIndex;
-    for (int32_t i = start; i < pInput->numOfRows + start; ++i) {
+    for (int32_t i = start; i < pInput->numOfRows + start && code == TSDB_CODE_SUCCESS; ++i) {
       if (colDataIsNull_f(pCol->nullbitmap, i)) {
         continue;
       }
 
-      char* data = colDataGetData(pCol, i);
       numOfElems += 1;
-      int32_t code = tMemBucketPut(pInfo->pMemBucket, data, 1);
-      if (code != TSDB_CODE_SUCCESS) {
-        tMemBucketDestroy(pInfo->pMemBucket);
-        return code;
-      }
+      code = tMemBucketPut(pInfo->pMemBucket, colDataGetData(pCol, i), 1);
     }
+  }
 
-    SET_VAL(pResInfo, numOfElems, 1);
+  if (code != TSDB_CODE_SUCCESS) {
+    tMemBucketDestroy(pInfo->pMemBucket);
+    pInfo->pMemBucket = NULL;
+    return code;
   }
 
+  SET_VAL(pResInfo, numOfElems, 1);
   return TSDB_CODE_SUCCESS;
 }
 
@@ -1781,7 +1768,8 @@ bool getApercentileFuncEnv(SFunctionNode* pFunc, SFuncExecEnv* pEnv) {
   int32_t bytesHist =
       (int32_t)(sizeof(SAPercentileInfo) + sizeof(SHistogramInfo) + sizeof(SHistBin) * (MAX_HISTOGRAM_BIN + 1));
   int32_t bytesDigest = (int32_t)(sizeof(SAPercentileInfo) + TDIGEST_SIZE(COMPRESSION));
-  pEnv->calcMemSize = TMAX(bytesHist, bytesDigest);
+  int32_t bytesSketch = (int32_t)(sizeof(SAPercentileInfo) + DDSKETCH_SIZE);
+  pEnv->calcMemSize = TMAX(TMAX(bytesHist, bytesDigest), bytesSketch);
   return true;
 }
 
@@ -1789,7 +1777,8 @@ int32_t getApercentileMaxSize() {
   int32_t bytesHist =
       (int32_t)(sizeof(SAPercentileInfo) + sizeof(SHistogramInfo) + sizeof(SHistBin) * (MAX_HISTOGRAM_BIN + 1));
   int32_t bytesDigest = (int32_t)(sizeof(SAPercentileInfo) + TDIGEST_SIZE(COMPRESSION));
-  return TMAX(bytesHist, bytesDigest);
+  int32_t bytesSketch = (int32_t)(sizeof(SAPercentileInfo) + DDSKETCH_SIZE);
+  return TMAX(TMAX(bytesHist, bytesDigest), bytesSketch);
 }
 
 static int8_t getApercentileAlgo(char* algoStr) {
@@ -1798,6 +1787,8 @@ static int8_t getApercentileAlgo(char* algoStr) {
     algoType = APERCT_ALGO_DEFAULT;
   } else if (strcasecmp(algoStr, "t-digest") == 0) {
     algoType = APERCT_ALGO_TDIGEST;
+  } else if (strcasecmp(algoStr, "ddsketch") == 0) {
+    algoType = APERCT_ALGO_DDSKETCH;
   } else {
     algoType = APERCT_ALGO_UNKNOWN;
   }
@@ -1814,6 +1805,10 @@ static void buildTDigestInfo(SAPercentileInfo* pInfo) {
   pInfo->pTDigest = (TDigest*)((char*)pInfo + sizeof(SAPercentileInfo));
 }
 
+static void buildDDSketchInfo(SAPercentileInfo* pInfo) {
+  pInfo->pDDSketch = (SDDSketch*)((char*)pInfo + sizeof(SAPercentileInfo));
+}
+
 bool apercentileFunctionSetup(SqlFunctionCtx* pCtx, SResultRowEntryInfo* pResultInfo) {
   if (!functionSetup(pCtx, pResultInfo)) {
     return false;
@@ -1837,6 +1832,8 @@ bool apercentileFunctionSetup(SqlFunctionCtx* pCtx, SResultRowEntryInfo* pResult
   char* tmp = (char*)pInfo + sizeof(SAPercentileInfo);
   if (pInfo->algo == APERCT_ALGO_TDIGEST) {
     pInfo->pTDigest = tdigestNewFrom(tmp, COMPRESSION);
+  } else if (pInfo->algo == APERCT_ALGO_DDSKETCH) {
+    pInfo->pDDSketch = tDDSketchCreateFrom(tmp);
   } else {
     buildHistogramInfo(pInfo);
     pInfo->pHisto = tHistogramCreateFrom(tmp, MAX_HISTOGRAM_BIN);
@@ -1873,6 +1870,19 @@ int32_t apercentileFunction(SqlFunctionCtx* pCtx) {
       GET_TYPED_DATA(v, double, type, data);
       tdigestAdd(pInfo->pTDigest, v, w);
     }
+  } else if (pInfo->algo == APERCT_ALGO_DDSKETCH) {
+    buildDDSketchInfo(pInfo);
+    for (int32_t i = start; i < pInput->numOfRows + start; ++i) {
+      if (colDataIsNull_f(pCol->nullbitmap, i)) {
+        continue;
+      }
+      numOfElems += 1;
+      char* data = colDataGetData(pCol, i);
+
+      double v = 0;
+      GET_TYPED_DATA(v, double, type, data);
+      tDDSketchAdd(pInfo->pDDSketch, v);
+    }
   } else {
     // might be a race condition here that pHisto can be overwritten or setup function
     // has not been called, need to relink the buffer pHisto points to.
@@ -1905,6 +1915,9 @@ int32_t apercentileFunction(SqlFunctionCtx* pCtx) {
 }
 
 static void apercentileTransferInfo(SAPercentileInfo* pInput, SAPercentileInfo* pOutput) {
+  // the buffer of the merge function is set up for the default algorithm
+  bool hasDDSketch = (pOutput->algo == APERCT_ALGO_DDSKETCH);
+
   pOutput->percent = pInput->percent;
   pOutput->algo = pInput->algo;
   if (pOutput->algo == APERCT_ALGO_TDIGEST) {
@@ -1925,6 +1938,14 @@ static void apercentileTransferInfo(SAPercentileInfo* pInput, SAPercentileInfo*
     } else {
       tdigestMerge(pTDigest, pInput->pTDigest);
     }
+  } else if (pOutput->algo == APERCT_ALGO_DDSKETCH) {
+    buildDDSketchInfo(pInput);
+    buildDDSketchInfo(pOutput);
+    if (!hasDDSketch) {
+      memcpy(pOutput->pDDSketch, pInput->pDDSketch, DDSKETCH_SIZE);
+    } else {
+      tDDSketchMerge(pOutput->pDDSketch, pInput->pDDSketch);
+    }
   } else {
     buildHistogramInfo(pInput);
     if (pInput->pHisto->numOfElems <= 0) {
@@ -1978,7 +1999,7 @@ int32_t apercentileFunctionMerge(SqlFunctionCtx* pCtx) {
     apercentileTransferInfo(pInputInfo, pInfo);
   }
 
-  if (pInfo->algo != APERCT_ALGO_TDIGEST) {
+  if (pInfo->algo != APERCT_ALGO_TDIGEST && pInfo->algo != APERCT_ALGO_DDSKETCH) {
     buildHistogramInfo(pInfo);
     qDebug("%s after merge, total:%" PRId64 ", numOfEntry:%d, %p", __FUNCTION__, pInfo->pHisto->numOfElems,
            pInfo->pHisto->numOfEntries, pInfo->pHisto);
@@ -2001,6 +2022,13 @@ int32_t apercentileFinalize(SqlFunctionCtx* pCtx, SSDataBlock* pBlock) {
       // setNull(pCtx->pOutput, pCtx->outputType, pCtx->outputBytes);
       return TSDB_CODE_SUCCESS;
     }
+  } else if (pInfo->algo == APERCT_ALGO_DDSKETCH) {
+    buildDDSketchInfo(pInfo);
+    if (pInfo->pDDSketch->count > 0) {
+      pInfo->result = tDDSketchQuantile(pInfo->pDDSketch, pInfo->percent / 100);
+    } else {
+      return TSDB_CODE_SUCCESS;
+    }
   } else {
     buildHistogramInfo(pInfo);
     if (pInfo->pHisto->numOfElems > 0) {
@@ -4152,6 +4180,66 @@ static void hllTransferInfo(SHLLInfo* pInput, SHLLInfo* pOutput) {
   pOutput->totalCount += pInput->totalCount;
 }
 
+/*
+ * A group of few distinct values sets few buckets, then its partial result only lists the index and count of the set
+ * buckets, 3 bytes for each, after the counters and a flag byte. It is told apart from the whole info by a shorter
+ * length. The older versions read any partial result as the whole info, so it is only sent with hllSparsePartial.
+ */
+static int32_t hllEncodeInfo(SHLLInfo* pInfo, char* buf) {
+  int32_t headerBytes = (int32_t)offsetof(SHLLInfo, buckets);
+  char*   p = buf + headerBytes;
+
+  if (!tsHllSparsePartial) {
+    memcpy(buf, pInfo, sizeof(SHLLInfo));
+    return sizeof(SHLLInfo);
+  }
+
+  *(p++) = HLL_SPARSE_FLAG;
+  for (int32_t k = 0; k < HLL_BUCKETS; ++k) {
+    if (pInfo->buckets[k] == 0) {
+      continue;
+    }
+
+    if (p - buf + HLL_ENTRY_BYTES >= sizeof(SHLLInfo)) {
+      memcpy(buf, pInfo, sizeof(SHLLInfo));
+      return sizeof(SHLLInfo);
+    }
+
+    p[0] = (char)(k & 0xFF);
+    p[1] = (char)(k >> 8);
+    p[2] = (char)pInfo->buckets[k];
+    p += HLL_ENTRY_BYTES;
+  }
+
+  memcpy(buf, pInfo, headerBytes);
+  return (int32_t)(p - buf);
+}
+
+static int32_t hllTransferEncodedInfo(char* buf, int32_t len, SHLLInfo* pOutput) {
+  if (len == sizeof(SHLLInfo)) {
+    hllTransferInfo((SHLLInfo*)buf, pOutput);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t headerBytes = (int32_t)offsetof(SHLLInfo, buckets);
+  if (len <= headerBytes || buf[headerBytes] != HLL_SPARSE_FLAG || (len - headerBytes - 1) % HLL_ENTRY_BYTES != 0) {
+    return TSDB_CODE_INVALID_MSG;
+  }
+
+  for (char* p = buf + headerBytes + 1; p < buf + len; p += HLL_ENTRY_BYTES) {
+    int32_t index = (uint8_t)p[0] | ((int32_t)(uint8_t)p[1] << 8);
+    uint8_t count = (uint8_t)p[2];
+    if (index >= HLL_BUCKETS) {
+      return TSDB_CODE_INVALID_MSG;
+    }
+    if (pOutput->buckets[index] < count) {
+      pOutput->buckets[index] = count;
+    }
+  }
+  pOutput->totalCount += ((SHLLInfo*)buf)->totalCount;
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t hllFunctionMerge(SqlFunctionCtx* pCtx) {
   SInputColumnInfoData* pInput = &pCtx->input;
   SColumnInfoData*      pCol = pInput->pData[0];
@@ -4165,9 +4253,11 @@ int32_t hllFunctionMerge(SqlFunctionCtx* pCtx) {
   int32_t start = pInput->startRowIndex;
 
   for (int32_t i = start; i < start + pInput->numOfRows; ++i) {
-    char*     data = colDataGetData(pCol, i);
-    SHLLInfo* pInputInfo = (SHLLInfo*)varDataVal(data);
-    hllTransferInfo(pInputInfo, pInfo);
+    char*   data = colDataGetData(pCol, i);
+    int32_t code = hllTransferEncodedInfo(varDataVal(data), varDataLen(data), pInfo);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
   }
 
   if (pInfo->totalCount == 0 && !tsCountAlwaysReturnValue) {
@@ -4197,8 +4287,8 @@ int32_t hllPartialFinalize(SqlFunctionCtx* pCtx, SSDataBlock* pBlock) {
   int32_t              resultBytes = getHLLInfoSize();
   char*                res = taosMemoryCalloc(resultBytes + VARSTR_HEADER_SIZE, sizeof(char));
 
-  memcpy(varDataVal(res), pInfo, resultBytes);
-  varDataSetLen(res, resultBytes);
+  int32_t len = hllEncodeInfo(pInfo, varDataVal(res));
+  varDataSetLen(res, len);
 
   int32_t          slotId = pCtx->pExpr->base.resSchema.slotId;
   SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, slotId);
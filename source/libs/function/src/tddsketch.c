@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "os.h"
+
+#include "taosdef.h"
+#include "tddsketch.h"
+
+/**
+ *
+ * implement the quantile sketch based on the paper:
+ * Charles Masson, Jee E. Rim, Homin K. Lee. DDSketch: A Fast and Fully-Mergeable Quantile Sketch with Relative-Error
+ * Guarantees, Proceedings of the VLDB Endowment, Volume 12, 2019, pp.2195-2205
+ *
+ * A value x > 0 is counted in the bin of key ceil(log(x) / log(gamma)), and all values of a bin are estimated as
+ * 2 * gamma^key / (gamma + 1), which is within the relative accuracy of any of them. Each sign has a fixed window of
+ * bins, the lowest keys are collapsed into the first bin if the values span more keys than the window.
+ *
+ */
+#define DDSKETCH_GAMMA ((1 + DDSKETCH_RELATIVE_ACCURACY) / (1 - DDSKETCH_RELATIVE_ACCURACY))
+
+static FORCE_INLINE int32_t ddsketchKey(double val) { return (int32_t)ceil(log(val) / log(DDSKETCH_GAMMA)); }
+
+static FORCE_INLINE double ddsketchValue(int32_t key) { return 2 * pow(DDSKETCH_GAMMA, key) / (DDSKETCH_GAMMA + 1); }
+
+static void ddsketchStoreRange(const SDDSketchStore* pStore, int32_t* lo, int32_t* hi) {
+  int32_t i = 0;
+  int32_t j = DDSKETCH_NUM_OF_BINS - 1;
+  while (pStore->bins[i] == 0) {
+    ++i;
+  }
+  while (pStore->bins[j] == 0) {
+    --j;
+  }
+
+  *lo = pStore->offset + i;
+  *hi = pStore->offset + j;
+}
+
+static void ddsketchStoreMoveTo(SDDSketchStore* pStore, int32_t offset) {
+  int64_t bins[DDSKETCH_NUM_OF_BINS] = {0};
+  for (int32_t i = 0; i < DDSKETCH_NUM_OF_BINS; ++i) {
+    if (pStore->bins[i] != 0) {
+      bins[TMAX(pStore->offset + i - offset, 0)] += pStore->bins[i];
+    }
+  }
+
+  memcpy(pStore->bins, bins, sizeof(bins));
+  pStore->offset = offset;
+}
+
+// move the window to cover the keys [lo, hi] and the keys in the store, or the highest of them if they do not fit
+static void ddsketchStoreExtend(SDDSketchStore* pStore, int32_t lo, int32_t hi) {
+  if (lo >= pStore->offset && hi < pStore->offset + DDSKETCH_NUM_OF_BINS) {
+    return;
+  }
+
+  if (pStore->count == 0) {
+    // leave room on both sides of an empty store
+    pStore->offset = (hi - lo < DDSKETCH_NUM_OF_BINS) ? lo - (DDSKETCH_NUM_OF_BINS - 1 - (hi - lo)) / 2
+                                                      : hi - DDSKETCH_NUM_OF_BINS + 1;
+    return;
+  }
+
+  int32_t minKey = 0, maxKey = 0;
+  ddsketchStoreRange(pStore, &minKey, &maxKey);
+  lo = TMIN(lo, minKey);
+  hi = TMAX(hi, maxKey);
+
+  if (hi - lo < DDSKETCH_NUM_OF_BINS && lo < pStore->offset) {
+    ddsketchStoreMoveTo(pStore, lo);
+  } else {
+    ddsketchStoreMoveTo(pStore, hi - DDSKETCH_NUM_OF_BINS + 1);
+  }
+}
+
+static void ddsketchStoreAdd(SDDSketchStore* pStore, int32_t key) {
+  ddsketchStoreExtend(pStore, key, key);
+  pStore->bins[TMAX(key - pStore->offset, 0)] += 1;
+  pStore->count += 1;
+}
+
+static void ddsketchStoreMerge(SDDSketchStore* pStore, const SDDSketchStore* pInput) {
+  if (pInput->count == 0) {
+    return;
+  }
+
+  int32_t lo = 0, hi = 0;
+  ddsketchStoreRange(pInput, &lo, &hi);
+  ddsketchStoreExtend(pStore, lo, hi);
+
+  for (int32_t i = 0; i < DDSKETCH_NUM_OF_BINS; ++i) {
+    if (pInput->bins[i] != 0) {
+      pStore->bins[TMAX(pInput->offset + i - pStore->offset, 0)] += pInput->bins[i];
+    }
+  }
+  pStore->count += pInput->count;
+}
+
+SDDSketch* tDDSketchCreateFrom(void* pBuf) {
+  SDDSketch* pSketch = (SDDSketch*)pBuf;
+  memset(pSketch, 0, sizeof(SDDSketch));
+
+  pSketch->min = DBL_MAX;
+  pSketch->max = -DBL_MAX;
+  return pSketch;
+}
+
+void tDDSketchAdd(SDDSketch* pSketch, double val) {
+  // nan has no order, and no bin covers an infinite value
+  if (!isfinite(val)) {
+    return;
+  }
+
+  if (val >= DBL_MIN) {
+    ddsketchStoreAdd(&pSketch->pos, ddsketchKey(val));
+  } else if (val <= -DBL_MIN) {
+    ddsketchStoreAdd(&pSketch->neg, ddsketchKey(-val));
+  } else {
+    pSketch->zeroCount += 1;
+  }
+
+  pSketch->count += 1;
+  pSketch->min = TMIN(pSketch->min, val);
+  pSketch->max = TMAX(pSketch->max, val);
+}
+
+void tDDSketchMerge(SDDSketch* pSketch, const SDDSketch* pInput) {
+  if (pInput->count == 0) {
+    return;
+  }
+
+  ddsketchStoreMerge(&pSketch->pos, &pInput->pos);
+  ddsketchStoreMerge(&pSketch->neg, &pInput->neg);
+
+  pSketch->zeroCount += pInput->zeroCount;
+  pSketch->count += pInput->count;
+  pSketch->min = TMIN(pSketch->min, pInput->min);
+  pSketch->max = TMAX(pSketch->max, pInput->max);
+}
+
+double tDDSketchQuantile(const SDDSketch* pSketch, double q) {
+  if (pSketch->count == 0) {
+    return 0;
+  }
+
+  if (q <= 0) {
+    return pSketch->min;
+  } else if (q >= 1) {
+    return pSketch->max;
+  }
+
+  double  rank = q * (pSketch->count - 1);
+  double  val = 0;
+  int64_t num = 0;
+
+  if (rank < pSketch->neg.count) {
+    // the negative values are in the descending order of their keys
+    for (int32_t i = DDSKETCH_NUM_OF_BINS - 1; i >= 0; --i) {
+      num += pSketch->neg.bins[i];
+      if (num > rank) {
+        val = -ddsketchValue(pSketch->neg.offset + i);
+        break;
+      }
+    }
+  } else if (rank >= pSketch->neg.count + pSketch->zeroCount) {
+    num = pSketch->neg.count + pSketch->zeroCount;
+    for (int32_t i = 0; i < DDSKETCH_NUM_OF_BINS; ++i) {
+      num += pSketch->pos.bins[i];
+      if (num > rank) {
+        val = ddsketchValue(pSketch->pos.offset + i);
+        break;
+      }
+    }
+  }
+
+  return TMAX(pSketch->min, TMIN(pSketch->max, val));
+}
@@ -55,6 +55,11 @@ static SFilePage *loadDataFromFilePage(tMemBucket *pMemBucket, int32_t slotIdx)
 
     memcpy(buffer->data + offset, pg->data, (size_t)(pg->num * pMemBucket->bytes));
     offset += (int32_t)(pg->num * pMemBucket->bytes);
+
+    // the page the slot still writes to stays pinned, it has never been flushed
+    if (pg != pMemBucket->pSlots[slotIdx].info.data) {
+      releaseBufPage(pMemBucket->pBuffer, pg);
+    }
   }
 
   taosSort(buffer->data, pMemBucket->pSlots[slotIdx].info.size, pMemBucket->bytes, pMemBucket->comparFn);
@@ -131,102 +136,71 @@ int32_t findOnlyResult(tMemBucket *pMemBucket, double *result) {
   return TSDB_CODE_SUCCESS;
 }
 
-int32_t tBucketIntHash(tMemBucket *pBucket, const void *value) {
-  int64_t v = 0;
-  GET_TYPED_DATA(v, int64_t, pBucket->type, value);
-
-  int32_t index = -1;
+// The slots are spans of a power of two value, and the first one starts at a multiple of it, so that the slot of a value
+// in a span twice as large is the slot of the value in the span divided by two.
+int32_t tBucketHash(tMemBucket *pBucket, const void *value) {
+  double v = 0;
+  GET_TYPED_DATA(v, double, pBucket->type, value);
 
-  if (v > pBucket->range.i64MaxVal || v < pBucket->range.i64MinVal) {
-    return index;
+  double index = floor(v / pBucket->slotSpan) - pBucket->slotStart;
+  if (!(index >= 0 && index < pBucket->numOfSlots)) {
+    return -1;
   }
 
-  // divide the value range into 1024 buckets
-  uint64_t span = pBucket->range.i64MaxVal - pBucket->range.i64MinVal;
-  if (span < pBucket->numOfSlots) {
-    int64_t delta = v - pBucket->range.i64MinVal;
-    index = (delta % pBucket->numOfSlots);
-  } else {
-    double   slotSpan = ((double)span) / pBucket->numOfSlots;
-    uint64_t delta = v - pBucket->range.i64MinVal;
+  return (int32_t)index;
+}
 
-    index = (int32_t)(delta / slotSpan);
-    if (v == pBucket->range.i64MaxVal || index == pBucket->numOfSlots) {
-      index -= 1;
-    }
+static __perc_hash_func_t getHashFunc(int32_t type) {
+  if (IS_NUMERIC_TYPE(type)) {
+    return tBucketHash;
   }
 
-  ASSERTS(index >= 0 && index < pBucket->numOfSlots, "tBucketIntHash Error, index:%d, numOfSlots:%d",
-          index, pBucket->numOfSlots);
-  return index;
+  return NULL;
 }
 
-int32_t tBucketUintHash(tMemBucket *pBucket, const void *value) {
-  int64_t v = 0;
-  GET_TYPED_DATA(v, uint64_t, pBucket->type, value);
-
-  int32_t index = -1;
+static void setSlotSpan(tMemBucket *pBucket, double minval, double maxval) {
+  double width = (maxval - minval) / pBucket->numOfSlots;
+  double span = 1;
 
-  if (v > pBucket->range.u64MaxVal || v < pBucket->range.u64MinVal) {
-    return index;
+  if (width > 0) {
+    span = exp2(ceil(log2(width)));
+  } else if (IS_FLOAT_TYPE(pBucket->type) && minval != 0) {
+    span = exp2(ilogb(minval) - 20);
   }
 
-  // divide the value range into 1024 buckets
-  uint64_t span = pBucket->range.u64MaxVal - pBucket->range.u64MinVal;
-  if (span < pBucket->numOfSlots) {
-    int64_t delta = v - pBucket->range.u64MinVal;
-    index = (int32_t)(delta % pBucket->numOfSlots);
-  } else {
-    double slotSpan = (double)span / pBucket->numOfSlots;
-    index = (int32_t)((v - pBucket->range.u64MinVal) / slotSpan);
-    if (v == pBucket->range.u64MaxVal) {
-      index -= 1;
-    }
+  if (!IS_FLOAT_TYPE(pBucket->type) && span < 1) {
+    span = 1;
   }
 
-  ASSERT(index >= 0 && index < pBucket->numOfSlots);
-  return index;
-}
-
-int32_t tBucketDoubleHash(tMemBucket *pBucket, const void *value) {
-  double v = 0;
-  if (pBucket->type == TSDB_DATA_TYPE_FLOAT) {
-    v = GET_FLOAT_VAL(value);
-  } else {
-    v = GET_DOUBLE_VAL(value);
+  while (floor(maxval / span) - floor(minval / span) >= pBucket->numOfSlots) {
+    span *= 2;
   }
 
-  int32_t index = -1;
-
-  if (v > pBucket->range.dMaxVal || v < pBucket->range.dMinVal) {
-    return index;
-  }
+  pBucket->slotSpan = span;
+  pBucket->slotStart = floor(minval / span);
+}
 
-  // divide a range of [dMinVal, dMaxVal] into 1024 buckets
-  double span = pBucket->range.dMaxVal - pBucket->range.dMinVal;
-  if (span < pBucket->numOfSlots) {
-    int32_t delta = (int32_t)(v - pBucket->range.dMinVal);
-    index = (delta % pBucket->numOfSlots);
-  } else {
-    double slotSpan = span / pBucket->numOfSlots;
-    index = (int32_t)((v - pBucket->range.dMinVal) / slotSpan);
-    if (v == pBucket->range.dMaxVal) {
-      index -= 1;
-    }
-  }
+// the key comparators take the float values closer than an epsilon as equal, the values of a slot are sorted exactly
+static int32_t comparePercentileFloat(const void *pLeft, const void *pRight) {
+  float p1 = GET_FLOAT_VAL(pLeft);
+  float p2 = GET_FLOAT_VAL(pRight);
+  return (p1 > p2) - (p1 < p2);
+}
 
-  ASSERT(index >= 0 && index < pBucket->numOfSlots);
-  return index;
+static int32_t comparePercentileDouble(const void *pLeft, const void *pRight) {
+  double p1 = GET_DOUBLE_VAL(pLeft);
+  double p2 = GET_DOUBLE_VAL(pRight);
+  return (p1 > p2) - (p1 < p2);
 }
 
-static __perc_hash_func_t getHashFunc(int32_t type) {
-  if (IS_SIGNED_NUMERIC_TYPE(type)) {
-    return tBucketIntHash;
-  } else if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
-    return tBucketUintHash;
-  } else {
-    return tBucketDoubleHash;
+static __compar_fn_t getPercentileComparFunc(int32_t type) {
+  if (type == TSDB_DATA_TYPE_FLOAT) {
+    return comparePercentileFloat;
+  } else if (type == TSDB_DATA_TYPE_DOUBLE) {
+    return comparePercentileDouble;
   }
+
+  return getKeyComparFunc(type, TSDB_ORDER_ASC);
 }
 
 static void resetSlotInfo(tMemBucket *pBucket) {
@@ -261,7 +235,7 @@ tMemBucket *tMemBucketCreate(int32_t nElemSize, int16_t dataType, double minval,
   }
 
   pBucket->elemPerPage = (pBucket->bufPageSize - sizeof(SFilePage)) / pBucket->bytes;
-  pBucket->comparFn = getKeyComparFunc(pBucket->type, TSDB_ORDER_ASC);
+  pBucket->comparFn = getPercentileComparFunc(pBucket->type);
 
   pBucket->hashFunc = getHashFunc(pBucket->type);
   if (pBucket->hashFunc == NULL) {
@@ -270,6 +244,8 @@ tMemBucket *tMemBucketCreate(int32_t nElemSize, int16_t dataType, double minval,
     return NULL;
   }
 
+  setSlotSpan(pBucket, minval, maxval);
+
   pBucket->pSlots = (tMemBucketSlot *)taosMemoryCalloc(pBucket->numOfSlots, sizeof(tMemBucketSlot));
   if (pBucket->pSlots == NULL) {
     taosMemoryFree(pBucket);
@@ -352,6 +328,91 @@ void tMemBucketUpdateBoundingBox(MinMaxEntry *r, const char *data, int32_t dataT
   }
 }
 
+static void mergeBoundingBox(MinMaxEntry *r, const MinMaxEntry *pInput, int32_t dataType) {
+  if (IS_SIGNED_NUMERIC_TYPE(dataType)) {
+    r->i64MinVal = TMIN(r->i64MinVal, pInput->i64MinVal);
+    r->i64MaxVal = TMAX(r->i64MaxVal, pInput->i64MaxVal);
+  } else if (IS_UNSIGNED_NUMERIC_TYPE(dataType)) {
+    r->u64MinVal = TMIN(r->u64MinVal, pInput->u64MinVal);
+    r->u64MaxVal = (int64_t)TMAX((uint64_t)r->u64MaxVal, (uint64_t)pInput->u64MaxVal);
+  } else {
+    r->dMinVal = TMIN(r->dMinVal, pInput->dMinVal);
+    r->dMaxVal = TMAX(r->dMaxVal, pInput->dMaxVal);
+  }
+}
+
+/*
+ * Doubles the slot span until the slots cover the value too. Since each slot falls into a single slot of the wider
+ * span, the slots are merged by moving their pages to the new slot, without reading the data again.
+ */
+static int32_t widenSlotSpan(tMemBucket *pBucket, double v) {
+  int32_t numOfSlots = pBucket->numOfSlots;
+  double  scale = 1;
+  double  start = 0;
+  double  last = 0;
+
+  do {
+    scale *= 2;
+    start = TMIN(floor(pBucket->slotStart / scale), floor(v / (pBucket->slotSpan * scale)));
+    last = TMAX(floor((pBucket->slotStart + numOfSlots - 1) / scale), floor(v / (pBucket->slotSpan * scale)));
+  } while (last - start >= numOfSlots);
+
+  tMemBucketSlot *pSlots = (tMemBucketSlot *)taosMemoryCalloc(numOfSlots, sizeof(tMemBucketSlot));
+  if (pSlots == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < numOfSlots; ++i) {
+    resetBoundingBox(&pSlots[i].range, pBucket->type);
+    resetPosInfo(&pSlots[i].info);
+  }
+
+  for (int32_t i = 0; i < numOfSlots; ++i) {
+    tMemBucketSlot *pSlot = &pBucket->pSlots[i];
+    if (pSlot->info.size == 0) {
+      continue;
+    }
+
+    int32_t         index = (int32_t)(floor((pBucket->slotStart + i) / scale) - start);
+    tMemBucketSlot *pNewSlot = &pSlots[index];
+
+    if (pSlot->info.data != NULL) {
+      setBufPageDirty(pSlot->info.data, true);
+      releaseBufPage(pBucket->pBuffer, pSlot->info.data);
+    }
+
+    pNewSlot->info.size += pSlot->info.size;
+    mergeBoundingBox(&pNewSlot->range, &pSlot->range, pBucket->type);
+
+    int32_t groupId = getGroupId(numOfSlots, i, pBucket->times);
+    int32_t newGroupId = getGroupId(numOfSlots, index, pBucket->times + 1);
+
+    SArray **p = taosHashGet(pBucket->groupPagesMap, &groupId, sizeof(groupId));
+    if (p == NULL) {
+      continue;
+    }
+
+    SArray  *pPageIdList = *p;
+    SArray **pNew = taosHashGet(pBucket->groupPagesMap, &newGroupId, sizeof(newGroupId));
+    taosHashRemove(pBucket->groupPagesMap, &groupId, sizeof(groupId));
+    if (pNew == NULL) {
+      taosHashPut(pBucket->groupPagesMap, &newGroupId, sizeof(newGroupId), &pPageIdList, POINTER_BYTES);
+    } else {
+      taosArrayAddAll(*pNew, pPageIdList);
+      taosArrayDestroy(pPageIdList);
+    }
+  }
+
+  taosMemoryFree(pBucket->pSlots);
+  pBucket->pSlots = pSlots;
+  pBucket->slotSpan *= scale;
+  pBucket->slotStart = start;
+  pBucket->times += 1;
+
+  setBoundingBox(&pBucket->range, pBucket->type, start * pBucket->slotSpan, (start + numOfSlots) * pBucket->slotSpan);
+  return TSDB_CODE_SUCCESS;
+}
+
 /*
  * in memory bucket, we only accept data array list
  */
@@ -362,7 +423,21 @@ int32_t tMemBucketPut(tMemBucket *pBucket, const void *data, size_t size) {
     char   *d = (char *)data + i * bytes;
     int32_t index = (pBucket->hashFunc)(pBucket, d);
     if (index < 0) {
-      continue;
+      double v = 0;
+      GET_TYPED_DATA(v, double, pBucket->type, d);
+
+      // nan has no order, and no slot span covers an infinite value
+      if (!isfinite(v)) {
+        continue;
+      }
+
+      int32_t code = widenSlotSpan(pBucket, v);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+
+      index = (pBucket->hashFunc)(pBucket, d);
+      ASSERT(index >= 0);
     }
 
     count += 1;
@@ -448,6 +523,31 @@ static double getIdenticalDataVal(tMemBucket *pMemBucket, int32_t slotIndex) {
   return finalResult;
 }
 
+// the integers of a page as offsets from the base, exact for the ones a double rounds together
+static int32_t putValueOffsets(tMemBucket *pBucket, tMemBucket *pSrcBucket, const SFilePage *pg, uint64_t base) {
+  int64_t *offsets = taosMemoryMalloc(pg->num * sizeof(int64_t));
+  if (offsets == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < pg->num; ++i) {
+    const char *d = pg->data + i * pSrcBucket->bytes;
+    uint64_t    v = 0;
+    if (IS_SIGNED_NUMERIC_TYPE(pSrcBucket->type)) {
+      int64_t iv = 0;
+      GET_TYPED_DATA(iv, int64_t, pSrcBucket->type, d);
+      v = (uint64_t)iv;
+    } else {
+      GET_TYPED_DATA(v, uint64_t, pSrcBucket->type, d);
+    }
+    offsets[i] = (int64_t)(v - base);
+  }
+
+  int32_t code = tMemBucketPut(pBucket, offsets, pg->num);
+  taosMemoryFree(offsets);
+  return code;
+}
+
 int32_t getPercentileImpl(tMemBucket *pMemBucket, int32_t count, double fraction, double *result) {
   int32_t num = 0;
 
@@ -485,6 +585,19 @@ int32_t getPercentileImpl(tMemBucket *pMemBucket, int32_t count, double fraction
         return TSDB_CODE_SUCCESS;
       }
 
+      double minOfThisSlot = 0;
+      double maxOfThisSlot = 0;
+      if (IS_SIGNED_NUMERIC_TYPE(pMemBucket->type)) {
+        minOfThisSlot = (double)pSlot->range.i64MinVal;
+        maxOfThisSlot = (double)pSlot->range.i64MaxVal;
+      } else if (IS_UNSIGNED_NUMERIC_TYPE(pMemBucket->type)) {
+        minOfThisSlot = (double)pSlot->range.u64MinVal;
+        maxOfThisSlot = (double)(uint64_t)pSlot->range.u64MaxVal;
+      } else {
+        minOfThisSlot = pSlot->range.dMinVal;
+        maxOfThisSlot = pSlot->range.dMaxVal;
+      }
+
       if (pSlot->info.size <= pMemBucket->maxCapacity) {
         // data in buffer and file are merged together to be processed.
         SFilePage *buffer = loadDataFromFilePage(pMemBucket, i);
@@ -511,44 +624,58 @@ int32_t getPercentileImpl(tMemBucket *pMemBucket, int32_t count, double fraction
           return TSDB_CODE_SUCCESS;
         }
 
-        // try next round
-        pMemBucket->times += 1;
-        //       qDebug("MemBucket:%p, start next round data bucketing, time:%d", pMemBucket, pMemBucket->times);
-
-        pMemBucket->range = pSlot->range;
-        pMemBucket->total = 0;
-
-        resetSlotInfo(pMemBucket);
-
-        int32_t groupId = getGroupId(pMemBucket->numOfSlots, i, pMemBucket->times - 1);
+        /*
+         * Split the data of the slot into a bucket of its own, this one is kept for the other percentiles. The big
+         * integers a double does not tell apart go to it as their exact offsets from the smallest one.
+         */
+        bool        rebase = (minOfThisSlot == maxOfThisSlot);
+        uint64_t    base = pSlot->range.u64MinVal;
+        tMemBucket *pSlotBucket = NULL;
+        if (rebase) {
+          double span = (double)((uint64_t)pSlot->range.u64MaxVal - base);
+          pSlotBucket = tMemBucketCreate(sizeof(int64_t), TSDB_DATA_TYPE_BIGINT, 0, span);
+        } else {
+          pSlotBucket = tMemBucketCreate(pMemBucket->bytes, pMemBucket->type, minOfThisSlot, maxOfThisSlot);
+        }
+        if (pSlotBucket == NULL) {
+          return terrno != 0 ? terrno : TSDB_CODE_OUT_OF_MEMORY;
+        }
 
-        SArray* list;
-        void *p = taosHashGet(pMemBucket->groupPagesMap, &groupId, sizeof(groupId));
+        int32_t groupId = getGroupId(pMemBucket->numOfSlots, i, pMemBucket->times);
+        SArray *list = NULL;
+        void   *p = taosHashGet(pMemBucket->groupPagesMap, &groupId, sizeof(groupId));
         if (p != NULL) {
           list = *(SArray **)p;
-          if (list == NULL || list->size <= 0) {
-            return -1;
-          }
-        } else {
-          return -1;
         }
 
-        for (int32_t f = 0; f < list->size; ++f) {
-          int32_t *pageId = taosArrayGet(list, f);
+        int32_t code = (list == NULL || list->size <= 0) ? -1 : TSDB_CODE_SUCCESS;
+        for (int32_t f = 0; code == TSDB_CODE_SUCCESS && f < list->size; ++f) {
+          int32_t   *pageId = taosArrayGet(list, f);
           SFilePage *pg = getBufPage(pMemBucket->pBuffer, *pageId);
           if (pg == NULL) {
-            return terrno;
+            code = terrno;
+            break;
           }
 
-          int32_t code = tMemBucketPut(pMemBucket, pg->data, (int32_t)pg->num);
-          if (code != TSDB_CODE_SUCCESS) {
-            return code;
+          if (rebase) {
+            code = putValueOffsets(pSlotBucket, pMemBucket, pg, base);
+          } else {
+            code = tMemBucketPut(pSlotBucket, pg->data, (int32_t)pg->num);
+          }
+          if (pg != pSlot->info.data) {
+            releaseBufPage(pMemBucket->pBuffer, pg);
           }
-          setBufPageDirty(pg, true);
-          releaseBufPage(pMemBucket->pBuffer, pg);
         }
 
-        return getPercentileImpl(pMemBucket, count - num, fraction, result);
+        if (code == TSDB_CODE_SUCCESS) {
+          code = getPercentileImpl(pSlotBucket, count - num, fraction, result);
+        }
+        if (code == TSDB_CODE_SUCCESS && rebase) {
+          *result += IS_SIGNED_NUMERIC_TYPE(pMemBucket->type) ? (double)(int64_t)base : (double)base;
+        }
+
+        tMemBucketDestroy(pSlotBucket);
+        return code;
       }
     } else {
       num += pSlot->info.size;
@@ -572,16 +699,25 @@ int32_t getPercentile(tMemBucket *pMemBucket, double percent, double *result) {
 
   percent = fabs(percent);
 
-  // find the min/max value, no need to scan all data in bucket
+  // find the min/max value in the first/last slot with data, no need to scan all data in bucket
   if (fabs(percent - 100.0) < DBL_EPSILON || (percent < DBL_EPSILON)) {
-    MinMaxEntry *pRange = &pMemBucket->range;
+    int32_t i = 0, j = pMemBucket->numOfSlots - 1;
+    while (pMemBucket->pSlots[i].info.size == 0) {
+      ++i;
+    }
+    while (pMemBucket->pSlots[j].info.size == 0) {
+      --j;
+    }
+
+    MinMaxEntry *pMin = &pMemBucket->pSlots[i].range;
+    MinMaxEntry *pMax = &pMemBucket->pSlots[j].range;
 
     if (IS_SIGNED_NUMERIC_TYPE(pMemBucket->type)) {
-      *result = (double)(fabs(percent - 100) < DBL_EPSILON ? pRange->i64MaxVal : pRange->i64MinVal);
+      *result = (double)(fabs(percent - 100) < DBL_EPSILON ? pMax->i64MaxVal : pMin->i64MinVal);
     } else if (IS_UNSIGNED_NUMERIC_TYPE(pMemBucket->type)) {
-      *result = (double)(fabs(percent - 100) < DBL_EPSILON ? pRange->u64MaxVal : pRange->u64MinVal);
+      *result = (double)(fabs(percent - 100) < DBL_EPSILON ? (uint64_t)pMax->u64MaxVal : pMin->u64MinVal);
     } else {
-      *result = fabs(percent - 100) < DBL_EPSILON ? pRange->dMaxVal : pRange->dMinVal;
+      *result = fabs(percent - 100) < DBL_EPSILON ? pMax->dMaxVal : pMin->dMinVal;
     }
 
     return TSDB_CODE_SUCCESS;
@@ -601,7 +737,7 @@ bool isIdenticalData(tMemBucket *pMemBucket, int32_t index) {
   tMemBucketSlot *pSeg = &pMemBucket->pSlots[index];
 
   if (IS_FLOAT_TYPE(pMemBucket->type)) {
-    return fabs(pSeg->range.dMaxVal - pSeg->range.dMinVal) < DBL_EPSILON;
+    return pSeg->range.dMaxVal == pSeg->range.dMinVal;
   } else {
     return pSeg->range.i64MinVal == pSeg->range.i64MaxVal;
   }
@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "tglobal.h"
+#include "tpercentile.h"
+#include "ttypes.h"
+
+namespace {
+
+const int32_t blockRows = 777;
+
+uint64_t nextRand(uint64_t *seed) {
+  *seed = *seed * 6364136223846793005ull + 1442695040888963407ull;
+  return *seed >> 11;
+}
+
+// the values of a column of the type, and the same as double
+class PercentileData {
+ public:
+  explicit PercentileData(int16_t type) : type(type), bytes(tDataTypes[type].bytes) {}
+
+  void append(double v) {
+    char buf[sizeof(int64_t)] = {0};
+    switch (type) {
+      case TSDB_DATA_TYPE_INT:
+        *(int32_t *)buf = (int32_t)v;
+        break;
+      case TSDB_DATA_TYPE_BIGINT:
+        *(int64_t *)buf = (int64_t)v;
+        break;
+      case TSDB_DATA_TYPE_UINT:
+        *(uint32_t *)buf = (uint32_t)v;
+        break;
+      case TSDB_DATA_TYPE_UBIGINT:
+        *(uint64_t *)buf = (uint64_t)v;
+        break;
+      case TSDB_DATA_TYPE_FLOAT:
+        *(float *)buf = (float)v;
+        break;
+      default:
+        *(double *)buf = v;
+        break;
+    }
+    data.insert(data.end(), buf, buf + bytes);
+
+    double val = 0;
+    GET_TYPED_DATA(val, double, type, buf);
+    if (std::isfinite(val)) {
+      values.push_back(val);
+    }
+  }
+
+  int32_t size() const { return (int32_t)(data.size() / bytes); }
+
+  // the bucket is sized by the finite values of the first block, as the percentile function does
+  tMemBucket *build(int32_t maxCapacity, int32_t inMemPages = 0) const {
+    double minVal = DBL_MAX, maxVal = -DBL_MAX;
+    for (int32_t i = 0; i < std::min(size(), blockRows); ++i) {
+      double v = 0;
+      GET_TYPED_DATA(v, double, type, data.data() + i * bytes);
+      if (std::isfinite(v)) {
+        minVal = std::min(minVal, v);
+        maxVal = std::max(maxVal, v);
+      }
+    }
+
+    tMemBucket *pBucket = tMemBucketCreate(bytes, type, minVal, maxVal);
+    EXPECT_NE(pBucket, nullptr);
+    if (pBucket == NULL) {
+      return NULL;
+    }
+
+    pBucket->maxCapacity = maxCapacity;
+    if (inMemPages > 0) {
+      destroyDiskbasedBuf(pBucket->pBuffer);
+      int32_t pageSize = pBucket->bufPageSize;
+      EXPECT_EQ(createDiskbasedBuf(&pBucket->pBuffer, pageSize, pageSize * inMemPages, "1", tsTempDir), 0);
+    }
+    for (int32_t i = 0; i < size(); i += blockRows) {
+      EXPECT_EQ(tMemBucketPut(pBucket, data.data() + i * bytes, std::min(blockRows, size() - i)), 0);
+    }
+    return pBucket;
+  }
+
+  // interpolated between the two closest ranks
+  double exact(double percent) const {
+    std::vector<double> sorted(values);
+    std::sort(sorted.begin(), sorted.end());
+
+    double  idx = (sorted.size() - 1) * percent / 100;
+    int32_t lo = (int32_t)idx;
+    if (lo + 1 >= (int32_t)sorted.size()) {
+      return sorted.back();
+    }
+    return sorted[lo] + (sorted[lo + 1] - sorted[lo]) * (idx - lo);
+  }
+
+  void check(tMemBucket *pBucket, const std::vector<double> &percents) const {
+    for (double p : percents) {
+      double  res = 0;
+      int32_t code = getPercentile(pBucket, p, &res);
+      ASSERT_EQ(code, TSDB_CODE_SUCCESS) << "percent " << p;
+
+      double expect = exact(p);
+      ASSERT_LE(fabs(res - expect), 1e-9 * std::max(1.0, fabs(expect)))
+          << "type " << type << ", percent " << p << ", result " << res << ", expect " << expect;
+    }
+  }
+
+  int16_t             type;
+  int32_t             bytes;
+  std::vector<char>   data;
+  std::vector<double> values;
+};
+
+const std::vector<double> percents = {0, 1, 10, 25, 50, 73.3, 90, 99, 100};
+
+class PercentileTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    strcpy(tsTempDir, "/tmp/");
+    tsTempSpace.size.avail = INT64_MAX;
+  }
+};
+
+}  // namespace
+
+TEST_F(PercentileTest, widenAfterNarrowFirstBlock) {
+  int16_t types[] = {TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_DOUBLE};
+  for (int16_t type : types) {
+    uint64_t       seed = 7;
+    PercentileData d(type);
+
+    // the first block spans 10 values, the later ones widen the range on both sides many times
+    for (int32_t i = 0; i < blockRows; ++i) {
+      d.append(100 + (double)(nextRand(&seed) % 10));
+    }
+    for (int32_t i = 0; i < 20 * blockRows; ++i) {
+      double scale = pow(2, i / blockRows);
+      d.append(((double)(nextRand(&seed) % 20001) - 10000) * scale);
+    }
+
+    tMemBucket *pBucket = d.build(200000);
+    ASSERT_NE(pBucket, nullptr);
+    ASSERT_EQ(pBucket->total, d.size());
+    d.check(pBucket, percents);
+    tMemBucketDestroy(pBucket);
+  }
+}
+
+TEST_F(PercentileTest, constantFirstBlock) {
+  PercentileData d(TSDB_DATA_TYPE_DOUBLE);
+  for (int32_t i = 0; i < blockRows; ++i) {
+    d.append(5);
+  }
+  for (int32_t i = 0; i < blockRows; ++i) {
+    d.append(i % 2 ? 1e6 : -0.001 * i);
+  }
+
+  tMemBucket *pBucket = d.build(200000);
+  ASSERT_NE(pBucket, nullptr);
+  d.check(pBucket, percents);
+  tMemBucketDestroy(pBucket);
+}
+
+TEST_F(PercentileTest, multiplePercentilesOfSplitSlot) {
+  uint64_t       seed = 11;
+  PercentileData d(TSDB_DATA_TYPE_DOUBLE);
+
+  // most values in a narrow cluster, so that their slot is over the capacity and split to find each percentile
+  for (int32_t i = 0; i < 30000; ++i) {
+    if (i % 10 == 0) {
+      d.append((double)(nextRand(&seed) % 100000));
+    } else {
+      d.append(500 + (double)(nextRand(&seed) % 1000) / 1000.0);
+    }
+  }
+
+  tMemBucket *pBucket = d.build(100);
+  ASSERT_NE(pBucket, nullptr);
+
+  // each call must find the main bucket intact, in any order of the percentiles
+  std::vector<double> ps = {50, 10, 90, 50, 35.5, 60.25, 0, 100, 99.9, 0.1};
+  d.check(pBucket, ps);
+  std::reverse(ps.begin(), ps.end());
+  d.check(pBucket, ps);
+  ASSERT_EQ(pBucket->total, d.size());
+  tMemBucketDestroy(pBucket);
+}
+
+TEST_F(PercentileTest, valueRanges) {
+  // negative, float and unsigned values, with small capacities to split the slots as well
+  struct {
+    int16_t type;
+    double  base;
+    double  scale;
+  } ranges[] = {
+      {TSDB_DATA_TYPE_INT, -2000000, 1},         {TSDB_DATA_TYPE_BIGINT, -1e15, 1e9},
+      {TSDB_DATA_TYPE_FLOAT, -10, 1e-4},         {TSDB_DATA_TYPE_DOUBLE, -1e-6, 1e-9},
+      {TSDB_DATA_TYPE_UINT, 4e9, 1},             {TSDB_DATA_TYPE_UBIGINT, 1e18, 1e9},
+      {TSDB_DATA_TYPE_UBIGINT, 0, 1},
+  };
+
+  for (auto &r : ranges) {
+    for (int32_t capacity : {200000, 100}) {
+      uint64_t       seed = 13;
+      PercentileData d(r.type);
+      for (int32_t i = 0; i < 10000; ++i) {
+        double v = r.base + (double)(nextRand(&seed) % 100000) * r.scale * (1 + i / 2000);
+        if (IS_UNSIGNED_NUMERIC_TYPE(r.type)) {
+          v = fabs(v);
+        }
+        d.append(v);
+      }
+
+      tMemBucket *pBucket = d.build(capacity);
+      ASSERT_NE(pBucket, nullptr);
+      d.check(pBucket, percents);
+      tMemBucketDestroy(pBucket);
+    }
+  }
+}
+
+TEST_F(PercentileTest, skipNanAndInf) {
+  int16_t types[] = {TSDB_DATA_TYPE_FLOAT, TSDB_DATA_TYPE_DOUBLE};
+  for (int16_t type : types) {
+    uint64_t       seed = 17;
+    PercentileData d(type);
+    double         special[] = {NAN, INFINITY, -INFINITY};
+    for (int32_t i = 0; i < 5000; ++i) {
+      if (i % 7 == 0) {
+        d.append(special[i % 3]);
+      } else {
+        d.append((double)(nextRand(&seed) % 10000) / 8 - 600);
+      }
+    }
+
+    tMemBucket *pBucket = d.build(200);
+    ASSERT_NE(pBucket, nullptr);
+    ASSERT_EQ(pBucket->total, (int32_t)d.values.size());
+    d.check(pBucket, percents);
+    tMemBucketDestroy(pBucket);
+  }
+}
+
+TEST_F(PercentileTest, slotPagesEvicted) {
+  uint64_t       seed = 19;
+  PercentileData d(TSDB_DATA_TYPE_BIGINT);
+
+  // three clusters of a slot each, with a few full pages and a page still written to
+  for (int32_t i = 0; i < 60000; ++i) {
+    d.append((double)((i % 3) << 20) + (double)(nextRand(&seed) % 1000));
+  }
+
+  // the pages of one slot read for a percentile evict those of the others
+  tMemBucket *pBucket = d.build(200000, 4);
+  ASSERT_NE(pBucket, nullptr);
+  d.check(pBucket, {10, 50, 90, 10, 50, 90, 45, 5, 95});
+  tMemBucketDestroy(pBucket);
+}
+
+TEST_F(PercentileTest, bigIntegersOfOneDouble) {
+  int16_t types[] = {TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_UBIGINT};
+  for (int16_t type : types) {
+    uint64_t seed = 23;
+    uint64_t base = (type == TSDB_DATA_TYPE_BIGINT) ? (1ull << 62) : (3ull << 62);
+
+    // integers above 2^53 closer than a double tells apart, many more than the capacity of a slot
+    PercentileData      d(type);
+    std::vector<double> offsets;
+    for (int32_t i = 0; i < 5000; ++i) {
+      uint64_t off = nextRand(&seed) % 512;
+      offsets.push_back((double)off);
+
+      uint64_t v = base + off;
+      d.data.insert(d.data.end(), (char *)&v, (char *)&v + sizeof(v));
+    }
+    std::sort(offsets.begin(), offsets.end());
+
+    tMemBucket *pBucket = d.build(100);
+    ASSERT_NE(pBucket, nullptr);
+    ASSERT_EQ(pBucket->total, d.size());
+    for (double p : percents) {
+      double  res = 0;
+      int32_t code = getPercentile(pBucket, p, &res);
+      ASSERT_EQ(code, TSDB_CODE_SUCCESS) << "percent " << p;
+
+      double  idx = (offsets.size() - 1) * p / 100;
+      int32_t lo = (int32_t)idx;
+      double  off = (lo + 1 >= (int32_t)offsets.size()) ? offsets.back()
+                                                         : offsets[lo] + (offsets[lo + 1] - offsets[lo]) * (idx - lo);
+      ASSERT_EQ(res, (double)base + off) << "type " << type << ", percent " << p;
+    }
+    tMemBucketDestroy(pBucket);
+  }
+}
@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "builtinsimpl.h"
+#include "function.h"
+#include "tdatablock.h"
+#include "tddsketch.h"
+#include "tglobal.h"
+
+namespace {
+
+uint64_t nextRand(uint64_t *seed) {
+  *seed = *seed * 6364136223846793005ull + 1442695040888963407ull;
+  return *seed >> 11;
+}
+
+double exactQuantile(std::vector<double> values, double q) {
+  std::sort(values.begin(), values.end());
+  return values[(size_t)(q * (values.size() - 1))];
+}
+
+// the relative error of the sketch, or the absolute one around zero
+void checkQuantile(const SDDSketch *pSketch, const std::vector<double> &values, double q) {
+  double expect = exactQuantile(values, q);
+  double val = tDDSketchQuantile(pSketch, q);
+  if (expect == 0) {
+    ASSERT_EQ(val, 0) << "q " << q;
+  } else {
+    ASSERT_LE(fabs(val - expect) / fabs(expect), DDSKETCH_RELATIVE_ACCURACY + 1e-9) << "q " << q;
+  }
+}
+
+const double quantiles[] = {0, 0.001, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 1};
+
+// the aggregate of hll over one column, driven as the executor does
+class HllCtx {
+ public:
+  HllCtx() {
+    buf.resize(sizeof(SResultRowEntryInfo) + getHLLInfoSize());
+    expr.base.resSchema.slotId = 0;
+    ctx.resultInfo = (SResultRowEntryInfo *)buf.data();
+    ctx.pExpr = &expr;
+    ctx.input.pData = &pCol;
+    ctx.input.numOfInputCols = 1;
+  }
+
+  void add(const std::vector<int64_t> &values) {
+    SColumnInfoData col = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 1);
+    ASSERT_EQ(colInfoDataEnsureCapacity(&col, values.size(), false), 0);
+    for (size_t i = 0; i < values.size(); ++i) {
+      colDataSetVal(&col, i, (const char *)&values[i], false);
+    }
+
+    setInput(&col, values.size());
+    ASSERT_EQ(hllFunction(&ctx), TSDB_CODE_SUCCESS);
+    colDataDestroy(&col);
+  }
+
+  // the partial result sent to the merge
+  std::string partial() {
+    SSDataBlock    *pBlock = createDataBlock();
+    SColumnInfoData col = createColumnInfoData(TSDB_DATA_TYPE_BINARY, getHLLInfoSize() + VARSTR_HEADER_SIZE, 1);
+    blockDataAppendColInfo(pBlock, &col);
+    blockDataEnsureCapacity(pBlock, 1);
+
+    hllPartialFinalize(&ctx, pBlock);
+    char       *data = colDataGetData((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0), 0);
+    std::string res(varDataVal(data), varDataLen(data));
+    blockDataDestroy(pBlock);
+    return res;
+  }
+
+  int32_t merge(const std::vector<std::string> &partials) {
+    SColumnInfoData col = createColumnInfoData(TSDB_DATA_TYPE_BINARY, getHLLInfoSize() + VARSTR_HEADER_SIZE, 1);
+    if (colInfoDataEnsureCapacity(&col, partials.size(), false) != 0) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    std::vector<char> val(getHLLInfoSize() + VARSTR_HEADER_SIZE);
+    for (size_t i = 0; i < partials.size(); ++i) {
+      varDataSetLen(val.data(), partials[i].size());
+      memcpy(varDataVal(val.data()), partials[i].data(), partials[i].size());
+      colDataSetVal(&col, i, val.data(), false);
+    }
+
+    setInput(&col, partials.size());
+    int32_t code = hllFunctionMerge(&ctx);
+    colDataDestroy(&col);
+    return code;
+  }
+
+  // the counters and buckets of the aggregate
+  std::string state() const {
+    return std::string(buf.data() + sizeof(SResultRowEntryInfo), getHLLInfoSize());
+  }
+
+ private:
+  void setInput(SColumnInfoData *p, int32_t numOfRows) {
+    pCol = p;
+    ctx.input.startRowIndex = 0;
+    ctx.input.numOfRows = numOfRows;
+    ctx.input.totalRows = numOfRows;
+  }
+
+  std::vector<char> buf;
+  SExprInfo         expr = {0};
+  SqlFunctionCtx    ctx = {0};
+  SColumnInfoData  *pCol = NULL;
+};
+
+std::vector<int64_t> distinctValues(int32_t start, int32_t num) {
+  std::vector<int64_t> values;
+  for (int32_t i = 0; i < num; ++i) {
+    values.push_back(start + i);
+  }
+  return values;
+}
+
+}  // namespace
+
+TEST(DDSketchTest, accuracy) {
+  uint64_t seed = 11;
+  for (int32_t dist = 0; dist < 3; ++dist) {
+    char                buf[DDSKETCH_SIZE];
+    SDDSketch          *pSketch = tDDSketchCreateFrom(buf);
+    std::vector<double> values;
+    for (int32_t i = 0; i < 50000; ++i) {
+      double v = 0;
+      if (dist == 0) {
+        v = (double)(nextRand(&seed) % 100000) / 7.0 + 1;
+      } else if (dist == 1) {
+        v = exp((double)(nextRand(&seed) % 4000) / 200.0);  // 8 decades, all in the window
+      } else {
+        v = -exp((double)(nextRand(&seed) % 1000) / 100.0);
+      }
+      values.push_back(v);
+      tDDSketchAdd(pSketch, v);
+    }
+
+    ASSERT_EQ(pSketch->count, (int64_t)values.size());
+    for (double q : quantiles) {
+      checkQuantile(pSketch, values, q);
+    }
+  }
+}
+
+TEST(DDSketchTest, merge) {
+  uint64_t            seed = 7;
+  char                buf[3][DDSKETCH_SIZE];
+  SDDSketch          *pPart[2] = {tDDSketchCreateFrom(buf[0]), tDDSketchCreateFrom(buf[1])};
+  SDDSketch          *pWhole = tDDSketchCreateFrom(buf[2]);
+  std::vector<double> values;
+
+  // the parts cover different ranges, the merge has to move the window of the first one
+  for (int32_t i = 0; i < 20000; ++i) {
+    double v = (i % 3 == 0) ? exp((double)(nextRand(&seed) % 500) / 100.0)
+                            : -exp((double)(nextRand(&seed) % 1500) / 100.0) * ((i % 5 == 0) ? 0 : 1);
+    values.push_back(v);
+    tDDSketchAdd(pPart[i % 3 == 0 ? 0 : 1], v);
+    tDDSketchAdd(pWhole, v);
+  }
+
+  tDDSketchMerge(pPart[0], pPart[1]);
+  ASSERT_EQ(pPart[0]->count, pWhole->count);
+  ASSERT_EQ(pPart[0]->zeroCount, pWhole->zeroCount);
+  ASSERT_EQ(pPart[0]->min, pWhole->min);
+  ASSERT_EQ(pPart[0]->max, pWhole->max);
+  for (double q : quantiles) {
+    ASSERT_EQ(tDDSketchQuantile(pPart[0], q), tDDSketchQuantile(pWhole, q)) << "q " << q;
+    checkQuantile(pWhole, values, q);
+  }
+
+  // an empty sketch changes nothing
+  char       emptyBuf[DDSKETCH_SIZE];
+  SDDSketch *pEmpty = tDDSketchCreateFrom(emptyBuf);
+  tDDSketchMerge(pWhole, pEmpty);
+  ASSERT_EQ(pWhole->count, (int64_t)values.size());
+  tDDSketchMerge(pEmpty, pWhole);
+  for (double q : quantiles) {
+    ASSERT_EQ(tDDSketchQuantile(pEmpty, q), tDDSketchQuantile(pWhole, q)) << "q " << q;
+  }
+}
+
+TEST(DDSketchTest, windowCollapse) {
+  char                buf[DDSKETCH_SIZE];
+  SDDSketch          *pSketch = tDDSketchCreateFrom(buf);
+  std::vector<double> values;
+
+  // 40 decades, far more keys than the bins of the window
+  for (int32_t i = 0; i < 4000; ++i) {
+    double v = pow(10, -20 + i / 100.0);
+    values.push_back(v);
+    tDDSketchAdd(pSketch, v);
+  }
+
+  ASSERT_EQ(pSketch->pos.count, (int64_t)values.size());
+  ASSERT_EQ(pSketch->min, values.front());
+  ASSERT_EQ(pSketch->max, values.back());
+
+  // the highest keys keep their bins, the lowest are collapsed into the first bin and over-estimated
+  for (double q : {0.8, 0.9, 0.99, 1.0}) {
+    checkQuantile(pSketch, values, q);
+  }
+  double first = tDDSketchQuantile(pSketch, 0.01);
+  ASSERT_GE(first, exactQuantile(values, 0.01));
+  ASSERT_LE(first, exactQuantile(values, 0.8));
+  ASSERT_LE(tDDSketchQuantile(pSketch, 0.01), tDDSketchQuantile(pSketch, 0.5));
+}
+
+TEST(DDSketchTest, signs) {
+  char                buf[DDSKETCH_SIZE];
+  SDDSketch          *pSketch = tDDSketchCreateFrom(buf);
+  std::vector<double> values;
+
+  // ranks [0, 100) negative, [100, 150) zero, [150, 250) positive
+  for (int32_t i = 1; i <= 100; ++i) {
+    values.push_back(-i * 1.5);
+    values.push_back(i * 2.5);
+  }
+  values.insert(values.end(), 50, 0.0);
+  for (double v : values) {
+    tDDSketchAdd(pSketch, v);
+  }
+
+  // neither nan nor inf are counted
+  tDDSketchAdd(pSketch, NAN);
+  tDDSketchAdd(pSketch, INFINITY);
+  tDDSketchAdd(pSketch, -INFINITY);
+
+  ASSERT_EQ(pSketch->count, 250);
+  ASSERT_EQ(pSketch->neg.count, 100);
+  ASSERT_EQ(pSketch->zeroCount, 50);
+  ASSERT_EQ(pSketch->pos.count, 100);
+
+  for (int32_t rank = 0; rank < 250; ++rank) {
+    double q = (rank + 0.25) / 249;
+    checkQuantile(pSketch, values, q);
+    double val = tDDSketchQuantile(pSketch, q);
+    if (rank < 100) {
+      ASSERT_LT(val, 0) << "rank " << rank;
+    } else if (rank < 150) {
+      ASSERT_EQ(val, 0) << "rank " << rank;
+    } else {
+      ASSERT_GT(val, 0) << "rank " << rank;
+    }
+  }
+}
+
+class HllSparseTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    hllSparsePartial = tsHllSparsePartial;
+    tsHllSparsePartial = true;
+  }
+  void TearDown() override { tsHllSparsePartial = hllSparsePartial; }
+
+  bool hllSparsePartial;
+};
+
+TEST_F(HllSparseTest, mergeSparseAndDense) {
+  // a group of few values, one of many, and an empty one
+  std::vector<int64_t> few = distinctValues(0, 100);
+  std::vector<int64_t> many = distinctValues(50, 200000);
+
+  HllCtx sparse, dense, empty, whole;
+  sparse.add(few);
+  dense.add(many);
+  whole.add(few);
+  whole.add(many);
+
+  std::string sparsePartial = sparse.partial();
+  std::string densePartial = dense.partial();
+  std::string emptyPartial = empty.partial();
+  ASSERT_LT(sparsePartial.size(), (size_t)getHLLInfoSize());
+  ASSERT_EQ(densePartial.size(), (size_t)getHLLInfoSize());
+  ASSERT_LT(emptyPartial.size(), sparsePartial.size());
+
+  // merged in any order and form, the buckets are those of a single aggregate
+  HllCtx merged1, merged2;
+  ASSERT_EQ(merged1.merge({sparsePartial, densePartial, emptyPartial}), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(merged2.merge({densePartial, emptyPartial}), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(merged2.merge({sparsePartial}), TSDB_CODE_SUCCESS);
+  ASSERT_TRUE(merged1.state() == whole.state());
+  ASSERT_TRUE(merged2.state() == whole.state());
+
+  // the dense form of the partial result merges alike
+  tsHllSparsePartial = false;
+  std::string fullPartial = sparse.partial();
+  ASSERT_EQ(fullPartial.size(), (size_t)getHLLInfoSize());
+
+  HllCtx merged3;
+  ASSERT_EQ(merged3.merge({densePartial, fullPartial}), TSDB_CODE_SUCCESS);
+  ASSERT_TRUE(merged3.state() == whole.state());
+}
+
+TEST_F(HllSparseTest, invalidPartial) {
+  HllCtx sparse;
+  sparse.add(distinctValues(0, 10));
+  std::string partial = sparse.partial();
+
+  // truncated, a bad flag byte, and a bucket out of range
+  HllCtx merged;
+  ASSERT_EQ(merged.merge({partial.substr(0, partial.size() - 1)}), TSDB_CODE_INVALID_MSG);
+
+  std::string badFlag = partial;
+  badFlag[2 * sizeof(uint64_t)] = 0x7F;
+  ASSERT_EQ(merged.merge({badFlag}), TSDB_CODE_INVALID_MSG);
+
+  std::string badIndex = partial;
+  badIndex[2 * sizeof(uint64_t) + 2] = (char)0xFF;
+  ASSERT_EQ(merged.merge({badIndex}), TSDB_CODE_INVALID_MSG);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1715,8 +1715,8 @@ static int32_t translateForbidSysTableFunc(STranslateContext* pCxt, SFunctionNod
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t translateRepeatScanFunc(STranslateContext* pCxt, SFunctionNode* pFunc) {
-  if (!fmIsRepeatScanFunc(pFunc->funcId)) {
+static int32_t translateSingleTableFunc(STranslateContext* pCxt, SFunctionNode* pFunc) {
+  if (!fmIsSingleTableFunc(pFunc->funcId)) {
     return TSDB_CODE_SUCCESS;
   }
   if (!isSelectStmt(pCxt->pCurrStmt)) {
@@ -1810,7 +1810,6 @@ static void setFuncClassification(SNode* pCurrStmt, SFunctionNode* pFunc) {
   if (NULL != pCurrStmt && QUERY_NODE_SELECT_STMT == nodeType(pCurrStmt)) {
     SSelectStmt* pSelect = (SSelectStmt*)pCurrStmt;
     pSelect->hasAggFuncs = pSelect->hasAggFuncs ? true : fmIsAggFunc(pFunc->funcId);
-    pSelect->hasRepeatScanFuncs = pSelect->hasRepeatScanFuncs ? true : fmIsRepeatScanFunc(pFunc->funcId);
 
     if (fmIsIndefiniteRowsFunc(pFunc->funcId)) {
       pSelect->hasIndefiniteRowsFunc = true;
@@ -1950,7 +1949,7 @@ static int32_t translateNormalFunction(STranslateContext* pCxt, SFunctionNode* p
     code = translateForbidSysTableFunc(pCxt, pFunc);
   }
   if (TSDB_CODE_SUCCESS == code) {
-    code = translateRepeatScanFunc(pCxt, pFunc);
+    code = translateSingleTableFunc(pCxt, pFunc);
   }
   if (TSDB_CODE_SUCCESS == code) {
     code = translateMultiResFunc(pCxt, pFunc);
@@ -15,6 +15,7 @@
 
 #include "planTestUtil.h"
 #include "planner.h"
+#include "tglobal.h"
 
 using namespace std;
 
@@ -58,3 +59,29 @@ TEST_F(PlanJoinTest, multiJoin) {
 
   run("SELECT t1.c1, t2.c1 FROM st1s1 t1 JOIN st1s2 t2 ON t1.ts = t2.ts JOIN st1s3 t3 ON t1.ts = t3.ts");
 }
+
+TEST_F(PlanJoinTest, hashJoin) {
+  useDb("root", "test");
+
+  tsQueryUseHashJoin = true;
+  run("SELECT t1.c1, t2.c1 FROM st1s1 t1 JOIN st1s2 t2 ON t1.ts = t2.ts AND t1.c1 = t2.c1");
+  EXPECT_NE(physiPlan().find("PhysiHashJoin"), string::npos);
+  EXPECT_EQ(physiPlan().find("PhysiJoin"), string::npos);
+
+  run("SELECT COUNT(*) FROM st1 t1 JOIN st1 t2 ON t1.ts = t2.ts AND t1.tag1 = t2.tag1");
+
+  // the primary key alone is left to the merge join
+  run("SELECT t1.c1, t2.c1 FROM st1s1 t1 JOIN st1s2 t2 ON t1.ts = t2.ts");
+  EXPECT_EQ(physiPlan().find("PhysiHashJoin"), string::npos);
+  EXPECT_NE(physiPlan().find("PhysiJoin"), string::npos);
+
+  // the hash join does not keep the primary key order required by the interval
+  run("SELECT COUNT(*) FROM st1s1 t1 JOIN st1s2 t2 ON t1.ts = t2.ts AND t1.c1 = t2.c1 INTERVAL(10s)");
+  EXPECT_EQ(physiPlan().find("PhysiHashJoin"), string::npos);
+  EXPECT_NE(physiPlan().find("PhysiJoin"), string::npos);
+  tsQueryUseHashJoin = false;
+
+  // off by default
+  run("SELECT t1.c1, t2.c1 FROM st1s1 t1 JOIN st1s2 t2 ON t1.ts = t2.ts AND t1.c1 = t2.c1");
+  EXPECT_EQ(physiPlan().find("PhysiHashJoin"), string::npos);
+}
@@ -128,6 +128,8 @@ class PlannerTestBaseImpl {
     }
   }
 
+  const string& physiPlan() const { return res_.physiPlan_; }
+
   void runImpl(const string& sql, int32_t queryPolicy) {
     int64_t allocatorId = 0;
     if (g_useNodeAllocator) {
@@ -535,3 +537,5 @@ void PlannerTestBase::bindParams(TAOS_MULTI_BIND* pParams, int32_t colIdx) {
 }
 
 void PlannerTestBase::exec() { return impl_->exec(); }
+
+const std::string& PlannerTestBase::physiPlan() const { return impl_->physiPlan(); }
@@ -36,6 +36,8 @@ class PlannerTestBase : public testing::Test {
   void prepare(const std::string& sql);
   void bindParams(TAOS_MULTI_BIND* pParams, int32_t colIdx);
   void exec();
+  // the json of the physical plan of the last sql run
+  const std::string& physiPlan() const;
 
  private:
   std::unique_ptr<PlannerTestBaseImpl> impl_;
@@ -33,6 +33,8 @@ extern "C" {
 #define FILTER_DEFAULT_FIELD_SIZE      4
 #define FILTER_DEFAULT_VALUE_SIZE      4
 #define FILTER_DEFAULT_GROUP_UNIT_SIZE 2
+#define FILTER_MEMO_BITS               6
+#define FILTER_MEMO_SIZE               (1 << FILTER_MEMO_BITS)
 
 #define FILTER_DUMMY_EMPTY_OPTR 127
 
@@ -214,6 +216,22 @@ typedef struct SFilterComUnit {
   int8_t   rfunc;
 } SFilterComUnit;
 
+typedef enum EFilterInstrType {
+  FLT_INSTR_GENERIC = 0,  // row by row through the compare functions of the unit
+  FLT_INSTR_IS_NULL,
+  FLT_INSTR_NOT_NULL,
+  FLT_INSTR_INT_RANGE,   // signed integer column within [lo, hi]
+  FLT_INSTR_UINT_RANGE,  // unsigned integer column within [lo, hi]
+  FLT_INSTR_EMPTY,
+} EFilterInstrType;
+
+typedef struct SFilterInstr {
+  uint8_t type;
+  bool    negate;  // keep the non null values out of [lo, hi] instead
+  int64_t lo;
+  int64_t hi;
+} SFilterInstr;
+
 typedef struct SFilterPCtx {
   SHashObj *valHash;
   SHashObj *unitHash;
@@ -267,6 +285,10 @@ struct SFilterInfo {
   int8_t           *blkUnitRes;
   void             *pTable;
   SArray           *blkList;
+  SFilterInstr     *instrs;   // compiled units
+  uint32_t         *prog;     // unit number and unit indexes of each group
+  int32_t          *selBuf;   // selection vectors of the compiled program
+  int32_t           selSize;
 
   SFilterPCtx pctx;
 };
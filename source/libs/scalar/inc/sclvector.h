@@ -103,6 +103,12 @@ static FORCE_INLINE _getDoubleValue_fn_t getVectorDoubleValueFn(int32_t srcType)
   return p;
 }
 
+// typed kernels of sclkernel.c, for the operands of fixed length types; false or -1 when the operands do not fit
+bool    sclKernelArith(int32_t optr, SColumnInfoData *pLeftCol, int32_t leftRows, SColumnInfoData *pRightCol,
+                       int32_t rightRows, SColumnInfoData *pOutputCol, int32_t numOfRows);
+int32_t sclKernelCompare(int32_t optr, SColumnInfoData *pLeftCol, int32_t leftRows, SColumnInfoData *pRightCol,
+                         int32_t rightRows, bool *pRes, int32_t start, int32_t end);
+
 typedef void (*_bufConverteFunc)(char *buf, SScalarParam *pOut, int32_t outType, int32_t *overflow);
 typedef void (*_bin_scalar_fn_t)(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *output, int32_t order);
 _bin_scalar_fn_t getBinScalarOperatorFn(int32_t binOperator);
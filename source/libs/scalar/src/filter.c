@@ -1870,6 +1870,9 @@ void filterFreeInfo(SFilterInfo *info) {
   taosMemoryFreeClear(info->cunits);
   taosMemoryFreeClear(info->blkUnitRes);
   taosMemoryFreeClear(info->blkUnits);
+  taosMemoryFreeClear(info->instrs);
+  taosMemoryFreeClear(info->prog);
+  taosMemoryFreeClear(info->selBuf);
 
   for (int32_t i = 0; i < FLD_TYPE_MAX; ++i) {
     for (uint32_t f = 0; f < info->fields[i].num; ++f) {
@@ -2797,6 +2800,138 @@ int32_t filterUpdateComUnits(SFilterInfo *info) {
   return TSDB_CODE_SUCCESS;
 }
 
+// integer units are compiled to a range check on the column values, the other ones are evaluated row by row
+static void filterCompileUnit(SFilterComUnit *cunit, SFilterInstr *instr) {
+  uint8_t type = cunit->dataType;
+  bool    sign = IS_SIGNED_NUMERIC_TYPE(type) || type == TSDB_DATA_TYPE_TIMESTAMP || type == TSDB_DATA_TYPE_BOOL;
+  bool    hasLo = false, hasHi = false, loEx = false, hiEx = false;
+
+  instr->type = FLT_INSTR_GENERIC;
+  instr->negate = false;
+  instr->lo = 0;
+  instr->hi = 0;
+
+  if (cunit->optr == OP_TYPE_IS_NULL) {
+    instr->type = FLT_INSTR_IS_NULL;
+    return;
+  }
+
+  if (cunit->optr == OP_TYPE_IS_NOT_NULL) {
+    instr->type = FLT_INSTR_NOT_NULL;
+    return;
+  }
+
+  if ((!sign && !IS_UNSIGNED_NUMERIC_TYPE(type)) || cunit->valData == NULL || cunit->valData2 == NULL) {
+    return;
+  }
+
+  // the lower bound is valData and the upper one valData2, see gRangeCompare
+  switch (cunit->rfunc) {
+    case 0:
+      hasLo = hasHi = loEx = hiEx = true;
+      break;
+    case 1:
+      hasLo = hasHi = loEx = true;
+      break;
+    case 2:
+      hasLo = hasHi = hiEx = true;
+      break;
+    case 3:
+      hasLo = hasHi = true;
+      break;
+    case 4:
+      hasLo = loEx = true;
+      break;
+    case 5:
+      hasLo = true;
+      break;
+    case 6:
+      hasHi = hiEx = true;
+      break;
+    case 7:
+      hasHi = true;
+      break;
+    default:
+      if (cunit->optr != OP_TYPE_EQUAL && cunit->optr != OP_TYPE_NOT_EQUAL) {
+        return;
+      }
+      hasLo = hasHi = true;
+      instr->negate = (cunit->optr == OP_TYPE_NOT_EQUAL);
+      break;
+  }
+
+  if (sign) {
+    int64_t lo = INT64_MIN, hi = INT64_MAX;
+    if (hasLo) {
+      GET_TYPED_DATA(lo, int64_t, type, cunit->valData);
+    }
+    if (hasHi) {
+      GET_TYPED_DATA(hi, int64_t, type, cunit->valData2);
+    }
+
+    if ((loEx && lo == INT64_MAX) || (hiEx && hi == INT64_MIN)) {
+      instr->type = FLT_INSTR_EMPTY;
+      return;
+    }
+
+    instr->type = FLT_INSTR_INT_RANGE;
+    instr->lo = loEx ? lo + 1 : lo;
+    instr->hi = hiEx ? hi - 1 : hi;
+  } else {
+    uint64_t lo = 0, hi = UINT64_MAX;
+    if (hasLo) {
+      GET_TYPED_DATA(lo, uint64_t, type, cunit->valData);
+    }
+    if (hasHi) {
+      GET_TYPED_DATA(hi, uint64_t, type, cunit->valData2);
+    }
+
+    if ((loEx && lo == UINT64_MAX) || (hiEx && hi == 0)) {
+      instr->type = FLT_INSTR_EMPTY;
+      return;
+    }
+
+    instr->type = FLT_INSTR_UINT_RANGE;
+    instr->lo = (int64_t)(loEx ? lo + 1 : lo);
+    instr->hi = (int64_t)(hiEx ? hi - 1 : hi);
+  }
+}
+
+// The program lists the unit number and the unit indexes of each group, like blkUnits does, with the compiled units of
+// a group ahead of the ones evaluated row by row.
+int32_t filterCompileProg(SFilterInfo *info) {
+  info->instrs = taosMemoryMalloc(sizeof(*info->instrs) * info->unitNum);
+  info->prog = taosMemoryMalloc(sizeof(*info->prog) * (info->unitNum + 1) * info->groupNum);
+  if (NULL == info->instrs || NULL == info->prog) {
+    taosMemoryFreeClear(info->instrs);
+    taosMemoryFreeClear(info->prog);
+    FLT_ERR_RET(TSDB_CODE_OUT_OF_MEMORY);
+  }
+
+  for (uint32_t i = 0; i < info->unitNum; ++i) {
+    filterCompileUnit(&info->cunits[i], &info->instrs[i]);
+  }
+
+  uint32_t *prog = info->prog;
+  for (uint32_t g = 0; g < info->groupNum; ++g) {
+    SFilterGroup *group = &info->groups[g];
+
+    *(prog++) = group->unitNum;
+    for (uint32_t u = 0; u < group->unitNum; ++u) {
+      if (info->instrs[group->unitIdxs[u]].type != FLT_INSTR_GENERIC) {
+        *(prog++) = group->unitIdxs[u];
+      }
+    }
+    for (uint32_t u = 0; u < group->unitNum; ++u) {
+      if (info->instrs[group->unitIdxs[u]].type == FLT_INSTR_GENERIC) {
+        *(prog++) = group->unitIdxs[u];
+      }
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t filterRmUnitByRange(SFilterInfo *info, SColumnDataAgg *pDataStatis, int32_t numOfCols, int32_t numOfRows) {
   int32_t rmUnit = 0;
 
@@ -3047,6 +3182,189 @@ bool filterExecuteBasedOnStatisImpl(void *pinfo, int32_t numOfRows, SColumnInfoD
   return all;
 }
 
+static FORCE_INLINE bool filterExecuteUnit(SFilterComUnit *cunit, int32_t i) {
+  SColumnInfoData *pCol = (SColumnInfoData *)cunit->colData;
+  uint8_t          optr = cunit->optr;
+  bool             res = false;
+
+  if (colDataIsNull(pCol, 0, i, NULL)) {
+    return optr == OP_TYPE_IS_NULL;
+  }
+
+  void *colData = colDataGetData(pCol, i);
+  if (colData == NULL) {
+    return optr == OP_TYPE_IS_NULL;
+  }
+
+  if (optr == OP_TYPE_IS_NOT_NULL) {
+    res = true;
+  } else if (optr == OP_TYPE_IS_NULL) {
+    res = false;
+  } else if (cunit->rfunc >= 0) {
+    res = (*gRangeCompare[cunit->rfunc])(colData, colData, cunit->valData, cunit->valData2, gDataCompare[cunit->func]);
+  } else if (cunit->dataType == TSDB_DATA_TYPE_NCHAR && (optr == OP_TYPE_MATCH || optr == OP_TYPE_NMATCH)) {
+    // match/nmatch for nchar type need convert from ucs4 to mbs
+    char   *newColData = taosMemoryCalloc(cunit->dataSize * TSDB_NCHAR_SIZE + VARSTR_HEADER_SIZE, 1);
+    int32_t len = taosUcs4ToMbs((TdUcs4 *)varDataVal(colData), varDataLen(colData), varDataVal(newColData));
+    if (len < 0) {
+      qError("castConvert1 taosUcs4ToMbs error");
+    } else {
+      varDataSetLen(newColData, len);
+      res = filterDoCompare(gDataCompare[cunit->func], optr, newColData, cunit->valData);
+    }
+    taosMemoryFreeClear(newColData);
+  } else {
+    res = filterDoCompare(gDataCompare[cunit->func], optr, colData, cunit->valData);
+  }
+
+  return res;
+}
+
+#define FLT_SELECT_RANGE(_t, _dt)                                                                         \
+  do {                                                                                                    \
+    const _t *pVal = (const _t *)pCol->pData;                                                             \
+    _dt       lo = (_dt)instr->lo, hi = (_dt)instr->hi;                                                   \
+    for (int32_t k = 0; k < num; ++k) {                                                                   \
+      int32_t r = pSel[k];                                                                                \
+      pSel[n] = r;                                                                                        \
+      n += (((_dt)pVal[r] >= lo && (_dt)pVal[r] <= hi) != instr->negate) && !colDataIsNull(pCol, 0, r, NULL); \
+    }                                                                                                     \
+  } while (0)
+
+// keeps the rows of the selection vector the unit qualifies, in order, and returns their number
+static int32_t filterSelectUnit(SFilterInfo *info, uint32_t uidx, int32_t *pSel, int32_t num) {
+  SFilterInstr    *instr = &info->instrs[uidx];
+  SFilterComUnit  *cunit = &info->cunits[uidx];
+  SColumnInfoData *pCol = (SColumnInfoData *)cunit->colData;
+  int32_t          n = 0;
+
+  switch (instr->type) {
+    case FLT_INSTR_EMPTY:
+      break;
+    case FLT_INSTR_IS_NULL:
+      for (int32_t k = 0; k < num; ++k) {
+        pSel[n] = pSel[k];
+        n += colDataIsNull(pCol, 0, pSel[k], NULL);
+      }
+      break;
+    case FLT_INSTR_NOT_NULL:
+      for (int32_t k = 0; k < num; ++k) {
+        pSel[n] = pSel[k];
+        n += !colDataIsNull(pCol, 0, pSel[k], NULL);
+      }
+      break;
+    case FLT_INSTR_INT_RANGE:
+      switch (cunit->dataType) {
+        case TSDB_DATA_TYPE_BOOL:
+        case TSDB_DATA_TYPE_TINYINT:
+          FLT_SELECT_RANGE(int8_t, int64_t);
+          break;
+        case TSDB_DATA_TYPE_SMALLINT:
+          FLT_SELECT_RANGE(int16_t, int64_t);
+          break;
+        case TSDB_DATA_TYPE_INT:
+          FLT_SELECT_RANGE(int32_t, int64_t);
+          break;
+        default:
+          FLT_SELECT_RANGE(int64_t, int64_t);
+          break;
+      }
+      break;
+    case FLT_INSTR_UINT_RANGE:
+      switch (cunit->dataType) {
+        case TSDB_DATA_TYPE_UTINYINT:
+          FLT_SELECT_RANGE(uint8_t, uint64_t);
+          break;
+        case TSDB_DATA_TYPE_USMALLINT:
+          FLT_SELECT_RANGE(uint16_t, uint64_t);
+          break;
+        case TSDB_DATA_TYPE_UINT:
+          FLT_SELECT_RANGE(uint32_t, uint64_t);
+          break;
+        default:
+          FLT_SELECT_RANGE(uint64_t, uint64_t);
+          break;
+      }
+      break;
+    default:
+      for (int32_t k = 0; k < num; ++k) {
+        pSel[n] = pSel[k];
+        n += filterExecuteUnit(cunit, pSel[k]);
+      }
+      break;
+  }
+
+  return n;
+}
+
+// Runs a program of groups over selection vectors of row ids instead of row by row: the units of a group only look at
+// the rows the previous units of the group kept, and a group only at the rows no previous group qualified. A group
+// stops once it has no row left, and the program once every row qualified.
+static int32_t filterExecuteProg(SFilterInfo *info, const uint32_t *prog, uint32_t groupNum, int32_t numOfRows,
+                                 int8_t *p, int32_t *numOfQualified, bool *all) {
+  if (numOfRows <= 0) {
+    *all = true;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (info->selSize < numOfRows) {
+    int32_t *selBuf = taosMemoryRealloc(info->selBuf, sizeof(int32_t) * numOfRows * 2);
+    if (NULL == selBuf) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    info->selBuf = selBuf;
+    info->selSize = numOfRows;
+  }
+
+  int32_t *pLeft = info->selBuf;
+  int32_t *pSel = info->selBuf + numOfRows;
+  int32_t  nLeft = numOfRows;
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    pLeft[i] = i;
+  }
+  memset(p, 0, numOfRows);
+
+  for (uint32_t g = 0; g < groupNum && nLeft > 0; ++g) {
+    uint32_t unitNum = *(prog++);
+    int32_t  nSel = nLeft;
+
+    memcpy(pSel, pLeft, sizeof(int32_t) * nLeft);
+    for (uint32_t u = 0; u < unitNum && nSel > 0; ++u) {
+      nSel = filterSelectUnit(info, prog[u], pSel, nSel);
+    }
+    prog += unitNum;
+
+    if (nSel == 0) {
+      continue;
+    }
+
+    for (int32_t k = 0; k < nSel; ++k) {
+      p[pSel[k]] = 1;
+    }
+    (*numOfQualified) += nSel;
+
+    if (nSel == nLeft) {
+      nLeft = 0;
+      break;
+    }
+
+    // both lists are ascending
+    int32_t n = 0;
+    for (int32_t k = 0, j = 0; k < nLeft; ++k) {
+      if (j < nSel && pSel[j] == pLeft[k]) {
+        ++j;
+      } else {
+        pLeft[n++] = pLeft[k];
+      }
+    }
+    nLeft = n;
+  }
+
+  *all = (nLeft == 0);
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t filterExecuteBasedOnStatis(SFilterInfo *info, int32_t numOfRows, SColumnInfoData *p, SColumnDataAgg *statis,
                                    int16_t numOfCols, bool *all) {
   if (statis && numOfRows >= FILTER_RM_UNIT_MIN_ROWS) {
@@ -3065,7 +3383,11 @@ int32_t filterExecuteBasedOnStatis(SFilterInfo *info, int32_t numOfRows, SColumn
 
       ASSERT(info->unitNum > 1);
 
-      *all = filterExecuteBasedOnStatisImpl(info, numOfRows, p, statis, numOfCols);
+      int32_t numOfQualified = 0;
+      if (NULL == info->prog || filterExecuteProg(info, info->blkUnits, info->blkGroupNum, numOfRows,
+                                                  (int8_t *)p->pData, &numOfQualified, all) != TSDB_CODE_SUCCESS) {
+        *all = filterExecuteBasedOnStatisImpl(info, numOfRows, p, statis, numOfCols);
+      }
       goto _return;
     }
   }
@@ -3186,6 +3508,15 @@ bool filterExecuteImplMisc(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes
 
   int8_t *p = (int8_t *)pRes->pData;
 
+  // the rows of a dictionary encoded block share the payload of their value, and so the result too
+  SColumnInfoData *pCol = (SColumnInfoData *)info->cunits[info->groups[0].unitIdxs[0]].colData;
+  bool             memo = IS_VAR_DATA_TYPE(pCol->info.type) && pCol->fromDict;
+  int32_t          memoOffset[FILTER_MEMO_SIZE];
+  int8_t           memoRes[FILTER_MEMO_SIZE];
+  if (memo) {
+    memset(memoOffset, 0xff, sizeof(memoOffset));
+  }
+
   for (int32_t i = 0; i < numOfRows; ++i) {
     uint32_t uidx = info->groups[0].unitIdxs[0];
     if (colDataIsNull_s((SColumnInfoData *)info->cunits[uidx].colData, i)) {
@@ -3194,6 +3525,20 @@ bool filterExecuteImplMisc(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes
       continue;
     }
 
+    uint32_t slot = 0;
+    if (memo) {
+      slot = ((uint32_t)pCol->varmeta.offset[i] * 2654435761u) >> (32 - FILTER_MEMO_BITS);
+      if (memoOffset[slot] == pCol->varmeta.offset[i]) {
+        p[i] = memoRes[slot];
+        if (p[i] == 0) {
+          all = false;
+        } else {
+          (*numOfQualified) += 1;
+        }
+        continue;
+      }
+    }
+
     void *colData = colDataGetData((SColumnInfoData *)info->cunits[uidx].colData, i);
     // match/nmatch for nchar type need convert from ucs4 to mbs
     if (info->cunits[uidx].dataType == TSDB_DATA_TYPE_NCHAR &&
@@ -3213,6 +3558,11 @@ bool filterExecuteImplMisc(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes
                              info->cunits[uidx].valData);
     }
 
+    if (memo) {
+      memoOffset[slot] = pCol->varmeta.offset[i];
+      memoRes[slot] = p[i];
+    }
+
     if (p[i] == 0) {
       all = false;
     } else {
@@ -3235,55 +3585,12 @@ bool filterExecuteImpl(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SC
   int8_t *p = (int8_t *)pRes->pData;
 
   for (int32_t i = 0; i < numOfRows; ++i) {
-    // FILTER_UNIT_CLR_F(info);
+    p[i] = 0;
 
     for (uint32_t g = 0; g < info->groupNum; ++g) {
       SFilterGroup *group = &info->groups[g];
       for (uint32_t u = 0; u < group->unitNum; ++u) {
-        uint32_t        uidx = group->unitIdxs[u];
-        SFilterComUnit *cunit = &info->cunits[uidx];
-        void           *colData = NULL;
-        bool            isNull = colDataIsNull((SColumnInfoData *)(cunit->colData), 0, i, NULL);
-        // if (FILTER_UNIT_GET_F(info, uidx)) {
-        //   p[i] = FILTER_UNIT_GET_R(info, uidx);
-        // } else {
-        uint8_t optr = cunit->optr;
-
-        if (!isNull) {
-          colData = colDataGetData((SColumnInfoData *)(cunit->colData), i);
-        }
-
-        if (colData == NULL || isNull) {
-          p[i] = optr == OP_TYPE_IS_NULL ? true : false;
-        } else {
-          if (optr == OP_TYPE_IS_NOT_NULL) {
-            p[i] = 1;
-          } else if (optr == OP_TYPE_IS_NULL) {
-            p[i] = 0;
-          } else if (cunit->rfunc >= 0) {
-            p[i] = (*gRangeCompare[cunit->rfunc])(colData, colData, cunit->valData, cunit->valData2,
-                                                  gDataCompare[cunit->func]);
-          } else {
-            if (cunit->dataType == TSDB_DATA_TYPE_NCHAR &&
-                (cunit->optr == OP_TYPE_MATCH || cunit->optr == OP_TYPE_NMATCH)) {
-              char   *newColData = taosMemoryCalloc(cunit->dataSize * TSDB_NCHAR_SIZE + VARSTR_HEADER_SIZE, 1);
-              int32_t len = taosUcs4ToMbs((TdUcs4 *)varDataVal(colData), varDataLen(colData), varDataVal(newColData));
-              if (len < 0) {
-                qError("castConvert1 taosUcs4ToMbs error");
-              } else {
-                varDataSetLen(newColData, len);
-                p[i] = filterDoCompare(gDataCompare[cunit->func], cunit->optr, newColData, cunit->valData);
-              }
-              taosMemoryFreeClear(newColData);
-            } else {
-              p[i] = filterDoCompare(gDataCompare[cunit->func], cunit->optr, colData, cunit->valData);
-            }
-          }
-
-          // FILTER_UNIT_SET_R(info, uidx, p[i]);
-          // FILTER_UNIT_SET_F(info, uidx);
-        }
-
+        p[i] = filterExecuteUnit(&info->cunits[group->unitIdxs[u]], i);
         if (p[i] == 0) {
           break;
         }
@@ -3304,6 +3611,23 @@ bool filterExecuteImpl(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SC
   return all;
 }
 
+bool filterExecuteImplProg(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
+                           int16_t numOfCols, int32_t *numOfQualified) {
+  SFilterInfo *info = (SFilterInfo *)pinfo;
+  bool         all = true;
+
+  if (filterExecuteBasedOnStatis(info, numOfRows, pRes, statis, numOfCols, &all) == 0) {
+    return all;
+  }
+
+  if (filterExecuteProg(info, info->prog, info->groupNum, numOfRows, (int8_t *)pRes->pData, numOfQualified, &all) !=
+      TSDB_CODE_SUCCESS) {
+    return filterExecuteImpl(pinfo, numOfRows, pRes, NULL, numOfCols, numOfQualified);
+  }
+
+  return all;
+}
+
 int32_t filterSetExecFunc(SFilterInfo *info) {
   if (FILTER_ALL_RES(info)) {
     info->func = filterExecuteImplAll;
@@ -3316,7 +3640,7 @@ int32_t filterSetExecFunc(SFilterInfo *info) {
   }
 
   if (info->unitNum > 1) {
-    info->func = filterExecuteImpl;
+    info->func = info->prog ? filterExecuteImplProg : filterExecuteImpl;
     return TSDB_CODE_SUCCESS;
   }
 
@@ -3330,6 +3654,11 @@ int32_t filterSetExecFunc(SFilterInfo *info) {
     return TSDB_CODE_SUCCESS;
   }
 
+  if (info->prog && info->instrs[0].type != FLT_INSTR_GENERIC) {
+    info->func = filterExecuteImplProg;
+    return TSDB_CODE_SUCCESS;
+  }
+
   if (info->cunits[0].rfunc >= 0) {
     info->func = filterExecuteImplRange;
     return TSDB_CODE_SUCCESS;
@@ -3368,6 +3697,8 @@ int32_t filterPreprocess(SFilterInfo *info) {
 
   FLT_ERR_JRET(filterGenerateComInfo(info));
 
+  FLT_ERR_JRET(filterCompileProg(info));
+
 _return:
 
   filterSetExecFunc(info);
@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Kernels of the arithmetic and comparison operators for each pair of fixed length types. The loops read both
+// operands with their own types, so the compiler can vectorize them, and the nulls of the operands are merged from
+// the null bitmaps afterwards. The var and json types keep the per row path of sclvector.c.
+
+#include "os.h"
+
+#include "function.h"
+#include "querynodes.h"
+#include "sclInt.h"
+#include "sclvector.h"
+#include "tcompare.h"
+#include "tdatablock.h"
+
+#define SCL_KERNEL_TYPE_NUM (TSDB_DATA_TYPE_UBIGINT + 1)
+
+// type name, c type, compare kind: S signed, U unsigned, F floating
+#define SCL_LEFT_TYPES(_, ...)          \
+  _(BOOL, bool, U, __VA_ARGS__)         \
+  _(TINYINT, int8_t, S, __VA_ARGS__)    \
+  _(SMALLINT, int16_t, S, __VA_ARGS__)  \
+  _(INT, int32_t, S, __VA_ARGS__)       \
+  _(BIGINT, int64_t, S, __VA_ARGS__)    \
+  _(FLOAT, float, F, __VA_ARGS__)       \
+  _(DOUBLE, double, F, __VA_ARGS__)     \
+  _(TIMESTAMP, int64_t, S, __VA_ARGS__) \
+  _(UTINYINT, uint8_t, U, __VA_ARGS__)  \
+  _(USMALLINT, uint16_t, U, __VA_ARGS__) \
+  _(UINT, uint32_t, U, __VA_ARGS__)     \
+  _(UBIGINT, uint64_t, U, __VA_ARGS__)
+
+// the same list, to nest the pairs
+#define SCL_RIGHT_TYPES(_, ...)         \
+  _(BOOL, bool, U, __VA_ARGS__)         \
+  _(TINYINT, int8_t, S, __VA_ARGS__)    \
+  _(SMALLINT, int16_t, S, __VA_ARGS__)  \
+  _(INT, int32_t, S, __VA_ARGS__)       \
+  _(BIGINT, int64_t, S, __VA_ARGS__)    \
+  _(FLOAT, float, F, __VA_ARGS__)       \
+  _(DOUBLE, double, F, __VA_ARGS__)     \
+  _(TIMESTAMP, int64_t, S, __VA_ARGS__) \
+  _(UTINYINT, uint8_t, U, __VA_ARGS__)  \
+  _(USMALLINT, uint16_t, U, __VA_ARGS__) \
+  _(UINT, uint32_t, U, __VA_ARGS__)     \
+  _(UBIGINT, uint64_t, U, __VA_ARGS__)
+
+typedef void (*_sclArithKernel_fn_t)(int32_t optr, const void *pLeft, bool lConst, const void *pRight, bool rConst,
+                                     double *pOut, int32_t numOfRows);
+typedef void (*_sclCompareKernel_fn_t)(bool equal, const void *pLeft, bool lConst, const void *pRight, bool rConst,
+                                       bool *pOut, int32_t start, int32_t end);
+typedef void (*_sclZeroKernel_fn_t)(const void *pData, SColumnInfoData *pOutputCol, int32_t numOfRows);
+
+// arithmetic ================================================================================================
+// in double, like getVectorDoubleValueFn
+#define SCL_ARITH_LOOPS(OP)                                                    \
+  do {                                                                         \
+    if (lConst) {                                                              \
+      double lv = (double)l[0];                                                \
+      for (int32_t i = 0; i < numOfRows; ++i) pOut[i] = lv OP(double) r[i];    \
+    } else if (rConst) {                                                       \
+      double rv = (double)r[0];                                                \
+      for (int32_t i = 0; i < numOfRows; ++i) pOut[i] = (double)l[i] OP rv;    \
+    } else {                                                                   \
+      for (int32_t i = 0; i < numOfRows; ++i) pOut[i] = (double)l[i] OP(double) r[i]; \
+    }                                                                          \
+  } while (0)
+
+#define SCL_DEF_ARITH(LN, LT, RN, RT)                                                                              \
+  static void sclArith_##LN##_##RN(int32_t optr, const void *pLeft, bool lConst, const void *pRight, bool rConst, \
+                                   double *pOut, int32_t numOfRows) {                                              \
+    const LT *l = (const LT *)pLeft;                                                                               \
+    const RT *r = (const RT *)pRight;                                                                              \
+    switch (optr) {                                                                                                \
+      case OP_TYPE_ADD:                                                                                            \
+        SCL_ARITH_LOOPS(+);                                                                                        \
+        break;                                                                                                     \
+      case OP_TYPE_SUB:                                                                                            \
+        SCL_ARITH_LOOPS(-);                                                                                        \
+        break;                                                                                                     \
+      case OP_TYPE_MULTI:                                                                                          \
+        SCL_ARITH_LOOPS(*);                                                                                        \
+        break;                                                                                                     \
+      case OP_TYPE_DIV:                                                                                            \
+        SCL_ARITH_LOOPS(/);                                                                                        \
+        break;                                                                                                     \
+      default:                                                                                                     \
+        ASSERT(0);                                                                                                 \
+    }                                                                                                              \
+  }
+
+// comparison ================================================================================================
+// a < b and a == b of each pair of kinds, the same as the compare functions filterGetCompFunc(Ex) picks: floating
+// pairs are nan aware and equal within FLT_EQUAL, a negative signed value is less than any unsigned one, and the
+// other pairs compare with the usual conversions
+#define SCL_LT_S_S(a, b) ((a) < (b))
+#define SCL_LT_U_U(a, b) ((a) < (b))
+#define SCL_LT_S_U(a, b) ((a) < 0 || (uint64_t)(a) < (uint64_t)(b))
+#define SCL_LT_U_S(a, b) ((b) >= 0 && (uint64_t)(a) < (uint64_t)(b))
+#define SCL_LT_S_F(a, b) ((a) < (b))
+#define SCL_LT_U_F(a, b) ((a) < (b))
+#define SCL_LT_F_S(a, b) ((a) < (b))
+#define SCL_LT_F_U(a, b) ((a) < (b))
+#define SCL_LT_F_F(a, b) ((isnan(a) && !isnan(b)) || (!FLT_EQUAL(a, b) && (a) < (b)))
+
+#define SCL_EQ_S_S(a, b) ((a) == (b))
+#define SCL_EQ_U_U(a, b) ((a) == (b))
+#define SCL_EQ_S_U(a, b) ((a) >= 0 && (uint64_t)(a) == (uint64_t)(b))
+#define SCL_EQ_U_S(a, b) ((b) >= 0 && (uint64_t)(a) == (uint64_t)(b))
+#define SCL_EQ_S_F(a, b) (!((a) < (b) || (a) > (b)))
+#define SCL_EQ_U_F(a, b) (!((a) < (b) || (a) > (b)))
+#define SCL_EQ_F_S(a, b) (!((a) < (b) || (a) > (b)))
+#define SCL_EQ_F_U(a, b) (!((a) < (b) || (a) > (b)))
+#define SCL_EQ_F_F(a, b) ((isnan(a) && isnan(b)) || FLT_EQUAL(a, b))
+
+#define SCL_COMPARE_LOOPS(CMP, LT, RT)                                             \
+  do {                                                                       \
+    if (lConst) {                                                            \
+      LT lv = l[0];                                                          \
+      for (int32_t i = start; i < end; ++i) pOut[i] = CMP(lv, r[i]);         \
+    } else if (rConst) {                                                     \
+      RT rv = r[0];                                                          \
+      for (int32_t i = start; i < end; ++i) pOut[i] = CMP(l[i], rv);         \
+    } else {                                                                 \
+      for (int32_t i = start; i < end; ++i) pOut[i] = CMP(l[i], r[i]);       \
+    }                                                                        \
+  } while (0)
+
+#define SCL_DEF_COMPARE(LN, LT, LK, RN, RT, RK)                                                                  \
+  static void sclCompare_##LN##_##RN(bool equal, const void *pLeft, bool lConst, const void *pRight, bool rConst, \
+                                     bool *pOut, int32_t start, int32_t end) {                                  \
+    const LT *l = (const LT *)pLeft;                                                                            \
+    const RT *r = (const RT *)pRight;                                                                           \
+    if (equal) {                                                                                                \
+      SCL_COMPARE_LOOPS(SCL_EQ_##LK##_##RK, LT, RT);                                                               \
+    } else {                                                                                                    \
+      SCL_COMPARE_LOOPS(SCL_LT_##LK##_##RK, LT, RT);                                                               \
+    }                                                                                                           \
+  }
+
+// the kernels of each pair and their tables
+#define SCL_DEF_PAIR(RN, RT, RK, LN, LT, LK) \
+  SCL_DEF_ARITH(LN, LT, RN, RT)              \
+  SCL_DEF_COMPARE(LN, LT, LK, RN, RT, RK)
+#define SCL_DEF_PAIRS(LN, LT, LK, ...) SCL_RIGHT_TYPES(SCL_DEF_PAIR, LN, LT, LK)
+SCL_LEFT_TYPES(SCL_DEF_PAIRS, 0)
+
+#define SCL_ARITH_ENTRY(RN, RT, RK, LN)        [TSDB_DATA_TYPE_##LN][TSDB_DATA_TYPE_##RN] = sclArith_##LN##_##RN,
+#define SCL_ARITH_ENTRIES(LN, LT, LK, ...)     SCL_RIGHT_TYPES(SCL_ARITH_ENTRY, LN)
+#define SCL_COMPARE_ENTRY(RN, RT, RK, LN)      [TSDB_DATA_TYPE_##LN][TSDB_DATA_TYPE_##RN] = sclCompare_##LN##_##RN,
+#define SCL_COMPARE_ENTRIES(LN, LT, LK, ...)   SCL_RIGHT_TYPES(SCL_COMPARE_ENTRY, LN)
+
+static const _sclArithKernel_fn_t sclArithKernels[SCL_KERNEL_TYPE_NUM][SCL_KERNEL_TYPE_NUM] = {
+    SCL_LEFT_TYPES(SCL_ARITH_ENTRIES, 0)};
+static const _sclCompareKernel_fn_t sclCompareKernels[SCL_KERNEL_TYPE_NUM][SCL_KERNEL_TYPE_NUM] = {
+    SCL_LEFT_TYPES(SCL_COMPARE_ENTRIES, 0)};
+
+// divisors of zero give null
+#define SCL_DEF_ZERO(N, T, K, ...)                                                                  \
+  static void sclZero_##N(const void *pData, SColumnInfoData *pOutputCol, int32_t numOfRows) {     \
+    const T *p = (const T *)pData;                                                                 \
+    for (int32_t i = 0; i < numOfRows; ++i) {                                                      \
+      if ((double)p[i] == 0) {                                                                     \
+        colDataSetNULL(pOutputCol, i);                                                             \
+      }                                                                                            \
+    }                                                                                              \
+  }
+SCL_LEFT_TYPES(SCL_DEF_ZERO, 0)
+
+#define SCL_ZERO_ENTRY(N, T, K, ...) [TSDB_DATA_TYPE_##N] = sclZero_##N,
+static const _sclZeroKernel_fn_t sclZeroKernels[SCL_KERNEL_TYPE_NUM] = {SCL_LEFT_TYPES(SCL_ZERO_ENTRY, 0)};
+
+// nulls =====================================================================================================
+static FORCE_INLINE bool sclKernelType(int32_t type) {
+  return type >= 0 && type < SCL_KERNEL_TYPE_NUM && sclArithKernels[type][type] != NULL;
+}
+
+static FORCE_INLINE const uint8_t *sclKernelNullBitmap(SColumnInfoData *pCol) {
+  return (pCol->hasNull && pCol->nullbitmap != NULL) ? (const uint8_t *)pCol->nullbitmap : NULL;
+}
+
+// the null rows of a column operand, or of none if the operand is a constant, of byte iByte of the bitmaps
+static FORCE_INLINE uint8_t sclKernelNullByte(const uint8_t *pLeftBitmap, const uint8_t *pRightBitmap,
+                                              int32_t iByte) {
+  return (pLeftBitmap ? pLeftBitmap[iByte] : 0) | (pRightBitmap ? pRightBitmap[iByte] : 0);
+}
+
+// rows [start, end) whose bit is set in byte iByte of a bitmap
+#define SCL_FOREACH_NULL_ROW(BYTE, I_BYTE, START, END, ROW)                                        \
+  for (int32_t ROW = TMAX((I_BYTE) << NBIT, (START)); ROW < TMIN(((I_BYTE) + 1) << NBIT, (END)); ++ROW) \
+    if ((BYTE) & (1u << (7u - BitPos(ROW))))
+
+static void sclKernelArithNull(SColumnInfoData *pOutputCol, const uint8_t *pLeftBitmap, const uint8_t *pRightBitmap,
+                               int32_t numOfRows) {
+  if (pLeftBitmap == NULL && pRightBitmap == NULL) return;
+
+  for (int32_t iByte = 0; iByte < BitmapLen(numOfRows); ++iByte) {
+    uint8_t nulls = sclKernelNullByte(pLeftBitmap, pRightBitmap, iByte);
+    if (nulls == 0) continue;
+
+    SCL_FOREACH_NULL_ROW(nulls, iByte, 0, numOfRows, row) { colDataSetNULL(pOutputCol, row); }
+  }
+}
+
+// exported ==================================================================================================
+bool sclKernelArith(int32_t optr, SColumnInfoData *pLeftCol, int32_t leftRows, SColumnInfoData *pRightCol,
+                    int32_t rightRows, SColumnInfoData *pOutputCol, int32_t numOfRows) {
+  int32_t lType = pLeftCol->info.type;
+  int32_t rType = pRightCol->info.type;
+
+  if (!sclKernelType(lType) || !sclKernelType(rType) || pOutputCol->info.type != TSDB_DATA_TYPE_DOUBLE) {
+    return false;
+  }
+  if (leftRows != rightRows && leftRows != 1 && rightRows != 1) {
+    return false;
+  }
+
+  bool lConst = (leftRows == 1);
+  bool rConst = (rightRows == 1);
+  if ((lConst && colDataIsNull_s(pLeftCol, 0)) || (rConst && colDataIsNull_s(pRightCol, 0)) ||
+      (rConst && optr == OP_TYPE_DIV && getVectorDoubleValueFn(rType)(pRightCol->pData, 0) == 0)) {
+    colDataSetNNULL(pOutputCol, 0, numOfRows);
+    return true;
+  }
+
+  sclArithKernels[lType][rType](optr, pLeftCol->pData, lConst, pRightCol->pData, rConst,
+                                (double *)pOutputCol->pData, numOfRows);
+
+  sclKernelArithNull(pOutputCol, lConst ? NULL : sclKernelNullBitmap(pLeftCol),
+                     rConst ? NULL : sclKernelNullBitmap(pRightCol), numOfRows);
+  if (optr == OP_TYPE_DIV && !rConst) {
+    sclZeroKernels[rType](pRightCol->pData, pOutputCol, numOfRows);
+  }
+
+  return true;
+}
+
+int32_t sclKernelCompare(int32_t optr, SColumnInfoData *pLeftCol, int32_t leftRows, SColumnInfoData *pRightCol,
+                         int32_t rightRows, bool *pRes, int32_t start, int32_t end) {
+  int32_t lType = pLeftCol->info.type;
+  int32_t rType = pRightCol->info.type;
+
+  if (!sclKernelType(lType) || !sclKernelType(rType)) {
+    return -1;
+  }
+  if ((leftRows != 1 && leftRows < end) || (rightRows != 1 && rightRows < end)) {
+    return -1;
+  }
+
+  bool lConst = (leftRows == 1);
+  bool rConst = (rightRows == 1);
+
+  // a > b is b < a, a >= b is !(a < b), a <= b is !(b < a) and a != b is !(a == b)
+  bool equal = (optr == OP_TYPE_EQUAL || optr == OP_TYPE_NOT_EQUAL);
+  bool swap = (optr == OP_TYPE_GREATER_THAN || optr == OP_TYPE_LOWER_EQUAL);
+  bool invert = (optr == OP_TYPE_GREATER_EQUAL || optr == OP_TYPE_LOWER_EQUAL || optr == OP_TYPE_NOT_EQUAL);
+  switch (optr) {
+    case OP_TYPE_GREATER_THAN:
+    case OP_TYPE_GREATER_EQUAL:
+    case OP_TYPE_LOWER_THAN:
+    case OP_TYPE_LOWER_EQUAL:
+    case OP_TYPE_EQUAL:
+    case OP_TYPE_NOT_EQUAL:
+      break;
+    default:
+      return -1;
+  }
+
+  if (swap) {
+    sclCompareKernels[rType][lType](equal, pRightCol->pData, rConst, pLeftCol->pData, lConst, pRes, start, end);
+  } else {
+    sclCompareKernels[lType][rType](equal, pLeftCol->pData, lConst, pRightCol->pData, rConst, pRes, start, end);
+  }
+  if (invert) {
+    for (int32_t i = start; i < end; ++i) pRes[i] = !pRes[i];
+  }
+
+  // null operands give false
+  if ((lConst && colDataIsNull_s(pLeftCol, 0)) || (rConst && colDataIsNull_s(pRightCol, 0))) {
+    memset(pRes + start, 0, end - start);
+    return 0;
+  }
+
+  const uint8_t *pLeftBitmap = lConst ? NULL : sclKernelNullBitmap(pLeftCol);
+  const uint8_t *pRightBitmap = rConst ? NULL : sclKernelNullBitmap(pRightCol);
+  if (pLeftBitmap != NULL || pRightBitmap != NULL) {
+    for (int32_t iByte = start >> NBIT; iByte < BitmapLen(end); ++iByte) {
+      uint8_t nulls = sclKernelNullByte(pLeftBitmap, pRightBitmap, iByte);
+      if (nulls == 0) continue;
+
+      SCL_FOREACH_NULL_ROW(nulls, iByte, start, end, row) { pRes[row] = false; }
+    }
+  }
+
+  int32_t num = 0;
+  for (int32_t i = start; i < end; ++i) num += pRes[i];
+  return num;
+}
@@ -15,6 +15,7 @@
 
 #include <gtest/gtest.h>
 #include <iostream>
+#include <vector>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wwrite-strings"
@@ -345,6 +346,245 @@ TEST(timerangeTest, greater_and_lower_not_strict) {
   nodesDestroyNode(logicNode1);
 }
 
+TEST(columnTest, int_columns_and_or_is_null) {
+  SNode       *pcol = NULL, *pval = NULL, *opNode1 = NULL, *opNode2 = NULL, *opNode3 = NULL, *logicNode = NULL;
+  SSDataBlock *src = NULL;
+  int32_t      av[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}, bv[10] = {0, 9, 8, 7, 6, 5, 4, 9, 2, 1};
+  int32_t      v2 = 2, v5 = 5, v8 = 8;
+  int8_t       eRes[10] = {1, 0, 0, 0, 0, 1, 1, 1, 1, 1};
+  SNode       *list[3] = {0};
+  int32_t      rowNum = sizeof(av) / sizeof(av[0]);
+
+  // (a > 2 and b <= 5) or a = 8 or b is null
+  flttMakeColumnNode(&pcol, &src, TSDB_DATA_TYPE_INT, sizeof(int32_t), rowNum, av);
+  flttMakeValueNode(&pval, TSDB_DATA_TYPE_INT, &v2);
+  flttMakeOpNode(&opNode1, OP_TYPE_GREATER_THAN, TSDB_DATA_TYPE_BOOL, pcol, pval);
+  flttMakeColumnNode(&pcol, NULL, TSDB_DATA_TYPE_INT, sizeof(int32_t), 0, NULL);
+  ((SColumnNode *)pcol)->slotId = 3;
+  ((SColumnNode *)pcol)->colId = 4;
+  flttMakeValueNode(&pval, TSDB_DATA_TYPE_INT, &v5);
+  flttMakeOpNode(&opNode2, OP_TYPE_LOWER_EQUAL, TSDB_DATA_TYPE_BOOL, pcol, pval);
+  list[0] = opNode1;
+  list[1] = opNode2;
+  flttMakeLogicNode(&opNode1, LOGIC_COND_TYPE_AND, list, 2);
+
+  flttMakeColumnNode(&pcol, NULL, TSDB_DATA_TYPE_INT, sizeof(int32_t), 0, NULL);
+  flttMakeValueNode(&pval, TSDB_DATA_TYPE_INT, &v8);
+  flttMakeOpNode(&opNode2, OP_TYPE_EQUAL, TSDB_DATA_TYPE_BOOL, pcol, pval);
+
+  flttMakeColumnNode(&pcol, NULL, TSDB_DATA_TYPE_INT, sizeof(int32_t), 0, NULL);
+  ((SColumnNode *)pcol)->slotId = 3;
+  ((SColumnNode *)pcol)->colId = 4;
+  flttMakeOpNode(&opNode3, OP_TYPE_IS_NULL, TSDB_DATA_TYPE_BOOL, pcol, NULL);
+
+  list[0] = opNode1;
+  list[1] = opNode2;
+  list[2] = opNode3;
+  flttMakeLogicNode(&logicNode, LOGIC_COND_TYPE_OR, list, 3);
+
+  SColumnInfoData bcol = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 4);
+  colInfoDataEnsureCapacity(&bcol, rowNum, true);
+  colDataSetNULL(&bcol, 0);
+  for (int32_t i = 1; i < rowNum; ++i) {
+    colDataSetVal(&bcol, i, (const char *)&bv[i], false);
+  }
+  blockDataAppendColInfo(src, &bcol);
+
+  SFilterInfo *filter = NULL;
+  int32_t      code = filterInitFromNode(logicNode, &filter, 0);
+  ASSERT_EQ(code, 0);
+
+  SFilterColumnParam param = {(int32_t)taosArrayGetSize(src->pDataBlock), src->pDataBlock};
+  code = filterSetDataFromSlotId(filter, &param);
+  ASSERT_EQ(code, 0);
+
+  SColumnInfoData *pRes = NULL;
+  int32_t          status = 0;
+  code = filterExecute(filter, src, &pRes, NULL, (int16_t)taosArrayGetSize(src->pDataBlock), &status);
+  ASSERT_EQ(code, 0);
+  ASSERT_EQ(status, FILTER_RESULT_PARTIAL_QUALIFIED);
+
+  for (int32_t i = 0; i < rowNum; ++i) {
+    ASSERT_EQ(*((int8_t *)pRes->pData + i), eRes[i]);
+  }
+
+  colDataDestroy(pRes);
+  taosMemoryFree(pRes);
+  filterFreeInfo(filter);
+  nodesDestroyNode(logicNode);
+  blockDataDestroy(src);
+}
+
+int32_t flttVarBytes(int8_t type) { return (type == TSDB_DATA_TYPE_NCHAR) ? 16 * TSDB_NCHAR_SIZE : 16; }
+
+// the value of a row of the blocks below, NULL for every 7th row
+const char *flttDictValue(int32_t i, char *buf) {
+  if (i % 7 == 3) {
+    return NULL;
+  }
+  sprintf(buf, "v%02d", (i * 37 + i / 13) % 100);
+  return buf;
+}
+
+// a binary or nchar column of rows picking from 100 values, every 7th row null; with shareDict the rows of the same
+// value point at one payload, as those of a dictionary encoded block do
+SSDataBlock *flttMakeDictBlock(int32_t rowNum, bool shareDict, int8_t type = TSDB_DATA_TYPE_BINARY) {
+  SSDataBlock    *pBlock = createDataBlock();
+  SColumnInfoData idata = createColumnInfoData(type, flttVarBytes(type), 1);
+  blockDataAppendColInfo(pBlock, &idata);
+  blockDataEnsureCapacity(pBlock, rowNum);
+
+  SColumnInfoData *pCol = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0);
+  int32_t          dictOffset[100];
+  char             val[16 * TSDB_NCHAR_SIZE + VARSTR_HEADER_SIZE];
+  char             buf[16];
+  memset(dictOffset, 0xff, sizeof(dictOffset));
+  for (int32_t i = 0; i < rowNum; ++i) {
+    const char *v = flttDictValue(i, buf);
+    if (v == NULL) {
+      colDataSetNULL(pCol, i);
+      continue;
+    }
+
+    int32_t iDict = atoi(v + 1);
+    if (shareDict && dictOffset[iDict] >= 0) {
+      pCol->varmeta.offset[i] = dictOffset[iDict];
+      continue;
+    }
+
+    if (type == TSDB_DATA_TYPE_NCHAR) {
+      int32_t len = 0;
+      EXPECT_TRUE(taosMbsToUcs4(v, strlen(v), (TdUcs4 *)varDataVal(val), 16 * TSDB_NCHAR_SIZE, &len));
+      varDataSetLen(val, len);
+    } else {
+      varDataSetLen(val, sprintf(varDataVal(val), "%s", v));
+    }
+    colDataSetVal(pCol, i, val, false);
+    dictOffset[iDict] = pCol->varmeta.offset[i];
+  }
+
+  pCol->fromDict = shareDict;
+  pBlock->info.rows = rowNum;
+  return pBlock;
+}
+
+void flttExecuteOnDictBlock(EOperatorType optr, const char *pattern, SSDataBlock *pBlock, std::vector<int8_t> &result) {
+  SNode *pcol = NULL, *pval = NULL, *opNode = NULL;
+  char   rightv[32] = {0};
+  int8_t type = ((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0))->info.type;
+
+  flttMakeColumnNode(&pcol, NULL, type, flttVarBytes(type), 0, NULL);
+  ((SColumnNode *)pcol)->slotId = 0;
+  ((SColumnNode *)pcol)->colId = 1;
+  varDataSetLen(rightv, sprintf(varDataVal(rightv), "%s", pattern));
+  flttMakeValueNode(&pval, TSDB_DATA_TYPE_BINARY, rightv);
+  ((SValueNode *)pval)->node.resType.bytes = varDataTLen(rightv);
+  flttMakeOpNode(&opNode, optr, TSDB_DATA_TYPE_BOOL, pcol, pval);
+
+  SFilterInfo *filter = NULL;
+  int32_t      code = filterInitFromNode(opNode, &filter, 0);
+  ASSERT_EQ(code, 0);
+
+  SFilterColumnParam param = {(int32_t)taosArrayGetSize(pBlock->pDataBlock), pBlock->pDataBlock};
+  code = filterSetDataFromSlotId(filter, &param);
+  ASSERT_EQ(code, 0);
+
+  SColumnInfoData *pRes = NULL;
+  int32_t          status = 0;
+  code = filterExecute(filter, pBlock, &pRes, NULL, (int16_t)taosArrayGetSize(pBlock->pDataBlock), &status);
+  ASSERT_EQ(code, 0);
+
+  result.assign((int8_t *)pRes->pData, (int8_t *)pRes->pData + pBlock->info.rows);
+
+  colDataDestroy(pRes);
+  taosMemoryFree(pRes);
+  filterFreeInfo(filter);
+  nodesDestroyNode(opNode);
+}
+
+TEST(columnTest, binary_column_shared_payload) {
+  int32_t      rowNum = 4000;
+  SSDataBlock *pShared = flttMakeDictBlock(rowNum, true);
+  SSDataBlock *pCopied = flttMakeDictBlock(rowNum, false);
+
+  struct {
+    EOperatorType optr;
+    const char   *pattern;
+  } cases[] = {{OP_TYPE_EQUAL, "v42"}, {OP_TYPE_NOT_EQUAL, "v07"}, {OP_TYPE_LIKE, "v1%"},
+               {OP_TYPE_NOT_LIKE, "%5"}, {OP_TYPE_MATCH, "v[2-4]3"}, {OP_TYPE_GREATER_THAN, "v50"}};
+
+  for (int32_t c = 0; c < sizeof(cases) / sizeof(cases[0]); ++c) {
+    std::vector<int8_t> sharedRes, copiedRes;
+    flttExecuteOnDictBlock(cases[c].optr, cases[c].pattern, pShared, sharedRes);
+    flttExecuteOnDictBlock(cases[c].optr, cases[c].pattern, pCopied, copiedRes);
+    ASSERT_EQ(sharedRes.size(), rowNum);
+    ASSERT_EQ(copiedRes.size(), rowNum);
+
+    int32_t numOfQualified = 0;
+    for (int32_t i = 0; i < rowNum; ++i) {
+      ASSERT_EQ(sharedRes[i], copiedRes[i]) << "case " << c << " row " << i;
+      numOfQualified += sharedRes[i];
+      if (i % 7 == 3) {
+        ASSERT_EQ(sharedRes[i], 0);
+      }
+    }
+    ASSERT_GT(numOfQualified, 0) << "case " << c;
+    ASSERT_LT(numOfQualified, rowNum) << "case " << c;
+  }
+
+  // spot check against the values themselves
+  std::vector<int8_t> res;
+  flttExecuteOnDictBlock(OP_TYPE_EQUAL, "v42", pShared, res);
+  SColumnInfoData *pCol = (SColumnInfoData *)taosArrayGet(pShared->pDataBlock, 0);
+  for (int32_t i = 0; i < rowNum; ++i) {
+    bool expect = !colDataIsNull_s(pCol, i) && varDataLen(colDataGetData(pCol, i)) == 3 &&
+                  memcmp(varDataVal(colDataGetData(pCol, i)), "v42", 3) == 0;
+    ASSERT_EQ(res[i], expect) << "row " << i;
+  }
+
+  blockDataDestroy(pShared);
+  blockDataDestroy(pCopied);
+}
+
+// the blocks not from a dictionary, each row with a payload of its own, against the values themselves
+TEST(columnTest, binary_and_nchar_column_plain) {
+  int32_t rowNum = 2000;
+
+  struct {
+    EOperatorType optr;
+    const char   *pattern;
+    bool (*expect)(const char *v);
+  } cases[] = {
+      {OP_TYPE_EQUAL, "v42", [](const char *v) { return strcmp(v, "v42") == 0; }},
+      {OP_TYPE_NOT_EQUAL, "v07", [](const char *v) { return strcmp(v, "v07") != 0; }},
+      {OP_TYPE_LIKE, "v1%", [](const char *v) { return strncmp(v, "v1", 2) == 0; }},
+      {OP_TYPE_NOT_LIKE, "%5", [](const char *v) { return v[strlen(v) - 1] != '5'; }},
+      {OP_TYPE_MATCH, "v[2-4]3", [](const char *v) { return v[1] >= '2' && v[1] <= '4' && v[2] == '3'; }},
+      {OP_TYPE_GREATER_THAN, "v50", [](const char *v) { return strcmp(v, "v50") > 0; }},
+  };
+
+  int8_t types[] = {TSDB_DATA_TYPE_BINARY, TSDB_DATA_TYPE_NCHAR};
+  for (int8_t type : types) {
+    SSDataBlock *pBlock = flttMakeDictBlock(rowNum, false, type);
+    ASSERT_FALSE(((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0))->fromDict);
+
+    for (int32_t c = 0; c < sizeof(cases) / sizeof(cases[0]); ++c) {
+      std::vector<int8_t> res;
+      flttExecuteOnDictBlock(cases[c].optr, cases[c].pattern, pBlock, res);
+      ASSERT_EQ(res.size(), rowNum);
+
+      for (int32_t i = 0; i < rowNum; ++i) {
+        char        buf[16];
+        const char *v = flttDictValue(i, buf);
+        bool        expect = (v != NULL) && cases[c].expect(v);
+        ASSERT_EQ(res[i], expect) << "type " << (int32_t)type << " case " << c << " row " << i;
+      }
+    }
+
+    blockDataDestroy(pBlock);
+  }
+}
+
 #if 0
 TEST(columnTest, smallint_column_greater_double_value) {
   SNode       *pLeft = NULL, *pRight = NULL, *opNode = NULL;
@@ -36,6 +36,7 @@
 #include "nodes.h"
 #include "parUtil.h"
 #include "scalar.h"
+#include "sclvector.h"
 #include "stub.h"
 #include "taos.h"
 #include "tdatablock.h"
@@ -1996,6 +1997,7 @@ void scltMakeDataBlock(SScalarParam **pInput, int32_t type, void *pVal, int32_t
   SScalarParam *input = (SScalarParam *)taosMemoryCalloc(1, sizeof(SScalarParam));
   int32_t       bytes;
   switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
     case TSDB_DATA_TYPE_TINYINT: {
       bytes = sizeof(int8_t);
       break;
@@ -2045,6 +2047,63 @@ void scltDestroyDataBlock(SScalarParam *pInput) {
   taosMemoryFree(pInput);
 }
 
+TEST(columnTest, int_column_op_smallint_column_with_null) {
+  SScalarParam *pLeft, *pRight, *pOut;
+  int32_t       leftv[5] = {1, -2, 3, 4, 5};
+  int16_t       rightv[5] = {10, 20, 0, 40, 50};
+  int32_t       rowNum = 5;
+
+  scltMakeDataBlock(&pLeft, TSDB_DATA_TYPE_INT, 0, rowNum, false);
+  scltMakeDataBlock(&pRight, TSDB_DATA_TYPE_SMALLINT, 0, rowNum, false);
+  for (int32_t i = 0; i < rowNum; ++i) {
+    colDataSetVal(pLeft->columnData, i, (const char *)&leftv[i], i == 1);
+    colDataSetVal(pRight->columnData, i, (const char *)&rightv[i], i == 3);
+  }
+
+  // null operands and zero divisors give null
+  double eAdd[5] = {11, 0, 3, 0, 55};
+  bool   eAddNull[5] = {false, true, false, true, false};
+  scltMakeDataBlock(&pOut, TSDB_DATA_TYPE_DOUBLE, 0, rowNum, false);
+  getBinScalarOperatorFn(OP_TYPE_ADD)(pLeft, pRight, pOut, TSDB_ORDER_ASC);
+  for (int32_t i = 0; i < rowNum; ++i) {
+    ASSERT_EQ(colDataIsNull_s(pOut->columnData, i), eAddNull[i]);
+    ASSERT_EQ(*((double *)colDataGetData(pOut->columnData, i)), eAdd[i]);
+  }
+  scltDestroyDataBlock(pOut);
+
+  double eDiv[5] = {0.1, 0, 0, 0, 0.1};
+  bool   eDivNull[5] = {false, true, true, true, false};
+  scltMakeDataBlock(&pOut, TSDB_DATA_TYPE_DOUBLE, 0, rowNum, false);
+  getBinScalarOperatorFn(OP_TYPE_DIV)(pLeft, pRight, pOut, TSDB_ORDER_ASC);
+  for (int32_t i = 0; i < rowNum; ++i) {
+    ASSERT_EQ(colDataIsNull_s(pOut->columnData, i), eDivNull[i]);
+    ASSERT_EQ(*((double *)colDataGetData(pOut->columnData, i)), eDiv[i]);
+  }
+  scltDestroyDataBlock(pOut);
+
+  // null operands compare false either way
+  bool eLower[5] = {true, false, false, false, true};
+  scltMakeDataBlock(&pOut, TSDB_DATA_TYPE_BOOL, 0, rowNum, false);
+  getBinScalarOperatorFn(OP_TYPE_LOWER_THAN)(pLeft, pRight, pOut, TSDB_ORDER_ASC);
+  for (int32_t i = 0; i < rowNum; ++i) {
+    ASSERT_EQ(*((bool *)colDataGetData(pOut->columnData, i)), eLower[i]);
+  }
+  ASSERT_EQ(pOut->numOfQualified, 2);
+  scltDestroyDataBlock(pOut);
+
+  bool eNotEqual[5] = {true, false, true, false, true};
+  scltMakeDataBlock(&pOut, TSDB_DATA_TYPE_BOOL, 0, rowNum, false);
+  getBinScalarOperatorFn(OP_TYPE_NOT_EQUAL)(pLeft, pRight, pOut, TSDB_ORDER_ASC);
+  for (int32_t i = 0; i < rowNum; ++i) {
+    ASSERT_EQ(*((bool *)colDataGetData(pOut->columnData, i)), eNotEqual[i]);
+  }
+  ASSERT_EQ(pOut->numOfQualified, 3);
+  scltDestroyDataBlock(pOut);
+
+  scltDestroyDataBlock(pLeft);
+  scltDestroyDataBlock(pRight);
+}
+
 TEST(ScalarFunctionTest, absFunction_constant) {
   SScalarParam *pInput, *pOutput;
   int32_t       code = TSDB_CODE_SUCCESS;
@@ -153,8 +153,11 @@ int32_t streamTaskEnqueueRetrieve(SStreamTask* pTask, SStreamRetrieveReq* pReq,
 
     pData->type = STREAM_INPUT__DATA_RETRIEVE;
     pData->srcVgId = 0;
-    streamRetrieveReqToData(pReq, pData);
-    if (tAppendDataToInputQueue(pTask, (SStreamQueueItem*)pData) == 0) {
+    if (streamRetrieveReqToData(pReq, pData) != 0) {
+      qError("s-task:%s failed to decode the retrieve req from task:0x%x", pTask->id.idStr, pReq->srcTaskId);
+      taosFreeQitem(pData);
+      status = TASK_INPUT_STATUS__FAILED;
+    } else if (tAppendDataToInputQueue(pTask, (SStreamQueueItem*)pData) == 0) {
       status = TASK_INPUT_STATUS__NORMAL;
     } else {
       status = TASK_INPUT_STATUS__FAILED;
@@ -210,8 +213,8 @@ static int32_t streamTaskAppendInputBlocks(SStreamTask* pTask, const SStreamDisp
   if (pBlock == NULL) {
     streamTaskInputFail(pTask);
     status = TASK_INPUT_STATUS__FAILED;
-    qError("vgId:%d, s-task:%s failed to receive dispatch msg, reason: out of memory", pTask->pMeta->vgId,
-           pTask->id.idStr);
+    qError("vgId:%d, s-task:%s failed to receive dispatch msg, reason:%s", pTask->pMeta->vgId, pTask->id.idStr,
+           tstrerror(terrno));
   } else {
     if (pBlock->type == STREAM_INPUT__TRANS_STATE) {
       pTask->status.appendTranstateBlock = true;
@@ -36,7 +36,12 @@ SStreamDataBlock* createStreamDataFromDispatchMsg(const SStreamDispatchReq* pReq
   for (int32_t i = 0; i < blockNum; i++) {
     SRetrieveTableRsp* pRetrieve = (SRetrieveTableRsp*) taosArrayGetP(pReq->data, i);
     SSDataBlock*       pDataBlock = taosArrayGet(pArray, i);
-    blockDecode(pDataBlock, pRetrieve->data);
+    if (blockDecode(pDataBlock, pRetrieve->data) == NULL) {
+      taosArrayDestroyEx(pArray, (FDelete)blockDataFreeRes);
+      taosFreeQitem(pData);
+      terrno = TSDB_CODE_INVALID_MSG;
+      return NULL;
+    }
 
     // TODO: refactor
     pDataBlock->info.window.skey = be64toh(pRetrieve->skey);
@@ -94,7 +99,10 @@ int32_t streamRetrieveReqToData(const SStreamRetrieveReq* pReq, SStreamDataBlock
   taosArrayPush(pArray, &(SSDataBlock){0});
   SRetrieveTableRsp* pRetrieve = pReq->pRetrieve;
   SSDataBlock*       pDataBlock = taosArrayGet(pArray, 0);
-  blockDecode(pDataBlock, pRetrieve->data);
+  if (blockDecode(pDataBlock, pRetrieve->data) == NULL) {
+    taosArrayDestroyEx(pArray, (FDelete)blockDataFreeRes);
+    return TSDB_CODE_INVALID_MSG;
+  }
 
   // TODO: refactor
   pDataBlock->info.window.skey = be64toh(pRetrieve->skey);
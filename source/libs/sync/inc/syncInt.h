@@ -196,6 +196,9 @@ typedef struct SSyncNode {
 
   // restore state
   bool restoreFinish;
+
+  // proposals being grouped into one wal fsync, single replica only
+  int32_t groupCommit;
   // SSnapshot*             pSnapshot;
   SSyncSnapshotSender*   senders[TSDB_MAX_REPLICA + TSDB_MAX_LEARNER_REPLICA];
   SSyncSnapshotReceiver* pNewNodeReceiver;
@@ -572,6 +572,47 @@ int32_t syncPropose(int64_t rid, SRpcMsg* pMsg, bool isWeak, int64_t* seq) {
   return ret;
 }
 
+// Proposals made between a successful begin and its end are appended to the wal one by one, but fsynced once by the
+// end, which then commits them. Only a single replica vgroup groups, a follower has to reply with what is on disk.
+bool syncBeginGroupCommit(int64_t rid) {
+  SSyncNode* pSyncNode = syncNodeAcquire(rid);
+  if (pSyncNode == NULL) return false;
+
+  bool grouped = (pSyncNode->replicaNum == 1 && pSyncNode->totalReplicaNum == 1);
+  if (grouped) {
+    atomic_add_fetch_32(&pSyncNode->groupCommit, 1);
+    pSyncNode->pLogStore->syncLogBeginGroupCommit(pSyncNode->pLogStore);
+  }
+
+  syncNodeRelease(pSyncNode);
+  return grouped;
+}
+
+void syncEndGroupCommit(int64_t rid) {
+  SSyncNode* pSyncNode = syncNodeAcquire(rid);
+  if (pSyncNode == NULL) return;
+
+  SSyncLogBuffer* pBuf = pSyncNode->pLogBuf;
+  if (pSyncNode->pLogStore->syncLogEndGroupCommit(pSyncNode->pLogStore)) {
+    taosThreadMutexLock(&pBuf->mutex);
+    SyncIndex matchIndex = pBuf->matchIndex;
+    syncIndexMgrSetIndex(pSyncNode->pMatchIndex, &pSyncNode->myRaftId, matchIndex);
+    taosThreadMutexUnlock(&pBuf->mutex);
+
+    if (atomic_sub_fetch_32(&pSyncNode->groupCommit, 1) == 0 && pSyncNode->state == TAOS_SYNC_STATE_LEADER &&
+        pSyncNode->replicaNum == 1) {
+      (void)syncNodeUpdateCommitIndex(pSyncNode, matchIndex);
+      if (syncLogBufferCommit(pBuf, pSyncNode, pSyncNode->commitIndex) < 0) {
+        sError("vgId:%d, failed to commit until commitIndex:%" PRId64 "", pSyncNode->vgId, pSyncNode->commitIndex);
+      }
+    }
+  } else {
+    atomic_sub_fetch_32(&pSyncNode->groupCommit, 1);
+  }
+
+  syncNodeRelease(pSyncNode);
+}
+
 int32_t syncIsCatchUp(int64_t rid) {
   SSyncNode* pSyncNode = syncNodeAcquire(rid);
   if (pSyncNode == NULL) {
@@ -2285,7 +2326,11 @@ int32_t syncNodeAppend(SSyncNode* ths, SSyncRaftEntry* pEntry) {
     return 0;
   }
 
-  // single replica
+  // single replica, committed by syncEndGroupCommit once the group is fsynced
+  if (atomic_load_32(&ths->groupCommit) > 0) {
+    return 0;
+  }
+
   (void)syncNodeUpdateCommitIndex(ths, matchIndex);
 
   if (syncLogBufferCommit(ths->pLogBuf, ths, ths->commitIndex) < 0) {
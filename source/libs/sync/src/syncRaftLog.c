@@ -25,6 +25,8 @@
 static int32_t   raftLogRestoreFromSnapshot(struct SSyncLogStore* pLogStore, SyncIndex snapshotIndex);
 static int32_t   raftLogAppendEntry(struct SSyncLogStore* pLogStore, SSyncRaftEntry* pEntry, bool forceSync);
 static int32_t   raftLogTruncate(struct SSyncLogStore* pLogStore, SyncIndex fromIndex);
+static void      raftLogBeginGroupCommit(struct SSyncLogStore* pLogStore);
+static bool      raftLogEndGroupCommit(struct SSyncLogStore* pLogStore);
 static bool      raftLogExist(struct SSyncLogStore* pLogStore, SyncIndex index);
 static int32_t   raftLogUpdateCommitIndex(SSyncLogStore* pLogStore, SyncIndex index);
 static SyncIndex raftlogCommitIndex(SSyncLogStore* pLogStore);
@@ -76,6 +78,8 @@ SSyncLogStore* logStoreCreate(SSyncNode* pSyncNode) {
   pLogStore->syncLogTruncate = raftLogTruncate;
   pLogStore->syncLogWriteIndex = raftLogWriteIndex;
   pLogStore->syncLogExist = raftLogExist;
+  pLogStore->syncLogBeginGroupCommit = raftLogBeginGroupCommit;
+  pLogStore->syncLogEndGroupCommit = raftLogEndGroupCommit;
 
   return pLogStore;
 }
@@ -226,6 +230,16 @@ static int32_t raftLogAppendEntry(struct SSyncLogStore* pLogStore, SSyncRaftEntr
   return 0;
 }
 
+static void raftLogBeginGroupCommit(struct SSyncLogStore* pLogStore) {
+  SSyncLogStoreData* pData = pLogStore->data;
+  walBeginGroupCommit(pData->pWal);
+}
+
+static bool raftLogEndGroupCommit(struct SSyncLogStore* pLogStore) {
+  SSyncLogStoreData* pData = pLogStore->data;
+  return walEndGroupCommit(pData->pWal);
+}
+
 // entry found, return 0
 // entry not found, return -1, terrno = TSDB_CODE_WAL_LOG_NOT_EXIST
 // other error, return -1
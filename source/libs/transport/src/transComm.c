@@ -131,8 +131,22 @@ int transDumpFromBuffer(SConnBuffer* connBuf, char** buf) {
   }
   int total = p->total;
   if (total >= HEADSIZE && !p->invalid) {
-    *buf = taosMemoryCalloc(1, total);
-    memcpy(*buf, p->buf, total);
+    if (p->len == total && p->cap > BUFFER_CAP) {
+      // the buffer was grown to the size of this message only, hand it over instead of copying the message out
+      char* newBuf = taosMemoryMalloc(BUFFER_CAP);
+      if (newBuf == NULL) {
+        return -1;
+      }
+      *buf = p->buf;
+      p->buf = newBuf;
+      p->cap = BUFFER_CAP;
+    } else {
+      *buf = taosMemoryMalloc(total);
+      if (*buf == NULL) {
+        return -1;
+      }
+      memcpy(*buf, p->buf, total);
+    }
     if (transResetBuffer(connBuf) < 0) {
       return -1;
     }
@@ -172,7 +186,7 @@ int transAllocBuffer(SConnBuffer* connBuf, uv_buf_t* uvBuf) {
   if (p->left == -1) {
     uvBuf->len = p->cap - p->len;
   } else {
-    if (p->left < p->cap - p->len) {
+    if (p->left <= p->cap - p->len) {
       uvBuf->len = p->left;
     } else {
       p->cap = p->left + p->len;
@@ -136,6 +136,64 @@ TEST_F(QueueEnv, testIter) {
   assert(result.size() == vals.size());
 }
 
+static std::string buildPacket(int32_t contLen, char fill) {
+  std::string   packet(sizeof(STransMsgHead) + contLen, fill);
+  STransMsgHead head;
+  memset(&head, 0, sizeof(head));
+  head.version = TRANS_VER;
+  head.magicNum = htonl(TRANS_MAGIC_NUM);
+  head.msgLen = (int32_t)htonl((uint32_t)packet.size());
+  memcpy(&packet[0], &head, sizeof(head));
+  return packet;
+}
+
+// feed the packets to the buffer in reads of at most readLen bytes, as libuv does, and dump each complete one
+static std::vector<std::string> readPackets(const std::string &stream, int32_t readLen) {
+  std::vector<std::string> packets;
+  SConnBuffer              connBuf;
+  transInitBuffer(&connBuf);
+
+  size_t offset = 0;
+  while (offset < stream.size()) {
+    uv_buf_t uvBuf;
+    transAllocBuffer(&connBuf, &uvBuf);
+    size_t nread = std::min(std::min((size_t)uvBuf.len, (size_t)readLen), stream.size() - offset);
+    memcpy(uvBuf.base, stream.data() + offset, nread);
+    offset += nread;
+    connBuf.len += (int)nread;
+
+    while (transReadComplete(&connBuf)) {
+      char *buf = NULL;
+      int   len = transDumpFromBuffer(&connBuf, &buf);
+      EXPECT_GT(len, 0);
+      packets.push_back(std::string(buf, len));
+      taosMemoryFree(buf);
+    }
+  }
+
+  transDestroyBuffer(&connBuf);
+  return packets;
+}
+
+TEST(TransBufferTest, dumpPackets) {
+  std::vector<std::string> packets;
+  std::string              stream;
+  int32_t                  contLens[] = {0, 10, 4000, 100, 1 << 20, 3, 5000, 70000, 1};
+  for (int i = 0; i < sizeof(contLens) / sizeof(contLens[0]); i++) {
+    packets.push_back(buildPacket(contLens[i], 'a' + i));
+    stream += packets.back();
+  }
+
+  int32_t readLens[] = {1, 7, 1000, 4096, 1 << 30};
+  for (int i = 0; i < sizeof(readLens) / sizeof(readLens[0]); i++) {
+    std::vector<std::string> result = readPackets(stream, readLens[i]);
+    ASSERT_EQ(result.size(), packets.size());
+    for (int j = 0; j < packets.size(); j++) {
+      EXPECT_TRUE(result[j] == packets[j]);
+    }
+  }
+}
+
 class TransCtxEnv : public ::testing::Test {
  protected:
   virtual void SetUp() {
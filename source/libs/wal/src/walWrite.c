@@ -630,14 +630,40 @@ int32_t walWrite(SWal *pWal, int64_t index, tmsg_t msgType, const void *body, in
   return walWriteWithSyncInfo(pWal, index, msgType, syncMeta, body, bodyLen);
 }
 
+static void walDoFsync(SWal *pWal) {
+  wTrace("vgId:%d, fileId:%" PRId64 ".log, do fsync", pWal->cfg.vgId, walGetCurFileFirstVer(pWal));
+  if (taosFsyncFile(pWal->pLogFile) < 0) {
+    wError("vgId:%d, file:%" PRId64 ".log, fsync failed since %s", pWal->cfg.vgId, walGetCurFileFirstVer(pWal),
+           strerror(errno));
+  }
+}
+
 void walFsync(SWal *pWal, bool forceFsync) {
   taosThreadMutexLock(&pWal->mutex);
   if (forceFsync || (pWal->cfg.level == TAOS_WAL_FSYNC && pWal->cfg.fsyncPeriod == 0)) {
-    wTrace("vgId:%d, fileId:%" PRId64 ".log, do fsync", pWal->cfg.vgId, walGetCurFileFirstVer(pWal));
-    if (taosFsyncFile(pWal->pLogFile) < 0) {
-      wError("vgId:%d, file:%" PRId64 ".log, fsync failed since %s", pWal->cfg.vgId, walGetCurFileFirstVer(pWal),
-             strerror(errno));
+    if (pWal->groupDepth > 0) {
+      pWal->fsyncPending = true;
+    } else {
+      walDoFsync(pWal);
     }
   }
   taosThreadMutexUnlock(&pWal->mutex);
 }
+
+void walBeginGroupCommit(SWal *pWal) {
+  taosThreadMutexLock(&pWal->mutex);
+  pWal->groupDepth++;
+  taosThreadMutexUnlock(&pWal->mutex);
+}
+
+bool walEndGroupCommit(SWal *pWal) {
+  taosThreadMutexLock(&pWal->mutex);
+  ASSERT(pWal->groupDepth > 0);
+  bool outermost = (--pWal->groupDepth == 0);
+  if (outermost && pWal->fsyncPending) {
+    walDoFsync(pWal);
+    pWal->fsyncPending = false;
+  }
+  taosThreadMutexUnlock(&pWal->mutex);
+  return outermost;
+}
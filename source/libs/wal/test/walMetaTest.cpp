@@ -234,6 +234,26 @@ TEST_F(WalCleanEnv, write) {
   ASSERT_EQ(code, 0);
 }
 
+TEST_F(WalCleanEnv, groupCommit) {
+  int code;
+  walBeginGroupCommit(pWal);
+  walBeginGroupCommit(pWal);
+  for (int i = 0; i < 10; i++) {
+    code = walWrite(pWal, i, i + 1, (void*)ranStr, ranStrLen);
+    ASSERT_EQ(code, 0);
+    walFsync(pWal, false);
+    ASSERT_EQ(pWal->fsyncPending, true);
+  }
+  ASSERT_EQ(walEndGroupCommit(pWal), false);
+  ASSERT_EQ(pWal->fsyncPending, true);
+  ASSERT_EQ(walEndGroupCommit(pWal), true);
+  ASSERT_EQ(pWal->fsyncPending, false);
+  ASSERT_EQ(pWal->vers.lastVer, 9);
+
+  walFsync(pWal, false);
+  ASSERT_EQ(pWal->fsyncPending, false);
+}
+
 TEST_F(WalCleanEnv, rollback) {
   int code;
   for (int i = 0; i < 10; i++) {
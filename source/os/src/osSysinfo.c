@@ -248,7 +248,7 @@ void taosGetSystemInfo() {
   taosGetCpuCores(&tsNumOfCores);
   taosGetTotalMemory(&tsTotalMemoryKB);
   taosGetCpuUsage(NULL, NULL);
-  taosGetCpuInstructions(&tsSSE42Enable, &tsAVXEnable, &tsAVX2Enable, &tsFMAEnable);
+  taosGetCpuInstructions(&tsSSE42Enable, &tsAVXEnable, &tsAVX2Enable, &tsFMAEnable, &tsAVX512Enable);
 #endif
 }
 
@@ -548,7 +548,7 @@ void taosGetCpuUsage(double *cpu_system, double *cpu_engine) {
                       : "0"(level))
 
 // todo add for windows and mac
-int32_t taosGetCpuInstructions(char* sse42, char* avx, char* avx2, char* fma) {
+int32_t taosGetCpuInstructions(char* sse42, char* avx, char* avx2, char* fma, char* avx512) {
 #ifdef WINDOWS
 #elif defined(_TD_DARWIN_64)
 #else
@@ -572,11 +572,19 @@ int32_t taosGetCpuInstructions(char* sse42, char* avx, char* avx2, char* fma) {
   *sse42 = (char) ((ecx & bit_SSE4_2) == bit_SSE4_2);
   *avx   = (char) ((ecx & bit_AVX) == bit_AVX);
   *fma   = (char) ((ecx & bit_FMA) == bit_FMA);
+  bool osxsave = (ecx & bit_OSXSAVE) == bit_OSXSAVE;
 
   // work around a bug in GCC.
   // Ref to https://gcc.gnu.org/bugzilla/show_bug.cgi?id=77756
   __cpuid_fix(7u, eax, ebx, ecx, edx);
   *avx2 = (char) ((ebx & bit_AVX2) == bit_AVX2);
+
+  // the zmm registers are usable only if the os saves the opmask and the upper zmm state as well
+  uint32_t xcr0 = 0;
+  if (osxsave) {
+    __asm__("xgetbv" : "=a"(xcr0) : "c"(0) : "edx");
+  }
+  *avx512 = (char) ((ebx & bit_AVX512F) == bit_AVX512F && (xcr0 & 0xE6) == 0xE6);
 #endif   // _TD_X86_
 #endif
 
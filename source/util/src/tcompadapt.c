@@ -0,0 +1,680 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Adaptive encodings of the TAOS compression.
+ *
+ *   tsCompressAdaptive() encodes a block with the codec of its type, in tcompression.c, unless one of these is
+ *   smaller:
+ *     FOR   frame of reference, value - min packed in the bits max - min needs (integers)
+ *     DICT  at most 256 distinct values, as codes packed in the bits the dictionary needs
+ *     RLE   runs of equal values
+ *     ALP   decimals, round(v * 10^e) packed as FOR, the values that do not round trip kept aside (float/double)
+ *   The sizes of these are known after one pass over the block, the exponent of ALP is picked on a sample of it.
+ *
+ *   An adaptive block starts with COMP_ADAPT_FLAG | encoding, a byte the codecs never start with (0 or 1, 2 or 3 for
+ *   the lossy floats), so the blocks written before are decoded by the codec of their type as ever.
+ */
+
+#define _DEFAULT_SOURCE
+#include <math.h>
+#include "tcompression.h"
+#include "tlog.h"
+
+#define ADAPT_FOR  1
+#define ADAPT_DICT 2
+#define ADAPT_RLE  3
+#define ADAPT_ALP  4
+
+#define ADAPT_MIN_ROWS    16
+#define ADAPT_DICT_MAX    256
+#define ADAPT_DICT_SLOTS  1024
+#define ADAPT_ALP_SAMPLE  32
+#define ADAPT_ALP_LIMIT   4503599627370496.0  // 2^52, integers below it convert to double exactly
+#define ADAPT_ALP_MAX_E64 18
+#define ADAPT_ALP_MAX_E32 10
+
+typedef int32_t (*FCompFn)(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg, void *pBuf,
+                           int32_t nBuf);
+
+static const double ADAPT_POW10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8, 1e9,
+                                     1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18};
+
+typedef struct {
+  int32_t bytes;
+  bool    isFloat;
+  bool    isDouble;
+  // FOR, of the values for integers and of the ALP integers for floats
+  int64_t min;
+  int64_t max;
+  // RLE
+  int32_t nRun;
+  int64_t szRle;
+  // DICT, nDict > ADAPT_DICT_MAX once there are too many values
+  int32_t  nDict;
+  int16_t  aSlot[ADAPT_DICT_SLOTS];
+  uint64_t aDict[ADAPT_DICT_MAX];
+  // ALP
+  int32_t e;
+  int32_t nExc;
+} SAdaptCtx;
+
+bool tsIsAdaptiveType(int8_t type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_UTINYINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+    case TSDB_DATA_TYPE_UINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+    case TSDB_DATA_TYPE_FLOAT:
+    case TSDB_DATA_TYPE_DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static void adaptTypeCodec(int8_t type, int32_t *pBytes, FCompFn *pComp, FCompFn *pDecomp) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_UTINYINT:
+      *pBytes = CHAR_BYTES;
+      *pComp = tsCompressTinyint;
+      *pDecomp = tsDecompressTinyint;
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+      *pBytes = SHORT_BYTES;
+      *pComp = tsCompressSmallint;
+      *pDecomp = tsDecompressSmallint;
+      break;
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_UINT:
+      *pBytes = INT_BYTES;
+      *pComp = tsCompressInt;
+      *pDecomp = tsDecompressInt;
+      break;
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      *pBytes = LONG_BYTES;
+      *pComp = tsCompressTimestamp;
+      *pDecomp = tsDecompressTimestamp;
+      break;
+    case TSDB_DATA_TYPE_FLOAT:
+      *pBytes = FLOAT_BYTES;
+      *pComp = tsCompressFloat;
+      *pDecomp = tsDecompressFloat;
+      break;
+    case TSDB_DATA_TYPE_DOUBLE:
+      *pBytes = DOUBLE_BYTES;
+      *pComp = tsCompressDouble;
+      *pDecomp = tsDecompressDouble;
+      break;
+    default:
+      *pBytes = LONG_BYTES;
+      *pComp = tsCompressBigint;
+      *pDecomp = tsDecompressBigint;
+      break;
+  }
+}
+
+// integers sign extended, floats as their bits
+static FORCE_INLINE uint64_t adaptGet(const void *p, int32_t bytes, bool isFloat, int32_t i) {
+  switch (bytes) {
+    case 1:
+      return (uint64_t)(int64_t)((const int8_t *)p)[i];
+    case 2:
+      return (uint64_t)(int64_t)((const int16_t *)p)[i];
+    case 4:
+      return isFloat ? ((const uint32_t *)p)[i] : (uint64_t)(int64_t)((const int32_t *)p)[i];
+    default:
+      return ((const uint64_t *)p)[i];
+  }
+}
+
+static FORCE_INLINE void adaptPut(void *p, int32_t bytes, int32_t i, uint64_t v) {
+  switch (bytes) {
+    case 1:
+      ((uint8_t *)p)[i] = (uint8_t)v;
+      break;
+    case 2:
+      ((uint16_t *)p)[i] = (uint16_t)v;
+      break;
+    case 4:
+      ((uint32_t *)p)[i] = (uint32_t)v;
+      break;
+    default:
+      ((uint64_t *)p)[i] = v;
+      break;
+  }
+}
+
+static FORCE_INLINE int32_t adaptBits(uint64_t v) { return v == 0 ? 0 : 64 - BUILDIN_CLZL(v); }
+
+static FORCE_INLINE int32_t adaptVarLen(uint64_t v) {
+  int32_t n = 1;
+  while (v >= 0x80) {
+    v >>= 7;
+    n++;
+  }
+  return n;
+}
+
+static FORCE_INLINE int64_t adaptPackedSize(int32_t nEle, int32_t bits) { return ((int64_t)nEle * bits + 7) / 8; }
+
+// bit packing, least significant bit first -------------------------------------------------
+typedef struct {
+  uint8_t *p;
+  uint64_t acc;
+  int32_t  nAcc;
+} SBitWriter;
+
+typedef struct {
+  const uint8_t *p;
+  const uint8_t *end;
+  uint64_t       acc;
+  int32_t        nAcc;
+} SBitReader;
+
+// at most 56 bits, so that they fit next to the less than 8 bits left in the accumulator
+static FORCE_INLINE void bitPut56(SBitWriter *w, uint64_t v, int32_t bits) {
+  w->acc |= (v & (((uint64_t)1 << bits) - 1)) << w->nAcc;
+  w->nAcc += bits;
+  while (w->nAcc >= 8) {
+    *w->p++ = (uint8_t)w->acc;
+    w->acc >>= 8;
+    w->nAcc -= 8;
+  }
+}
+
+static FORCE_INLINE void bitPut(SBitWriter *w, uint64_t v, int32_t bits) {
+  if (bits > 56) {
+    bitPut56(w, v, 32);
+    v >>= 32;
+    bits -= 32;
+  }
+  if (bits > 0) bitPut56(w, v, bits);
+}
+
+static FORCE_INLINE void bitFlush(SBitWriter *w) {
+  if (w->nAcc > 0) *w->p++ = (uint8_t)w->acc;
+  w->acc = 0;
+  w->nAcc = 0;
+}
+
+static FORCE_INLINE uint64_t bitGet56(SBitReader *r, int32_t bits) {
+  while (r->nAcc < bits) {
+    r->acc |= (uint64_t)(r->p < r->end ? *r->p : 0) << r->nAcc;
+    r->p++;
+    r->nAcc += 8;
+  }
+  uint64_t v = r->acc & (((uint64_t)1 << bits) - 1);
+  r->acc >>= bits;
+  r->nAcc -= bits;
+  return v;
+}
+
+static FORCE_INLINE uint64_t bitGet(SBitReader *r, int32_t bits) {
+  if (bits > 56) {
+    uint64_t lo = bitGet56(r, 32);
+    return lo | (bitGet56(r, bits - 32) << 32);
+  }
+  return (bits > 0) ? bitGet56(r, bits) : 0;
+}
+
+// ALP ------------------------------------------------------------------------------------
+static FORCE_INLINE double adaptToDouble(uint64_t v, bool isDouble) {
+  if (isDouble) {
+    double d;
+    memcpy(&d, &v, sizeof(d));
+    return d;
+  } else {
+    uint32_t u = (uint32_t)v;
+    float    f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+  }
+}
+
+static FORCE_INLINE uint64_t adaptAlpDecode(int64_t n, int32_t e, bool isDouble) {
+  double d = (double)n / ADAPT_POW10[e];
+  if (isDouble) {
+    uint64_t v;
+    memcpy(&v, &d, sizeof(v));
+    return v;
+  } else {
+    float    f = (float)d;
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+  }
+}
+
+// false if v * 10^e is not an integer that gives v back, nan, inf and -0.0 among them
+static FORCE_INLINE bool adaptAlpEncode(uint64_t v, int32_t e, bool isDouble, int64_t *pN) {
+  double d = adaptToDouble(v, isDouble) * ADAPT_POW10[e];
+  if (!(d > -ADAPT_ALP_LIMIT && d < ADAPT_ALP_LIMIT)) return false;
+
+  int64_t n = (int64_t)round(d);
+  if (adaptAlpDecode(n, e, isDouble) != v) return false;
+
+  *pN = n;
+  return true;
+}
+
+// the smallest exponent that encodes the most of a sample of the block, -1 if it is less than half of it
+static int32_t adaptAlpExponent(const void *pIn, int32_t nEle, const SAdaptCtx *pCtx) {
+  int32_t maxE = pCtx->isDouble ? ADAPT_ALP_MAX_E64 : ADAPT_ALP_MAX_E32;
+  int32_t nSample = TMIN(nEle, ADAPT_ALP_SAMPLE);
+  int32_t bestE = -1;
+  int32_t bestCnt = 0;
+
+  for (int32_t e = 0; e <= maxE && bestCnt < nSample; e++) {
+    int32_t cnt = 0;
+    for (int32_t s = 0; s < nSample; s++) {
+      int64_t  n;
+      uint64_t v = adaptGet(pIn, pCtx->bytes, true, (int32_t)((int64_t)s * nEle / nSample));
+      if (adaptAlpEncode(v, e, pCtx->isDouble, &n)) cnt++;
+    }
+    if (cnt > bestCnt) {
+      bestCnt = cnt;
+      bestE = e;
+    }
+  }
+
+  return (bestCnt * 2 >= nSample) ? bestE : -1;
+}
+
+// statistics --------------------------------------------------------------------------------
+static FORCE_INLINE int32_t adaptDictSlot(uint64_t v) {
+  return (int32_t)((v * 0x9E3779B97F4A7C15ull) >> 54);  // 10 bits, ADAPT_DICT_SLOTS
+}
+
+// the code of v, added to the dictionary if new, -1 if the dictionary is full
+static FORCE_INLINE int32_t adaptDictCode(SAdaptCtx *pCtx, uint64_t v) {
+  int32_t slot = adaptDictSlot(v);
+  while (pCtx->aSlot[slot] >= 0) {
+    if (pCtx->aDict[pCtx->aSlot[slot]] == v) return pCtx->aSlot[slot];
+    slot = (slot + 1) & (ADAPT_DICT_SLOTS - 1);
+  }
+
+  if (pCtx->nDict >= ADAPT_DICT_MAX) return -1;
+  pCtx->aDict[pCtx->nDict] = v;
+  pCtx->aSlot[slot] = pCtx->nDict;
+  return pCtx->nDict++;
+}
+
+static void adaptScan(const void *pIn, int32_t nEle, SAdaptCtx *pCtx) {
+  int32_t  bytes = pCtx->bytes;
+  bool     isFloat = pCtx->isFloat;
+  bool     hasDict = true;
+  uint64_t prev = adaptGet(pIn, bytes, isFloat, 0);
+  int32_t  runLen = 0;
+
+  memset(pCtx->aSlot, 0xFF, sizeof(pCtx->aSlot));
+  pCtx->nDict = 0;
+  pCtx->nRun = 0;
+  pCtx->szRle = 0;
+  pCtx->nExc = 0;
+  pCtx->min = INT64_MAX;
+  pCtx->max = INT64_MIN;
+  pCtx->e = isFloat ? adaptAlpExponent(pIn, nEle, pCtx) : -1;
+
+  for (int32_t i = 0; i < nEle; i++) {
+    uint64_t v = adaptGet(pIn, bytes, isFloat, i);
+
+    if (v == prev && i > 0) {
+      runLen++;
+    } else {
+      if (i > 0) {
+        pCtx->nRun++;
+        pCtx->szRle += bytes + adaptVarLen(runLen);
+      }
+      prev = v;
+      runLen = 1;
+
+      if (hasDict && adaptDictCode(pCtx, v) < 0) {
+        hasDict = false;
+        pCtx->nDict = ADAPT_DICT_MAX + 1;
+      }
+    }
+
+    int64_t n = (int64_t)v;
+    if (isFloat) {
+      if (pCtx->e < 0) continue;
+      if (!adaptAlpEncode(v, pCtx->e, pCtx->isDouble, &n)) {
+        pCtx->nExc++;
+        continue;
+      }
+    }
+    if (n < pCtx->min) pCtx->min = n;
+    if (n > pCtx->max) pCtx->max = n;
+  }
+  pCtx->nRun++;
+  pCtx->szRle += bytes + adaptVarLen(runLen);
+
+  if (pCtx->min > pCtx->max) pCtx->min = pCtx->max = 0;
+}
+
+static int64_t adaptSize(const SAdaptCtx *pCtx, int32_t nEle, int32_t enc) {
+  int32_t forBits = adaptBits((uint64_t)pCtx->max - (uint64_t)pCtx->min);
+  switch (enc) {
+    case ADAPT_FOR:
+      if (pCtx->isFloat) return INT64_MAX;
+      return 1 + sizeof(int64_t) + 1 + adaptPackedSize(nEle, forBits);
+    case ADAPT_DICT:
+      if (pCtx->nDict > ADAPT_DICT_MAX) return INT64_MAX;
+      return 1 + sizeof(uint16_t) + (int64_t)pCtx->nDict * pCtx->bytes + 1 +
+             adaptPackedSize(nEle, adaptBits(pCtx->nDict - 1));
+    case ADAPT_RLE:
+      return 1 + sizeof(int32_t) + pCtx->szRle;
+    case ADAPT_ALP:
+      if (!pCtx->isFloat || pCtx->e < 0) return INT64_MAX;
+      return 1 + 1 + sizeof(int64_t) + 1 + sizeof(int32_t) + adaptPackedSize(nEle, forBits) +
+             (int64_t)pCtx->nExc * (sizeof(int32_t) + pCtx->bytes);
+    default:
+      return INT64_MAX;
+  }
+}
+
+// encoders -----------------------------------------------------------------------------------
+static int32_t adaptEncodeFor(const void *pIn, int32_t nEle, const SAdaptCtx *pCtx, uint8_t *pOut) {
+  uint8_t *p = pOut;
+  int32_t  bits = adaptBits((uint64_t)pCtx->max - (uint64_t)pCtx->min);
+
+  *p++ = COMP_ADAPT_FLAG | ADAPT_FOR;
+  memcpy(p, &pCtx->min, sizeof(int64_t));
+  p += sizeof(int64_t);
+  *p++ = (uint8_t)bits;
+
+  SBitWriter w = {.p = p};
+  for (int32_t i = 0; i < nEle; i++) {
+    bitPut(&w, adaptGet(pIn, pCtx->bytes, false, i) - (uint64_t)pCtx->min, bits);
+  }
+  bitFlush(&w);
+  return (int32_t)(w.p - pOut);
+}
+
+static int32_t adaptEncodeDict(const void *pIn, int32_t nEle, SAdaptCtx *pCtx, uint8_t *pOut) {
+  uint8_t *p = pOut;
+  uint16_t nDict = (uint16_t)pCtx->nDict;
+  int32_t  bits = adaptBits(nDict - 1);
+
+  *p++ = COMP_ADAPT_FLAG | ADAPT_DICT;
+  memcpy(p, &nDict, sizeof(nDict));
+  p += sizeof(nDict);
+  for (int32_t i = 0; i < nDict; i++) {
+    memcpy(p, &pCtx->aDict[i], pCtx->bytes);  // the low bytes, little endian
+    p += pCtx->bytes;
+  }
+  *p++ = (uint8_t)bits;
+
+  SBitWriter w = {.p = p};
+  for (int32_t i = 0; i < nEle; i++) {
+    bitPut(&w, adaptDictCode(pCtx, adaptGet(pIn, pCtx->bytes, pCtx->isFloat, i)), bits);
+  }
+  bitFlush(&w);
+  return (int32_t)(w.p - pOut);
+}
+
+static int32_t adaptEncodeRle(const void *pIn, int32_t nEle, const SAdaptCtx *pCtx, uint8_t *pOut) {
+  uint8_t *p = pOut;
+
+  *p++ = COMP_ADAPT_FLAG | ADAPT_RLE;
+  memcpy(p, &pCtx->nRun, sizeof(int32_t));
+  p += sizeof(int32_t);
+
+  for (int32_t i = 0; i < nEle;) {
+    uint64_t v = adaptGet(pIn, pCtx->bytes, pCtx->isFloat, i);
+    int32_t  j = i + 1;
+    while (j < nEle && adaptGet(pIn, pCtx->bytes, pCtx->isFloat, j) == v) j++;
+    uint32_t runLen = j - i;
+    i = j;
+
+    memcpy(p, &v, pCtx->bytes);
+    p += pCtx->bytes;
+    while (runLen >= 0x80) {
+      *p++ = (uint8_t)(runLen | 0x80);
+      runLen >>= 7;
+    }
+    *p++ = (uint8_t)runLen;
+  }
+
+  return (int32_t)(p - pOut);
+}
+
+static int32_t adaptEncodeAlp(const void *pIn, int32_t nEle, const SAdaptCtx *pCtx, uint8_t *pOut) {
+  uint8_t *p = pOut;
+  int32_t  bits = adaptBits((uint64_t)pCtx->max - (uint64_t)pCtx->min);
+
+  *p++ = COMP_ADAPT_FLAG | ADAPT_ALP;
+  *p++ = (uint8_t)pCtx->e;
+  memcpy(p, &pCtx->min, sizeof(int64_t));
+  p += sizeof(int64_t);
+  *p++ = (uint8_t)bits;
+  memcpy(p, &pCtx->nExc, sizeof(int32_t));
+  p += sizeof(int32_t);
+
+  // exceptions after the packed integers, where they hold min
+  uint8_t   *pExc = p + adaptPackedSize(nEle, bits);
+  SBitWriter w = {.p = p};
+  for (int32_t i = 0; i < nEle; i++) {
+    uint64_t v = adaptGet(pIn, pCtx->bytes, true, i);
+    int64_t  n;
+    if (!adaptAlpEncode(v, pCtx->e, pCtx->isDouble, &n)) {
+      n = pCtx->min;
+      memcpy(pExc, &i, sizeof(int32_t));
+      pExc += sizeof(int32_t);
+      memcpy(pExc, &v, pCtx->bytes);
+      pExc += pCtx->bytes;
+    }
+    bitPut(&w, (uint64_t)n - (uint64_t)pCtx->min, bits);
+  }
+  bitFlush(&w);
+
+  return (int32_t)(pExc - pOut);
+}
+
+int32_t tsCompressAdaptive(int8_t type, void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg,
+                           void *pBuf, int32_t nBuf) {
+  int32_t bytes;
+  FCompFn comp, decomp;
+  adaptTypeCodec(type, &bytes, &comp, &decomp);
+
+  int32_t len = comp(pIn, nIn, nEle, pOut, nOut, cmprAlg, pBuf, nBuf);
+  if (len <= 0 || nEle < ADAPT_MIN_ROWS) return len;
+
+  SAdaptCtx ctx = {.bytes = bytes,
+                   .isFloat = (type == TSDB_DATA_TYPE_FLOAT || type == TSDB_DATA_TYPE_DOUBLE),
+                   .isDouble = (type == TSDB_DATA_TYPE_DOUBLE)};
+  adaptScan(pIn, nEle, &ctx);
+
+  int32_t enc = 0;
+  int64_t size = len;
+  for (int32_t e = ADAPT_FOR; e <= ADAPT_ALP; e++) {
+    int64_t sz = adaptSize(&ctx, nEle, e);
+    if (sz < size) {
+      size = sz;
+      enc = e;
+    }
+  }
+
+  switch (enc) {
+    case ADAPT_FOR:
+      len = adaptEncodeFor(pIn, nEle, &ctx, pOut);
+      break;
+    case ADAPT_DICT:
+      len = adaptEncodeDict(pIn, nEle, &ctx, pOut);
+      break;
+    case ADAPT_RLE:
+      len = adaptEncodeRle(pIn, nEle, &ctx, pOut);
+      break;
+    case ADAPT_ALP:
+      len = adaptEncodeAlp(pIn, nEle, &ctx, pOut);
+      break;
+    default:
+      break;
+  }
+
+  ASSERT(enc == 0 || len == size);
+  return len;
+}
+
+// decoders ------------------------------------------------------------------------------------
+static int32_t adaptDecodeFor(const uint8_t *p, const uint8_t *end, int32_t nEle, int32_t bytes, void *pOut) {
+  int64_t base;
+  if (end - p < sizeof(int64_t) + 1) return -1;
+  memcpy(&base, p, sizeof(int64_t));
+  p += sizeof(int64_t);
+  int32_t bits = *p++;
+  if (bits > 64 || end - p < adaptPackedSize(nEle, bits)) return -1;
+
+  SBitReader r = {.p = p, .end = end};
+  for (int32_t i = 0; i < nEle; i++) {
+    adaptPut(pOut, bytes, i, (uint64_t)base + bitGet(&r, bits));
+  }
+  return 0;
+}
+
+static int32_t adaptDecodeDict(const uint8_t *p, const uint8_t *end, int32_t nEle, int32_t bytes, void *pOut) {
+  uint16_t nDict;
+  if (end - p < sizeof(uint16_t)) return -1;
+  memcpy(&nDict, p, sizeof(uint16_t));
+  p += sizeof(uint16_t);
+  if (nDict == 0 || nDict > ADAPT_DICT_MAX || end - p < (int64_t)nDict * bytes + 1) return -1;
+
+  uint64_t aDict[ADAPT_DICT_MAX] = {0};
+  for (int32_t i = 0; i < nDict; i++) {
+    memcpy(&aDict[i], p, bytes);
+    p += bytes;
+  }
+  int32_t bits = *p++;
+  if (bits > 8 || end - p < adaptPackedSize(nEle, bits)) return -1;
+
+  SBitReader r = {.p = p, .end = end};
+  for (int32_t i = 0; i < nEle; i++) {
+    uint64_t code = bitGet(&r, bits);
+    if (code >= nDict) return -1;
+    adaptPut(pOut, bytes, i, aDict[code]);
+  }
+  return 0;
+}
+
+static int32_t adaptDecodeRle(const uint8_t *p, const uint8_t *end, int32_t nEle, int32_t bytes, void *pOut) {
+  int32_t nRun;
+  if (end - p < sizeof(int32_t)) return -1;
+  memcpy(&nRun, p, sizeof(int32_t));
+  p += sizeof(int32_t);
+
+  int32_t i = 0;
+  for (int32_t k = 0; k < nRun; k++) {
+    uint64_t v = 0;
+    if (end - p < bytes + 1) return -1;
+    memcpy(&v, p, bytes);
+    p += bytes;
+
+    uint64_t runLen = 0;
+    for (int32_t shift = 0;; shift += 7) {
+      if (p >= end || shift > 28) return -1;
+      uint8_t b = *p++;
+      runLen |= (uint64_t)(b & 0x7F) << shift;
+      if ((b & 0x80) == 0) break;
+    }
+    if (runLen > nEle - i) return -1;
+
+    for (uint64_t j = 0; j < runLen; j++) adaptPut(pOut, bytes, i++, v);
+  }
+  return (i == nEle) ? 0 : -1;
+}
+
+static int32_t adaptDecodeAlp(const uint8_t *p, const uint8_t *end, int32_t nEle, int32_t bytes, void *pOut) {
+  bool    isDouble = (bytes == DOUBLE_BYTES);
+  int64_t base;
+  int32_t nExc;
+  if (end - p < 1 + sizeof(int64_t) + 1 + sizeof(int32_t)) return -1;
+  int32_t e = *p++;
+  memcpy(&base, p, sizeof(int64_t));
+  p += sizeof(int64_t);
+  int32_t bits = *p++;
+  memcpy(&nExc, p, sizeof(int32_t));
+  p += sizeof(int32_t);
+  if (e > (isDouble ? ADAPT_ALP_MAX_E64 : ADAPT_ALP_MAX_E32) || bits > 64 || nExc < 0 || nExc > nEle) return -1;
+
+  int64_t szPacked = adaptPackedSize(nEle, bits);
+  if (end - p < szPacked + (int64_t)nExc * (sizeof(int32_t) + bytes)) return -1;
+
+  SBitReader r = {.p = p, .end = end};
+  for (int32_t i = 0; i < nEle; i++) {
+    int64_t n = (int64_t)((uint64_t)base + bitGet(&r, bits));
+    adaptPut(pOut, bytes, i, adaptAlpDecode(n, e, isDouble));
+  }
+
+  p += szPacked;
+  for (int32_t k = 0; k < nExc; k++) {
+    int32_t  pos;
+    uint64_t v = 0;
+    memcpy(&pos, p, sizeof(int32_t));
+    p += sizeof(int32_t);
+    memcpy(&v, p, bytes);
+    p += bytes;
+    if (pos < 0 || pos >= nEle) return -1;
+    adaptPut(pOut, bytes, pos, v);
+  }
+  return 0;
+}
+
+int32_t tsDecompressAdaptive(int8_t type, void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut,
+                             uint8_t cmprAlg, void *pBuf, int32_t nBuf) {
+  int32_t bytes;
+  FCompFn comp, decomp;
+  adaptTypeCodec(type, &bytes, &comp, &decomp);
+
+  const uint8_t *p = pIn;
+  if (nIn <= 0 || (p[0] & COMP_ADAPT_FLAG) == 0) {
+    return decomp(pIn, nIn, nEle, pOut, nOut, cmprAlg, pBuf, nBuf);
+  }
+
+  if ((int64_t)nEle * bytes > nOut) return -1;
+
+  const uint8_t *end = p + nIn;
+  int32_t        code = -1;
+  switch (p[0] & ~COMP_ADAPT_FLAG) {
+    case ADAPT_FOR:
+      code = adaptDecodeFor(p + 1, end, nEle, bytes, pOut);
+      break;
+    case ADAPT_DICT:
+      code = adaptDecodeDict(p + 1, end, nEle, bytes, pOut);
+      break;
+    case ADAPT_RLE:
+      code = adaptDecodeRle(p + 1, end, nEle, bytes, pOut);
+      break;
+    case ADAPT_ALP:
+      if (type == TSDB_DATA_TYPE_FLOAT || type == TSDB_DATA_TYPE_DOUBLE) {
+        code = adaptDecodeAlp(p + 1, end, nEle, bytes, pOut);
+      }
+      break;
+    default:
+      break;
+  }
+
+  if (code != 0) {
+    uError("failed to decompress adaptive block, encoding:%d type:%d nEle:%d nIn:%d", p[0] & ~COMP_ADAPT_FLAG, type,
+           nEle, nIn);
+    return -1;
+  }
+  return nEle * bytes;
+}
@@ -61,10 +61,32 @@ static const int32_t TEST_NUMBER = 1;
 #define is_bigendian()     ((*(char *)&TEST_NUMBER) == 0)
 #define SIMPLE8B_MAX_INT64 ((uint64_t)1152921504606846974LL)
 
+// simple8b selector tables, shared by the block and the stream compressors
+static const uint8_t BIT_PER_INTEGER[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
+static const int32_t SELECTOR_TO_ELEMS[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
+static const uint8_t BIT_TO_SELECTOR[] = {0,  2,  3,  4,  5,  6,  7,  8,  9,  10, 10, 11, 11, 12, 12, 12,
+                                          13, 13, 13, 13, 13, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 15,
+                                          15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+                                          15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15};
+
 #define safeInt64Add(a, b)  (((a >= 0) && (b <= INT64_MAX - a)) || ((a < 0) && (b >= INT64_MIN - a)))
 #define ZIGZAG_ENCODE(T, v) (((u##T)((v) >> (sizeof(T) * 8 - 1))) ^ (((u##T)(v)) << 1))  // zigzag encode
 #define ZIGZAG_DECODE(T, v) (((v) >> 1) ^ -((T)((v)&1)))                                 // zigzag decode
 
+// number of values the SIMD paths transform at a time, even so that no flag pair is split
+#define COMP_SIMD_CHUNK 1024
+
+// the low n bytes of a little endian word, indexed by a 4-bit byte count
+static const uint64_t COMP_BYTE_MASK[16] = {
+    0,          0xFFull,    0xFFFFull,  0xFFFFFFull, 0xFFFFFFFFull, 0xFFFFFFFFFFull, 0xFFFFFFFFFFFFull,
+    0xFFFFFFFFFFFFFFull,    UINT64_MAX, UINT64_MAX,  UINT64_MAX,    UINT64_MAX,      UINT64_MAX,
+    UINT64_MAX, UINT64_MAX, UINT64_MAX};
+
+// the SIMD paths write and read whole little endian words, they produce the same bytes as the scalar code
+static FORCE_INLINE const SCompSimdKernels *tsCompSimdKernels() {
+  return is_bigendian() ? NULL : tsGetCompSimdKernels();
+}
+
 #ifdef TD_TSZ
 bool lossyFloat = false;
 bool lossyDouble = false;
@@ -96,6 +118,88 @@ void tsCompressExit() { tdszExit(); }
 /*
  * Compress Integer (Simple8B).
  */
+static void tsWidenINT(const char *const input, int32_t start, int32_t n, const char type, int64_t *out) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      for (int32_t i = 0; i < n; i++) out[i] = ((int8_t *)input)[start + i];
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      for (int32_t i = 0; i < n; i++) out[i] = ((int16_t *)input)[start + i];
+      break;
+    case TSDB_DATA_TYPE_INT:
+      for (int32_t i = 0; i < n; i++) out[i] = ((int32_t *)input)[start + i];
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+      memcpy(out, (int64_t *)input + start, n * sizeof(int64_t));
+      break;
+  }
+}
+
+// The same greedy selector choice as tsCompressINTImp, on zigzag deltas computed COMP_SIMD_CHUNK values at a time.
+// The window [start, end) always holds the 240 values a word may look ahead at.
+static int32_t tsCompressINTSimd(const SCompSimdKernels *pSimd, const char *const input, const int32_t nelements,
+                                 char *const output, const char type, int32_t word_length) {
+  int64_t  vals[COMP_SIMD_CHUNK + 1];
+  uint64_t zz[COMP_SIMD_CHUNK];
+  uint8_t  bits[COMP_SIMD_CHUNK];
+  int32_t  byte_limit = nelements * word_length + 1;
+  int32_t  opos = 1;
+  int32_t  start = 0, end = 0;
+
+  for (int32_t i = 0; i < nelements;) {
+    if (end < nelements && end - i <= SELECTOR_TO_ELEMS[0]) {
+      memmove(zz, zz + (i - start), (end - i) * sizeof(uint64_t));
+      memmove(bits, bits + (i - start), (end - i) * sizeof(uint8_t));
+      start = i;
+
+      int32_t n = TMIN(start + COMP_SIMD_CHUNK, nelements) - end;
+      vals[0] = 0;
+      if (end > 0) tsWidenINT(input, end - 1, 1, type, vals);
+      tsWidenINT(input, end, n, type, vals + 1);
+      if (!pSimd->zigzagDeltaI64(vals + 1, n, zz + (end - start))) goto _copy_and_exit;
+
+      for (int32_t j = end - start; j < end - start + n; j++) {
+        if (zz[j] >= SIMPLE8B_MAX_INT64) goto _copy_and_exit;
+        bits[j] = (zz[j] == 0) ? 0 : (LONG_BYTES * BITS_PER_BYTE) - BUILDIN_CLZL(zz[j]);
+      }
+      end += n;
+    }
+
+    int32_t selector = 0;
+    int32_t elems = 0;
+    for (int32_t j = i; j < nelements; j++) {
+      int32_t tmp_bit = bits[j - start];
+      if (elems + 1 <= SELECTOR_TO_ELEMS[selector] && elems + 1 <= SELECTOR_TO_ELEMS[BIT_TO_SELECTOR[tmp_bit]]) {
+        selector = TMAX(selector, BIT_TO_SELECTOR[tmp_bit]);
+        elems++;
+      } else {
+        while (elems < SELECTOR_TO_ELEMS[selector]) selector++;
+        elems = SELECTOR_TO_ELEMS[selector];
+        break;
+      }
+    }
+
+    int32_t  bit = BIT_PER_INTEGER[selector];
+    uint64_t buffer = (uint64_t)selector;
+    for (int32_t k = 0; k < elems; k++) {
+      buffer |= ((zz[i - start + k] & INT64MASK(bit)) << (bit * k + 4));
+    }
+    i += elems;
+
+    if (opos + sizeof(buffer) > byte_limit) goto _copy_and_exit;
+    memcpy(output + opos, &buffer, sizeof(buffer));
+    opos += sizeof(buffer);
+  }
+
+  output[0] = 0;
+  return opos;
+
+_copy_and_exit:
+  output[0] = 1;
+  memcpy(output + 1, input, byte_limit - 1);
+  return byte_limit;
+}
+
 int32_t tsCompressINTImp(const char *const input, const int32_t nelements, char *const output, const char type) {
   // Selector value:              0    1   2   3   4   5   6   7   8  9  10  11
   // 12  13  14  15
@@ -125,6 +229,9 @@ int32_t tsCompressINTImp(const char *const input, const int32_t nelements, char
       return -1;
   }
 
+  const SCompSimdKernels *pSimd = tsCompSimdKernels();
+  if (pSimd != NULL) return tsCompressINTSimd(pSimd, input, nelements, output, type, word_length);
+
   int32_t byte_limit = nelements * word_length + 1;
   int32_t opos = 1;
   int64_t prev_value = 0;
@@ -227,6 +334,55 @@ int32_t tsCompressINTImp(const char *const input, const int32_t nelements, char
   return opos;
 }
 
+static int32_t tsDecompressINTSimd(const SCompSimdKernels *pSimd, const char *const input, const int32_t nelements,
+                                   char *const output, const char type, int32_t word_length) {
+  int64_t     buf[240];
+  const char *ip = input + 1;
+  int32_t     _pos = 0;
+  int64_t     prev_value = 0;
+
+  while (_pos < nelements) {
+    uint64_t w = 0;
+    memcpy(&w, ip, LONG_BYTES);
+    ip += LONG_BYTES;
+
+    int32_t selector = (int32_t)(w & INT64MASK(4));
+    int32_t elems = TMIN(SELECTOR_TO_ELEMS[selector], nelements - _pos);
+
+    // the bigint values are decoded in place, the narrower ones through buf
+    int64_t *p = (type == TSDB_DATA_TYPE_BIGINT) ? (int64_t *)output + _pos : buf;
+    if (selector == 0 || selector == 1) {
+      for (int32_t i = 0; i < elems; i++) p[i] = prev_value;
+    } else if (elems >= 8) {
+      prev_value = pSimd->unpackSimple8b(w, BIT_PER_INTEGER[selector], elems, prev_value, p);
+    } else {
+      // too few values in the word to pay for the vector setup
+      int32_t  bit = BIT_PER_INTEGER[selector];
+      uint64_t mask = INT64MASK(bit);
+      for (int32_t i = 0; i < elems; i++) {
+        uint64_t zigzag_value = (w >> (4 + bit * i)) & mask;
+        prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
+        p[i] = prev_value;
+      }
+    }
+
+    switch (type) {
+      case TSDB_DATA_TYPE_INT:
+        for (int32_t i = 0; i < elems; i++) ((int32_t *)output)[_pos + i] = (int32_t)p[i];
+        break;
+      case TSDB_DATA_TYPE_SMALLINT:
+        for (int32_t i = 0; i < elems; i++) ((int16_t *)output)[_pos + i] = (int16_t)p[i];
+        break;
+      case TSDB_DATA_TYPE_TINYINT:
+        for (int32_t i = 0; i < elems; i++) ((int8_t *)output)[_pos + i] = (int8_t)p[i];
+        break;
+    }
+    _pos += elems;
+  }
+
+  return nelements * word_length;
+}
+
 int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, char *const output, const char type) {
 
   int32_t word_length = 0;
@@ -254,6 +410,9 @@ int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, cha
     return nelements * word_length;
   }
 
+  const SCompSimdKernels *pSimd = tsCompSimdKernels();
+  if (pSimd != NULL) return tsDecompressINTSimd(pSimd, input, nelements, output, type, word_length);
+
   // Selector value:              0    1   2   3   4   5   6   7   8  9  10  11
   // 12  13  14  15
   char    bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
@@ -264,185 +423,6 @@ int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, cha
   int32_t     _pos = 0;
   int64_t     prev_value = 0;
 
-#if __AVX2__
-  while (1) {
-    if (_pos == nelements) break;
-
-    uint64_t w = 0;
-    memcpy(&w, ip, LONG_BYTES);
-
-    char    selector = (char)(w & INT64MASK(4));       // selector = 4
-    char    bit = bit_per_integer[(int32_t)selector];  // bit = 3
-    int32_t elems = selector_to_elems[(int32_t)selector];
-
-    // Optimize the performance, by remove the constantly switch operation.
-    int32_t  v = 4;
-    uint64_t zigzag_value = 0;
-    uint64_t mask = INT64MASK(bit);
-
-    switch (type) {
-      case TSDB_DATA_TYPE_BIGINT: {
-        int64_t* p = (int64_t*) output;
-
-        int32_t gRemainder = (nelements - _pos);
-        int32_t num = (gRemainder > elems)? elems:gRemainder;
-
-        int32_t batch = num >> 2;
-        int32_t remain = num & 0x03;
-        if (selector == 0 || selector == 1) {
-          if (tsAVX2Enable && tsSIMDBuiltins) {
-            for (int32_t i = 0; i < batch; ++i) {
-              __m256i prev = _mm256_set1_epi64x(prev_value);
-              _mm256_storeu_si256((__m256i *)&p[_pos], prev);
-              _pos += 4;
-            }
-
-            for (int32_t i = 0; i < remain; ++i) {
-              p[_pos++] = prev_value;
-            }
-          } else {
-            for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
-              p[_pos++] = prev_value;
-              v += bit;
-            }
-          }
-        } else {
-          if (tsAVX2Enable && tsSIMDBuiltins) {
-            __m256i base = _mm256_set1_epi64x(w);
-            __m256i maskVal = _mm256_set1_epi64x(mask);
-
-            __m256i shiftBits = _mm256_set_epi64x(bit * 3 + 4, bit * 2 + 4, bit + 4, 4);
-            __m256i inc = _mm256_set1_epi64x(bit << 2);
-
-            for (int32_t i = 0; i < batch; ++i) {
-              __m256i after = _mm256_srlv_epi64(base, shiftBits);
-              __m256i zigzagVal = _mm256_and_si256(after, maskVal);
-
-              // ZIGZAG_DECODE(T, v) (((v) >> 1) ^ -((T)((v)&1)))
-              __m256i signmask = _mm256_and_si256(_mm256_set1_epi64x(1), zigzagVal);
-              signmask = _mm256_sub_epi64(_mm256_setzero_si256(), signmask);
-              // get the four zigzag values here
-              __m256i delta = _mm256_xor_si256(_mm256_srli_epi64(zigzagVal, 1), signmask);
-
-              // calculate the cumulative sum (prefix sum) for each number
-              // decode[0] = prev_value + final[0]
-              // decode[1] = decode[0] + final[1]   -----> prev_value + final[0] + final[1]
-              // decode[2] = decode[1] + final[2]   -----> prev_value + final[0] + final[1] + final[2]
-              // decode[3] = decode[2] + final[3]   -----> prev_value + final[0] + final[1] + final[2] + final[3]
-
-              //  1, 2, 3, 4
-              //+ 0, 1, 0, 3
-              //  1, 3, 3, 7
-              // shift and add for the first round
-              __m128i prev = _mm_set1_epi64x(prev_value);
-              __m256i x =  _mm256_slli_si256(delta, 8);
-
-              delta = _mm256_add_epi64(delta, x);
-              _mm256_storeu_si256((__m256i *)&p[_pos], delta);
-
-              //  1, 3, 3, 7
-              //+ 0, 0, 3, 3
-              //  1, 3, 6, 10
-              // shift and add operation for the second round
-              __m128i firstPart = _mm_loadu_si128((__m128i *)&p[_pos]);
-              __m128i secondItem = _mm_set1_epi64x(p[_pos + 1]);
-              __m128i secPart = _mm_add_epi64(_mm_loadu_si128((__m128i *)&p[_pos + 2]), secondItem);
-              firstPart = _mm_add_epi64(firstPart, prev);
-              secPart = _mm_add_epi64(secPart, prev);
-
-              // save it in the memory
-              _mm_storeu_si128((__m128i *)&p[_pos], firstPart);
-              _mm_storeu_si128((__m128i *)&p[_pos + 2], secPart);
-
-              shiftBits = _mm256_add_epi64(shiftBits, inc);
-              prev_value = p[_pos + 3];
-//              uDebug("_pos:%d %"PRId64", %"PRId64", %"PRId64", %"PRId64, _pos, p[_pos], p[_pos+1], p[_pos+2], p[_pos+3]);
-              _pos += 4;
-            }
-
-            // handle the remain value
-            for (int32_t i = 0; i < remain; i++) {
-              zigzag_value = ((w >> (v + (batch * bit * 4))) & mask);
-              prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
-
-              p[_pos++] = prev_value;
-//              uDebug("_pos:%d %"PRId64, _pos-1, p[_pos-1]);
-
-              v += bit;
-            }
-          } else {
-            for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
-              zigzag_value = ((w >> v) & mask);
-              prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
-
-              p[_pos++] = prev_value;
-//              uDebug("_pos:%d %"PRId64, _pos-1, p[_pos-1]);
-
-              v += bit;
-            }
-          }
-        }
-      } break;
-      case TSDB_DATA_TYPE_INT: {
-        int32_t* p = (int32_t*) output;
-
-        if (selector == 0 || selector == 1) {
-          for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
-            p[_pos++] = (int32_t)prev_value;
-          }
-        } else {
-          for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
-            zigzag_value = ((w >> v) & mask);
-            prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
-
-            p[_pos++] = (int32_t)prev_value;
-            v += bit;
-          }
-        }
-      } break;
-      case TSDB_DATA_TYPE_SMALLINT: {
-        int16_t* p = (int16_t*) output;
-
-        if (selector == 0 || selector == 1) {
-          for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
-            p[_pos++] = (int16_t)prev_value;
-          }
-        } else {
-          for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
-            zigzag_value = ((w >> v) & mask);
-            prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
-
-            p[_pos++] = (int16_t)prev_value;
-            v += bit;
-          }
-        }
-      } break;
-
-      case TSDB_DATA_TYPE_TINYINT: {
-        int8_t *p = (int8_t *)output;
-
-        if (selector == 0 || selector == 1) {
-          for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
-            p[_pos++] = (int8_t)prev_value;
-          }
-        } else {
-          for (int32_t i = 0; i < elems && count < nelements; i++, count++) {
-            zigzag_value = ((w >> v) & mask);
-            prev_value += ZIGZAG_DECODE(int64_t, zigzag_value);
-
-            p[_pos++] = (int8_t)prev_value;
-            v += bit;
-          }
-        }
-      } break;
-    }
-
-    ip += LONG_BYTES;
-  }
-
-  return nelements * word_length;
-#else
-
   while (1) {
     if (count == nelements) break;
 
@@ -493,7 +473,6 @@ int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, cha
   }
 
   return nelements * word_length;
-#endif
 }
 
 /* ----------------------------------------------Bool Compression
@@ -648,6 +627,65 @@ int32_t tsDecompressStringImp(const char *const input, int32_t compressedSize, c
 
 /* --------------------------------------------Timestamp Compression
  * ---------------------------------------------- */
+// The deltas of delta are computed COMP_SIMD_CHUNK values at a time, each pair is then written with two whole word
+// stores as long as 17 bytes are left in the output, which holds nelements * LONG_BYTES + 1 bytes.
+static int32_t tsCompressTimestampSimd(const SCompSimdKernels *pSimd, const char *const input,
+                                       const int32_t nelements, char *const output) {
+  int64_t *istream = (int64_t *)input;
+  int32_t  limit = nelements * LONG_BYTES;
+  int32_t  _pos = 1;
+  uint64_t zz[COMP_SIMD_CHUNK];
+
+  if (istream[0] < 0) {
+    uWarn("compression timestamp is over signed long long range. ts = 0x%" PRIx64 " \n", istream[0]);
+    goto _exit_over;
+  }
+
+  for (int32_t i = 0; i < nelements; i += COMP_SIMD_CHUNK) {
+    int32_t n = TMIN(COMP_SIMD_CHUNK, nelements - i);
+    int32_t k = 0;
+    if (i == 0) {
+      // the first value is stored as is and the second one as a plain delta
+      zz[k++] = ZIGZAG_ENCODE(int64_t, istream[0]);
+      if (n > 1 && !pSimd->zigzagDeltaI64(istream + k, 1, zz + k)) goto _exit_over;
+      k = TMIN(n, 2);
+    }
+    if (!pSimd->zigzagDeltaOfDeltaI64(istream + i + k, n - k, zz + k)) goto _exit_over;
+
+    for (int32_t j = 0; j < n; j += 2) {
+      uint64_t dd1 = zz[j];
+      uint64_t dd2 = (j + 1 < n) ? zz[j + 1] : 0;
+      uint8_t  flag1 = (dd1 == 0) ? 0 : (uint8_t)(LONG_BYTES - BUILDIN_CLZL(dd1) / BITS_PER_BYTE);
+      uint8_t  flag2 = (dd2 == 0) ? 0 : (uint8_t)(LONG_BYTES - BUILDIN_CLZL(dd2) / BITS_PER_BYTE);
+
+      if (_pos + CHAR_BYTES + LONG_BYTES * 2 <= limit) {
+        output[_pos++] = (char)(flag1 | (flag2 << 4));
+        memcpy(output + _pos, &dd1, LONG_BYTES);
+        _pos += flag1;
+        memcpy(output + _pos, &dd2, LONG_BYTES);
+        _pos += flag2;
+      } else {
+        if ((_pos + CHAR_BYTES - 1) >= limit) goto _exit_over;
+        output[_pos++] = (char)(flag1 | (flag2 << 4));
+        if ((_pos + flag1 - 1) >= limit) goto _exit_over;
+        memcpy(output + _pos, &dd1, flag1);
+        _pos += flag1;
+        if ((_pos + flag2 - 1) >= limit) goto _exit_over;
+        memcpy(output + _pos, &dd2, flag2);
+        _pos += flag2;
+      }
+    }
+  }
+
+  output[0] = 1;
+  return _pos;
+
+_exit_over:
+  output[0] = 0;
+  memcpy(output + 1, input, nelements * LONG_BYTES);
+  return nelements * LONG_BYTES + 1;
+}
+
 // TODO: Take care here, we assumes little endian encoding.
 int32_t tsCompressTimestampImp(const char *const input, const int32_t nelements, char *const output) {
   int32_t _pos = 1;
@@ -655,6 +693,9 @@ int32_t tsCompressTimestampImp(const char *const input, const int32_t nelements,
 
   if (nelements == 0) return 0;
 
+  const SCompSimdKernels *pSimd = tsCompSimdKernels();
+  if (pSimd != NULL) return tsCompressTimestampSimd(pSimd, input, nelements, output);
+
   int64_t *istream = (int64_t *)input;
 
   int64_t prev_value = istream[0];
@@ -745,6 +786,51 @@ _exit_over:
   return nelements * LONG_BYTES + 1;
 }
 
+// The deltas of delta are parsed into the output first, a run of empty flag bytes being a run of zeros, then one
+// prefix sum pass turns them into the values.
+static int32_t tsDecompressTimestampSimd(const SCompSimdKernels *pSimd, const char *const input,
+                                         const int32_t nelements, char *const output) {
+  int64_t *ostream = (int64_t *)output;
+  int32_t  ipos = 1, opos = 0;
+
+  while (opos < nelements) {
+    int32_t remain = nelements - opos;
+
+    // every pair left has a flag byte, so there are at least remain / 2 bytes to scan
+    if (input[ipos] == 0 && remain >= 2) {
+      int32_t nzero = pSimd->zeroBytes((const uint8_t *)input + ipos, remain / 2);
+      memset(ostream + opos, 0, nzero * 2 * sizeof(int64_t));
+      ipos += nzero;
+      opos += nzero * 2;
+      continue;
+    }
+
+    uint8_t  flags = input[ipos++];
+    int32_t  nbytes1 = flags & INT8MASK(4);
+    int32_t  nbytes2 = (flags >> 4) & INT8MASK(4);
+    uint64_t dd1 = 0, dd2 = 0;
+    if (remain >= 18) {
+      // the flag bytes of the 8 pairs after this one are still ahead, the word loads stay in the input
+      memcpy(&dd1, input + ipos, LONG_BYTES);
+      memcpy(&dd2, input + ipos + nbytes1, LONG_BYTES);
+      dd1 &= COMP_BYTE_MASK[nbytes1];
+      dd2 &= COMP_BYTE_MASK[nbytes2];
+    } else {
+      memcpy(&dd1, input + ipos, nbytes1);
+      memcpy(&dd2, input + ipos + nbytes1, nbytes2);
+    }
+    ipos += nbytes1 + nbytes2;
+
+    ostream[opos++] = ZIGZAG_DECODE(int64_t, dd1);
+    if (opos < nelements) ostream[opos++] = ZIGZAG_DECODE(int64_t, dd2);
+  }
+
+  // the first value is stored as is and starts with a zero delta
+  int64_t value = ostream[0], delta = 0;
+  pSimd->prefixSum2I64(ostream + 1, nelements - 1, &value, &delta);
+  return nelements * LONG_BYTES;
+}
+
 int32_t tsDecompressTimestampImp(const char *const input, const int32_t nelements, char *const output) {
   ASSERTS(nelements >= 0, "nelements is negative");
   if (nelements == 0) return 0;
@@ -752,6 +838,8 @@ int32_t tsDecompressTimestampImp(const char *const input, const int32_t nelement
   if (input[0] == 0) {
     memcpy(output, input + 1, nelements * LONG_BYTES);
     return nelements * LONG_BYTES;
+  } else if (input[0] == 1 && tsCompSimdKernels() != NULL) {
+    return tsDecompressTimestampSimd(tsCompSimdKernels(), input, nelements, output);
   } else if (input[0] == 1) {  // Decompress
     int64_t *ostream = (int64_t *)output;
 
@@ -828,7 +916,74 @@ void encodeDoubleValue(uint64_t diff, uint8_t flag, char *const output, int32_t
   }
 }
 
+static FORCE_INLINE uint8_t tsDoubleFlag(uint64_t diff) {
+  if (diff == 0) return 0;
+
+  int32_t trailing_zeros = BUILDIN_CTZL(diff);
+  int32_t leading_zeros = BUILDIN_CLZL(diff);
+  uint8_t nbytes;
+  if (trailing_zeros > leading_zeros) {
+    nbytes = (uint8_t)(LONG_BYTES - trailing_zeros / BITS_PER_BYTE);
+    if (nbytes > 0) nbytes--;
+    return ((uint8_t)1 << 3) | nbytes;
+  } else {
+    nbytes = (uint8_t)(LONG_BYTES - leading_zeros / BITS_PER_BYTE);
+    if (nbytes > 0) nbytes--;
+    return nbytes;
+  }
+}
+
+// The XOR with the previous value is computed COMP_SIMD_CHUNK values at a time, each pair is then written with two
+// whole word stores as long as 17 bytes are left in the output.
+static int32_t tsCompressDoubleSimd(const SCompSimdKernels *pSimd, const char *const input, const int32_t nelements,
+                                    char *const output) {
+  const uint64_t *istream = (const uint64_t *)input;
+  int32_t         byte_limit = nelements * DOUBLE_BYTES + 1;
+  int32_t         opos = 1;
+  uint64_t        diffs[COMP_SIMD_CHUNK];
+
+  for (int32_t i = 0; i < nelements; i += COMP_SIMD_CHUNK) {
+    int32_t n = TMIN(COMP_SIMD_CHUNK, nelements - i);
+    int32_t k = 0;
+    if (i == 0) diffs[k++] = istream[0];
+    pSimd->xorPrevU64(istream + i + k, n - k, diffs + k);
+
+    for (int32_t j = 0; j < n; j += 2) {
+      uint64_t diff1 = diffs[j];
+      uint64_t diff2 = (j + 1 < n) ? diffs[j + 1] : 0;
+      uint8_t  flag1 = tsDoubleFlag(diff1);
+      uint8_t  flag2 = tsDoubleFlag(diff2);
+      int32_t  nbyte1 = (flag1 & INT8MASK(3)) + 1;
+      int32_t  nbyte2 = (flag2 & INT8MASK(3)) + 1;
+
+      if (opos + 1 + LONG_BYTES * 2 <= byte_limit) {
+        output[opos++] = (char)(flag1 | (flag2 << 4));
+        diff1 >>= (LONG_BYTES * BITS_PER_BYTE - nbyte1 * BITS_PER_BYTE) * (flag1 >> 3);
+        memcpy(output + opos, &diff1, LONG_BYTES);
+        opos += nbyte1;
+        diff2 >>= (LONG_BYTES * BITS_PER_BYTE - nbyte2 * BITS_PER_BYTE) * (flag2 >> 3);
+        memcpy(output + opos, &diff2, LONG_BYTES);
+        opos += nbyte2;
+      } else if (opos + 1 + nbyte1 + nbyte2 <= byte_limit) {
+        output[opos++] = (char)(flag1 | (flag2 << 4));
+        encodeDoubleValue(diff1, flag1, output, &opos);
+        encodeDoubleValue(diff2, flag2, output, &opos);
+      } else {
+        output[0] = 1;
+        memcpy(output + 1, input, byte_limit - 1);
+        return byte_limit;
+      }
+    }
+  }
+
+  output[0] = 0;
+  return opos;
+}
+
 int32_t tsCompressDoubleImp(const char *const input, const int32_t nelements, char *const output) {
+  const SCompSimdKernels *pSimd = tsCompSimdKernels();
+  if (pSimd != NULL) return tsCompressDoubleSimd(pSimd, input, nelements, output);
+
   int32_t byte_limit = nelements * DOUBLE_BYTES + 1;
   int32_t opos = 1;
 
@@ -924,6 +1079,39 @@ FORCE_INLINE uint64_t decodeDoubleValue(const char *const input, int32_t *const
   return diff;
 }
 
+// The XORed values are parsed into the output first, then one prefix XOR pass turns them into the values.
+static int32_t tsDecompressDoubleSimd(const SCompSimdKernels *pSimd, const char *const input, const int32_t nelements,
+                                      char *const output) {
+  uint64_t *ostream = (uint64_t *)output;
+  uint8_t   flags = 0;
+  int32_t   ipos = 1;
+
+  for (int32_t i = 0; i < nelements; i++) {
+    if ((i & 0x01) == 0) {
+      flags = input[ipos++];
+    }
+
+    uint8_t  flag = flags & 0x0f;
+    int32_t  nbytes = (flag & 0x7) + 1;
+    uint64_t diff = 0;
+    flags >>= 4;
+
+    // every value left takes at least one byte, so a word load at ipos stays in the input
+    if (nelements - i >= LONG_BYTES) {
+      memcpy(&diff, input + ipos, LONG_BYTES);
+      diff &= COMP_BYTE_MASK[nbytes];
+    } else {
+      memcpy(&diff, input + ipos, nbytes);
+    }
+    ipos += nbytes;
+    ostream[i] = diff << ((LONG_BYTES * BITS_PER_BYTE - nbytes * BITS_PER_BYTE) * (flag >> 3));
+  }
+
+  uint64_t prev = 0;
+  pSimd->prefixXorU64(ostream, nelements, &prev);
+  return nelements * DOUBLE_BYTES;
+}
+
 int32_t tsDecompressDoubleImp(const char *const input, const int32_t nelements, char *const output) {
   // output stream
   double *ostream = (double *)output;
@@ -933,6 +1121,9 @@ int32_t tsDecompressDoubleImp(const char *const input, const int32_t nelements,
     return nelements * DOUBLE_BYTES;
   }
 
+  const SCompSimdKernels *pSimd = tsCompSimdKernels();
+  if (pSimd != NULL) return tsDecompressDoubleSimd(pSimd, input, nelements, output);
+
   uint8_t  flags = 0;
   int32_t  ipos = 1;
   int32_t  opos = 0;
@@ -973,7 +1164,73 @@ void encodeFloatValue(uint32_t diff, uint8_t flag, char *const output, int32_t *
   }
 }
 
+static FORCE_INLINE uint8_t tsFloatFlag(uint32_t diff) {
+  if (diff == 0) return 0;
+
+  int32_t ctz = BUILDIN_CTZ(diff);
+  int32_t clz = BUILDIN_CLZ(diff);
+  uint8_t nbytes;
+  if (ctz > clz) {
+    nbytes = (uint8_t)(FLOAT_BYTES - ctz / BITS_PER_BYTE);
+    if (nbytes > 0) nbytes--;
+    return ((uint8_t)1 << 3) | nbytes;
+  } else {
+    nbytes = (uint8_t)(FLOAT_BYTES - clz / BITS_PER_BYTE);
+    if (nbytes > 0) nbytes--;
+    return nbytes;
+  }
+}
+
+// Same as tsCompressDoubleSimd, with 4-byte stores.
+static int32_t tsCompressFloatSimd(const SCompSimdKernels *pSimd, const char *const input, const int32_t nelements,
+                                   char *const output) {
+  const uint32_t *istream = (const uint32_t *)input;
+  int32_t         byte_limit = nelements * FLOAT_BYTES + 1;
+  int32_t         opos = 1;
+  uint32_t        diffs[COMP_SIMD_CHUNK];
+
+  for (int32_t i = 0; i < nelements; i += COMP_SIMD_CHUNK) {
+    int32_t n = TMIN(COMP_SIMD_CHUNK, nelements - i);
+    int32_t k = 0;
+    if (i == 0) diffs[k++] = istream[0];
+    pSimd->xorPrevU32(istream + i + k, n - k, diffs + k);
+
+    for (int32_t j = 0; j < n; j += 2) {
+      uint32_t diff1 = diffs[j];
+      uint32_t diff2 = (j + 1 < n) ? diffs[j + 1] : 0;
+      uint8_t  flag1 = tsFloatFlag(diff1);
+      uint8_t  flag2 = tsFloatFlag(diff2);
+      int32_t  nbyte1 = (flag1 & INT8MASK(3)) + 1;
+      int32_t  nbyte2 = (flag2 & INT8MASK(3)) + 1;
+
+      if (opos + 1 + FLOAT_BYTES * 2 <= byte_limit) {
+        output[opos++] = (char)(flag1 | (flag2 << 4));
+        diff1 >>= (FLOAT_BYTES * BITS_PER_BYTE - nbyte1 * BITS_PER_BYTE) * (flag1 >> 3);
+        memcpy(output + opos, &diff1, FLOAT_BYTES);
+        opos += nbyte1;
+        diff2 >>= (FLOAT_BYTES * BITS_PER_BYTE - nbyte2 * BITS_PER_BYTE) * (flag2 >> 3);
+        memcpy(output + opos, &diff2, FLOAT_BYTES);
+        opos += nbyte2;
+      } else if (opos + 1 + nbyte1 + nbyte2 <= byte_limit) {
+        output[opos++] = (char)(flag1 | (flag2 << 4));
+        encodeFloatValue(diff1, flag1, output, &opos);
+        encodeFloatValue(diff2, flag2, output, &opos);
+      } else {
+        output[0] = 1;
+        memcpy(output + 1, input, byte_limit - 1);
+        return byte_limit;
+      }
+    }
+  }
+
+  output[0] = 0;
+  return opos;
+}
+
 int32_t tsCompressFloatImp(const char *const input, const int32_t nelements, char *const output) {
+  const SCompSimdKernels *pSimd = tsCompSimdKernels();
+  if (pSimd != NULL) return tsCompressFloatSimd(pSimd, input, nelements, output);
+
   float  *istream = (float *)input;
   int32_t byte_limit = nelements * FLOAT_BYTES + 1;
   int32_t opos = 1;
@@ -1068,6 +1325,38 @@ uint32_t decodeFloatValue(const char *const input, int32_t *const ipos, uint8_t
   return diff;
 }
 
+// Same as tsDecompressDoubleSimd, with 4-byte loads.
+static int32_t tsDecompressFloatSimd(const SCompSimdKernels *pSimd, const char *const input, const int32_t nelements,
+                                     char *const output) {
+  uint32_t *ostream = (uint32_t *)output;
+  uint8_t   flags = 0;
+  int32_t   ipos = 1;
+
+  for (int32_t i = 0; i < nelements; i++) {
+    if (i % 2 == 0) {
+      flags = input[ipos++];
+    }
+
+    uint8_t  flag = flags & INT8MASK(4);
+    int32_t  nbytes = (flag & INT8MASK(3)) + 1;
+    uint32_t diff = 0;
+    flags >>= 4;
+
+    if (nelements - i >= FLOAT_BYTES && nbytes <= FLOAT_BYTES) {
+      memcpy(&diff, input + ipos, FLOAT_BYTES);
+      diff &= (uint32_t)COMP_BYTE_MASK[nbytes];
+    } else {
+      for (int32_t k = 0; k < nbytes; k++) diff |= ((INT32MASK(8) & input[ipos + k]) << BITS_PER_BYTE * k);
+    }
+    ipos += nbytes;
+    ostream[i] = diff << ((FLOAT_BYTES * BITS_PER_BYTE - nbytes * BITS_PER_BYTE) * (flag >> 3));
+  }
+
+  uint32_t prev = 0;
+  pSimd->prefixXorU32(ostream, nelements, &prev);
+  return nelements * FLOAT_BYTES;
+}
+
 int32_t tsDecompressFloatImp(const char *const input, const int32_t nelements, char *const output) {
   float *ostream = (float *)output;
 
@@ -1076,6 +1365,9 @@ int32_t tsDecompressFloatImp(const char *const input, const int32_t nelements, c
     return nelements * FLOAT_BYTES;
   }
 
+  const SCompSimdKernels *pSimd = tsCompSimdKernels();
+  if (pSimd != NULL) return tsDecompressFloatSimd(pSimd, input, nelements, output);
+
   uint8_t  flags = 0;
   int32_t  ipos = 1;
   int32_t  opos = 0;
@@ -1610,12 +1902,6 @@ static int32_t tCompTimestampEnd(SCompressor *pCmprsor, const uint8_t **ppData,
 
 // Integer =====================================================
 #define SIMPLE8B_MAX ((uint64_t)1152921504606846974LL)
-static const uint8_t BIT_PER_INTEGER[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
-static const int32_t SELECTOR_TO_ELEMS[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
-static const uint8_t BIT_TO_SELECTOR[] = {0,  2,  3,  4,  5,  6,  7,  8,  9,  10, 10, 11, 11, 12, 12, 12,
-                                          13, 13, 13, 13, 13, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 15,
-                                          15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
-                                          15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15};
 static const int32_t NEXT_IDX[] = {
     1,   2,   3,   4,   5,   6,   7,   8,   9,   10,  11,  12,  13,  14,  15,  16,  17,  18,  19,  20,  21,  22,
     23,  24,  25,  26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,  41,  42,  43,  44,
@@ -1,5 +1,6 @@
 #define _DEFAULT_SOURCE
 #include "tpagedbuf.h"
+#include "lz4.h"
 #include "taoserror.h"
 #include "tcompression.h"
 #include "tsimplehash.h"
@@ -10,6 +11,10 @@
 #define CLEAR_BUF_PAGE_IN_MEM_FLAG(_p) ((_p)->pData = NULL)
 #define HAS_DATA_IN_DISK(_p)           ((_p)->offset >= 0)
 #define NO_IN_MEM_AVAILABLE_PAGES(_b)  (listNEles((_b)->lruList) >= (_b)->inMemPages)
+#define PAGE_DISK_SIZE(_b)             ((_b)->pageSize + (int32_t)sizeof(SFilePage))
+
+#define PAGE_IO_WRITE 1
+#define PAGE_IO_READ  2
 
 typedef struct SPageDiskInfo {
   int64_t offset;
@@ -26,6 +31,37 @@ struct SPageInfo {
   bool       dirty : 1;  // set current buffer page is dirty or not
 };
 
+/**
+ * Pending disk io of one page. A write request owns a copy of the (compressed) page image, so the page memory can be
+ * reused as soon as the request is queued, and the page is served from this copy until the write is done. A read
+ * request is a prefetch, its buffer is handed to the next load of the page.
+ */
+typedef struct SPageIoReq {
+  int32_t pageId;
+  int8_t  type;
+  bool    done;
+  bool    cancelled;  // a prefetched page that is overwritten before it is consumed
+  int32_t code;
+  int32_t length;
+  int64_t offset;
+  char*   pData;
+} SPageIoReq;
+
+typedef struct SPageIoQueue {
+  TdThread      thread;
+  TdThreadMutex mutex;
+  TdThreadCond  notEmpty;  // wake up the io thread
+  TdThreadCond  ioDone;    // wake up the query thread waiting for a request to complete
+  SList*        pQueue;    // SPageIoReq* to be processed in FIFO order
+  SSHashObj*    pPending;  // pageId -> latest SPageIoReq* of this page
+  int64_t       inflight;  // bytes held by queued requests and unconsumed prefetched pages
+  int64_t       maxInflight;
+  int32_t       numOfActive;  // requests queued or being processed
+  int32_t       code;         // the first error of the io thread
+  bool          stop;
+  bool          running;
+} SPageIoQueue;
+
 struct SDiskbasedBuf {
   int32_t   numOfPages;
   int64_t   totalBufSize;
@@ -45,6 +81,7 @@ struct SDiskbasedBuf {
   SArray*   pFree;             // free area in file
   bool      comp;              // compressed before flushed to disk
   uint64_t  nextPos;           // next page flush position
+  SPageIoQueue* pIo;           // write-behind and prefetch of pages, NULL if all io is synchronous
 
   char*               id;           // for debug purpose
   bool                printStatis;  // Print statistics info when closing this buffer.
@@ -70,52 +107,58 @@ static int32_t createDiskFile(SDiskbasedBuf* pBuf) {
   return TSDB_CODE_SUCCESS;
 }
 
-static char* doCompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {  // do nothing
-  if (!pBuf->comp) {
-    *dst = srcSize;
-    return data;
+/*
+ * A page is compressed by LZ4 into dst, and is kept as it is if it can not be compressed. The on disk length tells them
+ * apart: only the uncompressed page image has the length of PAGE_DISK_SIZE.
+ */
+static int32_t doCompressData(SDiskbasedBuf* pBuf, const char* data, char* dst) {
+  int32_t srcSize = PAGE_DISK_SIZE(pBuf);
+  if (pBuf->comp) {
+    int32_t len = LZ4_compress_default(data, dst, srcSize, srcSize - 1);
+    if (len > 0) {
+      return len;
+    }
   }
 
-  *dst = tsCompressString(data, srcSize, 1, pBuf->assistBuf, srcSize, ONE_STAGE_COMP, NULL, 0);
-
-  memcpy(data, pBuf->assistBuf, *dst);
-  return data;
+  memcpy(dst, data, srcSize);
+  return srcSize;
 }
 
-static char* doDecompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {  // do nothing
-  if (!pBuf->comp) {
-    *dst = srcSize;
-    return data;
+static int32_t doDecompressData(SDiskbasedBuf* pBuf, const char* data, int32_t srcSize, char* dst) {
+  int32_t dstSize = PAGE_DISK_SIZE(pBuf);
+  if (srcSize == dstSize) {
+    if (data != dst) {
+      memcpy(dst, data, srcSize);
+    }
+    return TSDB_CODE_SUCCESS;
   }
 
-  *dst = tsDecompressString(data, srcSize, 1, pBuf->assistBuf, pBuf->pageSize, ONE_STAGE_COMP, NULL, 0);
-  if (*dst > 0) {
-    memcpy(data, pBuf->assistBuf, *dst);
+  int32_t len = LZ4_decompress_safe(data, dst, srcSize, dstSize);
+  if (len != dstSize) {
+    uError("failed to decompress buf page, len:%d, expect:%d, %s", len, dstSize, pBuf->id);
+    return TSDB_CODE_INVALID_PARA;
   }
-  return data;
+
+  return TSDB_CODE_SUCCESS;
 }
 
 static uint64_t allocateNewPositionInFile(SDiskbasedBuf* pBuf, size_t size) {
-  if (pBuf->pFree == NULL) {
-    return pBuf->nextPos;
-  } else {
-    int32_t offset = -1;
-
-    size_t num = taosArrayGetSize(pBuf->pFree);
-    for (int32_t i = 0; i < num; ++i) {
-      SFreeListItem* pi = taosArrayGet(pBuf->pFree, i);
-      if (pi->length >= size) {
-        offset = pi->offset;
-        pi->offset += (int32_t)size;
-        pi->length -= (int32_t)size;
-
-        return offset;
-      }
+  size_t num = taosArrayGetSize(pBuf->pFree);
+  for (int32_t i = 0; i < num; ++i) {
+    SFreeListItem* pi = taosArrayGet(pBuf->pFree, i);
+    if (pi->length >= size) {
+      int64_t offset = pi->offset;
+      pi->offset += (int32_t)size;
+      pi->length -= (int32_t)size;
+
+      return offset;
     }
-
-    // no available recycle space, allocate new area in file
-    return pBuf->nextPos;
   }
+
+  // no available recycle space, allocate new area in file
+  uint64_t offset = pBuf->nextPos;
+  pBuf->nextPos += size;
+  return offset;
 }
 
 /**
@@ -129,17 +172,235 @@ static uint64_t allocateNewPositionInFile(SDiskbasedBuf* pBuf, size_t size) {
 
 static FORCE_INLINE size_t getAllocPageSize(int32_t pageSize) { return pageSize + POINTER_BYTES + sizeof(SFilePage); }
 
-static int32_t doFlushBufPageImpl(SDiskbasedBuf* pBuf, int64_t offset, const char* pData, int32_t size) {
-  int32_t ret = taosLSeekFile(pBuf->pFile, offset, SEEK_SET);
-  if (ret == -1) {
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    return terrno;
+static void destroyPageIoReq(SPageIoReq* pReq) {
+  if (pReq != NULL) {
+    taosMemoryFree(pReq->pData);
+    taosMemoryFree(pReq);
+  }
+}
+
+static void* pageIoThreadFp(void* param) {
+  SDiskbasedBuf* pBuf = param;
+  SPageIoQueue*  pIo = pBuf->pIo;
+  setThreadName("pagedBufIo");
+
+  taosThreadMutexLock(&pIo->mutex);
+  while (1) {
+    while (!pIo->stop && listNEles(pIo->pQueue) == 0) {
+      taosThreadCondWait(&pIo->notEmpty, &pIo->mutex);
+    }
+
+    if (pIo->stop) {
+      break;
+    }
+
+    SListNode*  pNode = tdListPopHead(pIo->pQueue);
+    SPageIoReq* pReq = *(SPageIoReq**)pNode->data;
+    bool        skip = pReq->cancelled;
+    taosMemoryFree(pNode);
+    taosThreadMutexUnlock(&pIo->mutex);
+
+    int32_t code = TSDB_CODE_SUCCESS;
+    if (!skip) {
+      int64_t ret = (pReq->type == PAGE_IO_WRITE)
+                        ? taosPWriteFile(pBuf->pFile, pReq->pData, pReq->length, pReq->offset)
+                        : taosPReadFile(pBuf->pFile, pReq->pData, pReq->length, pReq->offset);
+      if (ret != pReq->length) {
+        code = TAOS_SYSTEM_ERROR(errno);
+      }
+    }
+
+    taosThreadMutexLock(&pIo->mutex);
+    pReq->done = true;
+    pReq->code = code;
+    pIo->numOfActive -= 1;
+
+    // a prefetched page stays in the pending list until it is consumed
+    if (pReq->type == PAGE_IO_WRITE || pReq->cancelled) {
+      if (pReq->type == PAGE_IO_WRITE && code != TSDB_CODE_SUCCESS && pIo->code == TSDB_CODE_SUCCESS) {
+        uError("failed to write buf page:%d in background, code:%s, %s", pReq->pageId, tstrerror(code), pBuf->id);
+        pIo->code = code;
+      }
+
+      SPageIoReq** p = tSimpleHashGet(pIo->pPending, &pReq->pageId, sizeof(int32_t));
+      if (p != NULL && *p == pReq) {
+        tSimpleHashRemove(pIo->pPending, &pReq->pageId, sizeof(int32_t));
+      }
+
+      pIo->inflight -= pReq->length;
+      destroyPageIoReq(pReq);
+    }
+
+    taosThreadCondBroadcast(&pIo->ioDone);
+  }
+
+  taosThreadMutexUnlock(&pIo->mutex);
+  return NULL;
+}
+
+static int32_t startPageIo(SDiskbasedBuf* pBuf) {
+  SPageIoQueue* pIo = pBuf->pIo;
+  if (pIo->running) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  TdThreadAttr thAttr;
+  taosThreadAttrInit(&thAttr);
+  taosThreadAttrSetDetachState(&thAttr, PTHREAD_CREATE_JOINABLE);
+  int32_t code = taosThreadCreate(&pIo->thread, &thAttr, pageIoThreadFp, pBuf);
+  taosThreadAttrDestroy(&thAttr);
+  if (code != 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    uError("failed to create io thread of paged buffer, code:%s, %s", tstrerror(code), pBuf->id);
+    return code;
+  }
+
+  pIo->running = true;
+  return TSDB_CODE_SUCCESS;
+}
+
+// wait for all requests to complete, and discard the prefetched pages
+static void drainPageIo(SPageIoQueue* pIo) {
+  taosThreadMutexLock(&pIo->mutex);
+  while (pIo->numOfActive > 0) {
+    taosThreadCondWait(&pIo->ioDone, &pIo->mutex);
+  }
+
+  int32_t iter = 0;
+  void*   p = NULL;
+  while ((p = tSimpleHashIterate(pIo->pPending, p, &iter)) != NULL) {
+    SPageIoReq* pReq = *(SPageIoReq**)p;
+    pIo->inflight -= pReq->length;
+    destroyPageIoReq(pReq);
+  }
+
+  tSimpleHashClear(pIo->pPending);
+  taosThreadMutexUnlock(&pIo->mutex);
+}
+
+static void destroyPageIo(SPageIoQueue* pIo) {
+  if (pIo == NULL) {
+    return;
+  }
+
+  if (pIo->running) {
+    taosThreadMutexLock(&pIo->mutex);
+    pIo->stop = true;
+    taosThreadCondSignal(&pIo->notEmpty);
+    taosThreadMutexUnlock(&pIo->mutex);
+    taosThreadJoin(pIo->thread, NULL);
+  }
+
+  // requests in the queue are not done yet, and the completed ones are left in the pending list only
+  SListIter  iter = {0};
+  SListNode* pn = NULL;
+  tdListInitIter(pIo->pQueue, &iter, TD_LIST_FORWARD);
+  while ((pn = tdListNext(&iter)) != NULL) {
+    destroyPageIoReq(*(SPageIoReq**)pn->data);
+  }
+
+  int32_t i = 0;
+  void*   p = NULL;
+  while ((p = tSimpleHashIterate(pIo->pPending, p, &i)) != NULL) {
+    SPageIoReq* pReq = *(SPageIoReq**)p;
+    if (pReq->done) {
+      destroyPageIoReq(pReq);
+    }
+  }
+
+  tdListFree(pIo->pQueue);
+  tSimpleHashCleanup(pIo->pPending);
+  taosThreadCondDestroy(&pIo->notEmpty);
+  taosThreadCondDestroy(&pIo->ioDone);
+  taosThreadMutexDestroy(&pIo->mutex);
+  taosMemoryFree(pIo);
+}
+
+// the caller must hold the lock of the io queue
+static int32_t doAddPageIoReq(SPageIoQueue* pIo, SPageIoReq* pReq) {
+  if (tSimpleHashPut(pIo->pPending, &pReq->pageId, sizeof(int32_t), &pReq, POINTER_BYTES) != 0) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  if (tdListAppend(pIo->pQueue, &pReq) != 0) {
+    tSimpleHashRemove(pIo->pPending, &pReq->pageId, sizeof(int32_t));
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pIo->inflight += pReq->length;
+  pIo->numOfActive += 1;
+  taosThreadCondSignal(&pIo->notEmpty);
+  return TSDB_CODE_SUCCESS;
+}
+
+// the caller must hold the lock of the io queue
+static void doCancelPagePrefetch(SPageIoQueue* pIo, int32_t pageId) {
+  SPageIoReq** p = tSimpleHashGet(pIo->pPending, &pageId, sizeof(int32_t));
+  if (p == NULL || (*p)->type != PAGE_IO_READ) {
+    return;
+  }
+
+  SPageIoReq* pReq = *p;
+  tSimpleHashRemove(pIo->pPending, &pageId, sizeof(int32_t));
+  if (pReq->done) {
+    pIo->inflight -= pReq->length;
+    destroyPageIoReq(pReq);
+  } else {
+    pReq->cancelled = true;
+  }
+}
+
+/*
+ * Hand the page image over to the io thread, the caller blocks only if the bytes in flight exceed the limit. The newer
+ * image of a page always supersedes the older one in the pending list, and since all requests are processed in FIFO
+ * order, a file area released by a page is never overwritten before the previous write into it.
+ */
+static int32_t asyncWritePage(SDiskbasedBuf* pBuf, int32_t pageId, int64_t offset, char* pData, int32_t size) {
+  SPageIoQueue* pIo = pBuf->pIo;
+
+  SPageIoReq* pReq = taosMemoryCalloc(1, sizeof(SPageIoReq));
+  if (pReq == NULL) {
+    taosMemoryFree(pData);
+    return TSDB_CODE_OUT_OF_MEMORY;
   }
 
-  ret = (int32_t)taosWriteFile(pBuf->pFile, pData, size);
-  if (ret != size) {
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    return terrno;
+  pReq->pageId = pageId;
+  pReq->type = PAGE_IO_WRITE;
+  pReq->offset = offset;
+  pReq->length = size;
+  pReq->pData = pData;
+
+  taosThreadMutexLock(&pIo->mutex);
+  // prefetched pages are only released by the query thread itself, so they are not waited for
+  while (pIo->code == TSDB_CODE_SUCCESS && pIo->numOfActive > 0 && pIo->inflight + size > pIo->maxInflight) {
+    pBuf->statis.flushWaits += 1;
+    taosThreadCondWait(&pIo->ioDone, &pIo->mutex);
+  }
+
+  int32_t code = pIo->code;
+  if (code == TSDB_CODE_SUCCESS) {
+    doCancelPagePrefetch(pIo, pageId);
+    code = doAddPageIoReq(pIo, pReq);
+  }
+  taosThreadMutexUnlock(&pIo->mutex);
+
+  if (code != TSDB_CODE_SUCCESS) {
+    destroyPageIoReq(pReq);
+  }
+  return code;
+}
+
+static int32_t doFlushBufPageImpl(SDiskbasedBuf* pBuf, SPageInfo* pg, int64_t offset, char* pData, int32_t size) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (pBuf->pIo != NULL) {
+    code = asyncWritePage(pBuf, pg->pageId, offset, pData, size);
+  } else if (taosPWriteFile(pBuf->pFile, pData, size, offset) != size) {
+    code = TAOS_SYSTEM_ERROR(errno);
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    terrno = code;
+    return code;
   }
 
   // extend the file
@@ -160,46 +421,41 @@ static char* doFlushBufPage(SDiskbasedBuf* pBuf, SPageInfo* pg) {
     return NULL;
   }
 
-  int32_t size = pBuf->pageSize;
+  int32_t size = PAGE_DISK_SIZE(pBuf);
   int64_t offset = pg->offset;
 
-  char* t = NULL;
-  if ((!HAS_DATA_IN_DISK(pg)) || pg->dirty) {
-    void* payload = GET_PAYLOAD_DATA(pg);
-    t = doCompressData(payload, pBuf->pageSize + sizeof(SFilePage), &size, pBuf);
-    if (size < 0) {
-      uError("failed to compress data when flushing data to disk, %s", pBuf->id);
-      terrno = TSDB_CODE_INVALID_PARA;
+  if (pg->dirty) {
+    // the page memory is reused once evicted, so the async write needs a private copy of the page image
+    char* payload = GET_PAYLOAD_DATA(pg);
+    char* t = payload;
+    if (pBuf->pIo != NULL) {
+      t = taosMemoryMalloc(size);
+    } else if (pBuf->comp) {
+      t = pBuf->assistBuf;
+    }
+
+    if (t == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
       return NULL;
     }
-  }
 
-  // this page is flushed to disk for the first time
-  if (pg->dirty) {
-    if (!HAS_DATA_IN_DISK(pg)) {
-      offset = allocateNewPositionInFile(pBuf, size);
-      pBuf->nextPos += size;
+    if (t != payload) {
+      size = doCompressData(pBuf, payload, t);
+    }
 
-      int32_t code = doFlushBufPageImpl(pBuf, offset, t, size);
-      if (code != TSDB_CODE_SUCCESS) {
-        return NULL;
-      }
-    } else {
-      // length becomes greater, current space is not enough, allocate new place, otherwise, do nothing
-      if (pg->length < size) {
-        // 1. add current space to free list
+    // this page is flushed to disk for the first time, or its length becomes greater and current space is not enough
+    if (!HAS_DATA_IN_DISK(pg) || pg->length < size) {
+      if (HAS_DATA_IN_DISK(pg)) {
         SPageDiskInfo dinfo = {.length = pg->length, .offset = offset};
         taosArrayPush(pBuf->pFree, &dinfo);
-
-        // 2. allocate new position, and update the info
-        offset = allocateNewPositionInFile(pBuf, size);
-        pBuf->nextPos += size;
       }
 
-      int32_t code = doFlushBufPageImpl(pBuf, offset, t, size);
-      if (code != TSDB_CODE_SUCCESS) {
-        return NULL;
-      }
+      offset = allocateNewPositionInFile(pBuf, size);
+    }
+
+    int32_t code = doFlushBufPageImpl(pBuf, pg, offset, t, size);
+    if (code != TSDB_CODE_SUCCESS) {
+      return NULL;
     }
   } else {  // NOTE: the size may be -1, the this recycle page has not been flushed to disk yet.
     size = pg->length;
@@ -227,6 +483,11 @@ static char* flushBufPage(SDiskbasedBuf* pBuf, SPageInfo* pg) {
     }
   }
 
+  if (pBuf->pIo != NULL && (ret = startPageIo(pBuf)) != TSDB_CODE_SUCCESS) {
+    terrno = ret;
+    return NULL;
+  }
+
   char* p = doFlushBufPage(pBuf, pg);
   CLEAR_BUF_PAGE_IN_MEM_FLAG(pg);
 
@@ -234,6 +495,53 @@ static char* flushBufPage(SDiskbasedBuf* pBuf, SPageInfo* pg) {
   return p;
 }
 
+// take the page image from the io queue if it is still being written, or has been prefetched
+static int32_t loadPageFromIoQueue(SDiskbasedBuf* pBuf, SPageInfo* pg, bool* pFound) {
+  SPageIoQueue* pIo = pBuf->pIo;
+  int32_t       code = TSDB_CODE_SUCCESS;
+  char*         pPage = GET_PAYLOAD_DATA(pg);
+
+  *pFound = false;
+
+  taosThreadMutexLock(&pIo->mutex);
+  if (pIo->code != TSDB_CODE_SUCCESS) {
+    code = pIo->code;
+    taosThreadMutexUnlock(&pIo->mutex);
+    return code;
+  }
+
+  SPageIoReq** p = tSimpleHashGet(pIo->pPending, &pg->pageId, sizeof(int32_t));
+  if (p == NULL) {
+    taosThreadMutexUnlock(&pIo->mutex);
+    return code;
+  }
+
+  SPageIoReq* pReq = *p;
+  if (pReq->type == PAGE_IO_WRITE) {
+    *pFound = true;
+    code = doDecompressData(pBuf, pReq->pData, pReq->length, pPage);
+    taosThreadMutexUnlock(&pIo->mutex);
+    return code;
+  }
+
+  while (!pReq->done) {
+    taosThreadCondWait(&pIo->ioDone, &pIo->mutex);
+  }
+
+  tSimpleHashRemove(pIo->pPending, &pg->pageId, sizeof(int32_t));
+  pIo->inflight -= pReq->length;
+  taosThreadMutexUnlock(&pIo->mutex);
+
+  // fall back to read the page again if the prefetch failed
+  if (pReq->code == TSDB_CODE_SUCCESS && pReq->offset == pg->offset && pReq->length == pg->length) {
+    *pFound = true;
+    code = doDecompressData(pBuf, pReq->pData, pReq->length, pPage);
+  }
+
+  destroyPageIoReq(pReq);
+  return code;
+}
+
 // load file block data in disk
 static int32_t loadPageFromDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
   if (pg->offset < 0 || pg->length <= 0) {
@@ -241,25 +549,38 @@ static int32_t loadPageFromDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
     return TSDB_CODE_INVALID_PARA;
   }
 
-  int32_t ret = taosLSeekFile(pBuf->pFile, pg->offset, SEEK_SET);
-  if (ret == -1) {
-    ret = TAOS_SYSTEM_ERROR(errno);
-    return ret;
+  char*   pPage = GET_PAYLOAD_DATA(pg);
+  bool    found = false;
+  int32_t code = TSDB_CODE_SUCCESS;
+
+  if (pBuf->pIo != NULL) {
+    code = loadPageFromIoQueue(pBuf, pg, &found);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
   }
 
-  void* pPage = (void*)GET_PAYLOAD_DATA(pg);
-  ret = (int32_t)taosReadFile(pBuf->pFile, pPage, pg->length);
-  if (ret != pg->length) {
-    ret = TAOS_SYSTEM_ERROR(errno);
-    return ret;
+  if (!found) {
+    // the compressed page is decompressed from the assistant buffer into the page directly
+    char* t = (pg->length == PAGE_DISK_SIZE(pBuf)) ? pPage : pBuf->assistBuf;
+    if (t == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    int64_t ret = taosPReadFile(pBuf->pFile, t, pg->length, pg->offset);
+    if (ret != pg->length) {
+      return TAOS_SYSTEM_ERROR(errno);
+    }
+
+    code = doDecompressData(pBuf, t, pg->length, pPage);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
   }
 
   pBuf->statis.loadBytes += pg->length;
   pBuf->statis.loadPages += 1;
-
-  int32_t fullSize = 0;
-  doDecompressData(pPage, pg->length, &fullSize, pBuf);
-  return 0;
+  return TSDB_CODE_SUCCESS;
 }
 
 static SPageInfo* registerNewPageInfo(SDiskbasedBuf* pBuf, int32_t pageId) {
@@ -569,6 +890,10 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
 
   dBufPrintStatis(pBuf);
 
+  // stop the io thread before the file is closed
+  destroyPageIo(pBuf->pIo);
+  pBuf->pIo = NULL;
+
   bool needRemoveFile = false;
   if (pBuf->pFile != NULL) {
     needRemoveFile = true;
@@ -649,9 +974,75 @@ void setBufPageDirty(void* pPage, bool dirty) {
 
 void setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, bool comp) {
   pBuf->comp = comp;
-  if (comp  && (pBuf->assistBuf == NULL)) {
-    pBuf->assistBuf = taosMemoryMalloc(pBuf->pageSize + 2);  // EXTRA BYTES
+  if (comp && (pBuf->assistBuf == NULL)) {
+    pBuf->assistBuf = taosMemoryMalloc(PAGE_DISK_SIZE(pBuf));
+  }
+}
+
+int32_t dBufSetAsyncIo(SDiskbasedBuf* pBuf, int64_t maxInflightBytes) {
+  if (pBuf->pIo != NULL || maxInflightBytes <= 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SPageIoQueue* pIo = taosMemoryCalloc(1, sizeof(SPageIoQueue));
+  if (pIo == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pIo->maxInflight = maxInflightBytes;
+  pIo->pQueue = tdListNew(POINTER_BYTES);
+  pIo->pPending = tSimpleHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT));
+  if (pIo->pQueue == NULL || pIo->pPending == NULL) {
+    tdListFree(pIo->pQueue);
+    tSimpleHashCleanup(pIo->pPending);
+    taosMemoryFree(pIo);
+    return TSDB_CODE_OUT_OF_MEMORY;
   }
+
+  taosThreadMutexInit(&pIo->mutex, NULL);
+  taosThreadCondInit(&pIo->notEmpty, NULL);
+  taosThreadCondInit(&pIo->ioDone, NULL);
+  pBuf->pIo = pIo;
+
+  // the io thread is created along with the disk file
+  if (pBuf->pFile != NULL) {
+    return startPageIo(pBuf);
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+void dBufPrefetchPage(SDiskbasedBuf* pBuf, int32_t pageId) {
+  SPageIoQueue* pIo = pBuf->pIo;
+  if (pIo == NULL || !pIo->running || pageId < 0) {
+    return;
+  }
+
+  SPageInfo** pi = tSimpleHashGet(pBuf->all, &pageId, sizeof(int32_t));
+  if (pi == NULL || *pi == NULL || BUF_PAGE_IN_MEM(*pi) || !HAS_DATA_IN_DISK(*pi) || (*pi)->length <= 0) {
+    return;
+  }
+
+  taosThreadMutexLock(&pIo->mutex);
+  // a page being written is served from memory, and the prefetch never blocks the caller
+  if (pIo->code != TSDB_CODE_SUCCESS || pIo->inflight + (*pi)->length > pIo->maxInflight ||
+      tSimpleHashGet(pIo->pPending, &pageId, sizeof(int32_t)) != NULL) {
+    taosThreadMutexUnlock(&pIo->mutex);
+    return;
+  }
+
+  SPageIoReq* pReq = taosMemoryCalloc(1, sizeof(SPageIoReq));
+  if (pReq != NULL) {
+    pReq->pageId = pageId;
+    pReq->type = PAGE_IO_READ;
+    pReq->offset = (*pi)->offset;
+    pReq->length = (*pi)->length;
+    pReq->pData = taosMemoryMalloc(pReq->length);
+  }
+
+  if (pReq == NULL || pReq->pData == NULL || doAddPageIoReq(pIo, pReq) != TSDB_CODE_SUCCESS) {
+    destroyPageIoReq(pReq);
+  }
+  taosThreadMutexUnlock(&pIo->mutex);
 }
 
 void dBufSetBufPageRecycled(SDiskbasedBuf* pBuf, void* pPage) {
@@ -690,16 +1081,20 @@ void dBufPrintStatis(const SDiskbasedBuf* pBuf) {
 
   if (ps->loadPages > 0) {
     printf(
-        "Get/Release pages:%d/%d, flushToDisk:%.2f Kb (%d Pages), loadFromDisk:%.2f Kb (%d Pages), avgPageSize:%.2f "
-        "Kb\n",
-        ps->getPages, ps->releasePages, ps->flushBytes / 1024.0f, ps->flushPages, ps->loadBytes / 1024.0f,
-        ps->loadPages, ps->loadBytes / (1024.0 * ps->loadPages));
+        "Get/Release pages:%d/%d, flushToDisk:%.2f Kb (%d Pages, %d waits), loadFromDisk:%.2f Kb (%d Pages), "
+        "avgPageSize:%.2f Kb\n",
+        ps->getPages, ps->releasePages, ps->flushBytes / 1024.0f, ps->flushPages, ps->flushWaits,
+        ps->loadBytes / 1024.0f, ps->loadPages, ps->loadBytes / (1024.0 * ps->loadPages));
   } else {
     // printf("no page loaded\n");
   }
 }
 
 void clearDiskbasedBuf(SDiskbasedBuf* pBuf) {
+  if (pBuf->pIo != NULL) {
+    drainPageIo(pBuf->pIo);
+  }
+
   size_t n = taosArrayGetSize(pBuf->pIdList);
   for (int32_t i = 0; i < n; ++i) {
     SPageInfo* pi = taosArrayGetP(pBuf->pIdList, i);
@@ -0,0 +1,527 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Vector kernels of the TAOS compression.
+ *
+ *   The codecs in tcompression.c keep their on-disk format, only the arithmetic around the byte/bit packing is
+ *   vectorized: the delta, delta-of-delta and XOR transforms of the encoders, the prefix sum/XOR that undo them in
+ *   the decoders, the simple8b word unpacking and the scan for the runs of empty timestamp flags.
+ *
+ *   Every kernel has a scalar, an AVX2 and an AVX-512 version. The vector versions are compiled with the target
+ *   attribute, so they exist even if the whole project is not built with -mavx2, and the widest one the cpu
+ *   supports is picked at run time by tsGetCompSimdKernels().
+ */
+
+#define _DEFAULT_SOURCE
+#if defined(_TD_X86_) && (defined(__GNUC__) || defined(__clang__))
+// before os.h, which forbids the malloc/free that mm_malloc.h refers to
+#include <immintrin.h>
+#define COMP_SIMD_X86
+#endif
+
+#include "tcompression.h"
+
+#ifdef COMP_SIMD_X86
+#define COMP_TARGET_AVX2   __attribute__((target("avx2")))
+#define COMP_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+// the same zigzag transform as ZIGZAG_ENCODE/ZIGZAG_DECODE of tcompression.c, for 64-bit lanes
+#define ZIGZAG_ENCODE_I64(v) (((uint64_t)(v) << 1) ^ (uint64_t)((v) >> 63))
+#define ZIGZAG_DECODE_I64(v) ((int64_t)((v) >> 1) ^ -(int64_t)((v)&1))
+
+// a - b computed as a + (-b) with the same overflow rule as safeInt64Add(a, -b) of tcompression.c
+#define I64_SUB_OVERFLOW(a, b, r) ((int64_t)(((a) ^ (r)) & ((0 - (b)) ^ (r))) < 0)
+
+/* ------------------------------------------------ scalar ------------------------------------------------ */
+static int32_t compZeroBytesScalar(const uint8_t *p, int32_t n) {
+  int32_t i = 0;
+  while (i < n && p[i] == 0) i++;
+  return i;
+}
+
+static void compPrefixSum2I64Scalar(int64_t *p, int32_t n, int64_t *pValue, int64_t *pDelta) {
+  uint64_t value = *pValue, delta = *pDelta;
+  for (int32_t i = 0; i < n; i++) {
+    delta += (uint64_t)p[i];
+    value += delta;
+    p[i] = (int64_t)value;
+  }
+  *pValue = (int64_t)value;
+  *pDelta = (int64_t)delta;
+}
+
+static void compPrefixXorU64Scalar(uint64_t *p, int32_t n, uint64_t *pPrev) {
+  uint64_t prev = *pPrev;
+  for (int32_t i = 0; i < n; i++) {
+    prev ^= p[i];
+    p[i] = prev;
+  }
+  *pPrev = prev;
+}
+
+static void compPrefixXorU32Scalar(uint32_t *p, int32_t n, uint32_t *pPrev) {
+  uint32_t prev = *pPrev;
+  for (int32_t i = 0; i < n; i++) {
+    prev ^= p[i];
+    p[i] = prev;
+  }
+  *pPrev = prev;
+}
+
+static int64_t compUnpackSimple8bScalar(uint64_t w, int32_t bit, int32_t n, int64_t prev, int64_t *out) {
+  uint64_t mask = INT64MASK(bit);
+  for (int32_t i = 0; i < n; i++) {
+    uint64_t zz = (w >> (4 + bit * i)) & mask;
+    prev = (int64_t)((uint64_t)prev + (uint64_t)ZIGZAG_DECODE_I64(zz));
+    out[i] = prev;
+  }
+  return prev;
+}
+
+static bool compZigzagDeltaI64Scalar(const int64_t *in, int32_t n, uint64_t *out) {
+  bool overflow = false;
+  for (int32_t i = 0; i < n; i++) {
+    uint64_t a = in[i], b = in[i - 1], r = a - b;
+    overflow |= I64_SUB_OVERFLOW(a, b, r);
+    out[i] = ZIGZAG_ENCODE_I64((int64_t)r);
+  }
+  return !overflow;
+}
+
+static bool compZigzagDeltaOfDeltaI64Scalar(const int64_t *in, int32_t n, uint64_t *out) {
+  bool overflow = false;
+  for (int32_t i = 0; i < n; i++) {
+    uint64_t a = in[i], b = in[i - 1], c = in[i - 2];
+    uint64_t d1 = a - b, d0 = b - c, dd = d1 - d0;
+    overflow |= I64_SUB_OVERFLOW(a, b, d1) | I64_SUB_OVERFLOW(d1, d0, dd);
+    out[i] = ZIGZAG_ENCODE_I64((int64_t)dd);
+  }
+  return !overflow;
+}
+
+static void compXorPrevU64Scalar(const uint64_t *in, int32_t n, uint64_t *out) {
+  for (int32_t i = 0; i < n; i++) out[i] = in[i] ^ in[i - 1];
+}
+
+static void compXorPrevU32Scalar(const uint32_t *in, int32_t n, uint32_t *out) {
+  for (int32_t i = 0; i < n; i++) out[i] = in[i] ^ in[i - 1];
+}
+
+static const SCompSimdKernels compKernelsScalar = {
+    .name = "scalar",
+    .zeroBytes = compZeroBytesScalar,
+    .prefixSum2I64 = compPrefixSum2I64Scalar,
+    .prefixXorU64 = compPrefixXorU64Scalar,
+    .prefixXorU32 = compPrefixXorU32Scalar,
+    .unpackSimple8b = compUnpackSimple8bScalar,
+    .zigzagDeltaI64 = compZigzagDeltaI64Scalar,
+    .zigzagDeltaOfDeltaI64 = compZigzagDeltaOfDeltaI64Scalar,
+    .xorPrevU64 = compXorPrevU64Scalar,
+    .xorPrevU32 = compXorPrevU32Scalar,
+};
+
+#ifdef COMP_SIMD_X86
+/* ------------------------------------------------- AVX2 ------------------------------------------------- */
+// shift the 64-bit lanes up by one/two lanes, filling with zero
+#define AVX2_SHL1_I64(x) _mm256_blend_epi32(_mm256_permute4x64_epi64(x, 0x90), _mm256_setzero_si256(), 0x03)
+#define AVX2_SHL2_I64(x) _mm256_blend_epi32(_mm256_permute4x64_epi64(x, 0x40), _mm256_setzero_si256(), 0x0F)
+#define AVX2_LAST_I64(x) _mm256_permute4x64_epi64(x, 0xFF)
+
+COMP_TARGET_AVX2 static int32_t compZeroBytesAvx2(const uint8_t *p, int32_t n) {
+  int32_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i  v = _mm256_loadu_si256((const __m256i *)(p + i));
+    uint32_t m = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+    if (m) return i + BUILDIN_CTZ(m);
+  }
+  return i + compZeroBytesScalar(p + i, n - i);
+}
+
+COMP_TARGET_AVX2 static void compPrefixSum2I64Avx2(int64_t *p, int32_t n, int64_t *pValue, int64_t *pDelta) {
+  __m256i value = _mm256_set1_epi64x(*pValue);
+  __m256i delta = _mm256_set1_epi64x(*pDelta);
+
+  int32_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i x = _mm256_loadu_si256((const __m256i *)(p + i));
+    x = _mm256_add_epi64(x, AVX2_SHL1_I64(x));
+    x = _mm256_add_epi64(x, AVX2_SHL2_I64(x));
+    x = _mm256_add_epi64(x, delta);
+    delta = AVX2_LAST_I64(x);
+
+    x = _mm256_add_epi64(x, AVX2_SHL1_I64(x));
+    x = _mm256_add_epi64(x, AVX2_SHL2_I64(x));
+    x = _mm256_add_epi64(x, value);
+    value = AVX2_LAST_I64(x);
+    _mm256_storeu_si256((__m256i *)(p + i), x);
+  }
+
+  *pValue = _mm256_extract_epi64(value, 0);
+  *pDelta = _mm256_extract_epi64(delta, 0);
+  compPrefixSum2I64Scalar(p + i, n - i, pValue, pDelta);
+}
+
+COMP_TARGET_AVX2 static void compPrefixXorU64Avx2(uint64_t *p, int32_t n, uint64_t *pPrev) {
+  __m256i prev = _mm256_set1_epi64x(*pPrev);
+
+  int32_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i x = _mm256_loadu_si256((const __m256i *)(p + i));
+    x = _mm256_xor_si256(x, AVX2_SHL1_I64(x));
+    x = _mm256_xor_si256(x, AVX2_SHL2_I64(x));
+    x = _mm256_xor_si256(x, prev);
+    prev = AVX2_LAST_I64(x);
+    _mm256_storeu_si256((__m256i *)(p + i), x);
+  }
+
+  *pPrev = _mm256_extract_epi64(prev, 0);
+  compPrefixXorU64Scalar(p + i, n - i, pPrev);
+}
+
+COMP_TARGET_AVX2 static void compPrefixXorU32Avx2(uint32_t *p, int32_t n, uint32_t *pPrev) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i shl1 = _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6);
+  const __m256i shl2 = _mm256_setr_epi32(0, 0, 0, 1, 2, 3, 4, 5);
+  const __m256i shl4 = _mm256_setr_epi32(0, 0, 0, 0, 0, 1, 2, 3);
+  const __m256i last = _mm256_set1_epi32(7);
+  __m256i       prev = _mm256_set1_epi32(*pPrev);
+
+  int32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i x = _mm256_loadu_si256((const __m256i *)(p + i));
+    x = _mm256_xor_si256(x, _mm256_blend_epi32(_mm256_permutevar8x32_epi32(x, shl1), zero, 0x01));
+    x = _mm256_xor_si256(x, _mm256_blend_epi32(_mm256_permutevar8x32_epi32(x, shl2), zero, 0x03));
+    x = _mm256_xor_si256(x, _mm256_blend_epi32(_mm256_permutevar8x32_epi32(x, shl4), zero, 0x0F));
+    x = _mm256_xor_si256(x, prev);
+    prev = _mm256_permutevar8x32_epi32(x, last);
+    _mm256_storeu_si256((__m256i *)(p + i), x);
+  }
+
+  *pPrev = (uint32_t)_mm256_extract_epi32(prev, 0);
+  compPrefixXorU32Scalar(p + i, n - i, pPrev);
+}
+
+COMP_TARGET_AVX2 static int64_t compUnpackSimple8bAvx2(uint64_t w, int32_t bit, int32_t n, int64_t prev, int64_t *out) {
+  const __m256i base = _mm256_set1_epi64x(w);
+  const __m256i mask = _mm256_set1_epi64x(INT64MASK(bit));
+  const __m256i one = _mm256_set1_epi64x(1);
+  const __m256i inc = _mm256_set1_epi64x(bit * 4);
+  __m256i       shift = _mm256_setr_epi64x(4, 4 + bit, 4 + bit * 2, 4 + bit * 3);
+  __m256i       sum = _mm256_set1_epi64x(prev);
+
+  int32_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i zz = _mm256_and_si256(_mm256_srlv_epi64(base, shift), mask);
+    __m256i x = _mm256_xor_si256(_mm256_srli_epi64(zz, 1), _mm256_sub_epi64(_mm256_setzero_si256(), _mm256_and_si256(zz, one)));
+    x = _mm256_add_epi64(x, AVX2_SHL1_I64(x));
+    x = _mm256_add_epi64(x, AVX2_SHL2_I64(x));
+    x = _mm256_add_epi64(x, sum);
+    sum = AVX2_LAST_I64(x);
+    _mm256_storeu_si256((__m256i *)(out + i), x);
+    shift = _mm256_add_epi64(shift, inc);
+  }
+
+  prev = _mm256_extract_epi64(sum, 0);
+  if (i < n) {
+    prev = compUnpackSimple8bScalar(w >> (bit * i), bit, n - i, prev, out + i);
+  }
+  return prev;
+}
+
+COMP_TARGET_AVX2 static FORCE_INLINE __m256i compZigzagEncodeAvx2(__m256i v) {
+  __m256i sign = _mm256_cmpgt_epi64(_mm256_setzero_si256(), v);
+  return _mm256_xor_si256(_mm256_slli_epi64(v, 1), sign);
+}
+
+// the sign bit of the result tells whether a - b overflowed
+COMP_TARGET_AVX2 static FORCE_INLINE __m256i compSubOverflowAvx2(__m256i a, __m256i b, __m256i r) {
+  __m256i nb = _mm256_sub_epi64(_mm256_setzero_si256(), b);
+  return _mm256_and_si256(_mm256_xor_si256(a, r), _mm256_xor_si256(nb, r));
+}
+
+COMP_TARGET_AVX2 static bool compZigzagDeltaI64Avx2(const int64_t *in, int32_t n, uint64_t *out) {
+  __m256i overflow = _mm256_setzero_si256();
+
+  int32_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i a = _mm256_loadu_si256((const __m256i *)(in + i));
+    __m256i b = _mm256_loadu_si256((const __m256i *)(in + i - 1));
+    __m256i r = _mm256_sub_epi64(a, b);
+    overflow = _mm256_or_si256(overflow, compSubOverflowAvx2(a, b, r));
+    _mm256_storeu_si256((__m256i *)(out + i), compZigzagEncodeAvx2(r));
+  }
+
+  bool ok = _mm256_movemask_pd(_mm256_castsi256_pd(overflow)) == 0;
+  return compZigzagDeltaI64Scalar(in + i, n - i, out + i) && ok;
+}
+
+COMP_TARGET_AVX2 static bool compZigzagDeltaOfDeltaI64Avx2(const int64_t *in, int32_t n, uint64_t *out) {
+  __m256i overflow = _mm256_setzero_si256();
+
+  int32_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i a = _mm256_loadu_si256((const __m256i *)(in + i));
+    __m256i b = _mm256_loadu_si256((const __m256i *)(in + i - 1));
+    __m256i c = _mm256_loadu_si256((const __m256i *)(in + i - 2));
+    __m256i d1 = _mm256_sub_epi64(a, b);
+    __m256i d0 = _mm256_sub_epi64(b, c);
+    __m256i dd = _mm256_sub_epi64(d1, d0);
+    overflow = _mm256_or_si256(overflow, compSubOverflowAvx2(a, b, d1));
+    overflow = _mm256_or_si256(overflow, compSubOverflowAvx2(d1, d0, dd));
+    _mm256_storeu_si256((__m256i *)(out + i), compZigzagEncodeAvx2(dd));
+  }
+
+  bool ok = _mm256_movemask_pd(_mm256_castsi256_pd(overflow)) == 0;
+  return compZigzagDeltaOfDeltaI64Scalar(in + i, n - i, out + i) && ok;
+}
+
+COMP_TARGET_AVX2 static void compXorPrevU64Avx2(const uint64_t *in, int32_t n, uint64_t *out) {
+  int32_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i a = _mm256_loadu_si256((const __m256i *)(in + i));
+    __m256i b = _mm256_loadu_si256((const __m256i *)(in + i - 1));
+    _mm256_storeu_si256((__m256i *)(out + i), _mm256_xor_si256(a, b));
+  }
+  compXorPrevU64Scalar(in + i, n - i, out + i);
+}
+
+COMP_TARGET_AVX2 static void compXorPrevU32Avx2(const uint32_t *in, int32_t n, uint32_t *out) {
+  int32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i a = _mm256_loadu_si256((const __m256i *)(in + i));
+    __m256i b = _mm256_loadu_si256((const __m256i *)(in + i - 1));
+    _mm256_storeu_si256((__m256i *)(out + i), _mm256_xor_si256(a, b));
+  }
+  compXorPrevU32Scalar(in + i, n - i, out + i);
+}
+
+static const SCompSimdKernels compKernelsAvx2 = {
+    .name = "avx2",
+    .zeroBytes = compZeroBytesAvx2,
+    .prefixSum2I64 = compPrefixSum2I64Avx2,
+    .prefixXorU64 = compPrefixXorU64Avx2,
+    .prefixXorU32 = compPrefixXorU32Avx2,
+    .unpackSimple8b = compUnpackSimple8bAvx2,
+    .zigzagDeltaI64 = compZigzagDeltaI64Avx2,
+    .zigzagDeltaOfDeltaI64 = compZigzagDeltaOfDeltaI64Avx2,
+    .xorPrevU64 = compXorPrevU64Avx2,
+    .xorPrevU32 = compXorPrevU32Avx2,
+};
+
+/* ------------------------------------------------ AVX-512 ----------------------------------------------- */
+// shift the lanes up by _k lanes, filling with zero
+#define AVX512_SHL_I64(x, _k) _mm512_alignr_epi64(x, _mm512_setzero_si512(), 8 - (_k))
+#define AVX512_SHL_I32(x, _k) _mm512_alignr_epi32(x, _mm512_setzero_si512(), 16 - (_k))
+#define AVX512_LAST_I64(x)    _mm512_permutexvar_epi64(_mm512_set1_epi64(7), x)
+#define AVX512_LAST_I32(x)    _mm512_permutexvar_epi32(_mm512_set1_epi32(15), x)
+
+COMP_TARGET_AVX512 static int32_t compZeroBytesAvx512(const uint8_t *p, int32_t n) {
+  int32_t i = 0;
+  for (; i + 64 <= n; i += 64) {
+    __m512i   v = _mm512_loadu_si512((const void *)(p + i));
+    __mmask8 m = _mm512_test_epi64_mask(v, v);
+    if (m) {
+      int32_t  lane = BUILDIN_CTZ(m);
+      uint64_t q = 0;
+      memcpy(&q, p + i + lane * 8, sizeof(q));
+      return i + lane * 8 + BUILDIN_CTZL(q) / BITS_PER_BYTE;
+    }
+  }
+  return i + compZeroBytesScalar(p + i, n - i);
+}
+
+COMP_TARGET_AVX512 static void compPrefixSum2I64Avx512(int64_t *p, int32_t n, int64_t *pValue, int64_t *pDelta) {
+  __m512i value = _mm512_set1_epi64(*pValue);
+  __m512i delta = _mm512_set1_epi64(*pDelta);
+
+  int32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512i x = _mm512_loadu_si512((const void *)(p + i));
+    x = _mm512_add_epi64(x, AVX512_SHL_I64(x, 1));
+    x = _mm512_add_epi64(x, AVX512_SHL_I64(x, 2));
+    x = _mm512_add_epi64(x, AVX512_SHL_I64(x, 4));
+    x = _mm512_add_epi64(x, delta);
+    delta = AVX512_LAST_I64(x);
+
+    x = _mm512_add_epi64(x, AVX512_SHL_I64(x, 1));
+    x = _mm512_add_epi64(x, AVX512_SHL_I64(x, 2));
+    x = _mm512_add_epi64(x, AVX512_SHL_I64(x, 4));
+    x = _mm512_add_epi64(x, value);
+    value = AVX512_LAST_I64(x);
+    _mm512_storeu_si512((void *)(p + i), x);
+  }
+
+  *pValue = _mm_cvtsi128_si64(_mm512_castsi512_si128(value));
+  *pDelta = _mm_cvtsi128_si64(_mm512_castsi512_si128(delta));
+  compPrefixSum2I64Scalar(p + i, n - i, pValue, pDelta);
+}
+
+COMP_TARGET_AVX512 static void compPrefixXorU64Avx512(uint64_t *p, int32_t n, uint64_t *pPrev) {
+  __m512i prev = _mm512_set1_epi64(*pPrev);
+
+  int32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512i x = _mm512_loadu_si512((const void *)(p + i));
+    x = _mm512_xor_si512(x, AVX512_SHL_I64(x, 1));
+    x = _mm512_xor_si512(x, AVX512_SHL_I64(x, 2));
+    x = _mm512_xor_si512(x, AVX512_SHL_I64(x, 4));
+    x = _mm512_xor_si512(x, prev);
+    prev = AVX512_LAST_I64(x);
+    _mm512_storeu_si512((void *)(p + i), x);
+  }
+
+  *pPrev = _mm_cvtsi128_si64(_mm512_castsi512_si128(prev));
+  compPrefixXorU64Scalar(p + i, n - i, pPrev);
+}
+
+COMP_TARGET_AVX512 static void compPrefixXorU32Avx512(uint32_t *p, int32_t n, uint32_t *pPrev) {
+  __m512i prev = _mm512_set1_epi32(*pPrev);
+
+  int32_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m512i x = _mm512_loadu_si512((const void *)(p + i));
+    x = _mm512_xor_si512(x, AVX512_SHL_I32(x, 1));
+    x = _mm512_xor_si512(x, AVX512_SHL_I32(x, 2));
+    x = _mm512_xor_si512(x, AVX512_SHL_I32(x, 4));
+    x = _mm512_xor_si512(x, AVX512_SHL_I32(x, 8));
+    x = _mm512_xor_si512(x, prev);
+    prev = AVX512_LAST_I32(x);
+    _mm512_storeu_si512((void *)(p + i), x);
+  }
+
+  *pPrev = (uint32_t)_mm_cvtsi128_si32(_mm512_castsi512_si128(prev));
+  compPrefixXorU32Scalar(p + i, n - i, pPrev);
+}
+
+COMP_TARGET_AVX512 static int64_t compUnpackSimple8bAvx512(uint64_t w, int32_t bit, int32_t n, int64_t prev,
+                                                           int64_t *out) {
+  const __m512i base = _mm512_set1_epi64(w);
+  const __m512i mask = _mm512_set1_epi64(INT64MASK(bit));
+  const __m512i one = _mm512_set1_epi64(1);
+  const __m512i inc = _mm512_set1_epi64(bit * 8);
+  __m512i       shift = _mm512_setr_epi64(4, 4 + bit, 4 + bit * 2, 4 + bit * 3, 4 + bit * 4, 4 + bit * 5, 4 + bit * 6,
+                                          4 + bit * 7);
+  __m512i       sum = _mm512_set1_epi64(prev);
+
+  int32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512i zz = _mm512_and_si512(_mm512_srlv_epi64(base, shift), mask);
+    __m512i x = _mm512_xor_si512(_mm512_srli_epi64(zz, 1), _mm512_sub_epi64(_mm512_setzero_si512(), _mm512_and_si512(zz, one)));
+    x = _mm512_add_epi64(x, AVX512_SHL_I64(x, 1));
+    x = _mm512_add_epi64(x, AVX512_SHL_I64(x, 2));
+    x = _mm512_add_epi64(x, AVX512_SHL_I64(x, 4));
+    x = _mm512_add_epi64(x, sum);
+    sum = AVX512_LAST_I64(x);
+    _mm512_storeu_si512((void *)(out + i), x);
+    shift = _mm512_add_epi64(shift, inc);
+  }
+
+  prev = _mm_cvtsi128_si64(_mm512_castsi512_si128(sum));
+  if (i < n) {
+    prev = compUnpackSimple8bScalar(w >> (bit * i), bit, n - i, prev, out + i);
+  }
+  return prev;
+}
+
+COMP_TARGET_AVX512 static FORCE_INLINE __m512i compZigzagEncodeAvx512(__m512i v) {
+  return _mm512_xor_si512(_mm512_slli_epi64(v, 1), _mm512_srai_epi64(v, 63));
+}
+
+COMP_TARGET_AVX512 static FORCE_INLINE __m512i compSubOverflowAvx512(__m512i a, __m512i b, __m512i r) {
+  __m512i nb = _mm512_sub_epi64(_mm512_setzero_si512(), b);
+  return _mm512_and_si512(_mm512_xor_si512(a, r), _mm512_xor_si512(nb, r));
+}
+
+COMP_TARGET_AVX512 static bool compZigzagDeltaI64Avx512(const int64_t *in, int32_t n, uint64_t *out) {
+  __m512i overflow = _mm512_setzero_si512();
+
+  int32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512i a = _mm512_loadu_si512((const void *)(in + i));
+    __m512i b = _mm512_loadu_si512((const void *)(in + i - 1));
+    __m512i r = _mm512_sub_epi64(a, b);
+    overflow = _mm512_or_si512(overflow, compSubOverflowAvx512(a, b, r));
+    _mm512_storeu_si512((void *)(out + i), compZigzagEncodeAvx512(r));
+  }
+
+  bool ok = _mm512_cmplt_epi64_mask(overflow, _mm512_setzero_si512()) == 0;
+  return compZigzagDeltaI64Scalar(in + i, n - i, out + i) && ok;
+}
+
+COMP_TARGET_AVX512 static bool compZigzagDeltaOfDeltaI64Avx512(const int64_t *in, int32_t n, uint64_t *out) {
+  __m512i overflow = _mm512_setzero_si512();
+
+  int32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512i a = _mm512_loadu_si512((const void *)(in + i));
+    __m512i b = _mm512_loadu_si512((const void *)(in + i - 1));
+    __m512i c = _mm512_loadu_si512((const void *)(in + i - 2));
+    __m512i d1 = _mm512_sub_epi64(a, b);
+    __m512i d0 = _mm512_sub_epi64(b, c);
+    __m512i dd = _mm512_sub_epi64(d1, d0);
+    overflow = _mm512_or_si512(overflow, compSubOverflowAvx512(a, b, d1));
+    overflow = _mm512_or_si512(overflow, compSubOverflowAvx512(d1, d0, dd));
+    _mm512_storeu_si512((void *)(out + i), compZigzagEncodeAvx512(dd));
+  }
+
+  bool ok = _mm512_cmplt_epi64_mask(overflow, _mm512_setzero_si512()) == 0;
+  return compZigzagDeltaOfDeltaI64Scalar(in + i, n - i, out + i) && ok;
+}
+
+COMP_TARGET_AVX512 static void compXorPrevU64Avx512(const uint64_t *in, int32_t n, uint64_t *out) {
+  int32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512i a = _mm512_loadu_si512((const void *)(in + i));
+    __m512i b = _mm512_loadu_si512((const void *)(in + i - 1));
+    _mm512_storeu_si512((void *)(out + i), _mm512_xor_si512(a, b));
+  }
+  compXorPrevU64Scalar(in + i, n - i, out + i);
+}
+
+COMP_TARGET_AVX512 static void compXorPrevU32Avx512(const uint32_t *in, int32_t n, uint32_t *out) {
+  int32_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m512i a = _mm512_loadu_si512((const void *)(in + i));
+    __m512i b = _mm512_loadu_si512((const void *)(in + i - 1));
+    _mm512_storeu_si512((void *)(out + i), _mm512_xor_si512(a, b));
+  }
+  compXorPrevU32Scalar(in + i, n - i, out + i);
+}
+
+static const SCompSimdKernels compKernelsAvx512 = {
+    .name = "avx512",
+    .zeroBytes = compZeroBytesAvx512,
+    .prefixSum2I64 = compPrefixSum2I64Avx512,
+    .prefixXorU64 = compPrefixXorU64Avx512,
+    .prefixXorU32 = compPrefixXorU32Avx512,
+    .unpackSimple8b = compUnpackSimple8bAvx512,
+    .zigzagDeltaI64 = compZigzagDeltaI64Avx512,
+    .zigzagDeltaOfDeltaI64 = compZigzagDeltaOfDeltaI64Avx512,
+    .xorPrevU64 = compXorPrevU64Avx512,
+    .xorPrevU32 = compXorPrevU32Avx512,
+};
+#endif
+
+const SCompSimdKernels *tsGetCompSimdKernels() {
+  if (!tsSIMDBuiltins) return NULL;
+
+#ifdef COMP_SIMD_X86
+  if (tsAVX512Enable) return &compKernelsAvx512;
+  if (tsAVX2Enable) return &compKernelsAvx2;
+#endif
+
+  return &compKernelsScalar;
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Throughput of the timestamp, integer, float and double codecs with the scalar code and each SIMD level the cpu
+// supports, in GB/s of uncompressed data, on blocks of the default tsdb block size.
+//
+// usage: compressBench [rows per block] [blocks]
+
+#include <math.h>
+#include "os.h"
+#include "tcompression.h"
+
+typedef int32_t (*FCodec)(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg, void *pBuf,
+                          int32_t nBuf);
+
+typedef struct {
+  const char *name;
+  char        simd;
+  char        avx2;
+  char        avx512;
+} SBenchLevel;
+
+typedef struct {
+  const char *name;
+  int8_t      type;
+  int32_t     bytes;
+  FCodec      comp;
+  FCodec      decomp;
+} SBenchCodec;
+
+static const SBenchCodec benchCodecs[] = {
+    {"timestamp", TSDB_DATA_TYPE_TIMESTAMP, sizeof(int64_t), tsCompressTimestamp, tsDecompressTimestamp},
+    {"bigint", TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), tsCompressBigint, tsDecompressBigint},
+    {"int", TSDB_DATA_TYPE_INT, sizeof(int32_t), tsCompressInt, tsDecompressInt},
+    {"float", TSDB_DATA_TYPE_FLOAT, sizeof(float), tsCompressFloat, tsDecompressFloat},
+    {"double", TSDB_DATA_TYPE_DOUBLE, sizeof(double), tsCompressDouble, tsDecompressDouble},
+};
+
+static uint64_t benchRand(uint64_t *pSeed) {
+  *pSeed = *pSeed * 6364136223846793005ull + 1442695040888963407ull;
+  return *pSeed >> 11;
+}
+
+// synthetic data: random walks with wide steps; sensor data: a clock with a few ms of jitter and a reading drifting
+// slowly with a little noise
+static void benchGenData(const SBenchCodec *pCodec, bool sensor, char *pData, int32_t nEle) {
+  uint64_t seed = 2023;
+  int64_t  ts = 1700000000000;
+  double   x = 0;
+
+  for (int32_t i = 0; i < nEle; i++) {
+    uint64_t r = benchRand(&seed);
+    if (sensor) {
+      ts += 1000 + (int64_t)(r % 5) - 2;
+      x = round((20 + 5 * sin(i / 300.0) + (double)(r % 100) / 100) * 10) / 10;
+    } else {
+      ts += (int64_t)(r % 1000000);
+      x += (double)(r % 2001) - 1000;
+    }
+
+    switch (pCodec->type) {
+      case TSDB_DATA_TYPE_TIMESTAMP:
+        ((int64_t *)pData)[i] = ts;
+        break;
+      case TSDB_DATA_TYPE_BIGINT:
+        ((int64_t *)pData)[i] = sensor ? (int64_t)(x * 10) : (int64_t)x * 1000;
+        break;
+      case TSDB_DATA_TYPE_INT:
+        ((int32_t *)pData)[i] = sensor ? (int32_t)(x * 10) : (int32_t)x;
+        break;
+      case TSDB_DATA_TYPE_FLOAT:
+        ((float *)pData)[i] = (float)x;
+        break;
+      case TSDB_DATA_TYPE_DOUBLE:
+        ((double *)pData)[i] = sensor ? x : x / 7;
+        break;
+    }
+  }
+}
+
+static double benchGBps(int64_t bytes, int64_t ns) { return ns > 0 ? (double)bytes / ns : 0; }
+
+static void benchCodec(const SBenchCodec *pCodec, bool sensor, const SBenchLevel *pLevels, int32_t nLevels,
+                       int32_t nEle, int32_t nBlocks) {
+  int32_t nIn = nEle * pCodec->bytes;
+  char   *pData = taosMemoryMalloc(nIn);
+  char   *pComp = taosMemoryMalloc(nIn + COMP_OVERFLOW_BYTES);
+  char   *pOut = taosMemoryMalloc(nIn);
+  benchGenData(pCodec, sensor, pData, nEle);
+
+  for (int32_t l = 0; l < nLevels; l++) {
+    tsSIMDBuiltins = pLevels[l].simd;
+    tsAVX2Enable = pLevels[l].avx2;
+    tsAVX512Enable = pLevels[l].avx512;
+
+    int32_t len = 0;
+    int64_t start = taosGetTimestampNs();
+    for (int32_t b = 0; b < nBlocks; b++) {
+      len = pCodec->comp(pData, nIn, nEle, pComp, nIn + COMP_OVERFLOW_BYTES, ONE_STAGE_COMP, NULL, 0);
+    }
+    int64_t compNs = taosGetTimestampNs() - start;
+
+    start = taosGetTimestampNs();
+    for (int32_t b = 0; b < nBlocks; b++) {
+      pCodec->decomp(pComp, len, nEle, pOut, nIn, ONE_STAGE_COMP, NULL, 0);
+    }
+    int64_t decompNs = taosGetTimestampNs() - start;
+
+    printf("%-10s %-9s %-7s ratio:%6.2f%%  compress:%7.3f GB/s  decompress:%7.3f GB/s%s\n", pCodec->name,
+           sensor ? "sensor" : "synthetic", pLevels[l].name, len * 100.0 / nIn,
+           benchGBps((int64_t)nIn * nBlocks, compNs), benchGBps((int64_t)nIn * nBlocks, decompNs),
+           memcmp(pData, pOut, nIn) == 0 ? "" : "  MISMATCH");
+  }
+
+  taosMemoryFree(pData);
+  taosMemoryFree(pComp);
+  taosMemoryFree(pOut);
+}
+
+int main(int argc, char *argv[]) {
+  int32_t nEle = (argc > 1) ? atoi(argv[1]) : 4096;
+  int32_t nBlocks = (argc > 2) ? atoi(argv[2]) : 20000;
+  if (nEle <= 0 || nBlocks <= 0) {
+    printf("usage: %s [rows per block] [blocks]\n", argv[0]);
+    return -1;
+  }
+
+  char sse42 = 0, avx = 0, avx2 = 0, fma = 0, avx512 = 0;
+  taosGetCpuInstructions(&sse42, &avx, &avx2, &fma, &avx512);
+
+  SBenchLevel levels[4] = {{"scalar", 0, 0, 0}};
+  int32_t     nLevels = 1;
+  if (avx2) levels[nLevels++] = (SBenchLevel){"avx2", 1, 1, 0};
+  if (avx512) levels[nLevels++] = (SBenchLevel){"avx512", 1, avx2, 1};
+
+  printf("%d rows per block, %d blocks\n", nEle, nBlocks);
+  for (int32_t i = 0; i < sizeof(benchCodecs) / sizeof(benchCodecs[0]); i++) {
+    benchCodec(&benchCodecs[i], false, levels, nLevels, nEle, nBlocks);
+    benchCodec(&benchCodecs[i], true, levels, nLevels, nEle, nBlocks);
+  }
+
+  return 0;
+}
@@ -0,0 +1,305 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "os.h"
+#include "tcompression.h"
+
+namespace {
+
+typedef int32_t (*FCodec)(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg, void *pBuf,
+                          int32_t nBuf);
+
+struct SSimdLevel {
+  const char *name;
+  char        simd;
+  char        avx2;
+  char        avx512;
+};
+
+const int32_t testSizes[] = {1, 2, 3, 7, 17, 18, 19, 100, 241, 1023, 1024, 1025, 4096, 5001};
+
+// the scalar code, the scalar kernels and whatever the cpu supports of AVX2/AVX-512
+std::vector<SSimdLevel> getSimdLevels() {
+  char sse42 = 0, avx = 0, avx2 = 0, fma = 0, avx512 = 0;
+  taosGetCpuInstructions(&sse42, &avx, &avx2, &fma, &avx512);
+
+  std::vector<SSimdLevel> levels = {{"none", 0, 0, 0}, {"scalar", 1, 0, 0}};
+  if (avx2) levels.push_back({"avx2", 1, 1, 0});
+  if (avx512) levels.push_back({"avx512", 1, avx2, 1});
+  return levels;
+}
+
+void setSimdLevel(const SSimdLevel &level) {
+  tsSIMDBuiltins = level.simd;
+  tsAVX2Enable = level.avx2;
+  tsAVX512Enable = level.avx512;
+}
+
+// every level must produce the bytes of the scalar code and decode them back; the buffers are sized exactly so that
+// the address sanitizer catches any access past them
+void checkCodec(FCodec comp, FCodec decomp, const void *pData, int32_t nEle, int32_t bytes) {
+  std::vector<SSimdLevel> levels = getSimdLevels();
+  int32_t                 nIn = nEle * bytes;
+
+  setSimdLevel(levels[0]);
+  std::vector<char> ref(nIn + 1);
+  int32_t           refLen = comp((void *)pData, nIn, nEle, ref.data(), (int32_t)ref.size(), ONE_STAGE_COMP, NULL, 0);
+  ASSERT_GT(refLen, 0);
+  ref.resize(refLen);
+
+  for (const SSimdLevel &level : levels) {
+    setSimdLevel(level);
+
+    std::vector<char> out(nIn + 1);
+    int32_t           len = comp((void *)pData, nIn, nEle, out.data(), (int32_t)out.size(), ONE_STAGE_COMP, NULL, 0);
+    ASSERT_EQ(len, refLen) << level.name << " nEle:" << nEle;
+    ASSERT_EQ(memcmp(out.data(), ref.data(), len), 0) << level.name << " nEle:" << nEle;
+
+    std::vector<char> dec(nIn);
+    int32_t           decLen = decomp(ref.data(), refLen, nEle, dec.data(), nIn, ONE_STAGE_COMP, NULL, 0);
+    ASSERT_EQ(decLen, nIn) << level.name << " nEle:" << nEle;
+    ASSERT_EQ(memcmp(dec.data(), pData, nIn), 0) << level.name << " nEle:" << nEle;
+  }
+
+  setSimdLevel(levels[0]);
+}
+
+template <typename T>
+void checkIntCodec(FCodec comp, FCodec decomp, const std::vector<T> &data) {
+  for (int32_t n : testSizes) {
+    if (n > (int32_t)data.size()) break;
+    checkCodec(comp, decomp, data.data(), n, sizeof(T));
+  }
+}
+
+template <typename T>
+std::vector<T> genRandomWalk(std::mt19937_64 &rng, int32_t n, int64_t maxStep) {
+  std::vector<T> v(n);
+  uint64_t       x = 0;
+  for (int32_t i = 0; i < n; i++) {
+    x += rng() % (2 * maxStep + 1) - maxStep;
+    v[i] = (T)x;
+  }
+  return v;
+}
+
+template <typename T>
+std::vector<T> genRandomBits(std::mt19937_64 &rng, int32_t n) {
+  std::vector<T> v(n);
+  for (int32_t i = 0; i < n; i++) {
+    uint64_t r = rng();
+    memcpy(&v[i], &r, sizeof(T));
+  }
+  return v;
+}
+
+}  // namespace
+
+TEST(compressTest, timestampSimd) {
+  std::mt19937_64      rng(1);
+  const int32_t        n = 5001;
+  std::vector<int64_t> ts(n);
+
+  // one row per second
+  for (int32_t i = 0; i < n; i++) ts[i] = 1700000000000 + i * 1000;
+  checkIntCodec(tsCompressTimestamp, tsDecompressTimestamp, ts);
+
+  // sensor clocks: jitter of a few ms and a gap now and then
+  int64_t t = 1700000000000;
+  for (int32_t i = 0; i < n; i++) {
+    t += 1000 + (int64_t)(rng() % 7) - 3 + ((rng() % 500 == 0) ? 3600000 : 0);
+    ts[i] = t;
+  }
+  checkIntCodec(tsCompressTimestamp, tsDecompressTimestamp, ts);
+
+  // runs of regular rows between jittered ones, to exercise the empty flag scan
+  t = 0;
+  for (int32_t i = 0; i < n; i++) {
+    t += (rng() % 100 == 0) ? (int64_t)(rng() % 100000) : 10;
+    ts[i] = t;
+  }
+  checkIntCodec(tsCompressTimestamp, tsDecompressTimestamp, ts);
+
+  // large deltas and deltas of delta that overflow, both fall back to the raw copy
+  ts = genRandomBits<int64_t>(rng, n);
+  ts[0] = 1;
+  checkIntCodec(tsCompressTimestamp, tsDecompressTimestamp, ts);
+  for (int32_t i = 0; i < n; i++) ts[i] = (i % 2) ? INT64_MAX - i : i;
+  checkIntCodec(tsCompressTimestamp, tsDecompressTimestamp, ts);
+  ts[0] = -1;
+  checkIntCodec(tsCompressTimestamp, tsDecompressTimestamp, ts);
+}
+
+TEST(compressTest, integerSimd) {
+  std::mt19937_64 rng(2);
+  const int32_t   n = 5001;
+
+  checkIntCodec(tsCompressBigint, tsDecompressBigint, std::vector<int64_t>(n, 42));
+  checkIntCodec(tsCompressBigint, tsDecompressBigint, genRandomWalk<int64_t>(rng, n, 3));
+  checkIntCodec(tsCompressBigint, tsDecompressBigint, genRandomWalk<int64_t>(rng, n, 1000000));
+  checkIntCodec(tsCompressBigint, tsDecompressBigint, genRandomWalk<int64_t>(rng, n, (int64_t)1 << 58));
+  checkIntCodec(tsCompressBigint, tsDecompressBigint, genRandomBits<int64_t>(rng, n));
+
+  checkIntCodec(tsCompressInt, tsDecompressInt, genRandomWalk<int32_t>(rng, n, 100));
+  checkIntCodec(tsCompressInt, tsDecompressInt, genRandomBits<int32_t>(rng, n));
+  checkIntCodec(tsCompressSmallint, tsDecompressSmallint, genRandomWalk<int16_t>(rng, n, 10));
+  checkIntCodec(tsCompressSmallint, tsDecompressSmallint, genRandomBits<int16_t>(rng, n));
+  checkIntCodec(tsCompressTinyint, tsDecompressTinyint, genRandomWalk<int8_t>(rng, n, 1));
+  checkIntCodec(tsCompressTinyint, tsDecompressTinyint, genRandomBits<int8_t>(rng, n));
+
+  // long runs of zero deltas mixed with single large ones
+  std::vector<int64_t> v(n);
+  for (int32_t i = 0; i < n; i++) v[i] = (i % 300 == 299) ? (int64_t)(rng() % 100000) : 7;
+  checkIntCodec(tsCompressBigint, tsDecompressBigint, v);
+}
+
+TEST(compressTest, floatingSimd) {
+  std::mt19937_64     rng(3);
+  const int32_t       n = 5001;
+  std::vector<double> d(n);
+  std::vector<float>  f(n);
+
+  // a temperature sensor: slow drift, noise and two decimals
+  for (int32_t i = 0; i < n; i++) {
+    d[i] = std::round((20 + 5 * std::sin(i / 200.0) + (double)(rng() % 100) / 100) * 100) / 100;
+    f[i] = (float)d[i];
+  }
+  checkIntCodec(tsCompressDouble, tsDecompressDouble, d);
+  checkIntCodec(tsCompressFloat, tsDecompressFloat, f);
+
+  // constant values and random bits, the latter falling back to the raw copy
+  checkIntCodec(tsCompressDouble, tsDecompressDouble, std::vector<double>(n, 1.5));
+  checkIntCodec(tsCompressFloat, tsDecompressFloat, std::vector<float>(n, -0.25f));
+  checkIntCodec(tsCompressDouble, tsDecompressDouble, genRandomBits<double>(rng, n));
+  checkIntCodec(tsCompressFloat, tsDecompressFloat, genRandomBits<float>(rng, n));
+
+  // counters stored as floating point, with nan and inf here and there
+  for (int32_t i = 0; i < n; i++) {
+    d[i] = (i % 1000 == 0) ? NAN : (i % 777 == 0) ? INFINITY : (double)(i / 10);
+    f[i] = (float)d[i];
+  }
+  checkIntCodec(tsCompressDouble, tsDecompressDouble, d);
+  checkIntCodec(tsCompressFloat, tsDecompressFloat, f);
+}
+
+namespace {
+
+template <typename T>
+int32_t checkAdaptive(int8_t type, const std::vector<T> &data, uint8_t cmprAlg = ONE_STAGE_COMP) {
+  int32_t nEle = (int32_t)data.size();
+  int32_t nIn = nEle * (int32_t)sizeof(T);
+  int32_t nOut = nIn + COMP_OVERFLOW_BYTES;
+
+  std::vector<char> buf(nOut);
+  std::vector<char> ref(nOut);
+  std::vector<char> out(nOut);
+  FCodec            comp = NULL;
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      comp = tsCompressTinyint;
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      comp = tsCompressSmallint;
+      break;
+    case TSDB_DATA_TYPE_INT:
+      comp = tsCompressInt;
+      break;
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      comp = tsCompressTimestamp;
+      break;
+    case TSDB_DATA_TYPE_FLOAT:
+      comp = tsCompressFloat;
+      break;
+    case TSDB_DATA_TYPE_DOUBLE:
+      comp = tsCompressDouble;
+      break;
+    default:
+      comp = tsCompressBigint;
+      break;
+  }
+
+  // never larger than the codec of the type, whose blocks decode as ever
+  int32_t refLen = comp((void *)data.data(), nIn, nEle, ref.data(), nOut, cmprAlg, buf.data(), nOut);
+  int32_t len = tsCompressAdaptive(type, (void *)data.data(), nIn, nEle, out.data(), nOut, cmprAlg, buf.data(), nOut);
+  EXPECT_GT(len, 0);
+  EXPECT_LE(len, refLen);
+
+  std::vector<T> dec(nEle);
+  EXPECT_EQ(tsDecompressAdaptive(type, out.data(), len, nEle, dec.data(), nIn, cmprAlg, buf.data(), nOut), nIn);
+  EXPECT_EQ(memcmp(dec.data(), data.data(), nIn), 0) << "type:" << (int)type << " head:" << (int)(uint8_t)out[0];
+
+  std::fill(dec.begin(), dec.end(), 0);
+  EXPECT_EQ(tsDecompressAdaptive(type, ref.data(), refLen, nEle, dec.data(), nIn, cmprAlg, buf.data(), nOut), nIn);
+  EXPECT_EQ(memcmp(dec.data(), data.data(), nIn), 0);
+
+  return (uint8_t)out[0];
+}
+
+}  // namespace
+
+TEST(compressTest, adaptiveInteger) {
+  std::mt19937_64 rng(4);
+  const int32_t   n = 4096;
+
+  // near constant: a status code that changes now and then
+  std::vector<int32_t> status(n);
+  for (int32_t i = 0; i < n; i++) status[i] = (i / 1000) % 2 ? 200 : 404;
+  EXPECT_EQ(checkAdaptive(TSDB_DATA_TYPE_INT, status), COMP_ADAPT_FLAG | 3);
+
+  // low cardinality with no runs
+  std::vector<int64_t> codes(n);
+  const int64_t        aCode[] = {-7000000000, 3, 99999999999, 42, -1};
+  for (int32_t i = 0; i < n; i++) codes[i] = aCode[rng() % 5];
+  EXPECT_EQ(checkAdaptive(TSDB_DATA_TYPE_BIGINT, codes), COMP_ADAPT_FLAG | 2);
+
+  // a narrow range far from zero
+  std::vector<int64_t> range(n);
+  for (int32_t i = 0; i < n; i++) range[i] = 1000000000000 + (int64_t)(rng() % 3000);
+  EXPECT_EQ(checkAdaptive(TSDB_DATA_TYPE_BIGINT, range), COMP_ADAPT_FLAG | 1);
+
+  // the codec of the type wins on regular timestamps and random bits
+  std::vector<int64_t> ts(n);
+  for (int32_t i = 0; i < n; i++) ts[i] = 1700000000000 + i * 1000;
+  EXPECT_EQ(checkAdaptive(TSDB_DATA_TYPE_TIMESTAMP, ts) & COMP_ADAPT_FLAG, 0);
+  EXPECT_EQ(checkAdaptive(TSDB_DATA_TYPE_BIGINT, genRandomBits<int64_t>(rng, n)) & COMP_ADAPT_FLAG, 0);
+
+  // the full range of the narrow types, signed and two stage
+  checkAdaptive(TSDB_DATA_TYPE_TINYINT, genRandomBits<int8_t>(rng, n));
+  checkAdaptive(TSDB_DATA_TYPE_SMALLINT, genRandomBits<int16_t>(rng, n), TWO_STAGE_COMP);
+  std::vector<int16_t> extremes(n);
+  for (int32_t i = 0; i < n; i++) extremes[i] = (i % 3) ? INT16_MIN : INT16_MAX;
+  checkAdaptive(TSDB_DATA_TYPE_SMALLINT, extremes);
+  std::vector<int64_t> wide(n);
+  for (int32_t i = 0; i < n; i++) wide[i] = (i % 2) ? INT64_MIN : INT64_MAX - (int64_t)(rng() % 4);
+  checkAdaptive(TSDB_DATA_TYPE_BIGINT, wide, TWO_STAGE_COMP);
+}
+
+TEST(compressTest, adaptiveFloating) {
+  std::mt19937_64 rng(5);
+  const int32_t   n = 4096;
+
+  // readings with one or two decimals, with nan, inf and -0.0 as exceptions
+  std::vector<double> d(n);
+  std::vector<float>  f(n);
+  for (int32_t i = 0; i < n; i++) {
+    d[i] = (double)(int64_t)(rng() % 100000 - 50000) / 100;
+    f[i] = (float)(int64_t)(rng() % 10000) / 10;
+  }
+  d[7] = NAN;
+  d[100] = -0.0;
+  d[4000] = INFINITY;
+  f[9] = 1.0f / 3;
+  EXPECT_EQ(checkAdaptive(TSDB_DATA_TYPE_DOUBLE, d), COMP_ADAPT_FLAG | 4);
+  EXPECT_EQ(checkAdaptive(TSDB_DATA_TYPE_FLOAT, f), COMP_ADAPT_FLAG | 4);
+
+  // a few set points
+  for (int32_t i = 0; i < n; i++) d[i] = (rng() % 2) ? 21.5 : 1.0 / 3;
+  EXPECT_EQ(checkAdaptive(TSDB_DATA_TYPE_DOUBLE, d), COMP_ADAPT_FLAG | 2);
+
+  // random bits, with and without the second stage
+  checkAdaptive(TSDB_DATA_TYPE_DOUBLE, genRandomBits<double>(rng, n));
+  checkAdaptive(TSDB_DATA_TYPE_FLOAT, genRandomBits<float>(rng, n), TWO_STAGE_COMP);
+  checkAdaptive(TSDB_DATA_TYPE_DOUBLE, std::vector<double>(n, 1.5), TWO_STAGE_COMP);
+}
@@ -219,6 +219,79 @@ void testFlushAndReadBackBuffer() {
   destroyDiskbasedBuf(pBuf);
 }
 
+void fillTestPage(SFilePage* pPg, int32_t pageId, int32_t round, bool compressible) {
+  int32_t* p = (int32_t*)pPg->data;
+  int32_t  num = (1024 - sizeof(SFilePage)) / sizeof(int32_t);
+  for (int32_t i = 0; i < num; ++i) {
+    p[i] = compressible ? (pageId * 31 + round) : (int32_t)taosRand();
+  }
+  p[0] = pageId;
+  p[1] = round;
+  pPg->num = num;
+}
+
+// evicted pages are compressed and written on the io thread, and read back either from the io queue or the disk file
+void asyncIoTest(bool comp) {
+  SDiskbasedBuf* pBuf = NULL;
+  int32_t        code = createDiskbasedBuf(&pBuf, 1024, 4 * 1024, "asyncIo", TD_TMP_DIR_PATH);
+  ASSERT_EQ(code, 0);
+
+  setBufPageCompressOnDisk(pBuf, comp);
+  ASSERT_EQ(dBufSetAsyncIo(pBuf, 3 * 1024), 0);
+
+  const int32_t numOfPages = 200;
+  for (int32_t i = 0; i < numOfPages; ++i) {
+    int32_t    pageId = -1;
+    SFilePage* pPg = static_cast<SFilePage*>(getNewBufPage(pBuf, &pageId));
+    ASSERT_TRUE(pPg != NULL);
+    ASSERT_EQ(pageId, i);
+
+    fillTestPage(pPg, pageId, 0, i % 2 == 0);
+    setBufPageDirty(pPg, true);
+    releaseBufPage(pBuf, pPg);
+  }
+
+  ASSERT_FALSE(isAllDataInMemBuf(pBuf));
+
+  // rewrite some of the pages, the rewritten ones may be larger than the original
+  for (int32_t i = 0; i < numOfPages; i += 3) {
+    SFilePage* pPg = static_cast<SFilePage*>(getBufPage(pBuf, i));
+    ASSERT_TRUE(pPg != NULL);
+    ASSERT_EQ(((int32_t*)pPg->data)[0], i);
+
+    fillTestPage(pPg, i, 1, i % 2 != 0);
+    setBufPageDirty(pPg, true);
+    releaseBufPage(pBuf, pPg);
+  }
+
+  // read all pages back in order with prefetch
+  for (int32_t i = 0; i < numOfPages; ++i) {
+    SFilePage* pPg = static_cast<SFilePage*>(getBufPage(pBuf, i));
+    ASSERT_TRUE(pPg != NULL);
+    dBufPrefetchPage(pBuf, i + 1);
+    dBufPrefetchPage(pBuf, i + 2);
+
+    int32_t* p = (int32_t*)pPg->data;
+    ASSERT_EQ(p[0], i);
+    ASSERT_EQ(p[1], (i % 3 == 0) ? 1 : 0);
+    bool compressible = (i % 3 == 0) ? (i % 2 != 0) : (i % 2 == 0);
+    if (compressible) {
+      ASSERT_EQ(p[2], i * 31 + p[1]);
+    }
+    releaseBufPage(pBuf, pPg);
+  }
+
+  SDiskbasedBufStatis statis = getDBufStatis(pBuf);
+  ASSERT_GT(statis.flushPages, 0);
+  ASSERT_GT(statis.loadPages, 0);
+  if (comp) {
+    ASSERT_LT(statis.flushBytes, (int64_t)statis.flushPages * (1024 + sizeof(SFilePage)));
+  }
+
+  clearDiskbasedBuf(pBuf);
+  destroyDiskbasedBuf(pBuf);
+}
+
 }  // namespace
 
 TEST(testCase, resultBufferTest) {
@@ -229,4 +302,10 @@ TEST(testCase, resultBufferTest) {
   testFlushAndReadBackBuffer();
 }
 
+TEST(testCase, asyncIoBufferTest) {
+  taosSeedRand(taosGetTimestampSec());
+  asyncIoTest(false);
+  asyncIoTest(true);
+}
+
 #pragma GCC diagnostic pop
@@ -0,0 +1,91 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    # a memtable across many file sets is committed by several of them at once, the small budget holds some back
+    updatecfgDict = {'commitFileSetThreads': 4, 'commitMemBudget': 1}
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug(f"start to excute {__file__}")
+        tdSql.init(conn.cursor(), logSql)
+        self.dbname = "commit_fsets"
+        self.ts = 1640966400000
+        self.day = 86400000
+        self.days = 12
+        self.rows = {}
+
+    def write(self, tb, keys, base):
+        for start in range(0, len(keys), 500):
+            values = ' '.join(f"({self.ts + k}, {base + k // 1000})" for k in keys[start:start + 500])
+            tdSql.execute(f"insert into {self.dbname}.{tb} values {values}")
+        for k in keys:
+            self.rows[(tb, k)] = base + k // 1000
+
+    def insert(self, base):
+        hour = 3600000
+        # across all the file sets, in one of them, in the first and the last only, and a few scattered rows
+        self.write("ct0", [i * hour for i in range(self.days * 24)], base)
+        self.write("ct1", [5 * self.day + i * 1000 for i in range(2000)], base)
+        self.write("ct2", [i * 1000 for i in range(100)] + [(self.days - 1) * self.day + i * 1000 for i in range(100)],
+                   base)
+        self.write("ct3", [d * self.day + 7 * hour for d in range(0, self.days, 3)], base)
+        tdSql.execute(f"flush database {self.dbname}")
+
+    def check(self):
+        for d in range(self.days):
+            start = self.ts + d * self.day
+            values = [v for (tb, k), v in self.rows.items() if d * self.day <= k < (d + 1) * self.day]
+            tdSql.query(f"select count(*), sum(c1) from {self.dbname}.stb where ts >= {start} and ts < {start + self.day}")
+            tdSql.checkData(0, 0, len(values))
+            if values:
+                tdSql.checkData(0, 1, sum(values))
+
+        tdSql.query(f"select count(*) from {self.dbname}.stb")
+        tdSql.checkData(0, 0, len(self.rows))
+        tdSql.query(f"select tbname, count(*) from {self.dbname}.stb partition by tbname order by tbname")
+        tdSql.checkRows(4)
+        for r, tb in enumerate(["ct0", "ct1", "ct2", "ct3"]):
+            tdSql.checkData(r, 1, sum(1 for (t, k) in self.rows if t == tb))
+
+    def run(self):
+        tdSql.execute(f"drop database if exists {self.dbname}")
+        tdSql.execute(f"create database {self.dbname} vgroups 1 duration 1d keep 3650")
+        tdSql.execute(f"create table {self.dbname}.stb (ts timestamp, c1 bigint) tags (t1 int)")
+        for i in range(4):
+            tdSql.execute(f"create table {self.dbname}.ct{i} using {self.dbname}.stb tags ({i})")
+
+        self.insert(0)
+        self.check()
+
+        # the second commit merges into the file sets of the first one
+        self.insert(1000000)
+        self.check()
+
+        tdDnodes.stop(1)
+        tdDnodes.start(1)
+        self.check()
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success(f"{__file__} successfully executed")
+
+
+tdCases.addLinux(__file__, TDTestCase())
+tdCases.addWindows(__file__, TDTestCase())
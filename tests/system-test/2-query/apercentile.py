@@ -85,7 +85,7 @@ class TDTestCase:
         ]
 
         self.percent = [1,50,100]
-        self.param_list = ['default','t-digest']
+        self.param_list = ['default','t-digest','ddsketch']
     def insert_data(self,column_dict,tbname,row_num):
         insert_sql = self.setsql.set_insertsql(column_dict,tbname,self.binary_str,self.nchar_str)
         for i in range(row_num):
@@ -0,0 +1,91 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TDTestCase:
+    # the binary/nchar columns of few distinct values are only dictionary encoded with adaptiveCompress
+    updatecfgDict = {'adaptiveCompress': 1}
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug(f"start to excute {__file__}")
+        tdSql.init(conn.cursor(), logSql)
+        self.dbname = "dict_col"
+        self.ts = 1640966400000
+        self.rows = 3000
+        self.status = ["OK", "WARN", "ERROR", "", "a longer status of the device"]
+
+    def value_of(self, i):
+        # every 9th row null, the others from a few values
+        if i % 9 == 4:
+            return None
+        return self.status[(i * 7 + i // 5) % len(self.status)]
+
+    def insert(self):
+        tdSql.execute(f"drop database if exists {self.dbname}")
+        tdSql.execute(f"create database {self.dbname} vgroups 1 stt_trigger 1")
+        tdSql.execute(f"create table {self.dbname}.ntb (ts timestamp, c1 int, c2 binary(32), c3 nchar(32))")
+
+        for start in range(0, self.rows, 500):
+            values = []
+            for i in range(start, min(start + 500, self.rows)):
+                v = self.value_of(i)
+                sv = "NULL" if v is None else f"'{v}'"
+                values.append(f"({self.ts + i * 1000}, {i}, {sv}, {sv})")
+            tdSql.execute(f"insert into {self.dbname}.ntb values {' '.join(values)}")
+        tdSql.execute(f"flush database {self.dbname}")
+
+    def check_rows(self, order, offset, limit):
+        tdSql.query(f"select c1, c2, c3 from {self.dbname}.ntb order by ts {order} limit {limit} offset {offset}")
+        rows = list(range(self.rows))
+        if order == "desc":
+            rows.reverse()
+        rows = rows[offset:offset + limit]
+        tdSql.checkRows(len(rows))
+        for r, i in enumerate(rows):
+            tdSql.checkData(r, 0, i)
+            tdSql.checkData(r, 1, self.value_of(i))
+            tdSql.checkData(r, 2, self.value_of(i))
+
+    def run(self):
+        self.insert()
+
+        # whole blocks and parts of them, in both orders
+        for order in ["asc", "desc"]:
+            self.check_rows(order, 0, self.rows)
+            self.check_rows(order, 777, 1111)
+
+        # the rows of a value share its payload in the result block, the filters on it must still see each row
+        for v in self.status:
+            expect = sum(1 for i in range(self.rows) if self.value_of(i) == v)
+            tdSql.query(f"select count(*) from {self.dbname}.ntb where c2 = '{v}'")
+            tdSql.checkData(0, 0, expect)
+            tdSql.query(f"select count(*) from {self.dbname}.ntb where c3 = '{v}'")
+            tdSql.checkData(0, 0, expect)
+        tdSql.query(f"select count(*) from {self.dbname}.ntb where c2 like 'W%' or c2 is null")
+        tdSql.checkData(0, 0, sum(1 for i in range(self.rows) if self.value_of(i) in (None, "WARN")))
+
+        tdSql.query(f"select c2, count(*) from {self.dbname}.ntb group by c2 order by c2")
+        tdSql.checkRows(len(self.status) + 1)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success(f"{__file__} successfully executed")
+
+
+tdCases.addLinux(__file__, TDTestCase())
+tdCases.addWindows(__file__, TDTestCase())
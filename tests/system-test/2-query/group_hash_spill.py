@@ -0,0 +1,77 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TDTestCase:
+    # the smallest threshold, far below the group hash of the groups here, so that it spills many times
+    updatecfgDict = {'groupHashMemThreshold': 1}
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug(f"start to excute {__file__}")
+        tdSql.init(conn.cursor(), logSql)
+        self.dbname = "group_spill"
+        self.ts = 1640966400000
+        self.rows = 200000
+        self.groups = 100000
+
+    def insert(self):
+        tdSql.execute(f"drop database if exists {self.dbname}")
+        tdSql.execute(f"create database {self.dbname} vgroups 1")
+        tdSql.execute(f"create table {self.dbname}.ntb (ts timestamp, c1 int, c2 bigint, c3 binary(16))")
+
+        # every group shows up in the first and in the second half, the second time after it was spilled
+        for start in range(0, self.rows, 5000):
+            values = []
+            for i in range(start, start + 5000):
+                g = i % self.groups
+                values.append(f"({self.ts + i}, {g}, {i}, 'g{g}')")
+            tdSql.execute(f"insert into {self.dbname}.ntb values {' '.join(values)}")
+        tdSql.execute(f"flush database {self.dbname}")
+
+    def check_groups(self, col, key_of):
+        tdSql.query(f"select {col}, count(*), sum(c2), min(c2), max(c2) from {self.dbname}.ntb group by {col}")
+        tdSql.checkRows(self.groups)
+        seen = set()
+        for row in tdSql.queryResult:
+            g = key_of(row[0])
+            seen.add(g)
+            if row[1:] != (2, 2 * g + self.groups, g, g + self.groups):
+                tdLog.exit(f"group {row[0]}: {row[1:]}, expect {(2, 2 * g + self.groups, g, g + self.groups)}")
+        if len(seen) != self.groups:
+            tdLog.exit(f"{len(seen)} distinct groups, expect {self.groups}")
+
+    def run(self):
+        self.insert()
+
+        self.check_groups("c1", lambda k: k)
+        self.check_groups("c3", lambda k: int(k[1:]))
+
+        tdSql.query(f"select count(*) from (select c1, count(*) from {self.dbname}.ntb group by c1 having count(*) = 2)")
+        tdSql.checkData(0, 0, self.groups)
+
+        tdSql.query(f"explain analyze select c1, count(*) from {self.dbname}.ntb group by c1")
+        if not any("Group Hash Spill" in str(row[0]) for row in tdSql.queryResult):
+            tdLog.exit("the group hash did not spill")
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success(f"{__file__} successfully executed")
+
+
+tdCases.addLinux(__file__, TDTestCase())
+tdCases.addWindows(__file__, TDTestCase())
@@ -0,0 +1,108 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TDTestCase:
+    # the build side of the larger joins goes over the threshold and is spilled in part
+    updatecfgDict = {'hashJoinMemThreshold': 1}
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug(f"start to excute {__file__}")
+        tdSql.init(conn.cursor(), logSql)
+        self.dbname = "hash_join"
+        self.ts = 1640966400000
+
+    def insert(self, tbname, rows, mod, null_every):
+        for start in range(0, rows, 1000):
+            values = []
+            for i in range(start, min(start + 1000, rows)):
+                c1 = "NULL" if i % null_every == 0 else str((i * 7) % mod)
+                values.append(f"({self.ts + i * 1000}, {c1}, 'v{i}', {i})")
+            tdSql.execute(f"insert into {self.dbname}.{tbname} values {' '.join(values)}")
+
+    def prepare(self):
+        tdSql.execute(f"drop database if exists {self.dbname}")
+        tdSql.execute(f"create database {self.dbname} vgroups 1")
+        tdSql.execute(f"create table {self.dbname}.stb (ts timestamp, c1 int, c2 binary(32), c3 bigint) tags (t1 int)")
+        tdSql.execute(f"create table {self.dbname}.ct1 using {self.dbname}.stb tags (1)")
+        tdSql.execute(f"create table {self.dbname}.ct2 using {self.dbname}.stb tags (2)")
+        tdSql.execute(f"create table {self.dbname}.ct3 using {self.dbname}.stb tags (3)")
+        self.insert("ct1", 30000, 40, 97)
+        self.insert("ct2", 20000, 60, 89)
+        # few rows, the build side
+        self.insert("ct3", 500, 40, 13)
+        tdSql.execute(f"flush database {self.dbname}")
+
+    def query_sorted(self, sql):
+        tdSql.query(sql)
+        return sorted(tdSql.queryResult, key=lambda row: tuple((v is None, str(v)) for v in row))
+
+    def uses_hash_join(self, sql):
+        tdSql.query(f"explain {sql}")
+        return any("Hash Inner join" in str(row[0]) for row in tdSql.queryResult)
+
+    def check_join(self, sql):
+        tdSql.execute("alter local 'queryUseHashJoin' '0'")
+        if self.uses_hash_join(sql):
+            tdLog.exit(f"merge join expected: {sql}")
+        expected = self.query_sorted(sql)
+
+        tdSql.execute("alter local 'queryUseHashJoin' '1'")
+        if not self.uses_hash_join(sql):
+            tdLog.exit(f"hash join expected: {sql}")
+        result = self.query_sorted(sql)
+        tdSql.execute("alter local 'queryUseHashJoin' '0'")
+
+        if result != expected:
+            tdLog.exit(f"hash join result differs from merge join, rows {len(result)} vs {len(expected)}: {sql}")
+        tdLog.info(f"{len(result)} rows as the merge join: {sql}")
+        return len(result)
+
+    def run(self):
+        self.prepare()
+        db = self.dbname
+
+        # both sides larger than the threshold
+        rows = self.check_join(f"select t1.ts, t1.c1, t1.c2, t2.c2, t2.c3 from {db}.ct1 t1 join {db}.ct2 t2 "
+                               f"on t1.ts = t2.ts and t1.c1 = t2.c1")
+        if rows == 0:
+            tdLog.exit("the join is expected to match rows")
+
+        # a small side, on the left and on the right
+        self.check_join(f"select t1.c3, t2.c3 from {db}.ct3 t1 join {db}.ct1 t2 on t1.ts = t2.ts and t1.c1 = t2.c1")
+        self.check_join(f"select t1.c3, t2.c3 from {db}.ct1 t1 join {db}.ct3 t2 on t1.ts = t2.ts and t1.c1 = t2.c1")
+
+        # more key columns, and conditions on the joined rows
+        self.check_join(f"select t1.c3, t2.c3 from {db}.ct1 t1 join {db}.ct2 t2 "
+                        f"on t1.ts = t2.ts and t1.c1 = t2.c1 and t1.c2 = t2.c2")
+        self.check_join(f"select t1.c3, t2.c3 from {db}.ct1 t1 join {db}.ct2 t2 "
+                        f"on t1.ts = t2.ts and t1.c1 = t2.c1 and t1.c3 > t2.c3")
+        self.check_join(f"select t1.c3, t2.c3 from {db}.ct1 t1 join {db}.ct2 t2 "
+                        f"on t1.ts = t2.ts and t1.c1 = t2.c1 where t1.c3 % 3 = 0 and t2.c2 like 'v1%'")
+
+        # aggregate over the join
+        self.check_join(f"select count(*), sum(t1.c3), max(t2.c3) from {db}.ct1 t1 join {db}.ct2 t2 "
+                        f"on t1.ts = t2.ts and t1.c1 = t2.c1")
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success(f"{__file__} successfully executed")
+
+
+tdCases.addLinux(__file__, TDTestCase())
+tdCases.addWindows(__file__, TDTestCase())
@@ -828,6 +828,41 @@ class TDTestCase:
         self.check_result_auto( f"select t3,c1 from {dbname}.stb1 where c1 > 0 order by tbname  " , f"select t3 ,abs(c1) from {dbname}.stb1 where c1 > 0 order by tbname" )
         self.check_result_auto( f"select t4,c1 from {dbname}.stb1 where c1 > 0 order by tbname  " , f"select t4 , abs(c1) from {dbname}.stb1 where c1 > 0 order by tbname" )
 
+    def last_cache_update_test(self, dbname="cache_update"):
+        # a column read alone from the cache, then updated, must come back new when read along with a column the cache
+        # has not seen yet
+        tdSql.execute(f"drop database if exists {dbname} ")
+        tdSql.execute(f"create database {dbname} cachemodel 'both' ")
+        tdSql.execute(f"create stable {dbname}.stb (ts timestamp, c1 int, c2 int) tags (t1 int)")
+        tdSql.execute(f"create table {dbname}.ct1 using {dbname}.stb tags(1) ")
+        tdSql.execute(f"create table {dbname}.ct2 using {dbname}.stb tags(2) ")
+        tdSql.execute(f"insert into {dbname}.ct1 values ({self.ts}, 1, 10) {dbname}.ct2 values ({self.ts}, 2, 20)")
+
+        tdSql.query(f"select last(c1) from {dbname}.ct1")
+        tdSql.checkData(0, 0, 1)
+        tdSql.query(f"select last_row(c1) from {dbname}.stb partition by tbname order by tbname")
+        tdSql.checkData(0, 0, 1)
+        tdSql.checkData(1, 0, 2)
+
+        tdSql.execute(f"insert into {dbname}.ct1 values ({self.ts + 1000}, 3, NULL) {dbname}.ct2 values ({self.ts + 1000}, 4, 40)")
+
+        tdSql.query(f"select last(c1), last(c2) from {dbname}.ct1")
+        tdSql.checkData(0, 0, 3)
+        tdSql.checkData(0, 1, 10)
+        tdSql.query(f"select last_row(c1), last_row(c2) from {dbname}.stb partition by tbname order by tbname")
+        tdSql.checkData(0, 0, 3)
+        tdSql.checkData(0, 1, None)
+        tdSql.checkData(1, 0, 4)
+        tdSql.checkData(1, 1, 40)
+
+        # and the same once the values went through a commit
+        tdSql.execute(f"flush database {dbname}")
+        tdSql.execute(f"insert into {dbname}.ct1 values ({self.ts + 2000}, 5, 50)")
+        tdSql.query(f"select last(c1), last(c2), last_row(c1) from {dbname}.ct1")
+        tdSql.checkData(0, 0, 5)
+        tdSql.checkData(0, 1, 50)
+        tdSql.checkData(0, 2, 5)
+
     def basic_query(self):
 
         tdLog.printNoPrefix("==========step2:test errors ==============")
@@ -890,6 +925,8 @@ class TDTestCase:
         self.insert_datas_and_check_abs(self.tb_nums,self.row_nums,self.time_step,"'BOTH'")
         self.basic_query()
 
+        self.last_cache_update_test()
+
 
     def stop(self):
         tdSql.close()
@@ -0,0 +1,131 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TDTestCase:
+    updatecfgDict = {'tagColumnStore': 1, 'tagColumnStoreSize': 1}
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug(f"start to excute {__file__}")
+        tdSql.init(conn.cursor(), logSql)
+        self.dbname = "tag_store"
+        self.ts = 1640966400000
+        self.tables = 200
+        self.regions = ["beijing", "shanghai", "shenzhen", "a much longer region name of the device"]
+
+    def create(self, stb, tables):
+        tdSql.execute(f"create table {self.dbname}.{stb} (ts timestamp, c1 int) "
+                      f"tags (t1 int, t2 binary(64), t3 double, t4 nchar(16))")
+        # the tags of a table, None for a null
+        tags = {}
+        for i in range(tables):
+            t1 = None if i % 17 == 3 else i % 10
+            t2 = None if i % 13 == 5 else self.regions[i % len(self.regions)]
+            t3 = i * 0.5
+            t4 = f"n{i % 7}"
+            tags[f"{stb}_{i}"] = [t1, t2, t3, t4]
+            sv = lambda v: "NULL" if v is None else (f"'{v}'" if isinstance(v, str) else str(v))
+            tdSql.execute(f"create table {self.dbname}.{stb}_{i} using {self.dbname}.{stb} "
+                          f"tags ({', '.join(sv(v) for v in tags[f'{stb}_{i}'])})")
+            tdSql.execute(f"insert into {self.dbname}.{stb}_{i} values ({self.ts + i}, {i})")
+        return tags
+
+    def check(self, stb, tags):
+        # the tables of each filter, from the tags kept by the case
+        filters = [
+            ("t1 = 3", lambda t: t[0] == 3),
+            ("t1 is null", lambda t: t[0] is None),
+            ("t1 > 6 and t3 < 50", lambda t: t[0] is not None and t[0] > 6 and t[2] < 50),
+            ("t2 = 'shanghai'", lambda t: t[1] == "shanghai"),
+            ("t2 is null", lambda t: t[1] is None),
+            ("t2 like 'sh%' or t4 = 'n6'", lambda t: (t[1] is not None and t[1].startswith("sh")) or t[3] == "n6"),
+            (f"t2 = '{self.regions[3]}'", lambda t: t[1] == self.regions[3]),
+        ]
+        for cond, match in filters:
+            expect = sorted(name for name, t in tags.items() if match(t))
+            tdSql.query(f"select tbname from {self.dbname}.{stb} where {cond} order by tbname")
+            tdSql.checkRows(len(expect))
+            for r, name in enumerate(expect):
+                tdSql.checkData(r, 0, name)
+
+            tdSql.query(f"select count(*) from {self.dbname}.{stb} where {cond}")
+            tdSql.checkData(0, 0, len(expect))
+
+    def run(self):
+        tdSql.execute(f"drop database if exists {self.dbname}")
+        tdSql.execute(f"create database {self.dbname} vgroups 1")
+
+        # built by the first query, served from the store by the second
+        tags = self.create("stb", self.tables)
+        self.check("stb", tags)
+        self.check("stb", tags)
+
+        # tag updates
+        for i in range(0, self.tables, 9):
+            name = f"stb_{i}"
+            tdSql.execute(f"alter table {self.dbname}.{name} set tag t1 = 3")
+            tdSql.execute(f"alter table {self.dbname}.{name} set tag t2 = 'a new region {i % 2}'")
+            tags[name][0] = 3
+            tags[name][1] = f"a new region {i % 2}"
+        tdSql.execute(f"alter table {self.dbname}.stb_1 set tag t2 = NULL")
+        tags["stb_1"][1] = None
+        self.check("stb", tags)
+        tdSql.query(f"select count(*) from {self.dbname}.stb where t2 = 'a new region 1'")
+        tdSql.checkData(0, 0, sum(1 for t in tags.values() if t[1] == "a new region 1"))
+
+        # dropped and created child tables
+        for i in range(0, self.tables, 7):
+            tdSql.execute(f"drop table {self.dbname}.stb_{i}")
+            del tags[f"stb_{i}"]
+        self.check("stb", tags)
+
+        tdSql.execute(f"create table {self.dbname}.stb_new using {self.dbname}.stb tags (3, 'shanghai', 1.5, 'n6')")
+        tags["stb_new"] = [3, "shanghai", 1.5, "n6"]
+        self.check("stb", tags)
+
+        # a second super table takes its own store, and the first one is read right after it
+        tags2 = self.create("stb2", 50)
+        self.check("stb2", tags2)
+        self.check("stb", tags)
+        self.check("stb2", tags2)
+
+        # a new tag column drops the store
+        tdSql.execute(f"alter stable {self.dbname}.stb add tag t5 int")
+        tdSql.execute(f"alter table {self.dbname}.stb_new set tag t5 = 8")
+        tdSql.query(f"select tbname from {self.dbname}.stb where t5 = 8")
+        tdSql.checkRows(1)
+        tdSql.checkData(0, 0, "stb_new")
+        self.check("stb", tags)
+
+        # and so does dropping the super table
+        tdSql.execute(f"drop table {self.dbname}.stb2")
+        tags2 = self.create("stb2", 20)
+        self.check("stb2", tags2)
+
+        # the commit clears the stores, they are built again
+        tdSql.execute(f"flush database {self.dbname}")
+        self.check("stb", tags)
+        self.check("stb2", tags2)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success(f"{__file__} successfully executed")
+
+
+tdCases.addLinux(__file__, TDTestCase())
+tdCases.addWindows(__file__, TDTestCase())
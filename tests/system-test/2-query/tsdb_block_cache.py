@@ -0,0 +1,76 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TDTestCase:
+    updatecfgDict = {'tsdbBlockCacheSize': 16}
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug(f"start to excute {__file__}")
+        tdSql.init(conn.cursor(), logSql)
+        self.dbname = "block_cache"
+        self.ts = 1640966400000
+        self.day = 86400000
+        self.rows = 1000
+
+    def insert_file_set(self, tbname, ts, base):
+        values = " ".join(f"({ts + i * 1000}, {base + i}, 'v{base + i}')" for i in range(self.rows))
+        tdSql.execute(f"insert into {self.dbname}.{tbname} values {values}")
+
+    def check_file_set(self, tbname, ts, base):
+        tdSql.query(f"select count(*), sum(c1), min(c2), max(c2) from {self.dbname}.{tbname} "
+                    f"where ts >= {ts} and ts < {ts + self.day}")
+        tdSql.checkData(0, 0, self.rows)
+        tdSql.checkData(0, 1, sum(range(base, base + self.rows)))
+        tdSql.checkData(0, 2, f"v{base}")
+        tdSql.checkData(0, 3, f"v{base + self.rows - 1}")
+
+    def run(self):
+        # the files of both file sets come out of one commit, with the same commit id and the same block layout, so
+        # their blocks sit at the same offsets
+        tdSql.execute(f"drop database if exists {self.dbname}")
+        tdSql.execute(f"create database {self.dbname} vgroups 1 duration 10d keep 3650d stt_trigger 1")
+        tdSql.execute(f"create table {self.dbname}.ntb (ts timestamp, c1 int, c2 binary(16))")
+
+        bases = [100000, 200000]
+        for i, base in enumerate(bases):
+            self.insert_file_set("ntb", self.ts + i * 20 * self.day, base)
+        tdSql.execute(f"flush database {self.dbname}")
+
+        # twice each, the second round is served by the block cache
+        for _ in range(2):
+            for i, base in enumerate(bases):
+                self.check_file_set("ntb", self.ts + i * 20 * self.day, base)
+
+        # the same through the stt files of a second commit
+        bases = [300000, 400000]
+        for i, base in enumerate(bases):
+            self.insert_file_set("ntb", self.ts + i * 20 * self.day + self.day, base)
+        tdSql.execute(f"flush database {self.dbname}")
+
+        for _ in range(2):
+            for i, base in enumerate(bases):
+                self.check_file_set("ntb", self.ts + i * 20 * self.day + self.day, base)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success(f"{__file__} successfully executed")
+
+
+tdCases.addLinux(__file__, TDTestCase())
+tdCases.addWindows(__file__, TDTestCase())